@@ -6,12 +6,14 @@
 #pragma once
 
 // System headers
+#include <memory>
 #include <vector>
 
 // Root headers
 #include "TH1.h"
 
 // Qweak headers
+#include "QwHistogramHelper.h"
 #include "QwLog.h"
 
 /**
@@ -35,12 +37,12 @@ class MQwHistograms {
 
   protected:
     /// Default constructor
-    MQwHistograms() { }
+    MQwHistograms(): fHistogramBufferGeneration(0) { }
     /// Copy constructor
     MQwHistograms(const MQwHistograms& source)
-    : fHistograms(source.fHistograms) { }
-    /// Virtual destructor
-    virtual ~MQwHistograms() { }
+    : fHistograms(source.fHistograms), fHistogramBufferGeneration(0) { }
+    /// Virtual destructor, which releases the fill buffers
+    virtual ~MQwHistograms() { ReleaseHistogramBuffers(); }
 
     /// Arithmetic assignment operator:  Should only copy event-based data.
     /// In this particular class, there is no event-based data.
@@ -57,10 +59,49 @@ class MQwHistograms {
       }
     }
 
+    /// Fill a histogram, through its fill buffer if it has one
+    inline void FillHistogram(std::size_t index, Double_t value) {
+      if (fHistogramBuffers.size() != fHistograms.size()
+       || fHistogramBufferGeneration != gQwHists.GetFillBufferGeneration())
+        ResolveHistogramBuffers();
+      QwHistogramBuffer* buffer = fHistogramBuffers[index].get();
+      // The histogram was replaced or its file was closed since the buffers
+      // were resolved
+      if (buffer != nullptr && buffer->GetHistogram() != fHistograms[index]) {
+        gQwHists.ReleaseFillBuffer(fHistogramBuffers[index]);
+        fHistogramBuffers[index] = gQwHists.GetFillBuffer(fHistograms[index]);
+        buffer = fHistogramBuffers[index].get();
+      }
+      if (buffer != nullptr)
+        buffer->Fill(value);
+      else
+        fHistograms[index]->Fill(value);
+    }
+
   protected:
     /// Histograms associated with this data element
     std::vector<TH1_ptr> fHistograms;
 
+  private:
+    /// Look up the fill buffers of the histograms
+    void ResolveHistogramBuffers() {
+      fHistogramBuffers.assign(fHistograms.size(), nullptr);
+      for (std::size_t i = 0; i < fHistograms.size(); i++)
+        fHistogramBuffers[i] = gQwHists.GetFillBuffer(fHistograms[i]);
+      fHistogramBufferGeneration = gQwHists.GetFillBufferGeneration();
+    }
+    /// Release the fill buffers, while the histograms still exist
+    void ReleaseHistogramBuffers() {
+      for (auto& buffer: fHistogramBuffers)
+        gQwHists.ReleaseFillBuffer(buffer);
+      fHistogramBuffers.clear();
+    }
+
+    /// Fill buffers of the histograms, resolved at the first fill and
+    /// shared with the histogram helper
+    std::vector<std::shared_ptr<QwHistogramBuffer> > fHistogramBuffers;
+    UInt_t fHistogramBufferGeneration;
+
   protected:
     /// Register a histogram
     void AddHistogram(TH1* h) {
@@ -71,7 +112,10 @@ class MQwHistograms {
   public:
     /// Share histogram pointers between objects
     void ShareHistograms(const MQwHistograms* source) {
-      if (source) fHistograms = source->fHistograms;
+      if (source) {
+        ReleaseHistogramBuffers();
+        fHistograms = source->fHistograms;
+      }
     }
 
 }; // class MQwHistograms
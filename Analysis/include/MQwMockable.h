@@ -7,6 +7,11 @@
 
 #pragma once
 
+// System headers
+#include <complex>
+#include <random>
+#include <vector>
+
 // Boost math library for random number generation
 #include "boost/random.hpp"
 
@@ -40,7 +45,8 @@ public:
   MQwMockable(): fUseExternalRandomVariable(false),
                  fCalcMockDataAsDiff(false),
 		 fMockAsymmetry(0.0), fMockGaussianMean(0.0),
-                 fMockGaussianSigma(0.0)
+                 fMockGaussianSigma(0.0),
+                 fMockDriftTime(0.0), fMockDriftStep(0.0), fMockDriftSteps(0)
   {
     // Mock drifts
     fMockDriftAmplitude.clear();
@@ -72,6 +78,17 @@ public:
   /// external Random Variable.
   Double_t GetRandomValue();
 
+  /// Fill an array with random values from the internal or external
+  /// Random Variable.
+  void GetRandomValues(Double_t* values, std::size_t n);
+  /// Return the sum of the harmonic drifts at this time
+  Double_t GetRandomEventDrift(Double_t time);
+
+  /// Reseed the internal random variable of the calling thread
+  static void SetRandomSeed(std::seed_seq& seed);
+  /// Fill an array with normal random values of the calling thread
+  static void FillRandomValues(Double_t* values, std::size_t n);
+
   /// Internally generate random event data
   virtual void  RandomizeEventData(int helicity = 0, double time = 0.0) = 0;
 
@@ -99,13 +116,13 @@ public:
  protected:
   /// \name Parity mock data generation
   // @{
-  /// Internal randomness generator
-  static boost::mt19937 fRandomnessGenerator;
+  /// Internal randomness generator (one per thread)
+  static thread_local boost::random::mt19937_64 fRandomnessGenerator;
   /// Internal normal probability distribution
-  static boost::normal_distribution<double> fNormalDistribution;
-  /// Internal normal random variable
-  static boost::variate_generator
-    < boost::mt19937, boost::normal_distribution<double> > fNormalRandomVariable;
+  static thread_local boost::normal_distribution<double> fNormalDistribution;
+  /// Internal normal random variable (one per thread)
+  static thread_local boost::variate_generator
+    < boost::random::mt19937_64, boost::normal_distribution<double> > fNormalRandomVariable;
   /// Flag to use an externally provided normal random variable
   bool fUseExternalRandomVariable;
   /// Externally provided normal random variable
@@ -120,5 +137,15 @@ public:
   std::vector<Double_t> fMockDriftAmplitude; ///< Harmonic drift amplitude
   std::vector<Double_t> fMockDriftFrequency; ///< Harmonic drift frequency
   std::vector<Double_t> fMockDriftPhase;     ///< Harmonic drift phase
+
+  /// Phasors of the harmonic drifts at the last drift time
+  std::vector< std::complex<Double_t> > fMockDriftPhasor;
+  /// Rotation of the phasors over the last time step
+  std::vector< std::complex<Double_t> > fMockDriftRotation;
+  Double_t fMockDriftTime;     ///< Time of the phasors
+  Double_t fMockDriftStep;     ///< Time step of the rotation
+  UInt_t   fMockDriftSteps;    ///< Rotations since the last exact evaluation
+  /// Rotations before the phasors are evaluated exactly again
+  static const UInt_t kMockDriftResync = 1024;
   // @}
 };
@@ -9,6 +9,63 @@
 // Qweak headers
 #include "VQwHardwareChannel.h"
 
+/**
+ * \class QwPublishedChannel
+ * \ingroup QwAnalysis
+ * \brief Handle to a published variable of a known channel type
+ *
+ * A handle is connected once to a published variable through
+ * ConnectExternalValue, and then gives direct access to the channel in
+ * every event, without a search by name, a copy or a cast.  The channel
+ * belongs to the subsystem array in which it was published, so a handle
+ * is only valid for that array.  Copies of a handle keep the name but are
+ * not connected, since they usually belong to a copy of the owner.
+ */
+template<class V>
+class QwPublishedChannel {
+
+  public:
+    /// \brief Constructor with the name of the published variable
+    QwPublishedChannel(const TString& name = ""): fName(name), fChannel(0) { };
+    /// \brief Copy constructor; the copy is not connected
+    QwPublishedChannel(const QwPublishedChannel& source): fName(source.fName), fChannel(0) { };
+    /// \brief Assignment operator; this handle is disconnected
+    QwPublishedChannel& operator=(const QwPublishedChannel& source) {
+      fName = source.fName;
+      fChannel = 0;
+      return *this;
+    };
+
+    /// Name of the published variable
+    const TString& GetName() const { return fName; };
+    /// Is the handle connected to a channel?
+    Bool_t IsConnected() const { return (fChannel != 0); };
+
+    /**
+     * \brief Connect the handle to a published channel
+     * @param channel Published channel, or null if it was not found
+     * @return kTRUE if the channel exists and has the type of this handle
+     */
+    Bool_t Connect(const VQwHardwareChannel* channel) {
+      fChannel = dynamic_cast<const V*>(channel);
+      if (channel != 0 && fChannel == 0)
+        QwWarning << "QwPublishedChannel: " << fName
+                  << " does not have the requested channel type" << QwLog::endl;
+      return IsConnected();
+    };
+    /// Disconnect the handle
+    void Disconnect() { fChannel = 0; };
+
+    /// Connected channel, or null
+    const V* Get() const { return fChannel; };
+    const V* operator->() const { return fChannel; };
+    const V& operator*() const { return *fChannel; };
+
+  private:
+    TString  fName;      ///< Name of the published variable
+    const V* fChannel;   ///< Connected channel
+};
+
 /**
  * \class MQwPublishable_child
  * \ingroup QwAnalysis
@@ -68,6 +125,17 @@ class MQwPublishable_child {
      * @return Pointer to the variable's data element, or nullptr if not found
      */
     const VQwHardwareChannel* RequestExternalPointer(const TString& name) const;
+    /**
+     * \brief Connect a handle to an external variable
+     * Resolves the variable named by the handle once, so that it can be read
+     * in every event without a request by name.
+     * @param handle Handle to connect
+     * @return True if the variable was found with the type of the handle
+     */
+    template<class V>
+    Bool_t ConnectExternalValue(QwPublishedChannel<V>& handle) const {
+      return handle.Connect(RequestExternalPointer(handle.GetName()));
+    };
     /**
       * \brief Publish a variable from this child into the parent container.
       * @param name    Variable key to publish under.
@@ -158,6 +226,18 @@ class MQwPublishable {
      * @return Pointer to the variable's data element, or nullptr if not found
      */
     const VQwHardwareChannel* RequestExternalPointer(const TString& name) const;
+
+    /**
+     * \brief Connect a handle to an external variable
+     * Resolves the variable named by the handle once, and connects the handle
+     * directly to its data element for per-event access.
+     * @param handle Handle to connect
+     * @return kTRUE if the variable was found with the type of the handle
+     */
+    template<class V>
+    Bool_t ConnectExternalValue(QwPublishedChannel<V>& handle) const {
+      return handle.Connect(RequestExternalPointer(handle.GetName()));
+    };
     
     /**
      * \brief Retrieve an internal variable by name (pointer version)
@@ -132,6 +132,7 @@ class QwADC18_Channel: public VQwHardwareChannel, public MQwMockable {
   QwADC18_Channel& operator=  (const QwADC18_Channel &value);
   void AssignScaledValue(const QwADC18_Channel &value, Double_t scale);
   void AssignValueFrom(const VQwDataElement* valueptr) override;
+  void Snapshot(QwSnapshot& snapshot) override;
   void AddValueFrom(const VQwHardwareChannel* valueptr) override;
   void SubtractValueFrom(const VQwHardwareChannel* valueptr) override;
   void MultiplyBy(const VQwHardwareChannel* valueptr) override;
@@ -0,0 +1,69 @@
+/*!
+ * \file   QwADCDecoder.h
+ * \brief  Batch decoding of the raw data words of Moller ADC and VQWK channels
+ */
+
+#pragma once
+
+// System headers
+#include <cstddef>
+
+// ROOT headers
+#include "Rtypes.h"
+
+/**
+ * \class QwADCDecoder
+ * \ingroup QwAnalysis_ADC
+ * \brief Unpacks the raw words of Moller ADC and VQWK channels
+ *
+ * The single channel functions are used by QwMollerADC_Channel and
+ * QwVQWK_Channel in ProcessEvBuffer.  The batch functions unpack many
+ * channels of a bank in one call, given the word offset of each channel,
+ * and produce exactly the same values.  When the library is compiled for
+ * AVX2 (x86) or NEON (ARM), the batch functions use vector gathers and
+ * loads; otherwise they fall back to the single channel functions.
+ */
+class QwADCDecoder {
+
+ public:
+  /// Number of blocks in the data of one channel
+  static const Int_t kBlocks = 4;
+  /// Words read for one Moller ADC channel
+  static const UInt_t kMollerADCWords = 30;
+  /// Words read for one VQWK channel
+  static const UInt_t kVQWKWords = 6;
+
+  /// Raw data of one Moller ADC channel
+  struct MollerADCWords {
+    Int_t    fBlock_raw[kBlocks];       ///< Block sums
+    Long64_t fBlockSumSq_raw[kBlocks];  ///< Block sums of squares
+    Int_t    fBlock_min[kBlocks];       ///< Block minima
+    Int_t    fBlock_max[kBlocks];       ///< Block maxima
+    Int_t    fHardwareBlockSum_raw;     ///< Hardware sum of all blocks
+    UInt_t   fSequenceNumber;           ///< Event sequence number
+    UInt_t   fNumberOfSamples;          ///< Number of samples
+  };
+
+  /// Raw data of one VQWK channel
+  struct VQWKWords {
+    Int_t    fBlock_raw[kBlocks];       ///< Block sums
+    Int_t    fHardwareBlockSum_raw;     ///< Hardware sum of all blocks
+    UInt_t   fSequenceNumber;           ///< Event sequence number
+    UInt_t   fNumberOfSamples;          ///< Number of samples
+  };
+
+  /// \brief Unpack the data of one Moller ADC channel
+  static void DecodeMollerADC(const UInt_t* buffer, MollerADCWords& words);
+  /// \brief Unpack the data of many Moller ADC channels in a bank
+  static void DecodeMollerADC(const UInt_t* buffer, const UInt_t* offsets,
+                              std::size_t nchannels, MollerADCWords* words);
+
+  /// \brief Unpack the data of one VQWK channel
+  static void DecodeVQWK(const UInt_t* buffer, VQWKWords& words);
+  /// \brief Unpack the data of many VQWK channels in a bank
+  static void DecodeVQWK(const UInt_t* buffer, const UInt_t* offsets,
+                         std::size_t nchannels, VQWKWords* words);
+
+  /// \brief Name of the instruction set used by the batch functions
+  static const char* GetInstructionSet();
+};
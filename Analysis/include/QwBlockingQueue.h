@@ -0,0 +1,81 @@
+/*!
+ * \file   QwBlockingQueue.h
+ * \brief  Blocking first-in first-out queue for handing objects between threads
+ */
+
+#pragma once
+
+// System headers
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+/**
+ * \class QwBlockingQueue
+ * \ingroup QwAnalysis
+ * \brief Blocking first-in first-out queue of pointers
+ *
+ * The queue hands objects (by pointer) from one thread to another.  Pop
+ * waits until an object is available, or until the queue is closed.  The
+ * objects themselves are not owned by the queue; bounded queues are built
+ * by circulating a fixed set of objects between a queue of free and a
+ * queue of filled objects.
+ */
+template <class T>
+class QwBlockingQueue {
+
+ public:
+  QwBlockingQueue(): fClosed(false), fAborted(false) { };
+
+  /// Add an object at the end of the queue
+  void Push(T* item) {
+    {
+      std::lock_guard<std::mutex> lock(fMutex);
+      fQueue.push_back(item);
+    }
+    fCondition.notify_one();
+  };
+  /// Wait for the next object, or return nullptr when closed and empty
+  T* Pop() {
+    std::unique_lock<std::mutex> lock(fMutex);
+    fCondition.wait(lock, [this]{ return fClosed || ! fQueue.empty(); });
+    if (fAborted || fQueue.empty()) return nullptr;
+    T* item = fQueue.front();
+    fQueue.pop_front();
+    return item;
+  };
+  /// Take the next object if one is available, without waiting
+  T* TryPop() {
+    std::lock_guard<std::mutex> lock(fMutex);
+    if (fAborted || fQueue.empty()) return nullptr;
+    T* item = fQueue.front();
+    fQueue.pop_front();
+    return item;
+  };
+  /// Close the queue; remaining objects are still returned unless aborted
+  void Close(bool abort = false) {
+    {
+      std::lock_guard<std::mutex> lock(fMutex);
+      fClosed = true;
+      fAborted = fAborted || abort;
+    }
+    fCondition.notify_all();
+  };
+  /// Empty and reopen the queue
+  void Reset() {
+    std::lock_guard<std::mutex> lock(fMutex);
+    fQueue.clear();
+    fClosed = false;
+    fAborted = false;
+  };
+
+ private:
+  QwBlockingQueue(const QwBlockingQueue&) = delete;
+  QwBlockingQueue& operator=(const QwBlockingQueue&) = delete;
+
+  std::mutex fMutex;
+  std::condition_variable fCondition;
+  std::deque<T*> fQueue;
+  bool fClosed;
+  bool fAborted;
+};
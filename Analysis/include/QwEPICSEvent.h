@@ -11,6 +11,7 @@
 #include <map>
 #include <vector>
 #include <string>
+#include <cstddef>
 using std::string;
 
 // ROOT headers
@@ -67,6 +68,8 @@ class QwEPICSEvent
   std::vector<Double_t> ReportAutogains(std::vector<std::string> tag_list = fDefaultAutogainList);
 
   void ExtractEPICSValues(const string& data, int event);
+  /// \brief Extract the values from an EPICS string bank, without copying it
+  void ExtractEPICSValues(const char* data, std::size_t length, int event);
 
   /// Find the index of an EPICS variable, or return error
   Int_t FindIndex(const string& tag) const;
@@ -153,11 +156,26 @@ class QwEPICSEvent
 
   // Test whether the string is a number string or not
   Bool_t IsNumber(const string& word) {
-    size_t pos;
-    pos = word.find_first_not_of("0123456789.+-eE"); // white space not allowed
-    if (pos != std::string::npos) return kFALSE;
-    else return kTRUE;
+    return IsNumber(word.data(), word.data() + word.size());
   }
+  Bool_t IsNumber(const char* begin, const char* end) const {
+    for (const char* c = begin; c != end; c++) {
+      switch (*c) {
+        case '0': case '1': case '2': case '3': case '4':
+        case '5': case '6': case '7': case '8': case '9':
+        case '.': case '+': case '-': case 'e': case 'E':
+          break;
+        default:
+          return kFALSE; // white space not allowed
+      }
+    }
+    return kTRUE;
+  }
+
+  /// Find the index of an EPICS variable in the sorted tag list
+  Int_t FindIndex(const char* tag, std::size_t length) const;
+  /// Set a value from the characters [begin,end) of an EPICS string bank
+  int SetDataValue(int index, const char* begin, const char* end, const int event);
 
   struct EPICSVariableRecord {   //One EPICS variable record.
     Int_t     EventNumber;
@@ -189,6 +207,8 @@ class QwEPICSEvent
   std::vector<EQwEPICSDataType> fEPICSVariableType;
 
   std::map<std::string,Int_t> fEPICSVariableMap;
+  /// Tags and their indices, sorted by tag, for lookups in string banks
+  std::vector<std::pair<std::string,Int_t>> fEPICSSortedTags;
 
   TList *GetEPICSStringValues();
 
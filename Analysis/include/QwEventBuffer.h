@@ -9,6 +9,7 @@
 #pragma once
 
 #include <string>
+#include <thread>
 #include <vector>
 #include "Rtypes.h"
 #include "TString.h"
@@ -18,8 +19,8 @@
 
 #include "MQwCodaControlEvent.h"
 #include "QwParameterFile.h"
-
-#include <unordered_map>
+#include "QwEventIndex.h"
+#include "QwBlockingQueue.h"
 
 #include "VEventDecoder.h"
 #include "Coda3EventDecoder.h"
@@ -68,6 +69,8 @@ class QwEventBuffer {
  public:
   QwEventBuffer();
   virtual ~QwEventBuffer() {
+    // Stop reading ahead before the stream goes away
+    StopReadAhead();
     // Delete event stream
     if (fEvStream != NULL) {
       delete fEvStream;
@@ -137,6 +140,8 @@ class QwEventBuffer {
 	void VerifyCodaVersion( const UInt_t *buffer);
 
   Int_t GetNextEvent();
+  /// \brief Advance to the next EPICS event, using the event index if available
+  Int_t GetNextEPICSEvent();
 
   Int_t  GetEvent();
   Int_t  WriteEvent(int* buffer);
@@ -156,12 +161,43 @@ class QwEventBuffer {
 
   Bool_t FillEPICSData(QwEPICSEvent &epics);
 
+ public:
+  /**
+   * \class RawEvent
+   * \brief Copy of a CODA event with the stream position it was read at
+   *
+   * A raw event can be decoded later, and on a different thread than the
+   * one reading the stream, by passing it with a private decoder (from
+   * CreateDecoder) to the Fill*Data methods below.
+   */
+  class RawEvent {
+   public:
+    RawEvent(): fRunNumber(0), fSegmentNumber(0) { };
+    std::vector<UInt_t> fWords; ///< Event buffer, including the length word
+    Int_t fRunNumber;           ///< Run number of the stream
+    Int_t fSegmentNumber;       ///< Run segment the event was read from
+  };
+
+  /// \brief Copy the current event into a raw event record
+  void CopyCurrentEvent(RawEvent &event) const;
+  /// \brief Create a new decoder for the configured CODA version
+  VEventDecoder* CreateDecoder() const;
+
+  Bool_t FillSubsystemConfigurationData(QwSubsystemArray &subsystems,
+                                        RawEvent &event, VEventDecoder &evdecoder);
+  Bool_t FillSubsystemData(QwSubsystemArray &subsystems,
+                           RawEvent &event, VEventDecoder &evdecoder);
+  Bool_t FillEPICSData(QwEPICSEvent &epics,
+                       RawEvent &event, VEventDecoder &evdecoder);
+
   template < class T > Bool_t FillObjectWithEventData(T &t);
 
 
   void ResetControlParameters();
 	void ReportRunSummary();
   Int_t EncodeSubsystemData(QwSubsystemArray &subsystems);
+  /// Write event data already encoded by QwSubsystemArray::EncodeEventData
+  Int_t EncodeSubsystemData(const std::vector<UInt_t> &buffer, std::vector<ROCID_t> &ROCList);
   Int_t EncodePrestartEvent(int runnumber, int runtype = 0);
   Int_t EncodeGoEvent();
   Int_t EncodePauseEvent();
@@ -180,11 +216,19 @@ class QwEventBuffer {
 
   Bool_t FillSubsystemConfigurationData(std::vector<VQwSubsystem*> &subsystems);
   Bool_t FillSubsystemData(std::vector<VQwSubsystem*> &subsystems);
+
+  Bool_t FillSubsystemConfigurationData(QwSubsystemArray &subsystems, UInt_t *localbuff,
+                                        VEventDecoder &evdecoder);
+  Bool_t FillSubsystemData(QwSubsystemArray &subsystems, UInt_t *localbuff,
+                           VEventDecoder &evdecoder, Int_t run, Int_t segment);
+  Bool_t FillEPICSData(QwEPICSEvent &epics, UInt_t *localbuff,
+                       VEventDecoder &evdecoder);
 	
 	// Coda Version that is set by void VerifyCodaVersion( ) 
 	// Compared against the user-input coda version
 	Int_t fDataVersionVerify = 0;
   Int_t fDataVersion; // User-input Coda Version	
+  Bool_t fAllowLowSubbankIDs; // User-input sub-bank ID policy
 
  protected:
   ///
@@ -197,6 +241,9 @@ class QwEventBuffer {
 
 
   Bool_t fChainDataFiles;
+  Bool_t fMapDataFiles;
+  Bool_t fUseEventIndex;
+  Int_t  fReadAheadDepth;
   std::pair<Int_t, Int_t> fRunRange;
   std::string fRunListFileName;
   std::unique_ptr<QwParameterFile> fRunListFile;
@@ -237,6 +284,39 @@ class QwEventBuffer {
 
   const TString&  DataFile(const UInt_t run, const Short_t seg);
 
+  ///  Methods and data members for the event index of the open data file
+  void  OpenEventIndex();
+  void  AddEventIndexEntry();
+  void  WriteEventIndex(Bool_t complete);
+  Int_t SeekEventIndex(std::size_t position);
+  void  SkipEventsWithIndex();
+  QwEventIndex fEventIndex;
+  std::size_t fEventIndexCursor; ///< Index position of the next event
+  Bool_t fHasEventIndex;         ///< A valid index was read for this file
+  Bool_t fBuildEventIndex;       ///< The index is built while reading
+  std::size_t fEventIndexStored; ///< Number of entries in the stored index
+
+  ///  Methods and data members for reading file events ahead on a thread
+  Bool_t UseReadAhead() const {
+    return (fReadAheadDepth > 0 && ! fHasEventIndex && ! fBuildEventIndex);
+  };
+  Int_t GetReadAheadEvent();
+  void  StartReadAhead();
+  void  StopReadAhead();
+  void  ReadAheadLoop();
+  /// Current event buffer, from the read-ahead queue or from the stream
+  UInt_t* GetEvBuffer() const {
+    if (fReadAheadCurrent != nullptr) return fReadAheadCurrent->fWords.data();
+    return (UInt_t*)(fEvStream->getEvBuffer());
+  };
+  std::vector<RawEvent> fReadAheadEvents;   ///< Buffers circulating between the queues
+  QwBlockingQueue<RawEvent> fReadAheadFree; ///< Buffers for the reader thread
+  QwBlockingQueue<RawEvent> fReadAheadReady;///< Events read by the reader thread
+  RawEvent* fReadAheadCurrent;   ///< Buffer of the current event
+  Int_t  fReadAheadStatus;       ///< Stream status that ended the reader thread
+  Bool_t fReadAheadRunning;
+  std::thread fReadAheadThread;
+
   //  void SetEventLength(const ULong_t tmplength) {fEvtLength = tmplength;};
   //  void SetEventType(const UInt_t tmptype) {fEvtType = tmptype;};
   //  void SetWordsSoFar(const ULong_t tmpwords) {fWordsSoFar = tmpwords;};
@@ -264,13 +344,11 @@ class QwEventBuffer {
   TStopwatch fStopwatch;     ///<  Timer used for internal timing
 
  protected:
-  ///  Methods and data members needed to find marker words
-  typedef ULong64_t RocBankLabel_t;
-  std::unordered_map<RocBankLabel_t, std::vector<UInt_t> > fMarkerList;
-  std::unordered_map<RocBankLabel_t, std::vector<UInt_t> > fOffsetList;
-
-  std::size_t CheckForMarkerWords(QwSubsystemArray &subsystems);
-  RocBankLabel_t fThisRocBankLabel;
+  ///  Methods and data members needed to find marker words; the marker
+  ///  words of each ROC/bank are kept in the dispatch table of the array
+  std::size_t CheckForMarkerWords(QwSubsystemArray &subsystems, VEventDecoder &evdecoder);
+  const std::vector<UInt_t>* fThisMarkerList;  ///< Marker words of the current bank
+  std::vector<UInt_t>* fThisOffsetList;        ///< Last positions of these marker words
   UInt_t FindMarkerWord(UInt_t markerID, UInt_t* buffer, UInt_t num_words);
   UInt_t GetMarkerWord(UInt_t markerID);
 
@@ -297,7 +375,7 @@ template < class T > Bool_t QwEventBuffer::FillObjectWithEventData(T &object){
   ///       const UInt_t banktype, UInt_t* buffer, UInt_t num_words);
   ///
   Bool_t okay = kFALSE;
-  UInt_t *localbuff = (UInt_t*)(fEvStream->getEvBuffer());
+  UInt_t *localbuff = GetEvBuffer();
 
   if (decoder->GetFragLength()==1 && localbuff[decoder->GetWordsSoFar()]==kNullDataWord){
     decoder->AddWordsSoFarAndFragLength();
@@ -0,0 +1,96 @@
+/*!
+ * \file   QwEventIndex.h
+ * \brief  Sidecar index of event positions in a CODA data file
+ */
+
+#pragma once
+
+// System headers
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// ROOT headers
+#include "Rtypes.h"
+
+/**
+ * \class QwEventIndex
+ * \ingroup QwAnalysis
+ * \brief Positions, numbers and types of all events in one CODA file
+ *
+ * The index is built while a file is read from start to end, and stored
+ * next to the data file (with extension .qwidx).  When a file is opened
+ * again, the stored index allows seeking directly to the first event of
+ * an event range, or to the next EPICS event, instead of reading all the
+ * events in between.  The list of non-physics events (EPICS, ROC
+ * configuration and control events) is stored separately, so that these
+ * events are never skipped by a seek.
+ *
+ * An index is only valid for the data file it was built from; the size
+ * and modification time of that file are stored in the index header.
+ * An index that was stored before the end of the file was reached (at the
+ * end of the event range, or when the stream was rewound) is marked as
+ * incomplete: it covers the events up to its last entry, and is extended
+ * when the file is read past that point.
+ */
+class QwEventIndex {
+
+ public:
+  /// Event classes stored in the flags of an entry
+  enum EQwEventIndexFlag {
+    kPhysicsEvent       = 0x1,
+    kEPICSEvent         = 0x2,
+    kROCConfigEvent     = 0x4,
+    kOtherEvent         = 0x8
+  };
+
+  /// Position and identification of one event
+  struct Entry {
+    ULong64_t fBlockOffset;  ///< Word offset of the block in the file
+    UInt_t    fEventOffset;  ///< Word offset of the event in the block
+    UInt_t    fEventNumber;  ///< CODA event number
+    UShort_t  fEventType;    ///< CODA event type
+    UShort_t  fFlags;        ///< Combination of EQwEventIndexFlag
+    Int_t     fSegment;      ///< Run segment of the file
+  };
+
+  QwEventIndex(): fFileSize(0), fFileTime(0), fComplete(kFALSE) { };
+  virtual ~QwEventIndex() { };
+
+  /// \brief Start a new, empty index for a data file
+  void Reset(ULong64_t filesize, Long64_t filetime);
+  /// \brief Add the next event of the data file
+  void AddEntry(const Entry& entry);
+
+  /// \brief Read the index from file, if it matches the data file
+  Bool_t Read(const std::string& filename, ULong64_t filesize, Long64_t filetime);
+  /// \brief Write the index to file
+  Bool_t Write(const std::string& filename) const;
+
+  /// Does the index cover the data file up to its end?
+  Bool_t IsComplete() const { return fComplete; };
+  /// Mark the index as covering the data file up to its end
+  void SetComplete(Bool_t complete = kTRUE) { fComplete = complete; };
+
+  /// Number of events in the index
+  std::size_t GetNumberOfEntries() const { return fEntries.size(); };
+  /// Number of non-physics events in the index
+  std::size_t GetNumberOfSpecialEntries() const { return fSpecial.size(); };
+  /// Event at an index position
+  const Entry& GetEntry(std::size_t i) const { return fEntries.at(i); };
+
+  /// \brief Position of the first physics event with at least this number
+  std::size_t FindPhysicsEvent(UInt_t eventnumber, std::size_t from) const;
+  /// \brief Position of the next event at or after 'from' with these flags
+  std::size_t FindSpecialEvent(UInt_t flags, std::size_t from) const;
+
+  /// Default extension of index files
+  static const std::string kExtension;
+
+ private:
+  ULong64_t fFileSize;               ///< Size of the indexed data file
+  Long64_t  fFileTime;               ///< Modification time of the data file
+  Bool_t    fComplete;               ///< Index covers the whole data file
+  std::vector<Entry> fEntries;       ///< All events in file order
+  std::vector<ULong64_t> fSpecial;   ///< Positions of non-physics events
+};
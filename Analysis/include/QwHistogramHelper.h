@@ -9,7 +9,9 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <TString.h>
 #include <TRegexp.h>
@@ -17,9 +19,48 @@
 #include <TH2.h>
 #include <TProfile.h>
 #include <TProfile2D.h>
+class TDirectory;
+class TFile;
 
 #include "QwParameterFile.h"
 #include "QwOptions.h"
+
+/**
+ * \class QwHistogramBuffer
+ * \ingroup QwAnalysis
+ * \brief Fill buffer of a one-dimensional histogram
+ *
+ * Collects the values filled into one histogram and passes them to
+ * TH1::FillN when the buffer is full, or when the buffers are flushed
+ * before the histograms are written.
+ */
+class QwHistogramBuffer {
+ public:
+  QwHistogramBuffer(TH1* h, const TFile* file, std::size_t size)
+  : fHistogram(h), fFile(file), fValues(size), fCount(0) { };
+
+  /// Histogram this buffer is filled into, or null once it is released
+  TH1* GetHistogram() const { return fHistogram; };
+  /// File of the histogram when it was constructed, or null
+  const TFile* GetFile() const { return fFile; };
+  /// Drop the buffered values and the histogram, which may be deleted
+  void Detach() { fHistogram = nullptr; fCount = 0; };
+
+  /// Add a value, and fill the histogram when the buffer is full
+  void Fill(Double_t value) {
+    fValues[fCount++] = value;
+    if (fCount == fValues.size()) Flush();
+  };
+  /// \brief Fill the buffered values into the histogram
+  void Flush();
+
+ private:
+  TH1* fHistogram;
+  const TFile* fFile;
+  std::vector<Double_t> fValues;
+  std::size_t fCount;
+};
+
 /**
  * \class QwHistogramHelper
  * \ingroup QwAnalysis
@@ -31,7 +72,7 @@
  */
 class QwHistogramHelper{
  public:
-  QwHistogramHelper(): fDEBUG(kFALSE) { fHistParams.clear(); };
+  QwHistogramHelper(): fDEBUG(kFALSE), fFillBufferSize(0), fFillBufferGeneration(1) { fHistParams.clear(); };
   virtual ~QwHistogramHelper() { };
 
   /// \brief Define the configuration options
@@ -64,6 +105,20 @@ class QwHistogramHelper{
   TProfile* Construct1DProf(const std::string& inputfile, const TString& name_title);
   TProfile2D* Construct2DProf(const std::string& inputfile, const TString& name_title);
 
+  /// Fill buffer of a histogram constructed here, or null
+  std::shared_ptr<QwHistogramBuffer> GetFillBuffer(TH1* h) const {
+    auto iter = fFillBuffers.find(h);
+    return (iter != fFillBuffers.end())? iter->second: nullptr;
+  };
+  /// \brief Drop a reference to a fill buffer, and the buffer with the last one
+  void ReleaseFillBuffer(std::shared_ptr<QwHistogramBuffer>& buffer);
+  /// Counter which changes whenever fill buffers are released
+  UInt_t GetFillBufferGeneration() const { return fFillBufferGeneration; };
+  /// \brief Fill all buffered values into their histograms
+  void FlushFillBuffers();
+  /// \brief Release the fill buffers of the histograms in a file
+  void ReleaseFillBuffers(const TDirectory* file);
+
   Bool_t MatchDeviceParamsFromList(const std::string& devicename);
   Bool_t MatchVQWKElementFromList(const std::string& subsystemname,
       const std::string& moduletype,
@@ -149,6 +204,9 @@ class QwHistogramHelper{
 
   Bool_t DoesMatch(const TString& s, const TRegexp& wildcard);
 
+  /// Attach a fill buffer to a newly constructed histogram
+  void AddFillBuffer(TH1* h);
+
  protected:
   static const Double_t fInvalidNumber;
   static const TString fInvalidName;
@@ -157,6 +215,10 @@ class QwHistogramHelper{
   Bool_t fTrimHistoEnable;
   Bool_t fTreeTrimFileLoaded;
 
+  std::size_t fFillBufferSize;             ///< Values per fill buffer, or zero
+  UInt_t fFillBufferGeneration;
+  std::unordered_map<TH1*, std::shared_ptr<QwHistogramBuffer> > fFillBuffers;
+
   std::string fInputFile;
   std::vector<HistParams> fHistParams;
   std::vector< std::pair< TString,TRegexp > > fTreeParams;
@@ -11,6 +11,10 @@
 // System headers
 #include <iostream>
 #include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
 #include <string>
 #include <vector>
 using std::string;
@@ -27,6 +31,7 @@ using std::string;
 
 // Forward declarations
 class QwOptions;
+class QwLog;
 
 /*! \def QwOut
  *  \brief Predefined log drain for explicit output
@@ -59,6 +64,38 @@ class QwOptions;
 #define QwDebug    if (gQwLog.GetLogLevel() >= QwLog::kDebug) gQwLog(QwLog::kDebug,__PRETTY_FUNCTION__)
 
 
+/**
+ *  \class QwLogCapture
+ *  \ingroup QwAnalysis
+ *  \brief Log output of one thread, kept until it is written out in order
+ *
+ * While a capture is set for a thread with QwLog::SetCapture, the screen
+ * and file output of that thread is appended to the capture instead, with
+ * the same prefixes and thresholds.  QwLog::Replay writes it out, so that
+ * the messages of events handled on other threads appear in event order.
+ */
+class QwLogCapture {
+  public:
+    /*! \brief Is there captured output?
+     */
+    bool IsEmpty() const {
+      return (! fScreen || fScreen->tellp() <= 0) && (! fFile || fFile->tellp() <= 0);
+    }
+
+  private:
+    friend class QwLog;
+    std::ostream& Screen() {
+      if (! fScreen) fScreen.reset(new std::ostringstream);
+      return *fScreen;
+    }
+    std::ostream& File() {
+      if (! fFile) fFile.reset(new std::ostringstream);
+      return *fFile;
+    }
+    std::unique_ptr<std::ostringstream> fScreen;
+    std::unique_ptr<std::ostringstream> fFile;
+};
+
 /**
  *  \class QwLog
  *  \ingroup QwAnalysis
@@ -141,10 +178,10 @@ class QwLog : public std::ostream {
      */
     template <class T> QwLog&   operator<<(const T &t) {
       if (fScreen && fLogLevel <= fScreenThreshold) {
-        *(fScreen) << t;
+        *(GetScreen()) << t;
       }
       if (fFile && fLogLevel <= fFileThreshold) {
-        *(fFile) << t;
+        *(GetFile()) << t;
       }
       return *this;
     }
@@ -164,12 +201,30 @@ class QwLog : public std::ostream {
      */
     static std::ostream&        flush(std::ostream&);
 
+    /*! \brief Redirect the output of the calling thread into a capture, returns the previous one
+     */
+    static QwLogCapture*        SetCapture(QwLogCapture* capture);
+    /*! \brief Write captured output to the destination of the calling thread, and clear it
+     */
+    void                        Replay(QwLogCapture& capture);
+
   private:
 
+    /*! \brief Screen stream of the calling thread
+     */
+    std::ostream*               GetScreen() const {
+      return fCapture? &fCapture->Screen(): fScreen;
+    }
+    /*! \brief File stream of the calling thread
+     */
+    std::ostream*               GetFile() const {
+      return fCapture? &fCapture->File(): fFile;
+    }
+
     /*! \brief Get the local time
      */
     const char*                 GetTime();
-    char                        fTimeString[128];
+    static thread_local char    fTimeString[128];
 
     //! Screen thresholds and stream
     QwLogLevel    fScreenThreshold;
@@ -177,8 +232,10 @@ class QwLog : public std::ostream {
     //! File thresholds and stream
     QwLogLevel    fFileThreshold;
     std::ostream *fFile;
-    //! Log level of this stream
-    QwLogLevel fLogLevel;
+    //! Log level of this stream (for the current line of each thread)
+    static thread_local QwLogLevel fLogLevel;
+    //! Capture of the output of each thread, if any
+    static thread_local QwLogCapture* fCapture;
 
     //! Flag to print function signature on warning or error
     bool fPrintFunctionSignature;
@@ -186,14 +243,15 @@ class QwLog : public std::ostream {
     //! List of regular expressions for functions that will have increased log level
     std::map<std::string,bool> fIsDebugFunction;
     std::vector<std::string> fDebugFunctionRegexString;
+    std::mutex fDebugFunctionMutex;
 
     //! Flag to disable color
     bool fUseColor;
 
     //! Flags only relevant for current line, but static for use in static function
-    static bool fFileAtNewLine;
-    static bool fScreenInColor;
-    static bool fScreenAtNewLine;
+    static thread_local bool fFileAtNewLine;
+    static thread_local bool fScreenInColor;
+    static thread_local bool fScreenAtNewLine;
 
 };
 
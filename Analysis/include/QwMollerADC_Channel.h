@@ -18,6 +18,7 @@
 #include "VQwHardwareChannel.h"
 #include "MQwMockable.h"
 #include "QwRootFile.h"
+#include "QwADCDecoder.h"
 
 // Forward declarations
 class QwBlinder;
@@ -68,18 +69,34 @@ class QwMollerADC_Channel: public VQwHardwareChannel, public MQwMockable {
   using VQwHardwareChannel::AccumulateRunningSum;
   using VQwHardwareChannel::DeaccumulateRunningSum;
 
+  /// \brief Event data of one channel
+  ///
+  /// The event data is kept in a separate record so that a subsystem can
+  /// place the records of all its channels next to each other in a
+  /// QwMollerADC_Storage, and process them in a single loop.
+  struct EventData {
+    Int_t    fBlock_raw[4];         ///< Array of the sub-block data as read from the module
+    Int_t    fHardwareBlockSum_raw; ///< Module-based sum of the four sub-blocks as read from the module
+    UInt_t   fNumberOfSamples;      ///< Number of samples  read through the module
+    Double_t fBlock[4];             ///< Array of the sub-block data
+    Double_t fHardwareBlockSum;     ///< Module-based sum of the four sub-blocks
+    Double_t fBlockM2[4];           ///< Second moment of the sub-block
+    Double_t fHardwareBlockSumM2;   ///< Second moment of the hardware sum
+  };
+
  public:
-  QwMollerADC_Channel(): MQwMockable() {
+  QwMollerADC_Channel(): MQwMockable(), fData(&fLocalData) {
     InitializeChannel("","");
     SetMollerADCSaturationLimt(8.5);//set the default saturation limit
   };
-  QwMollerADC_Channel(TString name, TString datatosave = "raw"): MQwMockable() {
+  QwMollerADC_Channel(TString name, TString datatosave = "raw"): MQwMockable(), fData(&fLocalData) {
     InitializeChannel(name, datatosave);
     SetMollerADCSaturationLimt(8.5);//set the default saturation limit
   };
   QwMollerADC_Channel(const QwMollerADC_Channel& value): 
     VQwHardwareChannel(value), MQwMockable(value),
     fBlocksPerEvent(value.fBlocksPerEvent),
+    fData(&fLocalData),
     fNumberOfSamples_map(value.fNumberOfSamples_map),
     fSaturationABSLimit(value.fSaturationABSLimit)
   {
@@ -88,6 +105,7 @@ class QwMollerADC_Channel: public VQwHardwareChannel, public MQwMockable {
   QwMollerADC_Channel(const QwMollerADC_Channel& value, VQwDataElement::EDataToSave datatosave):
     VQwHardwareChannel(value,datatosave), MQwMockable(value),
     fBlocksPerEvent(value.fBlocksPerEvent),
+    fData(&fLocalData),
     fNumberOfSamples_map(value.fNumberOfSamples_map),
     fSaturationABSLimit(value.fSaturationABSLimit)
   {
@@ -131,7 +149,7 @@ class QwMollerADC_Channel: public VQwHardwareChannel, public MQwMockable {
 
   /// Forces the event "number of samples" variable to be what was expected from the mapfile.
   /// NOTE: this should only be used in mock data generation!
-  void  ForceMapfileSampleSize() {fNumberOfSamples = fNumberOfSamples_map;};
+  void  ForceMapfileSampleSize() {fData->fNumberOfSamples = fNumberOfSamples_map;};
 
 //------------------------------------------------------------------------------------------
   void SmearByResolution(double resolution) override;
@@ -147,6 +165,8 @@ class QwMollerADC_Channel: public VQwHardwareChannel, public MQwMockable {
   void  EncodeEventData(std::vector<UInt_t> &buffer) override;
   /// Decode the event data from a CODA buffer
   Int_t ProcessEvBuffer(UInt_t* buffer, UInt_t num_words_left, UInt_t index = 0) override;
+  /// Set the raw event data from the unpacked words of a CODA buffer
+  void  SetRawWords(const QwADCDecoder::MollerADCWords& words);
   /// Process the event data according to pedestal and calibration factor
   void  ProcessEvent() override;
 
@@ -154,6 +174,7 @@ class QwMollerADC_Channel: public VQwHardwareChannel, public MQwMockable {
   QwMollerADC_Channel& operator=  (const QwMollerADC_Channel &value);
   void AssignScaledValue(const QwMollerADC_Channel &value, Double_t scale);
   void AssignValueFrom(const VQwDataElement* valueptr) override;
+  void Snapshot(QwSnapshot& snapshot) override;
   void AddValueFrom(const VQwHardwareChannel* valueptr) override;
   void SubtractValueFrom(const VQwHardwareChannel* valueptr) override;
   void MultiplyBy(const VQwHardwareChannel* valueptr) override;
@@ -174,6 +195,15 @@ class QwMollerADC_Channel: public VQwHardwareChannel, public MQwMockable {
   const QwMollerADC_Channel operator* (const QwMollerADC_Channel &value) const;
   void Sum(const QwMollerADC_Channel &value1, const QwMollerADC_Channel &value2);
   void Difference(const QwMollerADC_Channel &value1, const QwMollerADC_Channel &value2);
+
+  /// Number of values per event used by the helicity pattern kernel
+  static const size_t kPatternValues = 5;
+  /// \brief Copy the block values and the hardware sum into a flat array
+  void GetPatternValues(Double_t* values) const;
+  /// \brief Set this channel to a sum over the phases of a helicity pattern
+  void SetPatternSum(const QwMollerADC_Channel& first, UInt_t samples,
+                     UInt_t errorflag, const Double_t* values);
+
   void Ratio(const QwMollerADC_Channel &numer, const QwMollerADC_Channel &denom);
   void Product(const QwMollerADC_Channel &value1, const QwMollerADC_Channel &value2);
   void DivideBy(const QwMollerADC_Channel& denom);
@@ -251,18 +281,18 @@ class QwMollerADC_Channel: public VQwHardwareChannel, public MQwMockable {
 
   Int_t GetRawValue(size_t element) const override {
     RangeCheck(element);
-    if (element==0) return fHardwareBlockSum_raw;
-    return fBlock_raw[element-1];
+    if (element==0) return fData->fHardwareBlockSum_raw;
+    return fData->fBlock_raw[element-1];
   }
   Double_t GetValue(size_t element) const override {
     RangeCheck(element);
-    if (element==0) return fHardwareBlockSum;
-    return fBlock[element-1];
+    if (element==0) return fData->fHardwareBlockSum;
+    return fData->fBlock[element-1];
   }
   Double_t GetValueM2(size_t element) const override {
     RangeCheck(element);
-    if (element==0) return fHardwareBlockSumM2;
-    return fBlockM2[element-1];
+    if (element==0) return fData->fHardwareBlockSumM2;
+    return fData->fBlockM2[element-1];
   }
   Double_t GetValueError(size_t element) const override {
     RangeCheck(element);
@@ -274,11 +304,12 @@ class QwMollerADC_Channel: public VQwHardwareChannel, public MQwMockable {
   Double_t GetAverageVolts() const;
 
   size_t GetSequenceNumber() const {return (fSequenceNumber);};
-  size_t GetNumberOfSamples() const {return (fNumberOfSamples);};
+  size_t GetNumberOfSamples() const {return (fData->fNumberOfSamples);};
 
   void   SetCalibrationToVolts(){SetCalibrationFactor(kMollerADC_VoltsPerBit);};
 
   friend std::ostream& operator<< (std::ostream& stream, const QwMollerADC_Channel& channel);
+  friend class QwMollerADC_Storage;
   void PrintValue() const override;
   void PrintInfo() const override;
 
@@ -337,8 +368,6 @@ private:
 
   /*! \name Event data members---Raw values */
   // @{
-  Int_t fBlock_raw[4];      ///< Array of the sub-block data as read from the module
-  Int_t fHardwareBlockSum_raw; ///< Module-based sum of the four sub-blocks as read from the module
   Int_t fSoftwareBlockSum_raw; ///< Sum of the data in the four sub-blocks raw
   Long64_t fBlockSumSq_raw[5]; 
   Int_t fBlock_min[5];
@@ -348,26 +377,24 @@ private:
 
   /*! \name Event data members---Potentially calibrated values*/
   // @{
-  // The following values potentially have pedestal removed  and calibration applied
-  Double_t fBlock[4];          ///< Array of the sub-block data
-  Double_t fHardwareBlockSum;  ///< Module-based sum of the four sub-blocks
+  // The following values potentially have pedestal removed  and calibration applied;
+  // the sub-block data and hardware sum are kept in the event data record
+  EventData  fLocalData;       ///< Event data record owned by this channel
+  EventData* fData;            ///< Event data record in use (own or in a QwMollerADC_Storage)
   // @}
 
 
   /// \name Calculation of the statistical moments
   // @{
   // Moments of the separate blocks
-  Double_t fBlockM2[4];        ///< Second moment of the sub-block
   Double_t fBlockError[4];     ///< Uncertainty on the sub-block
   // Moments of the hardware sum
-  Double_t fHardwareBlockSumM2;    ///< Second moment of the hardware sum
   Double_t fHardwareBlockSumError; ///< Uncertainty on the hardware sum
   // @}
 
 
   UInt_t fSequenceNumber;      ///< Event sequence number for this channel
   UInt_t fPreviousSequenceNumber; ///< Previous event sequence number for this channel
-  UInt_t fNumberOfSamples;     ///< Number of samples  read through the module
   UInt_t fNumberOfSamples_map; ///< Number of samples in the expected to  read through the module. This value is set in the QwBeamline map file
 
 
@@ -0,0 +1,91 @@
+/*!
+ * \file   QwMollerADC_Storage.h
+ * \brief  Contiguous event data storage for the Moller ADC channels of a subsystem
+ */
+
+#pragma once
+
+// System headers
+#include <vector>
+
+// Qweak headers
+#include "QwMollerADC_Channel.h"
+
+/**
+ * \class QwMollerADC_Storage
+ * \ingroup QwAnalysis_ADC
+ * \brief Event data of many Moller ADC channels in one contiguous block
+ *
+ * A subsystem can attach its Moller ADC channels to a storage object after
+ * its channel map is loaded.  The event data records of the attached
+ * channels are then kept next to each other in this object, and the
+ * channels only refer to their record.
+ *
+ * ProcessEvent converts the raw data of all attached channels
+ * (normalisation by the number of samples, pedestal subtraction and
+ * calibration) without a virtual call per channel.  The raw data of the
+ * event, the calibrations and the pedestals are kept in one array per
+ * field, so that the conversion is a loop over contiguous arrays without
+ * branches; channels without samples are handed to the channel afterwards.
+ * The results are identical to QwMollerADC_Channel::ProcessEvent.
+ *
+ * The calibrations are copied when the channels are attached, and again by
+ * UpdateCalibration, which has to be called when the pedestal or the
+ * calibration factor of an attached channel is changed.
+ *
+ * The storage refers to the channel objects, so the channels must not be
+ * moved while they are attached (i.e. no elements may be added to the
+ * vectors holding them).  Copies of attached channels use their own record.
+ * Tree leaves bound directly to a channel (QwRootFile option
+ * tree-direct-binding) refer to the record in use at construction, so
+ * channels written to trees that way should not be attached afterwards.
+ */
+class QwMollerADC_Storage {
+
+ public:
+  QwMollerADC_Storage() { };
+  /// Destructor, returns the event data to the channels
+  virtual ~QwMollerADC_Storage() { Detach(); };
+
+  /// \brief Move the event data of these channels into this storage
+  void Attach(const std::vector<QwMollerADC_Channel*>& channels);
+  /// \brief Return the event data to the channels
+  void Detach();
+
+  /// Are any channels attached?
+  Bool_t IsAttached() const { return ! fChannels.empty(); };
+  /// Number of attached channels
+  size_t GetNumberOfChannels() const { return fChannels.size(); };
+
+  /// \brief Copy the pedestals and calibrations of the attached channels
+  void UpdateCalibration();
+
+  /// \brief Process the event data of all attached channels
+  void ProcessEvent();
+
+ private:
+  QwMollerADC_Storage(const QwMollerADC_Storage&) = delete;
+  QwMollerADC_Storage& operator=(const QwMollerADC_Storage&) = delete;
+
+  /// Blocks in an event data record
+  static const size_t kBlocks = 4;
+
+  std::vector<QwMollerADC_Channel*> fChannels;          ///< Attached channels
+  std::vector<QwMollerADC_Channel::EventData> fData;   ///< Their event data records
+
+  /// \name Constants of the channels, filled by UpdateCalibration
+  // @{
+  std::vector<Double_t> fCalibration;        ///< Calibration factors
+  std::vector<Double_t> fPedestal;           ///< Pedestals
+  std::vector<Double_t> fBlocksPerEvent;     ///< Blocks per event
+  // @}
+
+  /// \name Event data of the channels, one array per field
+  // @{
+  std::vector<Double_t> fBlockRaw;           ///< Raw blocks, kBlocks per channel
+  std::vector<Double_t> fHardwareBlockSumRaw;///< Raw hardware sums
+  std::vector<Double_t> fNumberOfSamples;    ///< Numbers of samples
+  std::vector<Double_t> fBlock;              ///< Blocks, kBlocks per channel
+  std::vector<Double_t> fHardwareBlockSum;   ///< Hardware sums
+  // @}
+};
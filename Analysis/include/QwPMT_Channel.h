@@ -68,6 +68,7 @@ class QwPMT_Channel: public VQwDataElement {
   void  ProcessEvent();
 
   QwPMT_Channel& operator=  (const QwPMT_Channel &value);
+  void Snapshot(QwSnapshot& snapshot) override;
   QwPMT_Channel& operator+= (const QwPMT_Channel &value);
   QwPMT_Channel& operator-= (const QwPMT_Channel &value);
   void Sum(const QwPMT_Channel &value1, const QwPMT_Channel &value2);
@@ -0,0 +1,33 @@
+/*!
+ * \file   QwPatternKernel.h
+ * \brief  Helicity pattern sums over flat arrays of channel values
+ */
+
+#pragma once
+
+// System headers
+#include <cstddef>
+
+// ROOT headers
+#include "Rtypes.h"
+
+/**
+ * \class QwPatternKernel
+ * \ingroup QwAnalysis
+ * \brief Yield and difference of a helicity pattern over flat value arrays
+ *
+ * Each phase (helicity window) of a pattern is given as one flat array of
+ * channel values, with the same layout for all phases.  The phases are
+ * ordered by helicity: first all positive, then all negative phases.  The
+ * positive and negative sums are accumulated in phase order, so the
+ * results are identical to summing the subsystem arrays with operator+=
+ * and combining them with Sum, Difference and Scale.
+ */
+class QwPatternKernel {
+
+ public:
+  /// \brief Scaled sum and difference of the positive and negative phases
+  static void Sums(const Double_t* const* phases, std::size_t nplus,
+                   std::size_t nphases, std::size_t nvalues, Double_t scale,
+                   Double_t* yield, Double_t* difference);
+};
@@ -9,6 +9,8 @@
 #include <algorithm>
 #include <cctype>
 #include <cstdint>
+#include <cstring>
+#include <memory>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -21,6 +23,8 @@ using std::type_info;
 // ROOT headers
 #include "TFile.h"
 #include "TTree.h"
+#include "TBranch.h"
+#include "TLeaf.h"
 #include "TPRegexp.h"
 #include "TSystem.h"
 #include "TString.h"
@@ -31,10 +35,20 @@ using std::type_info;
 #include "ROOT/RNTupleModel.hxx"
 #include "ROOT/RField.hxx"
 #include "ROOT/RNTupleWriter.hxx"
+#include "ROOT/RNTupleParallelWriter.hxx"
+#include "ROOT/RNTupleFillContext.hxx"
+#include "ROOT/REntry.hxx"
+#include <map>
+#include <mutex>
+#include <thread>
 #endif
 
 // Qweak headers
+#include "QwHistogramHelper.h"
 #include "QwOptions.h"
+#include "QwRootTreePrecision.h"
+#include "QwRootTreeWriter.h"
+#include "QwSharedMemoryPublisher.h"
 #include "TMapFile.h"
 
 // If one defines more than this number of words in the full ntuple,
@@ -56,7 +70,10 @@ public:
     std::string name;
     std::size_t offset;
     std::size_t size;
-    char type;
+    char type;          // type of the leaf in the tree
+    char input;         // type of the values set by the data element
+    bool converted;     // are values converted between these types?
+    std::string range;  // range and bits for 'd' and 'f' leaves
   };
 
   using size_type = std::size_t;
@@ -76,6 +93,9 @@ public:
   void clear() {
     m_entries.clear();
     m_buffer.clear();
+    m_sources.clear();
+    m_bound.clear();
+    m_num_bound = 0;
   }
 
   size_type size() const noexcept { return m_entries.size(); }
@@ -107,67 +127,137 @@ public:
   // (presence of multiple overloads ensures a compilation error if the types do not match)
   void SetValue(size_type index, Double_t val) {
     const auto& entry = m_entries.at(index);
-    if (entry.type != 'D') {
-      throw std::invalid_argument("Type mismatch: entry type '" + std::string(1, entry.type) + "' cannot store double value '" + entry.name + "'");
+    if (entry.input != 'D') {
+      throw std::invalid_argument("Type mismatch: entry type '" + std::string(1, entry.input) + "' cannot store double value '" + entry.name + "'");
     }
-    this->value<Double_t>(index) = val;
+    Store(entry, val);
   }
 
   void SetValue(size_type index, Float_t val) {
     const auto& entry = m_entries.at(index);
-    if (entry.type != 'F') {
-      throw std::invalid_argument("Type mismatch: entry type '" + std::string(1, entry.type) + "' cannot store float value '" + entry.name + "'");
+    if (entry.input != 'F') {
+      throw std::invalid_argument("Type mismatch: entry type '" + std::string(1, entry.input) + "' cannot store float value '" + entry.name + "'");
     }
-    this->value<Float_t>(index) = val;
+    Store(entry, val);
   }
 
   void SetValue(size_type index, Int_t val) {
     const auto& entry = m_entries.at(index);
-    if (entry.type != 'I') {
-      throw std::invalid_argument("Type mismatch: entry type '" + std::string(1, entry.type) + "' cannot store int value '" + entry.name + "'");
+    if (entry.input != 'I') {
+      throw std::invalid_argument("Type mismatch: entry type '" + std::string(1, entry.input) + "' cannot store int value '" + entry.name + "'");
     }
-    this->value<Int_t>(index) = val;
+    Store(entry, val);
   }
 
   void SetValue(size_type index, Long64_t val) {
     const auto& entry = m_entries.at(index);
-    if (entry.type != 'L') {
-      throw std::invalid_argument("Type mismatch: entry type '" + std::string(1, entry.type) + "' cannot store long long value '" + entry.name + "'");
+    if (entry.input != 'L') {
+      throw std::invalid_argument("Type mismatch: entry type '" + std::string(1, entry.input) + "' cannot store long long value '" + entry.name + "'");
     }
-    this->value<Long64_t>(index) = val;
+    Store(entry, val);
   }
 
   void SetValue(size_type index, Short_t val) {
     const auto& entry = m_entries.at(index);
-    if (entry.type != 'S') {
-      throw std::invalid_argument("Type mismatch: entry type '" + std::string(1, entry.type) + "' cannot store short value '" + entry.name + "'");
+    if (entry.input != 'S') {
+      throw std::invalid_argument("Type mismatch: entry type '" + std::string(1, entry.input) + "' cannot store short value '" + entry.name + "'");
     }
-    this->value<Short_t>(index) = val;
+    Store(entry, val);
   }
 
   // Unsigned type overloads
   void SetValue(size_type index, UShort_t val) {
     const auto& entry = m_entries.at(index);
-    if (entry.type != 's') {
-      throw std::invalid_argument("Type mismatch: entry type '" + std::string(1, entry.type) + "' cannot store short value '" + entry.name + "'");
+    if (entry.input != 's') {
+      throw std::invalid_argument("Type mismatch: entry type '" + std::string(1, entry.input) + "' cannot store short value '" + entry.name + "'");
     }
-    this->value<UShort_t>(index) = val;
+    Store(entry, val);
   }
 
   void SetValue(size_type index, UInt_t val) {
     const auto& entry = m_entries.at(index);
-    if (entry.type != 'i') {
-      throw std::invalid_argument("Type mismatch: entry type '" + std::string(1, entry.type) + "' cannot store unsigned int value '" + entry.name + "'");
+    if (entry.input != 'i') {
+      throw std::invalid_argument("Type mismatch: entry type '" + std::string(1, entry.input) + "' cannot store unsigned int value '" + entry.name + "'");
     }
-    this->value<UInt_t>(index) = val;
+    Store(entry, val);
   }
 
   void SetValue(size_type index, ULong64_t val) {
     const auto& entry = m_entries.at(index);
-    if (entry.type != 'l') {
-      throw std::invalid_argument("Type mismatch: entry type '" + std::string(1, entry.type) + "' cannot store long long value '" + entry.name + "'");
+    if (entry.input != 'l') {
+      throw std::invalid_argument("Type mismatch: entry type '" + std::string(1, entry.input) + "' cannot store long long value '" + entry.name + "'");
     }
-    this->value<ULong64_t>(index) = val;
+    Store(entry, val);
+  }
+
+  /// Register the storage which holds the value of an entry during the run,
+  /// so that the leaf can be bound to it instead of to the buffer
+  template <typename T>
+  void SetSource(size_type index, const T* source) {
+    const auto& entry = m_entries.at(index);
+    if (entry.input != GetTypeCode(source)) {
+      throw std::invalid_argument("Type mismatch: entry type '" + std::string(1, entry.input) + "' cannot be bound to source of type '" + std::string(1, GetTypeCode(source)) + "' for '" + entry.name + "'");
+    }
+    // Converted values have to be copied
+    if (entry.converted) return;
+    if (m_sources.size() < m_entries.size()) {
+      m_sources.resize(m_entries.size(), nullptr);
+    }
+    m_sources[index] = source;
+  }
+
+  /// Get the registered storage of an entry, or nullptr
+  const void* GetSource(size_type index) const {
+    return (index < m_sources.size()) ? m_sources[index] : nullptr;
+  }
+
+  /// Type of the value of an entry as it is kept in the buffer
+  char GetValueType(size_type index) const {
+    return GetMemoryType(m_entries.at(index).type);
+  }
+
+  /// Copy the buffer, with the values of bound entries taken from their storage
+  void CopyTo(void* destination) const {
+    std::uint8_t* target = static_cast<std::uint8_t*>(destination);
+    std::memcpy(target, m_buffer.data(), m_buffer.size());
+    if (m_num_bound == 0) return;
+    for (size_type index = 0; index < m_sources.size() && index < m_bound.size(); ++index) {
+      if (m_bound[index] && m_sources[index])
+        std::memcpy(target + m_entries[index].offset, m_sources[index], m_entries[index].size);
+    }
+  }
+
+  /// Find the entry at a byte offset in the buffer, or return size()
+  size_type FindEntry(std::size_t offset) const {
+    auto iter = std::lower_bound(m_entries.begin(), m_entries.end(), offset,
+        [](const Entry& entry, std::size_t value) { return entry.offset < value; });
+    if (iter == m_entries.end() || iter->offset != offset) return m_entries.size();
+    return iter - m_entries.begin();
+  }
+
+  /// Mark an entry whose value is not read from the buffer by the tree
+  void SetBound(size_type index) {
+    if (m_bound.size() < m_entries.size()) {
+      m_bound.resize(m_entries.size(), false);
+    }
+    if (! m_bound.at(index)) {
+      m_bound[index] = true;
+      m_num_bound++;
+    }
+  }
+
+  /// Are the values of these entries not read from the buffer?
+  bool IsBound(size_type first, size_type count) const {
+    if (m_num_bound == 0 || first + count > m_bound.size()) return false;
+    for (size_type index = first; index < first + count; ++index) {
+      if (! m_bound[index]) return false;
+    }
+    return true;
+  }
+
+  /// Is no value read from the buffer at all?
+  bool IsBound() const {
+    return ! m_entries.empty() && m_num_bound == m_entries.size();
   }
 
   void* data() noexcept { return m_buffer.data(); }
@@ -203,7 +293,7 @@ public:
       m_buffer.resize(offset, 0u);
     }
 
-    Entry entry{name, offset, entry_size, type};
+    Entry entry{name, offset, entry_size, type, type, false, ""};
     m_entries.push_back(entry);
 
     const std::size_t required = offset + entry_size;
@@ -234,12 +324,39 @@ public:
       if (!first) {
         stream << separator;
       }
-      stream << entry.name << "/" << entry.type;
+      stream << entry.name << "/" << entry.type << entry.range;
       first = false;
     }
     return stream.str();
   }
 
+  /// Leaf list of a branch, with the leaf types chosen by the precision policy
+  std::string LeafList(size_type start_index, const std::string& branch) {
+    if (m_precision != nullptr) {
+      for (size_type index = start_index; index < m_entries.size(); ++index) {
+        auto& entry = m_entries[index];
+        char type = entry.type;
+        std::string range = entry.range;
+        if (m_precision->Find(m_tree + ":" + branch + "." + entry.name, type, range)) {
+          entry.type = type;
+          entry.range = range;
+          entry.converted = (GetMemoryType(entry.type) != entry.input);
+          if (entry.converted && index < m_sources.size()) {
+            m_sources[index] = nullptr;
+          }
+        }
+      }
+      Relayout(start_index);
+    }
+    return LeafList(start_index);
+  }
+
+  /// Use a precision policy for the leaves of this tree
+  void SetPrecision(QwRootTreePrecision* precision, const std::string& tree) {
+    m_precision = precision;
+    m_tree = tree;
+  }
+
   std::string Dump(size_type start_index = 0, size_type end_index = 0) const {
     std::ostringstream stream;
     stream << "QwRootTreeBranchVector: " << m_entries.size() << " entries, "
@@ -295,8 +412,10 @@ private:
   static std::size_t GetTypeSize(char type) {
     switch (type) {
       case 'D':
+      case 'd':
         return sizeof(double);
       case 'F':
+      case 'f':
         return sizeof(float);
       case 'L':
         return sizeof(long long);
@@ -315,19 +434,78 @@ private:
     }
   }
 
+  static char GetTypeCode(const Double_t*)  { return 'D'; }
+  static char GetTypeCode(const Float_t*)   { return 'F'; }
+  static char GetTypeCode(const Long64_t*)  { return 'L'; }
+  static char GetTypeCode(const ULong64_t*) { return 'l'; }
+  static char GetTypeCode(const Int_t*)     { return 'I'; }
+  static char GetTypeCode(const UInt_t*)    { return 'i'; }
+  static char GetTypeCode(const Short_t*)   { return 'S'; }
+  static char GetTypeCode(const UShort_t*)  { return 's'; }
+
   static std::size_t AlignOffset(std::size_t offset) {
     const std::size_t alignment = 4u;
     return (offset + (alignment - 1u)) & ~(alignment - 1u);
   }
 
+  // Truncated types are kept in memory as double and float
+  static char GetMemoryType(char type) {
+    if (type == 'd') return 'D';
+    if (type == 'f') return 'F';
+    return type;
+  }
+
+  // Recompute the offsets of the last entries after their types changed
+  void Relayout(size_type start_index) {
+    if (start_index >= m_entries.size()) return;
+    std::size_t offset = m_entries[start_index].offset;
+    for (size_type index = start_index; index < m_entries.size(); ++index) {
+      auto& entry = m_entries[index];
+      entry.offset = AlignOffset(offset);
+      entry.size = GetTypeSize(entry.type);
+      offset = entry.offset + entry.size;
+    }
+    if (offset > m_buffer.capacity()) {
+      throw std::out_of_range("QwRootTreeBranchVector::Relayout() requires buffer resize beyond reserved capacity");
+    }
+    m_buffer.resize(offset, 0u);
+  }
+
+  // Store a value of the input type of an entry as the type of its leaf
+  template <typename T>
+  void Store(const Entry& entry, T val) {
+    std::uint8_t* address = m_buffer.data() + entry.offset;
+    if (! entry.converted) {
+      *reinterpret_cast<T*>(address) = val;
+      return;
+    }
+    switch (entry.type) {
+      case 'D': case 'd': *reinterpret_cast<Double_t*>(address)  = val; break;
+      case 'F': case 'f': *reinterpret_cast<Float_t*>(address)   = val; break;
+      case 'L':           *reinterpret_cast<Long64_t*>(address)  = val; break;
+      case 'l':           *reinterpret_cast<ULong64_t*>(address) = val; break;
+      case 'I':           *reinterpret_cast<Int_t*>(address)     = val; break;
+      case 'i':           *reinterpret_cast<UInt_t*>(address)    = val; break;
+      case 'S':           *reinterpret_cast<Short_t*>(address)   = val; break;
+      case 's':           *reinterpret_cast<UShort_t*>(address)  = val; break;
+    }
+  }
+
   std::vector<Entry> m_entries;
   std::vector<std::uint8_t> m_buffer;
+  std::vector<const void*> m_sources;   // storage of values, for direct binding
+  std::vector<bool> m_bound;            // values not read from the buffer
+  size_type m_num_bound = 0;
+  QwRootTreePrecision* m_precision = nullptr;  // leaf types by name
+  std::string m_tree;
 
   std::string FormatValue(const Entry& entry, size_type index) const {
     switch (entry.type) {
       case 'D':
+      case 'd':
         return FormatNumeric(value<double>(index));
       case 'F':
+      case 'f':
         return FormatNumeric(value<float>(index));
       case 'L':
         return FormatNumeric(value<long long>(index));
@@ -386,7 +564,8 @@ class QwRootTree {
 
     /// Constructor with name, description, and object
     template < class T >
-    QwRootTree(const std::string& name, const std::string& desc, T& object, const std::string& prefix = "")
+    QwRootTree(const std::string& name, const std::string& desc, T& object, const std::string& prefix = "",
+               QwRootTreePrecision* precision = 0)
     : fName(name),fDesc(desc),fPrefix(prefix),fType("type undefined"),
       fCurrentEvent(0),fNumEventsCycle(0),fNumEventsToSave(0),fNumEventsToSkip(0) {
       // Construct tree
@@ -396,19 +575,20 @@ class QwRootTree {
       ConstructUnitsBranch();
 
       // Construct branches and vector
-      ConstructBranchAndVector(object);
+      ConstructBranchAndVector(object, precision);
     }
 
     /// Constructor with existing tree, and object
     template < class T >
-    QwRootTree(const QwRootTree* tree, T& object, const std::string& prefix = "")
+    QwRootTree(const QwRootTree* tree, T& object, const std::string& prefix = "",
+               QwRootTreePrecision* precision = 0)
     : fName(tree->GetName()),fDesc(tree->GetDesc()),fPrefix(prefix),fType("type undefined"),
       fCurrentEvent(0),fNumEventsCycle(0),fNumEventsToSave(0),fNumEventsToSkip(0) {
       QwMessage << "Existing tree: " << tree->GetName() << ", " << tree->GetDesc() << QwLog::endl;
       fTree = tree->fTree;
 
       // Construct branches and vector
-      ConstructBranchAndVector(object);
+      ConstructBranchAndVector(object, precision);
     }
 
     /// Destructor
@@ -448,9 +628,12 @@ class QwRootTree {
 
     /// Construct the branches and vector for generic objects
     template < class T >
-    void ConstructBranchAndVector(T& object) {
+    void ConstructBranchAndVector(T& object, QwRootTreePrecision* precision) {
       // Reserve space for the branch vector
       fVector.reserve(BRANCH_VECTOR_MAX_SIZE);
+      // Leaf types from the precision policy
+      if (precision && ! precision->IsEmpty())
+        fVector.SetPrecision(precision, fName);
       // Associate branches with vector
       TString prefix = Form("%s",fPrefix.c_str());
       object.ConstructBranchAndVector(fTree, prefix, fVector);
@@ -466,7 +649,78 @@ class QwRootTree {
         exit(-1);
       }
     }
-   
+
+    /// Bind leaves directly to the value storage registered by the object
+    void ConstructDirectBinding() {
+      if (fVector.empty()) return;
+      const char* begin = static_cast<const char*>(fVector.data());
+      const char* end = begin + fVector.data_size();
+
+      // Find the entry read by each leaf of the branches in our vector
+      std::vector< std::pair<TLeaf*, size_t> > leaves;
+      TObjArray* branches = fTree->GetListOfBranches();
+      for (Int_t i = 0; i < branches->GetEntriesFast(); i++) {
+        TBranch* branch = static_cast<TBranch*>(branches->UncheckedAt(i));
+        const char* address = branch->GetAddress();
+        // Branches of other objects sharing this tree
+        if (address < begin || address >= end) continue;
+        TObjArray* list = branch->GetListOfLeaves();
+        for (Int_t j = 0; j < list->GetEntriesFast(); j++) {
+          TLeaf* leaf = static_cast<TLeaf*>(list->UncheckedAt(j));
+          size_t index = fVector.FindEntry(address - begin + leaf->GetOffset());
+          if (index == fVector.size()) {
+            QwWarning << "Leaf " << leaf->GetName() << " in tree " << fName
+                      << " does not match the branch vector; no direct binding."
+                      << QwLog::endl;
+            return;
+          }
+          leaves.push_back(std::make_pair(leaf, index));
+        }
+      }
+
+      // Entries without leaves, or with leaves bound elsewhere, are not copied
+      std::vector<bool> copied(fVector.size(), false);
+      for (auto& leaf: leaves) {
+        const void* source = fVector.GetSource(leaf.second);
+        if (source) leaf.first->SetAddress(const_cast<void*>(source));
+        else copied[leaf.second] = true;
+      }
+      size_t bound = 0;
+      for (size_t index = 0; index < fVector.size(); index++) {
+        if (! copied[index]) {
+          fVector.SetBound(index);
+          bound++;
+        }
+      }
+      QwMessage << "Tree " << fName << ": " << bound << " of " << fVector.size()
+                << " values bound directly" << QwLog::endl;
+    }
+
+
+    /// Describe the leaves in our vector, one "offset type branch.leaf" line each
+    std::string GetLeafLayout() const {
+      std::ostringstream layout;
+      if (fVector.empty()) return layout.str();
+      const char* begin = static_cast<const char*>(fVector.data());
+      const char* end = begin + fVector.data_size();
+      TObjArray* branches = fTree->GetListOfBranches();
+      for (Int_t i = 0; i < branches->GetEntriesFast(); i++) {
+        TBranch* branch = static_cast<TBranch*>(branches->UncheckedAt(i));
+        const char* address = branch->GetAddress();
+        if (address < begin || address >= end) continue;
+        TObjArray* list = branch->GetListOfLeaves();
+        for (Int_t j = 0; j < list->GetEntriesFast(); j++) {
+          TLeaf* leaf = static_cast<TLeaf*>(list->UncheckedAt(j));
+          std::size_t offset = address - begin + leaf->GetOffset();
+          size_t index = fVector.FindEntry(offset);
+          if (index == fVector.size()) continue;
+          layout << offset << " " << fVector.GetValueType(index) << " "
+                 << branch->GetName() << "." << leaf->GetName() << "\n";
+        }
+      }
+      return layout.str();
+    }
+
 
   public:
 
@@ -474,8 +728,9 @@ class QwRootTree {
     template < class T >
     void FillTreeBranches(const T& object) {
       if (typeid(object).name() == fType) {
-        // Fill the branch vector
-        object.FillTreeVector(fVector);
+        // Fill the branch vector, unless all leaves are bound directly
+        if (! fVector.IsBound())
+          object.FillTreeVector(fVector);
       } else {
         QwError << "Attempting to fill tree vector for type " << fType << " with "
                 << "object of type " << typeid(object).name() << QwLog::endl;
@@ -487,16 +742,22 @@ class QwRootTree {
       return fTree->AutoSave(option);
     }
 
-    /// Fill the tree
-    Int_t Fill() {
+    /// Count the event and determine whether it passes the prescaling
+    Bool_t Accept() {
       fCurrentEvent++;
 
       // Tree prescaling
       if (fNumEventsCycle > 0) {
         fCurrentEvent %= fNumEventsCycle;
         if (fCurrentEvent > fNumEventsToSave)
-          return 0;
+          return kFALSE;
       }
+      return kTRUE;
+    }
+
+    /// Fill the tree
+    Int_t Fill() {
+      if (! Accept()) return 0;
 
       // Fill the tree
       Int_t retval = fTree->Fill();
@@ -643,6 +904,10 @@ class QwRootNTuple {
 
     /// Close and finalize the RNTuple writer
     void Close() {
+      // Entries and fill contexts are flushed before their writer
+      fEntry.reset();
+      fThreadFills.clear();
+      fParallelWriter.reset();
       if (fWriter) {
         // Explicitly commit any remaining data and close the writer
         // This ensures all data is written to the file before destruction
@@ -680,7 +945,7 @@ class QwRootNTuple {
   public:
 
     /// Initialize the RNTuple writer with a file
-    void InitializeWriter(TFile* file) {
+    void InitializeWriter(TFile* file, Bool_t parallel = kFALSE) {
       if (!fModel) {
         QwError << "RNTuple model not created for " << fName << QwLog::endl;
         return;
@@ -695,9 +960,25 @@ class QwRootNTuple {
       try {
         // Create the writer with the model (transfers ownership)
         // Use Append to add RNTuple to existing TFile
-        fWriter = ROOT::RNTupleWriter::Append(std::move(fModel), fName, *file);
-        
-        QwMessage << "Created RNTuple '" << fName << "' in file " << file->GetName() << QwLog::endl;
+        if (parallel) {
+          fParallelWriter = ROOT::RNTupleParallelWriter::Append(std::move(fModel), fName, *file);
+          // Each filling thread gets its own context, entry, and value vector
+          CreateThreadFill();
+        } else {
+          fWriter = ROOT::RNTupleWriter::Append(std::move(fModel), fName, *file);
+          // Bind all fields of one entry to the value vector
+          fEntry = fWriter->CreateEntry();
+          fFieldNames = GetFieldNames(*fEntry);
+          if (BindEntry(*fEntry, fVector)) {
+            // The default entry with the shared field pointers is not used
+            fFieldPtrs.clear();
+          } else {
+            fEntry.reset();
+          }
+        }
+
+        QwMessage << "Created " << (parallel? "parallel ": "") << "RNTuple '" << fName
+                  << "' in file " << file->GetName() << QwLog::endl;
         
       } catch (const std::exception& e) {
         QwError << "Failed to create RNTuple writer for '" << fName << "': " << e.what() << QwLog::endl;
@@ -708,20 +989,39 @@ class QwRootNTuple {
     template < class T >
     void FillNTupleFields(const T& object) {
       if (typeid(object).name() == fType) {
+        // Parallel writer: fill the entry of this thread's context
+        if (fParallelWriter) {
+          ThreadFill* fill = GetThreadFill();
+          object.FillNTupleVector(fill->fValues);
+          fill->fContext->Fill(*fill->fEntry);
+
+          std::lock_guard<std::mutex> lock(fThreadFillMutex);
+          fCurrentEvent++;
+          if (fNumEventsCycle > 0) {
+            fCurrentEvent %= fNumEventsCycle;
+          }
+          return;
+        }
+
         // Fill the field vector
         object.FillNTupleVector(fVector);
         
-        // Use the shared field pointers which remain valid
         if (fWriter) {
-          for (size_t i = 0; i < fVector.size() && i < fFieldPtrs.size(); ++i) {
-            if (fFieldPtrs[i]) {
-              *(fFieldPtrs[i]) = fVector[i];
+          if (fEntry) {
+            // The fields of the entry read the field vector directly
+            fWriter->Fill(*fEntry);
+          } else {
+            // Use the shared field pointers which remain valid
+            for (size_t i = 0; i < fVector.size() && i < fFieldPtrs.size(); ++i) {
+              if (fFieldPtrs[i]) {
+                *(fFieldPtrs[i]) = fVector[i];
+              }
             }
+
+            // CRITICAL: Actually commit the data to the RNTuple
+            fWriter->Fill();
           }
           
-          // CRITICAL: Actually commit the data to the RNTuple
-          fWriter->Fill();
-          
           // Update event counter
           fCurrentEvent++;
           // RNTuple prescaling
@@ -770,9 +1070,70 @@ class QwRootNTuple {
 
   private:
 
+    /// Context, entry, and value vector of one thread filling a parallel writer
+    struct ThreadFill {
+      std::shared_ptr<ROOT::RNTupleFillContext> fContext;
+      std::unique_ptr<ROOT::REntry> fEntry;
+      std::vector<Double_t> fValues;
+    };
+
+    /// Create the fill context of the calling thread
+    ThreadFill* CreateThreadFill() {
+      std::unique_ptr<ThreadFill> fill(new ThreadFill);
+      fill->fContext = fParallelWriter->CreateFillContext();
+      fill->fEntry = fill->fContext->CreateEntry();
+      fill->fValues.assign(fVector.size(), 0.0);
+      // The first context is created by InitializeWriter, before any fill
+      if (fFieldNames.empty()) fFieldNames = GetFieldNames(*fill->fEntry);
+      if (! BindEntry(*fill->fEntry, fill->fValues)) {
+        QwError << "Cannot bind the fields of RNTuple " << fName << QwLog::endl;
+        exit(-1);
+      }
+      ThreadFill* ptr = fill.get();
+      std::lock_guard<std::mutex> lock(fThreadFillMutex);
+      fThreadFills[std::this_thread::get_id()] = std::move(fill);
+      return ptr;
+    }
+    /// Get the fill context of the calling thread
+    ThreadFill* GetThreadFill() {
+      {
+        std::lock_guard<std::mutex> lock(fThreadFillMutex);
+        auto iter = fThreadFills.find(std::this_thread::get_id());
+        if (iter != fThreadFills.end()) return iter->second.get();
+      }
+      return CreateThreadFill();
+    }
+
+    /// Names of the top-level fields, in the order in which they were created
+    static std::vector<std::string> GetFieldNames(const ROOT::REntry& entry) {
+      std::vector<std::string> names;
+      for (const auto& value: entry)
+        names.push_back(value.GetField().GetFieldName());
+      return names;
+    }
+    /// Bind the fields of an entry to consecutive values
+    Bool_t BindEntry(ROOT::REntry& entry, std::vector<Double_t>& values) const {
+      if (fFieldNames.size() != values.size()) {
+        QwWarning << "RNTuple " << fName << " has " << fFieldNames.size()
+                  << " fields for " << values.size() << " values" << QwLog::endl;
+        return kFALSE;
+      }
+      for (size_t i = 0; i < fFieldNames.size(); i++)
+        entry.BindRawPtr(fFieldNames[i], &values[i]);
+      return kTRUE;
+    }
+
     /// RNTuple model and writer
     std::unique_ptr<ROOT::RNTupleModel> fModel;
     std::unique_ptr<ROOT::RNTupleWriter> fWriter;
+    /// Entry with the fields bound to the vector of values
+    std::unique_ptr<ROOT::REntry> fEntry;
+    std::vector<std::string> fFieldNames;
+
+    /// Parallel writer and the fill contexts of the threads using it
+    std::unique_ptr<ROOT::RNTupleParallelWriter> fParallelWriter;
+    std::map< std::thread::id, std::unique_ptr<ThreadFill> > fThreadFills;
+    std::mutex fThreadFillMutex;
     
     /// Vector of values and shared field pointers (for RNTuple)
     std::vector<Double_t> fVector;
@@ -905,12 +1266,24 @@ class QwRootFile {
       if (! hasDir) return;
       // Fill histograms
       object.FillHistograms();
+
+      // Publish the histograms regularly
+      if (fPublisher && fPublishInterval > 0 && ++fPublishCount % fPublishInterval == 0)
+        PublishHistograms();
+    }
+
+    /// Copy the histograms into shared memory for online monitoring
+    void PublishHistograms() {
+      if (! fPublisher) return;
+      gQwHists.FlushFillBuffers();
+      fPublisher->PublishHistograms();
     }
 
 
     /// Create a new tree with name and description
     void NewTree(const std::string& name, const std::string& desc) {
       if (IsTreeDisabled(name)) return;
+      DrainWriter();
       this->cd();
       QwRootTree *tree = 0;
       if (! HasTreeByName(name)) {
@@ -929,7 +1302,7 @@ class QwRootFile {
       if (! HasNTupleByName(name)) {
         ntuple = new QwRootNTuple(name, desc);
         // Initialize the writer with our file
-        ntuple->InitializeWriter(fRootFile);
+        ntuple->InitializeWriter(fRootFile, fParallelNTuples);
       } else {
         // For simplicity, don't support copying existing RNTuples yet
         QwError << "Cannot create duplicate RNTuple: " << name << QwLog::endl;
@@ -939,16 +1312,25 @@ class QwRootFile {
     }
 #endif // HAS_RNTUPLE_SUPPORT
 
-    /// Get the tree with name
+    /// Get the tree with name (entries queued for the writer are written first)
     TTree* GetTree(const std::string& name) {
       if (! HasTreeByName(name)) return 0;
-      else return fTreeByName[name].front()->GetTree();
+      DrainWriter();
+      return fTreeByName[name].front()->GetTree();
     }
 
     /// Fill the tree with name
     Int_t FillTree(const std::string& name) {
       if (! HasTreeByName(name)) return 0;
-      else return fTreeByName[name].front()->Fill();
+      else return FillTree(name, fTreeByName[name].front());
+    }
+
+    /// Fill the tree with name directly and without prescaling, after the
+    /// entries queued for the writer (for trees with their own branches)
+    Int_t FillTreeDirect(const std::string& name) {
+      if (! HasTreeByName(name)) return 0;
+      DrainWriter();
+      return fTreeByName[name].front()->GetTree()->Fill();
     }
 
     /// Fill all registered trees
@@ -957,7 +1339,7 @@ class QwRootFile {
       Int_t retval = 0;
       std::map< const std::string, std::vector<QwRootTree*> >::iterator iter;
       for (iter = fTreeByName.begin(); iter != fTreeByName.end(); iter++) {
-        retval += iter->second.front()->Fill();
+        retval += FillTree(iter->first, iter->second.front());
       }
       return retval;
     }
@@ -1013,6 +1395,7 @@ class QwRootFile {
     Int_t WriteObject(const T* obj, const char* name, Option_t* option = "", Int_t bufsize = 0) {
       Int_t retval = 0;
       // TMapFile has no support for WriteObject
+      DrainWriter();
       if (fRootFile) retval = fRootFile->WriteObject(obj,name,option,bufsize);
       return retval;
     }
@@ -1020,6 +1403,7 @@ class QwRootFile {
 
     // Wrapped functionality
     void Update() {
+      gQwHists.FlushFillBuffers();
       if (fMapFile) {
         QwMessage << "TMapFile memory resident size: "
                   << ((int*)fMapFile->GetBreakval() - (int*)fMapFile->GetBaseAddr()) *
@@ -1028,6 +1412,7 @@ class QwRootFile {
         fMapFile->Update();
       }else{
 	// this option will allow for reading the tree during write
+	DrainWriter();
 	Long64_t nBytes(0);
 	for (auto iter = fTreeByName.begin(); iter != fTreeByName.end(); iter++)
 	  nBytes += iter->second.front()->AutoSave("SaveSelf");
@@ -1042,6 +1427,9 @@ class QwRootFile {
     void Map()    { if (fRootFile) fRootFile->Map(); }
     void Close()  {
 
+      // Write all queued entries and rebind the branches
+      StopWriter();
+
       // Check if we should make the file permanent - restore original logic
       if (!fMakePermanent) fMakePermanent = HasAnyFilled();
       
@@ -1073,6 +1461,9 @@ class QwRootFile {
       if (fRootFile) {
         TString rootfilename = fRootFile->GetName();
         
+        // Closing the file deletes its histograms
+        StopPublisher();
+        gQwHists.ReleaseFillBuffers(fRootFile);
         fRootFile->Close();        
 
       }
@@ -1084,6 +1475,7 @@ class QwRootFile {
 
     // Wrapped functionality
     Bool_t cd(const char* path = 0) {
+      DrainWriter();
       Bool_t status = kTRUE;
       if (fMapFile)  status &= fMapFile->cd(path);
       if (fRootFile) status &= fRootFile->cd(path);
@@ -1092,6 +1484,7 @@ class QwRootFile {
 
     // Wrapped functionality
     TDirectory* mkdir(const char* name, const char* title = "") {
+      DrainWriter();
       // TMapFile has no support for mkdir
       if (fRootFile) return fRootFile->mkdir(name, title);
       else return 0;
@@ -1101,6 +1494,8 @@ class QwRootFile {
     Int_t Write(const char* name = 0, Int_t option = 0, Int_t bufsize = 0) {
       Int_t retval = 0;
       // TMapFile has no support for Write
+      DrainWriter();
+      gQwHists.FlushFillBuffers();
       if (fRootFile) retval = fRootFile->Write(name, option, bufsize);
       return retval;
     }
@@ -1145,7 +1540,55 @@ class QwRootFile {
     Int_t fAutoFlush;
     Int_t fAutoSave;
 
-  
+
+  private:
+
+    /// Number of tree entries buffered for the writer thread (0 to fill directly)
+    Int_t fWriteDepth;
+    /// Writer thread for the trees of this file
+    std::unique_ptr<QwRootTreeWriter> fWriter;
+    Bool_t fWriterStarted;
+    /// Index of each tree name in the writer, or -1 if filled directly
+    std::map< const std::string, Int_t > fWriterTreeIndex;
+
+    /// Bind leaves directly to the values in the objects instead of copying
+    Bool_t fDirectBinding;
+
+    /// Leaf types of the trees, from the tree precision map file
+    QwRootTreePrecision fPrecision;
+
+    /// \brief Fill a tree directly or through the writer thread
+    Int_t FillTree(const std::string& name, QwRootTree* tree);
+    /// \brief Register the trees with the writer and start it
+    void StartWriter();
+    /// \brief Stop the writer after writing all queued entries
+    void StopWriter();
+    /// Wait until the writer has written all queued entries
+    void DrainWriter() {
+      if (fWriter) fWriter->Drain();
+    }
+    /// Stop the writer, which is started again at the next fill
+    void ResetWriter() {
+      StopWriter();
+      fWriterStarted = kFALSE;
+    }
+
+    /// Publish histograms and recent tree entries in shared memory
+    Bool_t fEnablePublisher;
+    std::string fPublisherName;
+    Int_t fPublishInterval;
+    Int_t fPublisherDepth;
+    Int_t fPublishCount;
+    std::shared_ptr<QwSharedMemoryPublisher> fPublisher;
+    std::map< const std::string, Int_t > fPublisherTreeIndex;
+    /// Publisher shared by all files of this process
+    static std::weak_ptr<QwSharedMemoryPublisher> fSharedPublisher;
+
+    /// \brief Copy the current entry of a tree into shared memory
+    void PublishEntry(const std::string& name, QwRootTree* tree);
+    /// \brief Remove the objects of this file from the publisher
+    void StopPublisher();
+
 
   private:
 
@@ -1191,6 +1634,8 @@ class QwRootFile {
 
     /// RNTuple support flag
     Bool_t fEnableRNTuples;
+    /// Use parallel writers, so that RNTuples can be filled from several threads
+    Bool_t fParallelNTuples;
 #endif // HAS_RNTUPLE_SUPPORT
 
     /// Is a tree registered for this name
@@ -1280,6 +1725,9 @@ inline void QwRootFile::ConstructIndices(const std::string& from, const std::str
   if (IsTreeDisabled(from)) return;
   if (IsTreeDisabled(to)) return;
 
+  // Entries queued for the writer are written before the trees change
+  DrainWriter();
+
   // If the trees are defined
   if (fTreeByName.count(from) > 0 && fTreeByName.count(to) > 0) {
 
@@ -1309,6 +1757,16 @@ void QwRootFile::ConstructTreeBranches(
   // Return if we do not want this tree information
   if (IsTreeDisabled(name)) return;
 
+  // Entries queued for the writer are written before the file changes.
+  // The writer fills its trees from mirrors of the branch vectors, so it
+  // is stopped before branches are added to one of its trees, and all
+  // trees are registered again at the next fill.
+  auto index = fWriterTreeIndex.find(name);
+  if (index != fWriterTreeIndex.end() && index->second >= 0)
+    ResetWriter();
+  else
+    DrainWriter();
+
   // Pointer to new tree
   QwRootTree* tree = 0;
 
@@ -1320,7 +1778,7 @@ void QwRootFile::ConstructTreeBranches(
     this->cd();
 
     // New tree with name, description, object, prefix
-    tree = new QwRootTree(name, desc, object, prefix);
+    tree = new QwRootTree(name, desc, object, prefix, &fPrecision);
 
     // Settings only relevant for new trees
     if (name == "evt")
@@ -1341,9 +1799,13 @@ void QwRootFile::ConstructTreeBranches(
   } else {
 
     // New tree based on existing tree
-    tree = new QwRootTree(fTreeByName[name].front(), object, prefix);
+    tree = new QwRootTree(fTreeByName[name].front(), object, prefix, &fPrecision);
   }
 
+  // Bind the leaves to the values in the object where possible
+  if (fDirectBinding)
+    tree->ConstructDirectBinding();
+
    // Add the branches to the list of trees by name, object, type
   const void* addr = static_cast<const void*>(&object);
   const std::type_index type = typeid(object);
@@ -1429,7 +1891,7 @@ void QwRootFile::ConstructNTupleFields(
     ntuple = new QwRootNTuple(name, desc, object, prefix);
 
     // Initialize the writer with our file
-    ntuple->InitializeWriter(fRootFile);
+    ntuple->InitializeWriter(fRootFile, fParallelNTuples);
 
     // Settings only relevant for new RNTuples
     if (name == "evt")
@@ -1510,6 +1972,9 @@ void QwRootFile::FillNTupleFields(
 template < class T >
 void QwRootFile::ConstructObjects(const std::string& name, T& object)
 {
+  // Entries queued for the writer are written before the file changes
+  DrainWriter();
+
   // Create the objects in a directory
   if (fRootFile) {
     std::string type = typeid(object).name();
@@ -1547,6 +2012,9 @@ void QwRootFile::ConstructHistograms(const std::string& name, T& object)
   // Return if we do not want this histogram information
   if (IsHistoDisabled(name)) return;
 
+  // Entries queued for the writer are written before the file changes
+  DrainWriter();
+
   // Create the histograms in a directory
   if (fRootFile) {
     std::string type = typeid(object).name();
@@ -1557,6 +2025,7 @@ void QwRootFile::ConstructHistograms(const std::string& name, T& object)
     fDirsByType[type].push_back(name);
         
     object.ConstructHistograms(fDirsByName[name]);
+    if (fPublisher) fPublisher->AddHistograms(this, fDirsByName[name], name);
   }
 
   // No support for directories in a map file
@@ -1579,6 +2048,7 @@ template < class T >
 Int_t QwRootFile::WriteParamFileList(const TString &name, T& object)
 {
   Int_t retval = 0;
+  DrainWriter();
   if (fRootFile) {
     TList *param_list = (TList*) fRootFile->FindObjectAny(name);
     if (not param_list) {
@@ -0,0 +1,56 @@
+/*!
+ * \file   QwRootTreePrecision.h
+ * \brief  Output types of ROOT tree leaves selected by regular expressions
+ */
+
+#pragma once
+
+// System headers
+#include <string>
+#include <vector>
+
+// ROOT headers
+#include "TPRegexp.h"
+
+/**
+ * \class QwRootTreePrecision
+ * \ingroup QwAnalysis
+ * \brief Precision policy for the leaves written to ROOT trees
+ *
+ * Each rule maps a regular expression on the full leaf name, written as
+ * "tree:branch.leaf" (e.g. "evt:sam1.hw_sum"), to the type with which the
+ * leaf is stored.  The first matching rule applies.  The types are the
+ * leaf list type codes D, F, L, l, I and i, and the truncated types d
+ * (Double32_t) and f (Float16_t) with an optional range and number of
+ * bits, e.g. "d[0,0,20]".  The map file has one rule per line:
+ * \code
+ * # regular expression            type
+ * ^evt:.*\.Device_Error_Code$     i
+ * ^mul:asym_.*\.block[0-3]$       f[0,0,16]
+ * \endcode
+ */
+class QwRootTreePrecision {
+
+ public:
+  QwRootTreePrecision() { };
+  virtual ~QwRootTreePrecision() { };
+
+  /// \brief Load the rules from a map file
+  void LoadFromFile(const std::string& filename);
+  /// \brief Add a rule; returns false if the type is not supported
+  Bool_t AddRule(const std::string& regexp, const std::string& type);
+
+  /// Are there any rules?
+  Bool_t IsEmpty() const { return fRules.empty(); };
+
+  /// \brief Find the type and range of a leaf
+  Bool_t Find(const std::string& name, char& type, std::string& range);
+
+ private:
+  struct Rule {
+    TPRegexp fRegexp;
+    char fType;
+    std::string fRange;
+  };
+  std::vector<Rule> fRules;
+};
@@ -0,0 +1,115 @@
+/*!
+ * \file   QwRootTreeWriter.h
+ * \brief  Writer thread which fills ROOT trees from snapshots of their branch buffers
+ */
+
+#pragma once
+
+// System headers
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// ROOT headers
+#include "Rtypes.h"
+class TBranch;
+class TTree;
+
+// Qweak headers
+#include "QwBlockingQueue.h"
+
+/**
+ * \class QwRootTreeWriter
+ * \ingroup QwAnalysis
+ * \brief Fills ROOT trees on a dedicated thread from a ring of snapshots
+ *
+ * The trees of one ROOT file are registered with the byte buffers their
+ * branches are bound to (the QwRootTreeBranchVector buffers).  Once the
+ * writer is started, the branches are rebound to mirror buffers owned by
+ * the writer.  Fill copies the current buffers into a free slot of the
+ * ring and queues it; the writer thread copies the slot into the mirrors
+ * and calls TTree::Fill, so compression and disk output overlap with the
+ * analysis.  Entries are written in the order in which they were queued,
+ * for all trees of the file, and Fill waits when all slots are in use.
+ *
+ * Trees are only accepted when every branch points into one of the
+ * registered buffers or into constant storage; anything else is read at
+ * fill time and has to be filled synchronously after Drain.
+ */
+class QwRootTreeWriter {
+
+ public:
+  /// \brief Constructor with the number of snapshot slots
+  explicit QwRootTreeWriter(std::size_t depth);
+  /// \brief Destructor, writes all queued entries and stops the thread
+  virtual ~QwRootTreeWriter();
+
+  /// \brief Register a tree with the buffers its branches are bound to
+  Int_t AddTree(TTree* tree,
+      const std::vector< std::pair<void*,std::size_t> >& buffers,
+      const std::vector<const void*>& constants);
+
+  /// \brief Rebind the branches and start the writer thread
+  void Start();
+  /// \brief Write all queued entries, stop the thread and restore the branches
+  void Stop();
+  /// Is the writer thread running?
+  Bool_t IsRunning() const { return fRunning; };
+
+  /// \brief Queue an entry of the registered tree with this index
+  void Fill(Int_t tree);
+  /// \brief Wait until all queued entries have been written
+  void Drain();
+
+  /// Status of the last failed TTree::Fill, or zero
+  Int_t GetStatus() const;
+
+ private:
+  /// Copying a writer is not supported
+  QwRootTreeWriter(const QwRootTreeWriter&) = delete;
+  QwRootTreeWriter& operator=(const QwRootTreeWriter&) = delete;
+
+  /// Buffer of the analysis and the writer copy the branches are bound to
+  struct Buffer {
+    char* fSource;
+    std::size_t fSize;
+    std::vector<char> fMirror;
+  };
+  /// Branch bound into a buffer at an offset
+  struct Binding {
+    TBranch* fBranch;
+    std::size_t fBuffer;
+    std::size_t fOffset;
+  };
+  /// Registered tree
+  struct Tree {
+    TTree* fTree;
+    std::vector<Buffer> fBuffers;
+    std::vector<Binding> fBindings;
+    std::size_t fSize;
+  };
+  /// Snapshot of the buffers of one tree
+  struct Slot {
+    Int_t fTree;
+    std::vector<char> fData;
+  };
+
+  /// \brief Main loop of the writer thread
+  void WriterLoop();
+
+  std::vector<Tree> fTrees;
+  std::vector<Slot> fSlots;                ///< Slots circulating between the queues
+  QwBlockingQueue<Slot> fFree;
+  QwBlockingQueue<Slot> fReady;
+
+  std::thread fThread;
+  Bool_t fRunning;
+
+  mutable std::mutex fMutex;
+  std::condition_variable fDrained;        ///< Signals a written entry
+  std::size_t fPending;                    ///< Entries queued but not written
+  Int_t fStatus;
+};
@@ -147,6 +147,7 @@ public:
   VQwScaler_Channel& operator=  (const VQwScaler_Channel &value);
   void AssignScaledValue(const VQwScaler_Channel &value, Double_t scale);
   void AssignValueFrom(const VQwDataElement* valueptr) override;
+  void Snapshot(QwSnapshot& snapshot) override;
   void AddValueFrom(const VQwHardwareChannel* valueptr) override;
   void SubtractValueFrom(const VQwHardwareChannel* valueptr) override;
   void MultiplyBy(const VQwHardwareChannel* valueptr) override;
@@ -0,0 +1,112 @@
+/*!
+ * \file   QwSharedMemoryLayout.h
+ * \brief  Layout of the shared-memory segment of the live publisher
+ */
+
+#pragma once
+
+// System headers
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * \class QwSharedMemoryRecord
+ * \ingroup QwAnalysis
+ * \brief Directory entry of one published object in the shared segment
+ *
+ * The segment starts with a QwSharedMemoryHeader, followed by the array
+ * of records and the data areas they point to.  All offsets are relative
+ * to the start of the segment, so that readers can map it anywhere.
+ *
+ * The data of each record is guarded by its own sequence lock: the
+ * publisher makes the sequence number odd while it writes, and even when
+ * it is done.  Readers copy the data and retry when the sequence number
+ * was odd or changed during the copy; they never block the publisher.
+ *
+ * Histograms store the number of entries, the sums of weights, of
+ * squared weights, of x times weights and of x squared times weights,
+ * followed by the bin contents including underflow and overflow.  Trees
+ * store a text description of their leaves (one "offset type name" line
+ * per leaf) and a ring of the most recent entries.
+ */
+struct QwSharedMemoryRecord {
+  static const std::size_t kNameSize = 128;
+  enum EType: std::uint32_t { kHistogram = 1, kTreeEntries = 2 };
+  enum EHistogramData: std::uint32_t {
+    kEntries, kSumW, kSumW2, kSumWX, kSumWX2, kNumHistogramStats
+  };
+
+  char fName[kNameSize];        ///< Path of the histogram, or name of the tree
+  std::uint32_t fType;
+  std::uint32_t fReserved;
+  std::uint64_t fOffset;        ///< Data offset in the segment
+  std::uint64_t fSize;          ///< Data size in bytes
+  std::uint64_t fCount;         ///< Number of bins including under/overflow, or entry size
+  std::uint64_t fDepth;         ///< Entries in the ring of a tree
+  std::uint64_t fLayoutOffset;  ///< Offset of the leaf description of a tree
+  std::uint64_t fLayoutSize;
+  double fMin, fMax;            ///< Axis range of a histogram
+  std::uint64_t fWritten;       ///< Entries written into the ring so far
+  std::atomic<std::uint64_t> fSequence;
+
+  /// Mark the start of a modification of the data
+  void BeginWrite() {
+    fSequence.store(fSequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+  /// Mark the end of a modification of the data
+  void EndWrite() {
+    fSequence.store(fSequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  /// Call copy() until it ran without a concurrent modification
+  template <class Copy>
+  bool Read(Copy copy, int attempts = 1000) const {
+    for (int i = 0; i < attempts; i++) {
+      std::uint64_t before = fSequence.load(std::memory_order_acquire);
+      if (before & 1) continue;
+      copy();
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (fSequence.load(std::memory_order_relaxed) == before) return true;
+    }
+    return false;
+  }
+};
+
+/**
+ * \class QwSharedMemoryHeader
+ * \ingroup QwAnalysis
+ * \brief Header at the start of the shared segment of the live publisher
+ *
+ * The state is set to kReady once the records are complete.  When the
+ * publisher replaces the segment (new objects, or a new run) it sets the
+ * state of the old segment to kStale, and readers attach again.
+ */
+struct QwSharedMemoryHeader {
+  static const std::uint32_t kMagic = 0x5177534d; // "QwSM"
+  static const std::uint32_t kVersion = 1;
+  enum EState: std::uint32_t { kInitializing = 0, kReady = 1, kStale = 2 };
+
+  std::uint32_t fMagic;
+  std::uint32_t fVersion;
+  std::uint64_t fSize;          ///< Size of the segment
+  std::uint64_t fNumRecords;
+  std::atomic<std::uint32_t> fState;
+  std::atomic<std::uint32_t> fPid;        ///< Process ID of the publisher
+  std::atomic<std::uint64_t> fUpdates;    ///< Number of histogram updates
+
+  /// Records following the header
+  QwSharedMemoryRecord* GetRecords() {
+    return reinterpret_cast<QwSharedMemoryRecord*>(this + 1);
+  }
+  const QwSharedMemoryRecord* GetRecords() const {
+    return reinterpret_cast<const QwSharedMemoryRecord*>(this + 1);
+  }
+};
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+    "the shared segment requires lock-free 64-bit atomics");
+static_assert(sizeof(QwSharedMemoryHeader) % 8 == 0 && sizeof(QwSharedMemoryRecord) % 8 == 0,
+    "the shared segment requires 8-byte aligned records");
@@ -0,0 +1,110 @@
+/*!
+ * \file   QwSharedMemoryPublisher.h
+ * \brief  Publisher of live histograms and tree entries in POSIX shared memory
+ */
+
+#pragma once
+
+// System headers
+#include <cstddef>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+// ROOT headers
+#include "Rtypes.h"
+class TDirectory;
+class TH1;
+
+// Qweak headers
+#include "QwSharedMemoryLayout.h"
+
+/**
+ * \class QwSharedMemoryPublisher
+ * \ingroup QwAnalysis
+ * \brief Publishes histograms and recent tree entries for online monitoring
+ *
+ * The publisher owns a POSIX shared-memory segment (see
+ * QwSharedMemoryLayout.h) with one record per histogram and per tree.
+ * Histograms are copied into the segment by PublishHistograms, tree
+ * entries are copied into a ring of recent entries between BeginEntry and
+ * EndEntry.  Each record is guarded by a sequence lock, so that readers
+ * (QwSharedMemoryReader) in other processes obtain consistent copies
+ * without ever stalling the analysis.
+ *
+ * The segment is sized for the registered objects when data is first
+ * published.  When objects are added or removed later, a new segment is
+ * created under the same name and the old one is marked as stale, so
+ * that readers attach to the new one.  The last segment is left in place
+ * when the publisher is destroyed, so the final state stays readable.
+ */
+class QwSharedMemoryPublisher {
+
+ public:
+  /// \brief Constructor with the segment name and the entries kept per tree
+  QwSharedMemoryPublisher(const std::string& name, std::size_t depth);
+  /// \brief Destructor, unmaps but keeps the segment
+  virtual ~QwSharedMemoryPublisher();
+
+  /// \brief Register the one-dimensional histograms in a directory tree
+  void AddHistograms(const void* owner, TDirectory* dir, const std::string& path);
+  /// \brief Register a histogram
+  void AddHistogram(const void* owner, TH1* h, const std::string& path);
+  /// \brief Register a tree with the description of its leaves and its entry size
+  Int_t AddTree(const void* owner, const std::string& name,
+      const std::string& layout, std::size_t size);
+  /// \brief Remove all objects registered by an owner
+  void Remove(const void* owner);
+
+  /// \brief Copy the contents of all histograms into the segment
+  void PublishHistograms();
+
+  /// \brief Start writing an entry of a tree, returns the slot or nullptr
+  char* BeginEntry(Int_t tree);
+  /// \brief Finish writing the entry returned by BeginEntry
+  void EndEntry(Int_t tree);
+
+  /// Name of the shared-memory segment
+  const std::string& GetName() const { return fName; };
+
+ private:
+  /// Copying a publisher is not supported
+  QwSharedMemoryPublisher(const QwSharedMemoryPublisher&) = delete;
+  QwSharedMemoryPublisher& operator=(const QwSharedMemoryPublisher&) = delete;
+
+  /// \brief Create the segment for the registered objects
+  Bool_t Build();
+  /// \brief Mark the segment as stale, unmap and unlink it
+  void Release();
+
+  /// Registered histogram
+  struct Histogram {
+    const void* fOwner;
+    TH1* fHistogram;
+    std::string fPath;
+    std::size_t fRecord;
+  };
+  /// Registered tree; the index is kept when the tree is removed
+  struct Tree {
+    const void* fOwner;
+    std::string fName;
+    std::string fLayout;
+    std::size_t fSize;
+    std::size_t fRecord;
+  };
+
+  QwSharedMemoryRecord* GetRecord(std::size_t record) {
+    return fHeader->GetRecords() + record;
+  };
+
+  std::string fName;
+  std::size_t fDepth;
+
+  std::vector<Histogram> fHistograms;
+  std::unordered_set<const TH1*> fRegistered;
+  std::vector<Tree> fTrees;
+  Bool_t fDirty;                ///< Registered objects differ from the segment
+
+  QwSharedMemoryHeader* fHeader;
+  std::size_t fSize;
+};
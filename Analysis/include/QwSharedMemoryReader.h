@@ -0,0 +1,79 @@
+/*!
+ * \file   QwSharedMemoryReader.h
+ * \brief  Reader of the live histograms and tree entries in shared memory
+ */
+
+#pragma once
+
+// System headers
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// ROOT headers
+#include "Rtypes.h"
+class TH1D;
+
+// Qweak headers
+#include "QwSharedMemoryLayout.h"
+
+/**
+ * \class QwSharedMemoryReader
+ * \ingroup QwAnalysis
+ * \brief Reads consistent snapshots from the segment of QwSharedMemoryPublisher
+ *
+ * The reader maps the segment read-only, so it can be used from any local
+ * process (e.g. panguin) without affecting the analysis.  Every read copies
+ * one record under its sequence lock.  When the publisher has replaced the
+ * segment, the reads fail and IsStale returns true; Attach maps the new
+ * segment.  The offsets and sizes of the records are checked against the
+ * size of the mapped segment before anything is copied.
+ */
+class QwSharedMemoryReader {
+
+ public:
+  QwSharedMemoryReader();
+  virtual ~QwSharedMemoryReader();
+
+  /// \brief Map the segment with this name
+  Bool_t Attach(const std::string& name);
+  /// \brief Unmap the segment
+  void Detach();
+  /// Is a segment mapped?
+  Bool_t IsAttached() const { return fHeader != nullptr; };
+  /// \brief Has the publisher replaced or abandoned the segment?
+  Bool_t IsStale() const;
+  /// Number of histogram updates by the publisher
+  std::uint64_t GetUpdates() const;
+
+  /// \brief Names of the published histograms
+  std::vector<std::string> GetHistogramNames() const;
+  /// \brief Names of the published trees
+  std::vector<std::string> GetTreeNames() const;
+
+  /// \brief Copy a histogram into a new TH1D, which is owned by the caller
+  TH1D* GetHistogram(const std::string& name) const;
+  /// \brief Copy the values of a leaf in the recent entries of a tree, oldest first
+  Bool_t GetLeafValues(const std::string& tree, const std::string& leaf,
+      std::vector<Double_t>& values) const;
+
+ private:
+  /// Copying a reader is not supported
+  QwSharedMemoryReader(const QwSharedMemoryReader&) = delete;
+  QwSharedMemoryReader& operator=(const QwSharedMemoryReader&) = delete;
+
+  /// \brief Find a record by name and type
+  const QwSharedMemoryRecord* FindRecord(const std::string& name, std::uint32_t type) const;
+  /// Data area of a record
+  const char* GetData(std::uint64_t offset) const {
+    return reinterpret_cast<const char*>(fHeader) + offset;
+  };
+  /// Does an area with this offset and size lie within the mapped segment?
+  Bool_t IsInSegment(std::uint64_t offset, std::uint64_t size) const {
+    return offset <= fSize && size <= fSize - offset;
+  };
+
+  std::string fName;
+  const QwSharedMemoryHeader* fHeader;
+  std::size_t fSize;
+};
@@ -0,0 +1,86 @@
+/*!
+ * \file   QwSnapshot.h
+ * \brief  Flat buffer of per-event values, for storing and restoring event data
+ */
+
+#pragma once
+
+// System headers
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+// ROOT headers
+#include "Rtypes.h"
+
+/**
+ * \class QwSnapshot
+ * \ingroup QwAnalysis
+ * \brief Cursor into a flat buffer of per-event values
+ *
+ * Data elements and subsystems transfer their per-event state, i.e. the
+ * values copied by their assignment operators, through Transfer.  The same
+ * sequence of calls is used to measure the size of a snapshot, to write an
+ * object into a buffer, and to read it back into another object with the
+ * same configuration.  Only plain values are transferred; names, channel
+ * maps, histograms and other configuration are not part of a snapshot.
+ */
+class QwSnapshot {
+
+ public:
+  /// Direction of the transfer
+  enum EQwSnapshotMode { kMeasure, kWrite, kRead };
+
+  QwSnapshot(): fMode(kMeasure), fBuffer(0), fCapacity(0), fPosition(0), fOverflow(kFALSE) { };
+
+  /// Start measuring the size of a snapshot
+  void Measure() { Start(kMeasure, 0, 0); };
+  /// Start writing a snapshot into a buffer of the given size
+  void Write(char* buffer, std::size_t size) { Start(kWrite, buffer, size); };
+  /// Start reading a snapshot from a buffer of the given size
+  void Read(const char* buffer, std::size_t size) { Start(kRead, const_cast<char*>(buffer), size); };
+
+  /// Direction of the current transfer
+  EQwSnapshotMode GetMode() const { return fMode; };
+  /// Number of bytes transferred so far
+  std::size_t GetSize() const { return fPosition; };
+  /// Did the transfer run past the end of the buffer?
+  Bool_t HasOverflow() const { return fOverflow; };
+
+  /// Transfer a single value
+  template <class T>
+  void Transfer(T& value) { Transfer(&value, 1); };
+  /// Transfer an array of values
+  template <class T>
+  void Transfer(T* values, std::size_t n) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "QwSnapshot can only transfer plain values");
+    const std::size_t size = n * sizeof(T);
+    if (fMode != kMeasure) {
+      if (fPosition + size > fCapacity) {
+        fOverflow = kTRUE;
+        return;
+      }
+      if (fMode == kWrite)
+        std::memcpy(fBuffer + fPosition, values, size);
+      else
+        std::memcpy(values, fBuffer + fPosition, size);
+    }
+    fPosition += size;
+  };
+
+ private:
+  void Start(EQwSnapshotMode mode, char* buffer, std::size_t size) {
+    fMode = mode;
+    fBuffer = buffer;
+    fCapacity = size;
+    fPosition = 0;
+    fOverflow = kFALSE;
+  };
+
+  EQwSnapshotMode fMode;   ///< Direction of the transfer
+  char* fBuffer;           ///< Buffer being written or read
+  std::size_t fCapacity;   ///< Size of the buffer
+  std::size_t fPosition;   ///< Current position in the buffer
+  Bool_t fOverflow;        ///< Set when the buffer was too small
+};
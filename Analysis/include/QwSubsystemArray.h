@@ -10,6 +10,7 @@
 #include <vector>
 #include <map>
 #include <memory>
+#include <unordered_map>
 
 #include "Rtypes.h"
 #include "TString.h"
@@ -28,6 +29,7 @@
 class VQwHardwareChannel;
 class QwParameterFile;
 class QwRootTreeBranchVector;
+class QwThreadPool;
 
 /**
  * \class QwSubsystemArray
@@ -111,6 +113,11 @@ class QwSubsystemArray:
   };
 
 
+  /// \brief Set the thread pool used to process subsystems in parallel
+  void   SetThreadPool(QwThreadPool* pool) { fThreadPool = pool; };
+  /// \brief Get the thread pool used to process subsystems in parallel
+  QwThreadPool* GetThreadPool() const { return fThreadPool; };
+
   /// \brief Set data loaded flag
   void   SetDataLoaded(const Bool_t flag) { fHasDataLoaded = flag; };
   /// \brief Get data loaded flag
@@ -269,6 +276,28 @@ class QwSubsystemArray:
  public:
   void GetMarkerWordList(const ROCID_t roc_id, const BankID_t bank_id, std::vector<UInt_t>& marker) const;
 
+  /**
+   * \brief Subsystems reading one ROC/bank, and the marker words within it
+   *
+   * The dispatch table is built once from the ROC/bank registrations of
+   * the subsystems (after their channel maps are loaded), so that each bank
+   * is only passed to the subsystems that read it.  Subsystems for which
+   * VQwSubsystem::ReadsAllBanks() is true are included in every entry.
+   */
+  struct BankDispatch {
+    /// Subsystems reading this bank, with their subbank index
+    std::vector< std::pair<VQwSubsystem*, Int_t> > fConsumers;
+    /// Marker words of the subbanks within this bank
+    std::vector<UInt_t> fMarkerWords;
+    /// Position of each marker word in the previous event
+    std::vector<UInt_t> fMarkerOffsets;
+  };
+  /// \brief Get the dispatch table entry for a ROC/bank
+  BankDispatch& GetBankDispatch(const ROCID_t roc_id, const BankID_t bank_id);
+  /// \brief Rebuild the dispatch table before the next bank is processed
+  void InvalidateDispatchTable() { fDispatchTableValid = kFALSE; };
+
+
  protected:
   size_t fTreeArrayIndex;  //! Index of this data element in root tree
 
@@ -282,6 +311,9 @@ class QwSubsystemArray:
   UInt_t fEventTypeMask;   ///< Mask of event types
   Bool_t fHasDataLoaded;   ///< Has this array gotten data to be processed?
 
+  /// Pool for processing the subsystems in parallel (not owned, not copied)
+  QwThreadPool* fThreadPool;
+
  protected:
   /// Function to determine which subsystems we can accept
   CanContainFn fnCanContain;
@@ -303,6 +335,22 @@ class QwSubsystemArray:
   std::vector<std::string> fSubsystemsDisabledByName; ///< List of disabled types
   std::vector<std::string> fSubsystemsDisabledByType; ///< List of disabled names
 
+  /// \brief Build the dispatch table from the subsystem registrations
+  void BuildDispatchTable();
+
+  /// Hash of a ROC/bank pair (the bank ID may contain a marker word)
+  struct RocBankHash {
+    std::size_t operator()(const std::pair<ROCID_t,BankID_t>& key) const {
+      return std::hash<BankID_t>()(key.second ^ (BankID_t(key.first) * 0x9e3779b97f4a7c15ULL));
+    }
+  };
+  /// Dispatch table entries of all registered ROC/banks (not copied)
+  std::unordered_map<std::pair<ROCID_t,BankID_t>, BankDispatch, RocBankHash> fDispatchTable;
+  /// Dispatch entry for banks without any registration
+  BankDispatch fDispatchDefault;
+  /// Is the dispatch table up to date with the subsystems?
+  Bool_t fDispatchTableValid;
+
 public:
   // Mock Data Variables
     /// \brief Randomize the data in this event
@@ -0,0 +1,68 @@
+/*!
+ * \file   QwThreadPool.h
+ * \brief  Minimal fixed-size thread pool for data-parallel loops
+ */
+
+#pragma once
+
+// System headers
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Qweak headers
+#include "QwLog.h"
+
+/**
+ * \class QwThreadPool
+ * \ingroup QwAnalysis
+ * \brief Fixed-size pool of worker threads for blocking parallel loops
+ *
+ * The pool executes one loop at a time: ForEach(n, fn) calls fn(i) for
+ * every i in [0,n), distributing the indices over the worker threads and
+ * the calling thread, and returns only after all calls have completed.
+ * Completion of ForEach establishes a happens-before relation with the
+ * caller, so objects modified inside fn can be used safely afterwards.
+ */
+class QwThreadPool {
+
+ public:
+  /// \brief Constructor with the number of additional worker threads
+  explicit QwThreadPool(std::size_t nthreads);
+  /// \brief Destructor, joins all worker threads
+  virtual ~QwThreadPool();
+
+  /// Number of worker threads (not counting the calling thread)
+  std::size_t GetNumberOfThreads() const { return fThreads.size(); };
+
+  /// \brief Call fn(i) for all i in [0,n) and wait for completion
+  void ForEach(std::size_t n, const std::function<void(std::size_t)>& fn);
+
+ private:
+  /// Copying a thread pool is not supported
+  QwThreadPool(const QwThreadPool&) = delete;
+  QwThreadPool& operator=(const QwThreadPool&) = delete;
+
+  /// \brief Main loop of each worker thread
+  void WorkerLoop();
+  /// \brief Process indices of the current loop until none are left
+  void RunTasks();
+
+  std::vector<std::thread> fThreads;
+
+  std::mutex fMutex;
+  std::condition_variable fStartCondition; ///< Signals a new loop or stop
+  std::condition_variable fDoneCondition;  ///< Signals a finished worker
+
+  const std::function<void(std::size_t)>* fTask; ///< Body of current loop
+  std::size_t fTaskSize;                   ///< Number of indices in loop
+  std::atomic<std::size_t> fNextIndex;     ///< Next index to be processed
+  std::size_t fBusyThreads;                ///< Workers still in this loop
+  unsigned long fGeneration;               ///< Counter of started loops
+  bool fStop;                              ///< Request to end the workers
+  std::vector<QwLogCapture> fLogs;         ///< Log output of each index
+};
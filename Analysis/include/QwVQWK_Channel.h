@@ -22,6 +22,7 @@
 // Qweak headers
 #include "VQwHardwareChannel.h"
 #include "MQwMockable.h"
+#include "QwADCDecoder.h"
 
 // Forward declarations
 class QwBlinder;
@@ -150,6 +151,8 @@ class QwVQWK_Channel: public VQwHardwareChannel, public MQwMockable {
   void  EncodeEventData(std::vector<UInt_t> &buffer) override;
   /// Decode the event data from a CODA buffer
   Int_t ProcessEvBuffer(UInt_t* buffer, UInt_t num_words_left, UInt_t index = 0) override;
+  /// Set the raw event data from the unpacked words of a CODA buffer
+  void  SetRawWords(const QwADCDecoder::VQWKWords& words);
   /// Process the event data according to pedestal and calibration factor
   void  ProcessEvent() override;
 
@@ -157,6 +160,7 @@ class QwVQWK_Channel: public VQwHardwareChannel, public MQwMockable {
   QwVQWK_Channel& operator=(const QwVQWK_Channel &value);
   void AssignScaledValue(const QwVQWK_Channel &value, Double_t scale);
   void AssignValueFrom(const VQwDataElement* valueptr) override;
+  void Snapshot(QwSnapshot& snapshot) override;
   void AddValueFrom(const VQwHardwareChannel* valueptr) override;
   void SubtractValueFrom(const VQwHardwareChannel* valueptr) override;
   void MultiplyBy(const VQwHardwareChannel* valueptr) override;
@@ -23,6 +23,7 @@
 #include "QwLog.h"
 #include "QwTypes.h"
 #include "MQwHistograms.h"
+#include "QwSnapshot.h"
 
 class QwParameterFile;
 class VQwHardwareChannel;
@@ -150,6 +151,13 @@ class VQwDataElement: public MQwHistograms {
     std::cerr << "Operation AssignValueFrom not defined!" << std::endl;
   };
 
+  /*! \brief Transfer the event-based data (as copied by operator=) to or
+   *         from a snapshot */
+  virtual void Snapshot(QwSnapshot& snapshot) {
+    snapshot.Transfer(fGoodEventCount);
+    snapshot.Transfer(fErrorFlag);
+  };
+
   /*! \brief Addition-assignment operator */
   VQwDataElement& operator+= (const VQwDataElement & /*value*/)
     { throw std::runtime_error(std::string("VQwDataElement::operator+= not implemented for ") + GetElementName().Data()); }
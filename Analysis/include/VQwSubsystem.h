@@ -120,7 +120,8 @@ class VQwSubsystem: virtual public VQwSubsystemCloneable, public MQwHistograms,
   : MQwHistograms(),
     MQwPublishable_child<QwSubsystemArray, VQwSubsystem>(),
     fSystemName(name), fEventTypeMask(0x0), fIsDataLoaded(kFALSE),
-    fCurrentROC_ID(-1), fCurrentBank_ID(-1) {
+    fCurrentROC_ID(-1), fCurrentBank_ID(-1),
+    fHintROC_ID(kNullROCID), fHintBank_ID(kNullBankID), fHintSubbankIndex(-1) {
     ClearAllBankRegistrations();
   }
   /// Copy constructor by object
@@ -130,7 +131,8 @@ class VQwSubsystem: virtual public VQwSubsystemCloneable, public MQwHistograms,
     fPublishList(orig.fPublishList),
     fROC_IDs(orig.fROC_IDs),
     fBank_IDs(orig.fBank_IDs),
-    fMarkerWords(orig.fMarkerWords)
+    fMarkerWords(orig.fMarkerWords),
+    fHintROC_ID(kNullROCID), fHintBank_ID(kNullBankID), fHintSubbankIndex(-1)
   {
     fSystemName = orig.fSystemName;
     fIsDataLoaded = orig.fIsDataLoaded;
@@ -498,8 +500,28 @@ class VQwSubsystem: virtual public VQwSubsystemCloneable, public MQwHistograms,
   /// Vector of marker words per ROC & subbank associated with this subsystem
   std::vector< std::vector< std::vector<UInt_t> > > fMarkerWords;
 
+ private:
+  ROCID_t  fHintROC_ID;       ///< ROC ID of the subbank index hint
+  BankID_t fHintBank_ID;      ///< Bank ID of the subbank index hint
+  Int_t    fHintSubbankIndex; ///< Subbank index of the hinted ROC/bank
+
  public:
   std::vector<ROCID_t> GetROCIds() const { return fROC_IDs; }
+  /// Subbanks registered for each ROC, in the order of GetROCIds()
+  const std::vector< std::vector<BankID_t> >& GetBankIds() const { return fBank_IDs; }
+
+  /// \brief Should this subsystem be offered banks it has not registered?
+  /// By default only subsystems without any ROC registration read all banks.
+  virtual Bool_t ReadsAllBanks() const { return fROC_IDs.empty(); }
+
+  /// \brief Subbank index of the next ROC/bank passed to ProcessEvBuffer
+  /// Set by the subsystem array from its dispatch table, so that the
+  /// following GetSubbankIndex call does not search the registrations.
+  void SetSubbankIndexHint(const ROCID_t roc_id, const BankID_t bank_id, const Int_t index) {
+    fHintROC_ID = roc_id;
+    fHintBank_ID = bank_id;
+    fHintSubbankIndex = index;
+  }
  protected:
 
   // Comparison of type
@@ -4,23 +4,57 @@
  */
 
 #include "MQwMockable.h"
+
+// System headers
+#include <algorithm>
+#include <cmath>
+
+// Qweak headers
 #include "QwParameterFile.h"
 
 // Randomness generator: Mersenne twister with period 2^19937 - 1
 //
 // This is defined as static to avoid getting stuck with 100% correlated
 // ADC channels when each channel goes through the same list of pseudo-
-// random numbers...
-boost::mt19937 MQwMockable::fRandomnessGenerator;
-boost::normal_distribution<double> MQwMockable::fNormalDistribution;
+// random numbers...  It is thread-local so that mock data can be generated
+// on several threads, each with its own stream (see SetRandomSeed).
+thread_local boost::random::mt19937_64 MQwMockable::fRandomnessGenerator;
+thread_local boost::normal_distribution<double> MQwMockable::fNormalDistribution;
 // The boost::variate_generator has operator() overloaded to get a new random
 // value according to the distribution in the second template argument, based
 // on the uniform random value generated by the first template argument.
 // For example: fNormalRandomVariable() will return a random normal variable.
-boost::variate_generator < boost::mt19937, boost::normal_distribution<double> >
+thread_local boost::variate_generator < boost::random::mt19937_64, boost::normal_distribution<double> >
   MQwMockable::fNormalRandomVariable(fRandomnessGenerator, fNormalDistribution);
 
 
+/**
+ * Reseed the random variable of the calling thread, e.g. at the start of
+ * every block of events in the mock data generator.  Seeding the full state
+ * of the Mersenne twister from a seed sequence gives independent streams
+ * for different (run, block) keys.
+ */
+void MQwMockable::SetRandomSeed(std::seed_seq& seed)
+{
+  fNormalRandomVariable.engine().seed(seed);
+  fNormalRandomVariable.distribution().reset();
+}
+
+/**
+ * Generate normal random values in one tight loop over the engine and the
+ * distribution of the calling thread, rather than through a call of the
+ * variate_generator for every value.  The values are the same as those of
+ * n successive calls of GetRandomValue.
+ */
+void MQwMockable::FillRandomValues(Double_t* values, std::size_t n)
+{
+  boost::random::mt19937_64& engine = fNormalRandomVariable.engine();
+  boost::normal_distribution<double>& distribution = fNormalRandomVariable.distribution();
+  for (std::size_t i = 0; i < n; i++)
+    values[i] = distribution(engine);
+}
+
+
 void MQwMockable::LoadMockDataParameters(QwParameterFile &paramfile){
   Bool_t   ldebug=kFALSE;
   Double_t asym=0.0, mean=0.0, sigma=0.0;
@@ -61,6 +95,7 @@ void MQwMockable::SetRandomEventDriftParameters(Double_t amplitude, Double_t pha
   fMockDriftAmplitude.clear();
   fMockDriftFrequency.clear();
   fMockDriftPhase.clear();
+  fMockDriftPhasor.clear();
   // Add new values
   fMockDriftAmplitude.push_back(amplitude);
   fMockDriftFrequency.push_back(frequency);
@@ -70,6 +105,7 @@ void MQwMockable::SetRandomEventDriftParameters(Double_t amplitude, Double_t pha
 
 void MQwMockable::AddRandomEventDriftParameters(Double_t amplitude, Double_t phase, Double_t frequency)
 {
+  fMockDriftPhasor.clear();
   // Add new values
   fMockDriftAmplitude.push_back(amplitude);
   fMockDriftFrequency.push_back(frequency);
@@ -101,3 +137,57 @@ Double_t MQwMockable::GetRandomValue(){
   return random_variable;
 }
 
+void MQwMockable::GetRandomValues(Double_t* values, std::size_t n)
+{
+  if (fUseExternalRandomVariable)
+    std::fill_n(values, n, fExternalRandomVariable);
+  else
+    FillRandomValues(values, n);
+}
+
+/**
+ * The drifts are evaluated as phasors exp(i*(2 pi f t + phase)).  When the
+ * time advances in equal steps, as in the mock data generator, the phasors
+ * are rotated by the precomputed phasor of the step instead of evaluating
+ * the sines.  They are evaluated exactly again after a different step and
+ * every kMockDriftResync steps, which bounds the rounding errors.
+ */
+Double_t MQwMockable::GetRandomEventDrift(Double_t time)
+{
+  std::size_t ndrift = fMockDriftFrequency.size();
+  if (ndrift == 0) return 0.0;
+
+  Double_t step = time - fMockDriftTime;
+  if (fMockDriftPhasor.size() == ndrift
+   && fMockDriftRotation.size() == ndrift
+   && fMockDriftSteps < kMockDriftResync
+   && std::fabs(step - fMockDriftStep) <= 1.0e-6 * std::fabs(fMockDriftStep)) {
+    // Same time step: rotate the phasors
+    for (std::size_t i = 0; i < ndrift; i++) {
+      // Plain complex product, without the checks for infinities
+      const std::complex<Double_t>& p = fMockDriftPhasor[i];
+      const std::complex<Double_t>& r = fMockDriftRotation[i];
+      fMockDriftPhasor[i] = std::complex<Double_t>(p.real() * r.real() - p.imag() * r.imag(),
+                                                   p.real() * r.imag() + p.imag() * r.real());
+    }
+    fMockDriftSteps++;
+  } else {
+    // Evaluate the phasors, and the rotation for this time step
+    Bool_t continued = (fMockDriftPhasor.size() == ndrift && step != 0.0);
+    fMockDriftPhasor.resize(ndrift);
+    fMockDriftRotation.clear();
+    for (std::size_t i = 0; i < ndrift; i++) {
+      fMockDriftPhasor[i] = std::polar(1.0, 2.0 * Qw::pi * fMockDriftFrequency[i] * time + fMockDriftPhase[i]);
+      if (continued)
+        fMockDriftRotation.push_back(std::polar(1.0, 2.0 * Qw::pi * fMockDriftFrequency[i] * step));
+    }
+    fMockDriftStep = step;
+    fMockDriftSteps = 0;
+  }
+  fMockDriftTime = time;
+
+  Double_t drift = 0.0;
+  for (std::size_t i = 0; i < ndrift; i++)
+    drift += fMockDriftAmplitude[i] * fMockDriftPhasor[i].imag();
+  return drift;
+}
@@ -248,10 +248,7 @@ void QwADC18_Channel::ClearEventData()
 void QwADC18_Channel::RandomizeEventData(int helicity, double time)
 {
   // Calculate drift (if time is not specified, it stays constant at zero)
-  Double_t drift = 0.0;
-  for (UInt_t i = 0; i < fMockDriftFrequency.size(); i++) {
-    drift += fMockDriftAmplitude[i] * sin(2.0 * Qw::pi * fMockDriftFrequency[i] * time + fMockDriftPhase[i]);
-  }
+  Double_t drift = GetRandomEventDrift(time);
 
   Double_t value = fMockGaussianMean * (1 + helicity * fMockAsymmetry)
     + fMockGaussianSigma * GetRandomValue()
@@ -557,14 +554,14 @@ void  QwADC18_Channel::FillHistograms()
 	if(fDataToSave==kRaw)
 	  {
 	    if (fHistograms[index] != NULL && (fErrorFlag)==0)
-	      fHistograms[index++]->Fill(GetValue());
+	      FillHistogram(index++, GetValue());
 	    if (fHistograms[index] != NULL && (fErrorFlag)==0)
-	      fHistograms[index++]->Fill(GetRawValue());
+	      FillHistogram(index++, GetRawValue());
 	  }
 	else if(fDataToSave==kDerived)
 	  {
 	    if (fHistograms[index] != NULL && (fErrorFlag)==0)
-	      fHistograms[index++]->Fill(GetValue());
+	      FillHistogram(index++, GetValue());
 	  }
     }
 }
@@ -596,7 +593,7 @@ void  QwADC18_Channel::ConstructBranchAndVector(TTree *tree, TString &prefix, Qw
 
     fTreeArrayNumEntries = values.size() - fTreeArrayIndex;
     if (gQwHists.MatchDeviceParamsFromList(basename.Data()))
-      tree->Branch(basename, &(values[fTreeArrayIndex]), values.LeafList(fTreeArrayIndex).c_str());
+      tree->Branch(basename, &(values[fTreeArrayIndex]), values.LeafList(fTreeArrayIndex, basename.Data()).c_str());
   }
 }
 
@@ -748,6 +745,21 @@ QwADC18_Channel& QwADC18_Channel::operator= (const QwADC18_Channel &value)
   return *this;
 }
 
+/// Transfer the same event-based data as operator= to or from a snapshot
+void QwADC18_Channel::Snapshot(QwSnapshot& snapshot)
+{
+  if (!IsNameEmpty()) {
+    VQwHardwareChannel::Snapshot(snapshot);
+    snapshot.Transfer(fDiff_Raw);
+    snapshot.Transfer(fPeak_Raw);
+    snapshot.Transfer(fBase_Raw);
+    snapshot.Transfer(fValue_Raw);
+    snapshot.Transfer(fValue);
+    snapshot.Transfer(fValueError);
+    snapshot.Transfer(fValueM2);
+  }
+}
+
 void QwADC18_Channel::AssignScaledValue(const QwADC18_Channel &value,
 				 Double_t scale)
 {
@@ -0,0 +1,203 @@
+/*!
+ * \file   QwADCDecoder.cc
+ * \brief  Batch decoding of the raw data words of Moller ADC and VQWK channels
+ */
+
+#include "QwADCDecoder.h"
+
+//  The instruction set follows the build flags; defining
+//  QW_ADC_DECODER_SCALAR selects the scalar code in any build (the batch
+//  decoder test compares all variants against the scalar code).
+#if ! defined(QW_ADC_DECODER_SCALAR)
+#if defined(__AVX2__)
+#define QW_ADC_DECODER_AVX2
+#elif defined(__ARM_NEON)
+#define QW_ADC_DECODER_NEON
+#endif
+#endif
+
+// System headers
+#if defined(QW_ADC_DECODER_AVX2)
+#include <immintrin.h>
+#elif defined(QW_ADC_DECODER_NEON)
+#include <arm_neon.h>
+#endif
+
+/**
+ * Unpack the data of one Moller ADC channel.  Each of the four blocks
+ * takes five words (sum, low and high word of the sum of squares, minimum
+ * and maximum), followed by the hardware sum in word 20.  The upper 16 bits
+ * of word 25 are the number of samples, and the upper 8 of the lower 16
+ * bits are the sequence number.
+ * @param buffer First word of the channel
+ * @param words  Unpacked data
+ */
+void QwADCDecoder::DecodeMollerADC(const UInt_t* buffer, MollerADCWords& words)
+{
+  // The conversion from UInt_t to Double_t discards the sign, so the words
+  // are converted to Int_t first.
+  for (Int_t i = 0; i < kBlocks; i++) {
+    words.fBlock_raw[i] = static_cast<Int_t>(buffer[i*5]);
+    words.fBlockSumSq_raw[i] = static_cast<Int_t>(buffer[i*5+1]);
+    words.fBlockSumSq_raw[i] += Long64_t(static_cast<Int_t>(buffer[i*5+2])) << 32;
+    words.fBlock_min[i] = static_cast<Int_t>(buffer[i*5+3]);
+    words.fBlock_max[i] = static_cast<Int_t>(buffer[i*5+4]);
+  }
+  words.fHardwareBlockSum_raw = static_cast<Int_t>(buffer[20]);
+  words.fSequenceNumber  = (buffer[25]>>8)  & 0xFF;
+  words.fNumberOfSamples = (buffer[25]>>16) & 0xFFFF;
+}
+
+/**
+ * Unpack the data of many Moller ADC channels in a bank.  With AVX2, the
+ * blocks of two channels are gathered into one vector per quantity.
+ * @param buffer    First word of the bank
+ * @param offsets   Word offset of each channel in the bank
+ * @param nchannels Number of channels
+ * @param words     Unpacked data, one entry per channel
+ */
+void QwADCDecoder::DecodeMollerADC(const UInt_t* buffer, const UInt_t* offsets,
+                                   std::size_t nchannels, MollerADCWords* words)
+{
+  std::size_t ch = 0;
+#if defined(QW_ADC_DECODER_AVX2)
+  const int* base = reinterpret_cast<const int*>(buffer);
+  for (; ch + 1 < nchannels; ch += 2) {
+    const Int_t o0 = offsets[ch], o1 = offsets[ch+1];
+    const __m256i sum = _mm256_setr_epi32(o0, o0+5, o0+10, o0+15,
+                                          o1, o1+5, o1+10, o1+15);
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i sumsq_lo = _mm256_add_epi32(sum, one);
+    const __m256i sumsq_hi = _mm256_add_epi32(sumsq_lo, one);
+    const __m256i min = _mm256_add_epi32(sumsq_hi, one);
+    const __m256i max = _mm256_add_epi32(min, one);
+
+    const __m256i block = _mm256_i32gather_epi32(base, sum, 4);
+    const __m256i block_min = _mm256_i32gather_epi32(base, min, 4);
+    const __m256i block_max = _mm256_i32gather_epi32(base, max, 4);
+    const __m256i lo = _mm256_i32gather_epi32(base, sumsq_lo, 4);
+    const __m256i hi = _mm256_i32gather_epi32(base, sumsq_hi, 4);
+
+    MollerADCWords& w0 = words[ch];
+    MollerADCWords& w1 = words[ch+1];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(w0.fBlock_raw), _mm256_castsi256_si128(block));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(w1.fBlock_raw), _mm256_extracti128_si256(block, 1));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(w0.fBlock_min), _mm256_castsi256_si128(block_min));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(w1.fBlock_min), _mm256_extracti128_si256(block_min, 1));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(w0.fBlock_max), _mm256_castsi256_si128(block_max));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(w1.fBlock_max), _mm256_extracti128_si256(block_max, 1));
+
+    //  Sign extend both words to 64 bits, and add the shifted high word
+    const __m256i sumsq0 = _mm256_add_epi64(
+        _mm256_cvtepi32_epi64(_mm256_castsi256_si128(lo)),
+        _mm256_slli_epi64(_mm256_cvtepi32_epi64(_mm256_castsi256_si128(hi)), 32));
+    const __m256i sumsq1 = _mm256_add_epi64(
+        _mm256_cvtepi32_epi64(_mm256_extracti128_si256(lo, 1)),
+        _mm256_slli_epi64(_mm256_cvtepi32_epi64(_mm256_extracti128_si256(hi, 1)), 32));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(w0.fBlockSumSq_raw), sumsq0);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(w1.fBlockSumSq_raw), sumsq1);
+
+    w0.fHardwareBlockSum_raw = static_cast<Int_t>(buffer[o0+20]);
+    w1.fHardwareBlockSum_raw = static_cast<Int_t>(buffer[o1+20]);
+    w0.fSequenceNumber  = (buffer[o0+25]>>8)  & 0xFF;
+    w0.fNumberOfSamples = (buffer[o0+25]>>16) & 0xFFFF;
+    w1.fSequenceNumber  = (buffer[o1+25]>>8)  & 0xFF;
+    w1.fNumberOfSamples = (buffer[o1+25]>>16) & 0xFFFF;
+  }
+#endif
+  for (; ch < nchannels; ch++)
+    DecodeMollerADC(buffer + offsets[ch], words[ch]);
+}
+
+/**
+ * Unpack the data of one VQWK channel: four block sums, the hardware sum,
+ * and the number of samples and sequence number in the same format as for
+ * the Moller ADC.
+ * @param buffer First word of the channel
+ * @param words  Unpacked data
+ */
+void QwADCDecoder::DecodeVQWK(const UInt_t* buffer, VQWKWords& words)
+{
+  for (Int_t i = 0; i < kBlocks; i++) {
+    words.fBlock_raw[i] = static_cast<Int_t>(buffer[i]);
+  }
+  words.fHardwareBlockSum_raw = static_cast<Int_t>(buffer[4]);
+  words.fSequenceNumber  = (buffer[5]>>8)  & 0xFF;
+  words.fNumberOfSamples = (buffer[5]>>16) & 0xFFFF;
+}
+
+/**
+ * Unpack the data of many VQWK channels in a bank.  The hardware sums and
+ * status words of eight (AVX2) or four (NEON) channels are unpacked
+ * together.
+ * @param buffer    First word of the bank
+ * @param offsets   Word offset of each channel in the bank
+ * @param nchannels Number of channels
+ * @param words     Unpacked data, one entry per channel
+ */
+void QwADCDecoder::DecodeVQWK(const UInt_t* buffer, const UInt_t* offsets,
+                              std::size_t nchannels, VQWKWords* words)
+{
+  std::size_t ch = 0;
+#if defined(QW_ADC_DECODER_AVX2)
+  const int* base = reinterpret_cast<const int*>(buffer);
+  const __m256i seqmask = _mm256_set1_epi32(0xFF);
+  const __m256i samplemask = _mm256_set1_epi32(0xFFFF);
+  alignas(32) Int_t  hwsum[8];
+  alignas(32) UInt_t sequence[8];
+  alignas(32) UInt_t samples[8];
+  for (; ch + 7 < nchannels; ch += 8) {
+    const __m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(offsets + ch));
+    const __m256i status = _mm256_i32gather_epi32(base, _mm256_add_epi32(first, _mm256_set1_epi32(5)), 4);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(hwsum),
+        _mm256_i32gather_epi32(base, _mm256_add_epi32(first, _mm256_set1_epi32(4)), 4));
+    _mm256_store_si256(reinterpret_cast<__m256i*>(sequence),
+        _mm256_and_si256(_mm256_srli_epi32(status, 8), seqmask));
+    _mm256_store_si256(reinterpret_cast<__m256i*>(samples),
+        _mm256_and_si256(_mm256_srli_epi32(status, 16), samplemask));
+    for (Int_t i = 0; i < 8; i++) {
+      VQWKWords& w = words[ch+i];
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(w.fBlock_raw),
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer + offsets[ch+i])));
+      w.fHardwareBlockSum_raw = hwsum[i];
+      w.fSequenceNumber  = sequence[i];
+      w.fNumberOfSamples = samples[i];
+    }
+  }
+#elif defined(QW_ADC_DECODER_NEON)
+  const uint32x4_t seqmask = vdupq_n_u32(0xFF);
+  const uint32x4_t samplemask = vdupq_n_u32(0xFFFF);
+  UInt_t status[4];
+  UInt_t sequence[4];
+  UInt_t samples[4];
+  for (; ch + 3 < nchannels; ch += 4) {
+    for (Int_t i = 0; i < 4; i++) {
+      const UInt_t* channel = buffer + offsets[ch+i];
+      VQWKWords& w = words[ch+i];
+      vst1q_s32(w.fBlock_raw, vld1q_s32(reinterpret_cast<const int32_t*>(channel)));
+      w.fHardwareBlockSum_raw = static_cast<Int_t>(channel[4]);
+      status[i] = channel[5];
+    }
+    const uint32x4_t st = vld1q_u32(status);
+    vst1q_u32(sequence, vandq_u32(vshrq_n_u32(st, 8), seqmask));
+    vst1q_u32(samples, vandq_u32(vshrq_n_u32(st, 16), samplemask));
+    for (Int_t i = 0; i < 4; i++) {
+      words[ch+i].fSequenceNumber  = sequence[i];
+      words[ch+i].fNumberOfSamples = samples[i];
+    }
+  }
+#endif
+  for (; ch < nchannels; ch++)
+    DecodeVQWK(buffer + offsets[ch], words[ch]);
+}
+
+const char* QwADCDecoder::GetInstructionSet()
+{
+#if defined(QW_ADC_DECODER_AVX2)
+  return "AVX2";
+#elif defined(QW_ADC_DECODER_NEON)
+  return "NEON";
+#else
+  return "scalar";
+#endif
+}
@@ -9,6 +9,11 @@
 #include <iostream>
 #include <fstream>
 #include <cmath>
+#include <cctype>
+#include <cstring>
+#include <algorithm>
+#include <charconv>
+#include <string_view>
 
 // ROOT headers
 #include "TObject.h"
@@ -190,7 +195,7 @@ void QwEPICSEvent::ConstructBranchAndVector(TTree *tree, TString& prefix, QwRoot
     	values.push_back(name.Data(), 'D');
 
     	// Create branch
-    	tree->Branch(name, &(values[treeindex]), values.LeafList(treeindex).c_str());
+    	tree->Branch(name, &(values[treeindex]), values.LeafList(treeindex, name.Data()).c_str());
         treeindex++;
 
     } else {
@@ -300,6 +305,13 @@ Int_t QwEPICSEvent::AddEPICSTag(
 {
   fEPICSVariableList.push_back(tag);
   fEPICSVariableMap[tag] = fEPICSVariableList.size() - 1;
+  // Keep the sorted tag list in step with the map
+  auto sorted = std::lower_bound(fEPICSSortedTags.begin(), fEPICSSortedTags.end(), tag,
+      [](const std::pair<std::string,Int_t>& entry, const string& key) { return entry.first < key; });
+  if (sorted != fEPICSSortedTags.end() && sorted->first == tag)
+    sorted->second = fEPICSVariableList.size() - 1;
+  else
+    fEPICSSortedTags.insert(sorted, std::make_pair(tag, Int_t(fEPICSVariableList.size() - 1)));
   fEPICSTableList.push_back(table);
   fEPICSVariableType.push_back(datatype);
   fNumberEPICSVariables++;
@@ -388,29 +400,61 @@ void QwEPICSEvent::CalculateRunningValues()
 
 void QwEPICSEvent::ExtractEPICSValues(const string& data, int event)
 {
-  /* This routine will decode the input string, which holds the  *
-   * epics buffer and extract the EPICS values from it.          */
+  ExtractEPICSValues(data.data(), data.size(), event);
+}
 
+/**
+ * Decode an EPICS string bank and extract the values of the known tags.
+ * Each line holds a tag and a value, separated by spaces or tabs.  The
+ * lines are tokenized in place, with the same rules as QwParameterFile
+ * (TrimWhitespace and HasVariablePair), and the bank ends at the first
+ * null character or after length characters.
+ * @param data   Start of the string bank
+ * @param length Maximum number of characters in the bank
+ * @param event  Event number
+ */
+void QwEPICSEvent::ExtractEPICSValues(const char* data, std::size_t length, int event)
+{
   if (kDebug == 1) std::cout <<"Here we are, entering 'ExtractEPICSValues'!!"<<std::endl;
 
   for (size_t tagindex = 0; tagindex < fEPICSVariableList.size(); tagindex++) {
     fEPICSDataEvent[tagindex].Filled = kFALSE;
   }
 
-  // Convert the input stream into a stringstream so we can
-  // do manipulation on it just like reading a file
-  std::stringstream ss(data, std::stringstream::in | std::stringstream::out);
-  QwParameterFile file(ss);
-  while (file.ReadNextLine()) {
-    file.TrimWhitespace();
-    string varname, varvalue;
-    if (file.HasVariablePair(" \t\n", varname, varvalue)) {
-      Int_t tagindex = FindIndex(varname);
+  auto is_whitespace = [](char c) { return c == ' ' || c == '\t' || c == '\r'; };
+  auto is_separator  = [](char c) { return c == ' ' || c == '\t'; };
+
+  const char* end = data + length;
+  const char* null = static_cast<const char*>(std::memchr(data, '\0', length));
+  if (null != NULL) end = null;
+
+  const char* line = data;
+  while (line < end) {
+    const char* eol = static_cast<const char*>(std::memchr(line, '\n', end - line));
+    if (eol == NULL) eol = end;
+    const char* next = eol + 1;
+
+    // Trim whitespace
+    const char* begin = line;
+    while (begin < eol && is_whitespace(*begin)) begin++;
+    while (eol > begin && is_whitespace(*(eol - 1))) eol--;
+
+    // Split into tag and value at the first separator
+    const char* sep = begin;
+    while (sep < eol && ! is_separator(*sep)) sep++;
+    if (sep < eol) {
+      const char* name_end = sep;
+      while (name_end > begin && is_whitespace(*(name_end - 1))) name_end--;
+      const char* value = sep;
+      while (value < eol && is_whitespace(*value)) value++;
+
+      Int_t tagindex = FindIndex(begin, name_end - begin);
       if (tagindex != kEPICS_Error) {
-        SetDataValue(tagindex, varvalue, event);
+        SetDataValue(tagindex, value, eol, event);
         SetDataLoaded(kTRUE);
       }
     }
+    line = next;
   }
   if (fIsDataLoaded) {
     //  Determine the WienMode and save it.
@@ -419,6 +463,20 @@ void QwEPICSEvent::ExtractEPICSValues(const string& data, int event)
 }
 
 
+Int_t QwEPICSEvent::FindIndex(const char* tag, std::size_t length) const
+{
+  const std::string_view key(tag, length);
+  auto match = std::lower_bound(fEPICSSortedTags.begin(), fEPICSSortedTags.end(), key,
+      [](const std::pair<std::string,Int_t>& entry, const std::string_view& k) { return std::string_view(entry.first) < k; });
+  if (match != fEPICSSortedTags.end() && std::string_view(match->first) == key)
+    // A match was found
+    return match->second;
+  else
+    // Otherwise return error
+    return kEPICS_Error;
+}
+
+
 Int_t QwEPICSEvent::FindIndex(const string& tag) const
 {
   // Find a match for the tag
@@ -568,6 +626,43 @@ int QwEPICSEvent::SetDataValue(int index, const string& value, const int event)
   return kEPICS_Error;
 }
 
+/**
+ * Set a value from a range of characters, with the same conversions as
+ * SetDataValue(int, const string&, int): numbers are converted like atof
+ * and atol, i.e. up to the first character that does not fit.
+ */
+int QwEPICSEvent::SetDataValue(int index, const char* begin, const char* end, const int event)
+{
+  if (index == kEPICS_Error) return kEPICS_Error;
+  if (index < 0)             return kEPICS_Error;
+
+  if (fEPICSVariableType[index] == kEPICSString) {
+    fEPICSDataEvent[index].EventNumber = event;
+    fEPICSDataEvent[index].Value       = 0.0;
+    fEPICSDataEvent[index].StringValue = TString(begin, end - begin);
+    fEPICSDataEvent[index].Filled      = kTRUE;
+    return 0;
+  }
+
+  Double_t tmpvalue = kInvalidEPICSData;
+  if (IsNumber(begin, end)) {
+    // from_chars does not accept a leading plus sign, atof and atol do
+    const char* first = begin;
+    if (end - begin > 1 && *begin == '+' && (std::isdigit(begin[1]) || begin[1] == '.'))
+      first = begin + 1;
+    if (fEPICSVariableType[index] == kEPICSFloat) {
+      Double_t value = 0.0;
+      if (std::from_chars(first, end, value).ec == std::errc()) tmpvalue = value;
+      else tmpvalue = 0.0;
+    } else {
+      Long_t value = 0;
+      if (std::from_chars(first, end, value).ec == std::errc()) tmpvalue = Double_t(value);
+      else tmpvalue = 0.0;
+    }
+  }
+  return SetDataValue(index, tmpvalue, event);
+}
+
 void QwEPICSEvent::PrintAverages() const
 {
   Double_t mean     = 0.0;
@@ -13,7 +13,9 @@
 #include <TMath.h>
 
 #include <vector>
+#include <algorithm>
 #include <glob.h>
+#include <sys/stat.h>
 
 #include <csignal>
 Bool_t globalEXIT;
@@ -32,6 +34,7 @@ void sigusr_handler(int sig)
 }
 
 #include "THaCodaFile.h"
+#include "THaCodaMappedFile.h"
 #ifdef __CODA_ET
 #include "THaEtClient.h"
 #endif
@@ -51,11 +54,22 @@ const UInt_t QwEventBuffer::kNullDataWord = 0x4e554c4c;
 
 /// Default constructor
 QwEventBuffer::QwEventBuffer()
-  :    fRunListFile(nullptr),
+  :    fAllowLowSubbankIDs(kFALSE),
+       fMapDataFiles(kFALSE),
+       fUseEventIndex(kFALSE),
+       fReadAheadDepth(0),
+       fRunListFile(nullptr),
        fEventListFile(nullptr),
        fDataFileStem(fDefaultDataFileStem),
        fDataFileExtension(fDefaultDataFileExtension),
        fDataDirectory(fDefaultDataDirectory),
+       fEventIndexCursor(0),
+       fHasEventIndex(kFALSE),
+       fBuildEventIndex(kFALSE),
+       fEventIndexStored(0),
+       fReadAheadCurrent(nullptr),
+       fReadAheadStatus(CODA_OK),
+       fReadAheadRunning(kFALSE),
        fEvStreamMode(fEvStreamNull),
        fEvStream(NULL),
        fCurrentRun(-1),
@@ -74,6 +88,9 @@ QwEventBuffer::QwEventBuffer()
   fCleanParameter[0] = 0.0;
   fCleanParameter[1] = 0.0;
   fCleanParameter[2] = 0.0;
+
+  fThisMarkerList = nullptr;
+  fThisOffsetList = nullptr;
 }
 
 /**
@@ -109,6 +126,15 @@ void QwEventBuffer::DefineOptions(QwOptions &options)
   options.AddDefaultOptions()
     ("chainfiles", po::value<bool>()->default_bool_value(false),
      "chain file segments together, do not analyze them separately");
+  options.AddDefaultOptions()
+    ("codafile-mmap", po::value<bool>()->default_bool_value(false),
+     "read CODA files through a memory mapping instead of the EVIO library");
+  options.AddDefaultOptions()
+    ("codafile-index", po::value<bool>()->default_bool_value(false),
+     "use (and create) event index files next to the CODA files to skip directly to the event range; requires codafile-mmap");
+  options.AddDefaultOptions()
+    ("codafile-readahead", po::value<int>()->default_value(0),
+     "number of CODA file events to read ahead on a separate thread (0 disables read-ahead)");
   options.AddDefaultOptions()
     ("codafile-stem", po::value<string>()->default_value(fDefaultDataFileStem),
      "stem of the input CODA filename");
@@ -208,21 +234,26 @@ void QwEventBuffer::ProcessOptions(QwOptions &options)
   fSegmentRange = options.GetIntValuePair("segment");
   fRunListFileName = options.GetValue<string>("runlist");
   fChainDataFiles = options.GetValue<bool>("chainfiles");
+  fMapDataFiles = options.GetValue<bool>("codafile-mmap");
+  fUseEventIndex = options.GetValue<bool>("codafile-index");
+  if (fUseEventIndex && ! fMapDataFiles) {
+    QwWarning << "The option codafile-index requires codafile-mmap; "
+              << "no event index will be used." << QwLog::endl;
+    fUseEventIndex = kFALSE;
+  }
+  fReadAheadDepth = options.GetValue<int>("codafile-readahead");
+  if (fReadAheadDepth < 0) fReadAheadDepth = 0;
   fDataFileStem = options.GetValue<string>("codafile-stem");
   fDataFileExtension = options.GetValue<string>("codafile-ext");
 	fDataVersion = options.GetValue<int>("coda-version");
-	
-	if(fDataVersion == 2){
-		decoder = new Coda2EventDecoder();
-	} else if(fDataVersion == 3) {
-		decoder = new Coda3EventDecoder();
-	} else{
+	fAllowLowSubbankIDs = options.GetValue<bool>("allow-low-subbank-ids");
+
+	decoder = CreateDecoder();
+	if(decoder == nullptr){
 		QwError << "Invalid Coda Version. Only versions 2 and 3 are supported. "
 						<< "Please set using --coda-version 2(3)" << QwLog::endl;
     exit(EXIT_FAILURE);
 	}
-	
-	decoder->SetAllowLowSubbankIDs( options.GetValue<bool>("allow-low-subbank-ids") );
 
   // Open run list file
   /* runlist file format example:
@@ -349,7 +380,8 @@ Int_t QwEventBuffer::ReOpenStream()
     // Online stream
     status = OpenETStream(fETHostname, fETSession, fETWaitMode, fETStationName);
   } else {
-    // Offline data file
+    // Offline data file: keep the part of the index built so far
+    if (fBuildEventIndex) WriteEventIndex(kFALSE);
     if (fRunIsSegmented)
       // Segmented
       status = OpenNextSegment();
@@ -501,6 +533,32 @@ Int_t QwEventBuffer::GetNextEvent()
 }
 
 
+/**
+ * Advance to the next EPICS event.  With an event index, the events before
+ * it are skipped without being read.
+ */
+Int_t QwEventBuffer::GetNextEPICSEvent()
+{
+  Int_t status = CODA_OK;
+  do {
+    if (fHasEventIndex) {
+      std::size_t n = fEventIndex.GetNumberOfEntries();
+      std::size_t next = fEventIndex.FindSpecialEvent(QwEventIndex::kEPICSEvent,
+                                                      fEventIndexCursor);
+      if (next < n) {
+        SeekEventIndex(next);
+      } else if (fEventIndex.IsComplete()) {
+        return EOF;
+      } else if (fEventIndexCursor + 1 < n) {
+        //  Not in the part covered by the index: continue reading after it
+        SeekEventIndex(n - 1);
+      }
+    }
+    status = GetNextEvent();
+  } while (status == CODA_OK && ! IsEPICSEvent());
+  return status;
+}
+
 Int_t QwEventBuffer::GetEvent()
 {
   Int_t status = kFileHandleNotConfigured;
@@ -512,11 +570,14 @@ Int_t QwEventBuffer::GetEvent()
   }
   if (status == CODA_OK){
     // Coda Data was loaded correctly
-    UInt_t* evBuffer = (UInt_t*)fEvStream->getEvBuffer();
+    UInt_t* evBuffer = GetEvBuffer();
 	if(fDataVersionVerify == 0){ // Default = 0 => Undetermined
 		VerifyCodaVersion(evBuffer);
 	}
 	decoder->DecodeEventIDBank(evBuffer);
+    //  Only events past the end of a partial index are new to it
+    if (fBuildEventIndex && fEventIndexCursor > fEventIndex.GetNumberOfEntries())
+      AddEventIndexEntry();
   }
   return status;
 }
@@ -558,7 +619,14 @@ Int_t QwEventBuffer::GetFileEvent(){
   //  next segment and read a new event; repeat
   //  if needed.
   do {
-    status = fEvStream->codaRead();
+    if (fHasEventIndex) SkipEventsWithIndex();
+    if (UseReadAhead())
+      status = GetReadAheadEvent();
+    else
+      status = fEvStream->codaRead();
+    if (status == CODA_OK && (fHasEventIndex || fBuildEventIndex))
+      fEventIndexCursor++;
+    if (status == EOF && fBuildEventIndex) WriteEventIndex(kTRUE);
     if (fChainDataFiles && status == EOF){
       CloseThisSegment();
       //  Crash out of the loop if we can't open the
@@ -569,6 +637,78 @@ Int_t QwEventBuffer::GetFileEvent(){
   return status;
 }
 
+/**
+ * Get the next file event from the read-ahead thread, starting the thread
+ * for the open file if needed.  The thread only reads the open file; at
+ * the end of the file it stops, and the caller moves on to the next
+ * segment or file on this thread as without read-ahead.
+ * @return Status of the file stream
+ */
+Int_t QwEventBuffer::GetReadAheadEvent()
+{
+  //  Return the buffer of the previous event to the reader
+  if (fReadAheadCurrent != nullptr) {
+    fReadAheadFree.Push(fReadAheadCurrent);
+    fReadAheadCurrent = nullptr;
+  }
+  if (! fReadAheadRunning) StartReadAhead();
+
+  fReadAheadCurrent = fReadAheadReady.Pop();
+  if (fReadAheadCurrent == nullptr) {
+    //  The reader stopped; its status is visible after the join
+    StopReadAhead();
+    return fReadAheadStatus;
+  }
+  return CODA_OK;
+}
+
+void QwEventBuffer::StartReadAhead()
+{
+  if (fReadAheadEvents.size() != size_t(fReadAheadDepth))
+    fReadAheadEvents.resize(fReadAheadDepth);
+  fReadAheadFree.Reset();
+  fReadAheadReady.Reset();
+  for (auto& event: fReadAheadEvents) fReadAheadFree.Push(&event);
+
+  fReadAheadStatus = CODA_OK;
+  fReadAheadRunning = kTRUE;
+  fReadAheadThread = std::thread(&QwEventBuffer::ReadAheadLoop, this);
+}
+
+/**
+ * Stop the read-ahead thread and discard the events it has read.  This
+ * must be called before the file stream is closed, reopened or moved.
+ */
+void QwEventBuffer::StopReadAhead()
+{
+  fReadAheadCurrent = nullptr;
+  if (! fReadAheadRunning) return;
+
+  fReadAheadFree.Close(true);
+  fReadAheadReady.Close(true);
+  if (fReadAheadThread.joinable()) fReadAheadThread.join();
+  fReadAheadRunning = kFALSE;
+}
+
+/**
+ * Reader thread: copy the events of the open file into free buffers.
+ * Only this thread touches the file stream while read-ahead is running.
+ */
+void QwEventBuffer::ReadAheadLoop()
+{
+  Int_t status = CODA_OK;
+  RawEvent* event;
+  while ((event = fReadAheadFree.Pop()) != nullptr) {
+    status = fEvStream->codaRead();
+    if (status != CODA_OK) break;
+    const UInt_t *localbuff = (const UInt_t*)(fEvStream->getEvBuffer());
+    event->fWords.assign(localbuff, localbuff + localbuff[0] + 1);
+    fReadAheadReady.Push(event);
+  }
+  fReadAheadStatus = status;
+  fReadAheadReady.Close();
+}
+
 Int_t QwEventBuffer::GetEtEvent(){
   Int_t status = CODA_OK;
   //  Do we want to have any loop here to wait for a bad
@@ -611,6 +751,16 @@ Int_t QwEventBuffer::EncodeSubsystemData(QwSubsystemArray &subsystems)
   std::vector<ROCID_t> ROCList;
   subsystems.EncodeEventData(buffer);
   subsystems.GetROCIDList(ROCList);
+  return EncodeSubsystemData(buffer, ROCList);
+}
+
+/**
+ * Add the CODA event header to the encoded data of the subsystems, and write
+ * the event.  The data can be encoded on another thread, but the events have
+ * to be written in order since the header carries the event number.
+ */
+Int_t QwEventBuffer::EncodeSubsystemData(const std::vector<UInt_t> &buffer, std::vector<ROCID_t> &ROCList)
+{
   // Add CODA event header
  	std::vector<UInt_t> header = decoder->EncodePHYSEventHeader(ROCList);
 
@@ -700,6 +850,35 @@ Int_t QwEventBuffer::EncodeEndEvent()
 void QwEventBuffer::ResetFlags(){
 }
 
+/**
+ * Create a decoder for the CODA version selected in the options.  The
+ * caller owns the returned decoder; returns nullptr for unsupported versions.
+ */
+VEventDecoder* QwEventBuffer::CreateDecoder() const
+{
+  VEventDecoder* evdecoder = nullptr;
+  if (fDataVersion == 2) {
+    evdecoder = new Coda2EventDecoder();
+  } else if (fDataVersion == 3) {
+    evdecoder = new Coda3EventDecoder();
+  }
+  if (evdecoder != nullptr)
+    evdecoder->SetAllowLowSubbankIDs(fAllowLowSubbankIDs);
+  return evdecoder;
+}
+
+/**
+ * Copy the current event buffer, together with the run and segment number
+ * of the stream, so that it can be decoded after the next event was read.
+ */
+void QwEventBuffer::CopyCurrentEvent(RawEvent &event) const
+{
+  const UInt_t *localbuff = GetEvBuffer();
+  event.fWords.assign(localbuff, localbuff + localbuff[0] + 1);
+  event.fRunNumber = fCurrentRun;
+  event.fSegmentNumber = fRunIsSegmented? *fRunSegmentIterator: 0;
+}
+
 Bool_t QwEventBuffer::FillSubsystemConfigurationData(QwSubsystemArray &subsystems)
 {
   ///  Passes the data for the configuration events into each subsystem
@@ -708,26 +887,44 @@ Bool_t QwEventBuffer::FillSubsystemConfigurationData(QwSubsystemArray &subsystem
   ///  NOTE TO DAQ PROGRAMMERS:
   ///      The configuration event for a ROC must have the same
   ///      subbank structure as the physics events for that ROC.
+  UInt_t *localbuff = GetEvBuffer();
+  return FillSubsystemConfigurationData(subsystems, localbuff, *decoder);
+}
+
+/// Fill the configuration data from a copy of an event, using a decoder
+/// private to the calling thread.
+Bool_t QwEventBuffer::FillSubsystemConfigurationData(QwSubsystemArray &subsystems,
+                                                     RawEvent &event,
+                                                     VEventDecoder &evdecoder)
+{
+  if (event.fWords.empty()) return kFALSE;
+  evdecoder.DecodeEventIDBank(event.fWords.data());
+  return FillSubsystemConfigurationData(subsystems, event.fWords.data(), evdecoder);
+}
+
+Bool_t QwEventBuffer::FillSubsystemConfigurationData(QwSubsystemArray &subsystems,
+                                                     UInt_t *localbuff,
+                                                     VEventDecoder &evdecoder)
+{
   Bool_t okay = kTRUE;
-  UInt_t rocnum = decoder->GetEvtType() - 0x90;
+  UInt_t rocnum = evdecoder.GetEvtType() - 0x90;
   QwMessage << "QwEventBuffer::FillSubsystemConfigurationData:  "
 	    << "Found configuration event for ROC"
 	    << rocnum
 	    << QwLog::endl;
-	decoder->PrintDecoderInfo(QwMessage);
+	evdecoder.PrintDecoderInfo(QwMessage);
   //  Loop through the data buffer in this event.
-  UInt_t *localbuff = (UInt_t*)(fEvStream->getEvBuffer());
-	decoder->DecodeEventIDBank(localbuff);
-  while ((okay = decoder->DecodeSubbankHeader(&localbuff[decoder->GetWordsSoFar()]))){
+	evdecoder.DecodeEventIDBank(localbuff);
+  while ((okay = evdecoder.DecodeSubbankHeader(&localbuff[evdecoder.GetWordsSoFar()]))){
     //  If this bank has further subbanks, restart the loop.
-    if (decoder->GetSubbankType() == 0x10) {
+    if (evdecoder.GetSubbankType() == 0x10) {
       QwMessage << "This bank has further subbanks, restart the loop" << QwLog::endl;
       continue;
     }
     //  If this bank only contains the word 'NULL' then skip
     //  this bank.
-    if (decoder->GetFragLength()==1 && localbuff[decoder->GetWordsSoFar()]==kNullDataWord){
-      decoder->AddWordsSoFarAndFragLength();
+    if (evdecoder.GetFragLength()==1 && localbuff[evdecoder.GetWordsSoFar()]==kNullDataWord){
+      evdecoder.AddWordsSoFarAndFragLength();
       QwMessage << "Skip this bank" << QwLog::endl;
       continue;
     }
@@ -740,12 +937,12 @@ Bool_t QwEventBuffer::FillSubsystemConfigurationData(QwSubsystemArray &subsystem
     //  After trying the data in each subsystem, bump the
     //  fWordsSoFar to move to the next bank.
 
-    subsystems.ProcessConfigurationBuffer(rocnum, decoder->GetSubbankTag(),
-					  &localbuff[decoder->GetWordsSoFar()],
-					  decoder->GetFragLength());
-    decoder->AddWordsSoFarAndFragLength();
+    subsystems.ProcessConfigurationBuffer(rocnum, evdecoder.GetSubbankTag(),
+					  &localbuff[evdecoder.GetWordsSoFar()],
+					  evdecoder.GetFragLength());
+    evdecoder.AddWordsSoFarAndFragLength();
     QwDebug << "QwEventBuffer::FillSubsystemConfigurationData:  "
-	    << "Ending loop: fWordsSoFar=="<<decoder->GetWordsSoFar()
+	    << "Ending loop: fWordsSoFar=="<<evdecoder.GetWordsSoFar()
 	    <<QwLog::endl;
   }
 
@@ -753,42 +950,64 @@ Bool_t QwEventBuffer::FillSubsystemConfigurationData(QwSubsystemArray &subsystem
 }
 
 Bool_t QwEventBuffer::FillSubsystemData(QwSubsystemArray &subsystems)
+{
+  //  Reload the data buffer and decode the header again, this allows
+  //  multiple calls to this function for different subsystem arrays.
+  UInt_t *localbuff = GetEvBuffer();
+  return FillSubsystemData(subsystems, localbuff, *decoder,
+                           fCurrentRun, fRunIsSegmented? *fRunSegmentIterator: 0);
+}
+
+/// Fill the subsystems from a copy of an event, using a decoder private
+/// to the calling thread.  The marker word and clean parameter caches are
+/// shared, so only one thread at a time may fill subsystem data.
+Bool_t QwEventBuffer::FillSubsystemData(QwSubsystemArray &subsystems,
+                                        RawEvent &event,
+                                        VEventDecoder &evdecoder)
+{
+  if (event.fWords.empty()) return kFALSE;
+  return FillSubsystemData(subsystems, event.fWords.data(), evdecoder,
+                           event.fRunNumber, event.fSegmentNumber);
+}
+
+Bool_t QwEventBuffer::FillSubsystemData(QwSubsystemArray &subsystems,
+                                        UInt_t *localbuff,
+                                        VEventDecoder &evdecoder,
+                                        Int_t run, Int_t segment)
 {
   //  Initialize local flag
   Bool_t okay = kTRUE;
 
-  //  Reload the data buffer and decode the header again, this allows
-  //  multiple calls to this function for different subsystem arrays.
-  UInt_t *localbuff = (UInt_t*)(fEvStream->getEvBuffer());
-  
-	decoder->DecodeEventIDBank(localbuff);
+  //  Decode the header again, this allows multiple calls to this
+  //  function for different subsystem arrays.
+	evdecoder.DecodeEventIDBank(localbuff);
 
   //  Clear the old event information from the subsystems.
   subsystems.ClearEventData();
 
   //  Pass CODA run, segment, event number and type to the subsystem array.
-  subsystems.SetCodaRunNumber(fCurrentRun);
-  subsystems.SetCodaSegmentNumber(fRunIsSegmented? *fRunSegmentIterator: 0);
-  subsystems.SetCodaEventNumber(decoder->GetEvtNumber());
-  subsystems.SetCodaEventType(decoder->GetEvtType());
+  subsystems.SetCodaRunNumber(run);
+  subsystems.SetCodaSegmentNumber(segment);
+  subsystems.SetCodaEventNumber(evdecoder.GetEvtNumber());
+  subsystems.SetCodaEventType(evdecoder.GetEvtType());
 
   // If this event type is masked for the subsystem array, return right away
-  if (((0x1 << (decoder->GetEvtType() - 1)) & subsystems.GetEventTypeMask()) == 0) {
+  if (((0x1 << (evdecoder.GetEvtType() - 1)) & subsystems.GetEventTypeMask()) == 0) {
     return kTRUE;
   }
 
   UInt_t offset;
 
   //  Loop through the data buffer in this event.
-  while ((okay = decoder->DecodeSubbankHeader(&localbuff[decoder->GetWordsSoFar()]))){
+  while ((okay = evdecoder.DecodeSubbankHeader(&localbuff[evdecoder.GetWordsSoFar()]))){
 
     //  If this bank has further subbanks, restart the loop.
-    if (decoder->GetSubbankType() == 0x10) continue;
+    if (evdecoder.GetSubbankType() == 0x10) continue;
 
     //  If this bank only contains the word 'NULL' then skip
     //  this bank.
-    if (decoder->GetFragLength() == 1 && localbuff[decoder->GetWordsSoFar()]==kNullDataWord) {
-      decoder->AddWordsSoFarAndFragLength();
+    if (evdecoder.GetFragLength() == 1 && localbuff[evdecoder.GetWordsSoFar()]==kNullDataWord) {
+      evdecoder.AddWordsSoFarAndFragLength();
       continue;
     }
 
@@ -813,11 +1032,11 @@ Bool_t QwEventBuffer::FillSubsystemData(QwSubsystemArray &subsystems)
 		
 		// TODO:
 		// What is special about this subbank?
-    if( decoder->GetROC() == 0 && decoder->GetSubbankTag()==0x6101) {
+    if( evdecoder.GetROC() == 0 && evdecoder.GetSubbankTag()==0x6101) {
       //std::cout << "ProcessEventBuffer: ROC="<<GetROC()<<", SubbankTag="<< GetSubbankTag()<<", FragLength="<<GetFragLength() <<std::endl;
-      fCleanParameter[0]=localbuff[decoder->GetWordsSoFar()+decoder->GetFragLength()-4];//clean data
-      fCleanParameter[1]=localbuff[decoder->GetWordsSoFar()+decoder->GetFragLength()-3];//scan data 1
-      fCleanParameter[2]=localbuff[decoder->GetWordsSoFar()+decoder->GetFragLength()-2];//scan data 2
+      fCleanParameter[0]=localbuff[evdecoder.GetWordsSoFar()+evdecoder.GetFragLength()-4];//clean data
+      fCleanParameter[1]=localbuff[evdecoder.GetWordsSoFar()+evdecoder.GetFragLength()-3];//scan data 1
+      fCleanParameter[2]=localbuff[evdecoder.GetWordsSoFar()+evdecoder.GetFragLength()-2];//scan data 2
       //std::cout << "ProcessEventBuffer: ROC="<<GetROC()<<", SubbankTag="<< GetSubbankTag()
       //		<<", FragLength="<<GetFragLength() << " " <<fCleanParameter[0]<< " " <<fCleanParameter[1]<< " " <<fCleanParameter[2]<<std::endl;
 
@@ -825,27 +1044,27 @@ Bool_t QwEventBuffer::FillSubsystemData(QwSubsystemArray &subsystems)
     
     subsystems.SetCleanParameters(fCleanParameter);
 
-    std::size_t nmarkers = CheckForMarkerWords(subsystems);
+    std::size_t nmarkers = CheckForMarkerWords(subsystems, evdecoder);
     if (nmarkers>0) {
       //  There are markerwords for this ROC/Bank
       for (size_t i=0; i<nmarkers; i++){
-        offset = FindMarkerWord(i,&localbuff[decoder->GetWordsSoFar()],decoder->GetFragLength());
+        offset = FindMarkerWord(i,&localbuff[evdecoder.GetWordsSoFar()],evdecoder.GetFragLength());
 	      BankID_t tmpbank = GetMarkerWord(i);
-        tmpbank = ((tmpbank)<<32) + decoder->GetSubbankTag();
+        tmpbank = ((tmpbank)<<32) + evdecoder.GetSubbankTag();
         offset++; //  Skip the marker word
-        subsystems.ProcessEvBuffer(decoder->GetEvtType(), decoder->GetROC(), tmpbank,
-				     &localbuff[decoder->GetWordsSoFar()+offset],
-				     decoder->GetFragLength()-offset);
+        subsystems.ProcessEvBuffer(evdecoder.GetEvtType(), evdecoder.GetROC(), tmpbank,
+				     &localbuff[evdecoder.GetWordsSoFar()+offset],
+				     evdecoder.GetFragLength()-offset);
       }
     } else {
       QwDebug << "QwEventBuffer::FillSubsystemData:  "
-	      << "fROC=="<<decoder->GetROC() << ", GetSubbankTag()==" << decoder->GetSubbankTag()
+	      << "fROC=="<<evdecoder.GetROC() << ", GetSubbankTag()==" << evdecoder.GetSubbankTag()
 	      << QwLog::endl;	
-      subsystems.ProcessEvBuffer(decoder->GetEvtType(), decoder->GetROC(), decoder->GetSubbankTag(),
-				 &localbuff[decoder->GetWordsSoFar()],
-				 decoder->GetFragLength());
+      subsystems.ProcessEvBuffer(evdecoder.GetEvtType(), evdecoder.GetROC(), evdecoder.GetSubbankTag(),
+				 &localbuff[evdecoder.GetWordsSoFar()],
+				 evdecoder.GetFragLength());
     }
-    decoder->AddWordsSoFarAndFragLength();
+    evdecoder.AddWordsSoFarAndFragLength();
 //     QwDebug << "QwEventBuffer::FillSubsystemData:  "
 // 	    << "Ending loop: fWordsSoFar=="<<GetWordsSoFar()
 // 	    <<QwLog::endl;
@@ -868,38 +1087,56 @@ Bool_t QwEventBuffer::FillEPICSData(QwEPICSEvent &epics)
 
 
   ///
+  UInt_t *localbuff = GetEvBuffer();
+  return FillEPICSData(epics, localbuff, *decoder);
+}
+
+/// Fill the EPICS data from a copy of an event, using a decoder private
+/// to the calling thread.
+Bool_t QwEventBuffer::FillEPICSData(QwEPICSEvent &epics,
+                                    RawEvent &event,
+                                    VEventDecoder &evdecoder)
+{
+  if (event.fWords.empty()) return kFALSE;
+  evdecoder.DecodeEventIDBank(event.fWords.data());
+  return FillEPICSData(epics, event.fWords.data(), evdecoder);
+}
+
+Bool_t QwEventBuffer::FillEPICSData(QwEPICSEvent &epics,
+                                    UInt_t *localbuff,
+                                    VEventDecoder &evdecoder)
+{
   Bool_t okay = kTRUE;
-  if (! IsEPICSEvent()){
+  if (! evdecoder.IsEPICSEvent()){
     okay = kFALSE;
     return okay;
   }
   QwVerbose << "QwEventBuffer::FillEPICSData:  "
 	    << QwLog::endl;
   //  Loop through the data buffer in this event.
-  UInt_t *localbuff = (UInt_t*)(fEvStream->getEvBuffer());
-  if (decoder->GetBankDataType()==0x10){
-    while ((okay = decoder->DecodeSubbankHeader(&localbuff[decoder->GetWordsSoFar()]))){
+  if (evdecoder.GetBankDataType()==0x10){
+    while ((okay = evdecoder.DecodeSubbankHeader(&localbuff[evdecoder.GetWordsSoFar()]))){
       //  If this bank has further subbanks, restart the loop.
-      if (decoder->GetSubbankType() == 0x10) continue;
+      if (evdecoder.GetSubbankType() == 0x10) continue;
       //  If this bank only contains the word 'NULL' then skip
       //  this bank.
-      if (decoder->GetFragLength()==1 && localbuff[decoder->GetWordsSoFar()]==kNullDataWord){
-	decoder->AddWordsSoFarAndFragLength();
+      if (evdecoder.GetFragLength()==1 && localbuff[evdecoder.GetWordsSoFar()]==kNullDataWord){
+	evdecoder.AddWordsSoFarAndFragLength();
 	continue;
       }
 
-      if (decoder->GetSubbankType() == 0x3){
+      if (evdecoder.GetSubbankType() == 0x3){
 	//  This is an ASCII string bank.  Try to decode it and
 	//  pass it to the EPICS class.
-	char* tmpchar = (Char_t*)&localbuff[decoder->GetWordsSoFar()];
+	char* tmpchar = (Char_t*)&localbuff[evdecoder.GetWordsSoFar()];
 	
-	epics.ExtractEPICSValues(string(tmpchar), GetEventNumber());
-	QwVerbose << "test for GetEventNumber =" << GetEventNumber() << QwLog::endl;// always zero, wrong.
+	epics.ExtractEPICSValues(tmpchar, evdecoder.GetFragLength()*sizeof(UInt_t), evdecoder.GetEvtNumber());
+	QwVerbose << "test for GetEventNumber =" << evdecoder.GetEvtNumber() << QwLog::endl;// always zero, wrong.
 	
       }
 
 
-      decoder->AddWordsSoFarAndFragLength();
+      evdecoder.AddWordsSoFarAndFragLength();
 
 //     QwDebug << "QwEventBuffer::FillEPICSData:  "
 // 	    << "Ending loop: fWordsSoFar=="<<GetWordsSoFar()
@@ -910,14 +1147,14 @@ Bool_t QwEventBuffer::FillEPICSData(QwEPICSEvent &epics)
     }
   } else {
     // Single bank in the event, use event headers.
-    if (decoder->GetBankDataType() == 0x3){
+    if (evdecoder.GetBankDataType() == 0x3){
       //  This is an ASCII string bank.  Try to decode it and
       //  pass it to the EPICS class.
-      Char_t* tmpchar = (Char_t*)&localbuff[decoder->GetWordsSoFar()];
+      Char_t* tmpchar = (Char_t*)&localbuff[evdecoder.GetWordsSoFar()];
       
       QwError << tmpchar << QwLog::endl;
       
-      epics.ExtractEPICSValues(string(tmpchar), GetEventNumber());
+      epics.ExtractEPICSValues(tmpchar, evdecoder.GetFragLength()*sizeof(UInt_t), evdecoder.GetEvtNumber());
       
     }
 
@@ -1136,11 +1373,16 @@ Int_t QwEventBuffer::OpenDataFile(UInt_t current_run, const TString rw)
 //------------------------------------------------------------
 Int_t QwEventBuffer::OpenDataFile(const TString filename, const TString rw)
 {
+  //  Events read ahead from the previous file are discarded
+  StopReadAhead();
   if (fEvStreamMode==fEvStreamNull){
     QwDebug << "QwEventBuffer::OpenDataFile:  File handle doesn't exist.\n"
 	    << "                              Try to open a new file handle!"
 	    << QwLog::endl;
-    fEvStream = new THaCodaFile();
+    if (fMapDataFiles && ! rw.Contains("w",TString::kIgnoreCase))
+      fEvStream = new THaCodaMappedFile();
+    else
+      fEvStream = new THaCodaFile();
     fEvStreamMode = fEvStreamFile;
   } else if (fEvStreamMode!=fEvStreamFile){
     QwError << "QwEventBuffer::OpenDataFile:  The stream is not configured as an input\n"
@@ -1183,14 +1425,140 @@ Int_t QwEventBuffer::OpenDataFile(const TString filename, const TString rw)
     }
     globfree(&globbuf);
   }
+  if (dynamic_cast<THaCodaMappedFile*>(fEvStream) != nullptr) {
+    //  Compressed, byte-swapped or unknown formats can't be mapped;
+    //  fall back to the EVIO library for this and the following files.
+    Int_t status = CODA_ERROR;
+    if (! fDataFile.EndsWith(".gz"))
+      status = fEvStream->codaOpen(fDataFile, rw);
+    if (status == CODA_OK) {
+      OpenEventIndex();
+      return status;
+    }
+    QwWarning << "QwEventBuffer::OpenDataFile:  Unable to map " << fDataFile
+              << ", reading it through the EVIO library instead" << QwLog::endl;
+    delete fEvStream;
+    fEvStream = new THaCodaFile();
+  }
+  fHasEventIndex = fBuildEventIndex = kFALSE;
   return fEvStream->codaOpen(fDataFile, rw);
 }
 
+//------------------------------------------------------------
+/// Read the event index of the newly opened data file, or prepare to
+/// build it while the file is read.
+void QwEventBuffer::OpenEventIndex()
+{
+  fHasEventIndex = fBuildEventIndex = kFALSE;
+  fEventIndexCursor = 0;
+  fEventIndexStored = 0;
+  if (! fUseEventIndex) return;
+
+  struct stat st;
+  if (stat(fDataFile.Data(), &st) != 0) return;
+  std::string indexfile = fDataFile.Data() + QwEventIndex::kExtension;
+  if (fEventIndex.Read(indexfile, st.st_size, st.st_mtime)) {
+    fEventIndexStored = fEventIndex.GetNumberOfEntries();
+    QwMessage << "Using " << (fEventIndex.IsComplete()? "": "partial ")
+              << "event index " << indexfile << " with "
+              << fEventIndexStored << " events" << QwLog::endl;
+    fHasEventIndex = kTRUE;
+    //  Extend a partial index when the file is read past its end
+    fBuildEventIndex = ! fEventIndex.IsComplete();
+  } else {
+    fEventIndex.Reset(st.st_size, st.st_mtime);
+    fBuildEventIndex = kTRUE;
+  }
+}
+
+/// Record the position and type of the current event in the index
+void QwEventBuffer::AddEventIndexEntry()
+{
+  THaCodaMappedFile* stream = dynamic_cast<THaCodaMappedFile*>(fEvStream);
+  if (stream == nullptr) {
+    fBuildEventIndex = kFALSE;
+    return;
+  }
+  QwEventIndex::Entry entry;
+  stream->getEventPosition(entry.fBlockOffset, entry.fEventOffset);
+  entry.fEventNumber = decoder->GetEvtNumber();
+  entry.fEventType = decoder->GetEvtType();
+  if (decoder->IsPhysicsEvent())
+    entry.fFlags = QwEventIndex::kPhysicsEvent;
+  else if (decoder->IsEPICSEvent())
+    entry.fFlags = QwEventIndex::kEPICSEvent;
+  else if (decoder->IsROCConfigurationEvent())
+    entry.fFlags = QwEventIndex::kROCConfigEvent;
+  else
+    entry.fFlags = QwEventIndex::kOtherEvent;
+  entry.fSegment = fRunIsSegmented? *fRunSegmentIterator: 0;
+  fEventIndex.AddEntry(entry);
+}
+
+/// Store the index after the data file has been read completely, or the
+/// part of it built so far when the file is closed or rewound before its
+/// end.  A partial index is only stored if it covers more events than the
+/// index that was read for this file.
+void QwEventBuffer::WriteEventIndex(Bool_t complete)
+{
+  fBuildEventIndex = kFALSE;
+  if (! complete && fEventIndex.GetNumberOfEntries() <= fEventIndexStored) return;
+  fEventIndex.SetComplete(complete);
+  std::string indexfile = fDataFile.Data() + QwEventIndex::kExtension;
+  if (fEventIndex.Write(indexfile)) {
+    fEventIndexStored = fEventIndex.GetNumberOfEntries();
+    QwMessage << "Wrote " << (complete? "": "partial ")
+              << "event index " << indexfile << " with "
+              << fEventIndexStored << " events" << QwLog::endl;
+  }
+}
+
+/// Position the stream so that the next read returns the event at the
+/// given index position.
+Int_t QwEventBuffer::SeekEventIndex(std::size_t position)
+{
+  THaCodaMappedFile* stream = dynamic_cast<THaCodaMappedFile*>(fEvStream);
+  if (stream == nullptr || position >= fEventIndex.GetNumberOfEntries())
+    return CODA_ERROR;
+  if (position == fEventIndexCursor) return CODA_OK;
+  const QwEventIndex::Entry& entry = fEventIndex.GetEntry(position);
+  Int_t status = stream->codaSeek(entry.fBlockOffset, entry.fEventOffset);
+  if (status == CODA_OK) {
+    fEventIndexCursor = position;
+  } else {
+    QwWarning << "QwEventBuffer::SeekEventIndex:  Seek failed, "
+              << "reading without event index" << QwLog::endl;
+    fHasEventIndex = fBuildEventIndex = kFALSE;
+  }
+  return status;
+}
+
+/// Skip physics events below the event range, but never skip past a
+/// non-physics event, which must still be seen by the event loop.
+void QwEventBuffer::SkipEventsWithIndex()
+{
+  std::size_t n = fEventIndex.GetNumberOfEntries();
+  if (fEventIndexCursor >= n) return;
+  const QwEventIndex::Entry& next = fEventIndex.GetEntry(fEventIndexCursor);
+  if ((next.fFlags & QwEventIndex::kPhysicsEvent) == 0
+      || next.fEventNumber >= fEventRange.first) return;
+
+  std::size_t target =
+    std::min(fEventIndex.FindPhysicsEvent(fEventRange.first, fEventIndexCursor),
+             fEventIndex.FindSpecialEvent(~0u, fEventIndexCursor));
+  //  Past the last event, let the last event be read and skipped normally
+  if (target >= n) target = n - 1;
+  SeekEventIndex(target);
+}
+
 
 //------------------------------------------------------------
 Int_t QwEventBuffer::CloseDataFile()
 {
   Int_t status = kFileHandleNotConfigured;
+  StopReadAhead();
+  //  Keep the part of the index built before the end of the event range
+  if (fBuildEventIndex) WriteEventIndex(kFALSE);
   if (fEvStreamMode==fEvStreamFile){
     status = fEvStream->codaClose();
   }
@@ -1226,41 +1594,34 @@ Int_t QwEventBuffer::CloseETStream()
 }
 
 //------------------------------------------------------------
-std::size_t QwEventBuffer::CheckForMarkerWords(QwSubsystemArray &subsystems)
+std::size_t QwEventBuffer::CheckForMarkerWords(QwSubsystemArray &subsystems, VEventDecoder &evdecoder)
 {
   QwDebug << "QwEventBuffer::GetMarkerWordList:  start function" <<QwLog::endl;
-  fThisRocBankLabel = decoder->GetROC();
-  fThisRocBankLabel = fThisRocBankLabel<<32;
-  fThisRocBankLabel += decoder->GetSubbankTag();
-  if (fMarkerList.count(fThisRocBankLabel)==0){
-    std::vector<UInt_t> tmpvec;
-    subsystems.GetMarkerWordList(decoder->GetROC(), decoder->GetSubbankTag(), tmpvec);
-    fMarkerList.emplace(fThisRocBankLabel, tmpvec);
-    fOffsetList.emplace(fThisRocBankLabel, std::vector<UInt_t>(tmpvec.size(),0));
-  }
-  QwDebug << "QwEventBuffer::GetMarkerWordList:  fMarkerList.count(fThisRocBankLabel)==" 
-	  << fMarkerList.count(fThisRocBankLabel) 
-	  << " fMarkerList.at(fThisRocBankLabel).size()==" 
-	  << fMarkerList.at(fThisRocBankLabel).size()
+  QwSubsystemArray::BankDispatch& dispatch =
+    subsystems.GetBankDispatch(evdecoder.GetROC(), evdecoder.GetSubbankTag());
+  fThisMarkerList = &dispatch.fMarkerWords;
+  fThisOffsetList = &dispatch.fMarkerOffsets;
+  QwDebug << "QwEventBuffer::GetMarkerWordList:  fThisMarkerList->size()=="
+	  << fThisMarkerList->size()
 	  << QwLog::endl;
-  return fMarkerList.at(fThisRocBankLabel).size();
+  return fThisMarkerList->size();
 }
 
 UInt_t QwEventBuffer::GetMarkerWord(UInt_t markerID){
-  return fMarkerList.at(fThisRocBankLabel).at(markerID);
+  return fThisMarkerList->at(markerID);
 };
 
 
 UInt_t QwEventBuffer::FindMarkerWord(UInt_t markerindex, UInt_t* buffer, UInt_t num_words){
-  UInt_t markerpos  = fOffsetList.at(fThisRocBankLabel).at(markerindex);
-  UInt_t markerval  = fMarkerList.at(fThisRocBankLabel).at(markerindex);
+  UInt_t markerpos  = fThisOffsetList->at(markerindex);
+  UInt_t markerval  = fThisMarkerList->at(markerindex);
   if (markerpos < num_words && buffer[markerpos] == markerval){
     // The marker word is where it was last time
     return markerpos;
   } else {
     for (size_t i=0; i<num_words; i++){
       if (buffer[i] == markerval){
-	fOffsetList.at(fThisRocBankLabel).at(markerindex) = i;
+	fThisOffsetList->at(markerindex) = i;
 	markerpos = i;
 	break;
       }
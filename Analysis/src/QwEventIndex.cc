@@ -0,0 +1,194 @@
+/*!
+ * \file   QwEventIndex.cc
+ * \brief  Sidecar index of event positions in a CODA data file
+ */
+
+#include "QwEventIndex.h"
+
+// System headers
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+// Qweak headers
+#include "QwLog.h"
+
+const std::string QwEventIndex::kExtension = ".qwidx";
+
+namespace {
+  /// Identification of index files: "QIDX" and the format version
+  const UInt_t kIndexMagic   = 0x58444951;
+  const UInt_t kIndexVersion = 2;
+}
+
+void QwEventIndex::Reset(ULong64_t filesize, Long64_t filetime)
+{
+  fFileSize = filesize;
+  fFileTime = filetime;
+  fComplete = kFALSE;
+  fEntries.clear();
+  fSpecial.clear();
+}
+
+void QwEventIndex::AddEntry(const Entry& entry)
+{
+  if ((entry.fFlags & kPhysicsEvent) == 0)
+    fSpecial.push_back(fEntries.size());
+  fEntries.push_back(entry);
+}
+
+/**
+ * Read the index from file.  The index is rejected if it was built for a
+ * data file with a different size or modification time.
+ * @param filename Name of the index file
+ * @param filesize Size of the data file
+ * @param filetime Modification time of the data file
+ * @return kTRUE if a valid index was read
+ */
+Bool_t QwEventIndex::Read(const std::string& filename, ULong64_t filesize, Long64_t filetime)
+{
+  Reset(filesize, filetime);
+
+  std::ifstream input(filename, std::ios::binary);
+  if (! input.is_open()) return kFALSE;
+
+  UInt_t magic = 0, version = 0, complete = 0;
+  ULong64_t size = 0, nentries = 0, nspecial = 0;
+  Long64_t time = 0;
+  input.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+  input.read(reinterpret_cast<char*>(&version), sizeof(version));
+  input.read(reinterpret_cast<char*>(&size), sizeof(size));
+  input.read(reinterpret_cast<char*>(&time), sizeof(time));
+  input.read(reinterpret_cast<char*>(&complete), sizeof(complete));
+  input.read(reinterpret_cast<char*>(&nentries), sizeof(nentries));
+  input.read(reinterpret_cast<char*>(&nspecial), sizeof(nspecial));
+  if (! input.good() || magic != kIndexMagic || version != kIndexVersion) {
+    QwWarning << "QwEventIndex::Read: " << filename
+              << " is not a valid event index" << QwLog::endl;
+    return kFALSE;
+  }
+  if (size != filesize || time != filetime) {
+    QwWarning << "QwEventIndex::Read: " << filename
+              << " does not match the data file" << QwLog::endl;
+    return kFALSE;
+  }
+
+  //  The counts must match the rest of the file before anything is allocated
+  std::streamoff start = input.tellg();
+  input.seekg(0, std::ios::end);
+  std::streamoff remaining = input.tellg() - start;
+  input.seekg(start);
+  if (! input.good() || remaining < 0
+      || nspecial > nentries
+      || nentries > ULong64_t(remaining) / sizeof(Entry)
+      || ULong64_t(remaining) != nentries * sizeof(Entry) + nspecial * sizeof(ULong64_t)) {
+    QwWarning << "QwEventIndex::Read: " << filename
+              << " is truncated or corrupt" << QwLog::endl;
+    Reset(filesize, filetime);
+    return kFALSE;
+  }
+
+  fEntries.resize(nentries);
+  fSpecial.resize(nspecial);
+  input.read(reinterpret_cast<char*>(fEntries.data()), nentries * sizeof(Entry));
+  input.read(reinterpret_cast<char*>(fSpecial.data()), nspecial * sizeof(ULong64_t));
+  if (! input.good()) {
+    QwWarning << "QwEventIndex::Read: " << filename
+              << " is truncated" << QwLog::endl;
+    Reset(filesize, filetime);
+    return kFALSE;
+  }
+
+  //  The special events are positions in the entries, in increasing order
+  //  for FindSpecialEvent
+  for (std::size_t i = 0; i < fSpecial.size(); i++) {
+    if (fSpecial[i] >= nentries || (i > 0 && fSpecial[i] <= fSpecial[i-1])) {
+      QwWarning << "QwEventIndex::Read: " << filename
+                << " has an invalid special event entry" << QwLog::endl;
+      Reset(filesize, filetime);
+      return kFALSE;
+    }
+  }
+  fComplete = (complete != 0);
+  return kTRUE;
+}
+
+/**
+ * Write the index to file.  The index is written to a temporary file first
+ * and then renamed, so readers never see a partially written index.
+ * @param filename Name of the index file
+ * @return kTRUE if the index was written
+ */
+Bool_t QwEventIndex::Write(const std::string& filename) const
+{
+  std::string tmpname = filename + ".tmp";
+  std::ofstream output(tmpname, std::ios::binary | std::ios::trunc);
+  if (! output.is_open()) {
+    QwWarning << "QwEventIndex::Write: Unable to create " << tmpname << QwLog::endl;
+    return kFALSE;
+  }
+
+  UInt_t complete = fComplete? 1: 0;
+  ULong64_t nentries = fEntries.size();
+  ULong64_t nspecial = fSpecial.size();
+  output.write(reinterpret_cast<const char*>(&kIndexMagic), sizeof(kIndexMagic));
+  output.write(reinterpret_cast<const char*>(&kIndexVersion), sizeof(kIndexVersion));
+  output.write(reinterpret_cast<const char*>(&fFileSize), sizeof(fFileSize));
+  output.write(reinterpret_cast<const char*>(&fFileTime), sizeof(fFileTime));
+  output.write(reinterpret_cast<const char*>(&complete), sizeof(complete));
+  output.write(reinterpret_cast<const char*>(&nentries), sizeof(nentries));
+  output.write(reinterpret_cast<const char*>(&nspecial), sizeof(nspecial));
+  output.write(reinterpret_cast<const char*>(fEntries.data()), nentries * sizeof(Entry));
+  output.write(reinterpret_cast<const char*>(fSpecial.data()), nspecial * sizeof(ULong64_t));
+  output.close();
+  if (output.fail() || std::rename(tmpname.c_str(), filename.c_str()) != 0) {
+    QwWarning << "QwEventIndex::Write: Unable to write " << filename << QwLog::endl;
+    std::remove(tmpname.c_str());
+    return kFALSE;
+  }
+  return kTRUE;
+}
+
+/**
+ * Find the first position at or after 'from' from which on all physics
+ * events have at least the requested event number.  Physics event numbers
+ * increase through the file, so a binary search over the physics events is
+ * sufficient.  Non-physics events are not considered.
+ * @param eventnumber Requested event number
+ * @param from First position to consider
+ * @return Position, or the number of entries if there is no such event
+ */
+std::size_t QwEventIndex::FindPhysicsEvent(UInt_t eventnumber, std::size_t from) const
+{
+  std::size_t lo = from, hi = fEntries.size();
+  while (lo < hi) {
+    std::size_t mid = lo + (hi - lo) / 2;
+    //  Use the first physics event at or after the midpoint
+    std::size_t m = mid;
+    while (m < hi && (fEntries[m].fFlags & kPhysicsEvent) == 0) m++;
+    if (m == hi) {
+      hi = mid;
+    } else if (fEntries[m].fEventNumber < eventnumber) {
+      lo = m + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+/**
+ * Find the next non-physics event at or after 'from' with any of the
+ * requested flags.
+ * @param flags Combination of EQwEventIndexFlag
+ * @param from First position to consider
+ * @return Position, or the number of entries if there is no such event
+ */
+std::size_t QwEventIndex::FindSpecialEvent(UInt_t flags, std::size_t from) const
+{
+  auto it = std::lower_bound(fSpecial.begin(), fSpecial.end(), ULong64_t(from));
+  for (; it != fSpecial.end(); ++it) {
+    if (fEntries[*it].fFlags & flags) return *it;
+  }
+  return fEntries.size();
+}
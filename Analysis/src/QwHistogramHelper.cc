@@ -11,6 +11,13 @@
 
 #include "QwHistogramHelper.h"
 
+// System headers
+#include <algorithm>
+
+// ROOT headers
+#include <TDirectory.h>
+#include <TFile.h>
+
 // Qweak headers
 #include "QwLog.h"
 
@@ -46,6 +53,9 @@ void QwHistogramHelper::DefineOptions(QwOptions &options)
 		       "trimmed histo file name"
 		       );
 
+  options.AddOptions()
+    ("histo-fill-buffer", po::value<int>()->default_value(0),
+     "number of values buffered per histogram before filling (0 fills directly)");
 }
 
 void QwHistogramHelper::ProcessOptions(QwOptions &options)
@@ -55,6 +65,7 @@ void QwHistogramHelper::ProcessOptions(QwOptions &options)
   //  fTrimHistoEnable = options.GetValue<bool>("enable-histo-trim") || options.GetValue<bool>("enable-mapfile");
   fTrimDisable =!( options.GetValue<bool>("enable-tree-trim"));
   fTrimHistoEnable = options.GetValue<bool>("enable-histo-trim");
+  fFillBufferSize = std::max(options.GetValue<int>("histo-fill-buffer"), 0);
   
   if (fTrimDisable)
     QwMessage <<"tree-trim is disabled"<<QwLog::endl;
@@ -511,6 +522,7 @@ TH1F* QwHistogramHelper::Construct1DHist(const QwHistogramHelper::HistParams &pa
   h1->SetYTitle(params.ytitle);
   //  if(params.min!=fInvalidNumber) h1->SetMinimum(params.min);
   //  if(params.max!=fInvalidNumber) h1->SetMinimum(params.max);
+  AddFillBuffer(h1);
   return h1;
 }
 
@@ -579,3 +591,79 @@ TProfile2D* QwHistogramHelper::Construct2DProf(const QwHistogramHelper::HistPara
   h2->SetYTitle(params.ytitle);
   return h2;
 }
+
+/////////////////////////////////////////////////////////////////////////////////////////
+
+void QwHistogramBuffer::Flush()
+{
+  if (fCount == 0 || fHistogram == nullptr) return;
+  fHistogram->FillN(fCount, fValues.data(), nullptr);
+  fCount = 0;
+}
+
+void QwHistogramHelper::AddFillBuffer(TH1* h)
+{
+  if (fFillBufferSize == 0 || h == nullptr) return;
+  // A histogram allocated at the address of a deleted one replaces its buffer
+  std::shared_ptr<QwHistogramBuffer>& buffer = fFillBuffers[h];
+  if (buffer) {
+    buffer->Detach();
+    fFillBufferGeneration++;
+  }
+  //  The file is kept, so that closing it does not have to look at
+  //  histograms which may already have been deleted
+  TDirectory* dir = h->GetDirectory();
+  buffer = std::make_shared<QwHistogramBuffer>(h, dir? dir->GetFile(): nullptr, fFillBufferSize);
+}
+
+/**
+ * Drop the reference of an owner of histograms to a fill buffer.  When no
+ * other owner uses the buffer, its values are filled into the histogram
+ * and the buffer is removed, so it cannot outlive the histogram.  Buffers
+ * of closed files were already flushed and detached from their histograms.
+ * @param buffer Reference to the buffer, reset on return
+ */
+void QwHistogramHelper::ReleaseFillBuffer(std::shared_ptr<QwHistogramBuffer>& buffer)
+{
+  if (! buffer) return;
+  auto iter = fFillBuffers.find(buffer->GetHistogram());
+  if (iter != fFillBuffers.end() && iter->second == buffer && buffer.use_count() == 2) {
+    buffer->Flush();
+    buffer->Detach();
+    fFillBuffers.erase(iter);
+    fFillBufferGeneration++;
+  }
+  buffer.reset();
+}
+
+/**
+ * Fill the buffered values of all histograms.  This has to be called
+ * before the histograms are written, saved, or read.
+ */
+void QwHistogramHelper::FlushFillBuffers()
+{
+  for (auto& buffer: fFillBuffers)
+    buffer.second->Flush();
+}
+
+/**
+ * Flush and drop the fill buffers of the histograms in a file before it
+ * is closed, since closing the file deletes these histograms.
+ * @param file File, or any directory of it
+ */
+void QwHistogramHelper::ReleaseFillBuffers(const TDirectory* file)
+{
+  if (file == nullptr) return;
+  const TFile* rootfile = file->GetFile();
+  Bool_t released = kFALSE;
+  for (auto iter = fFillBuffers.begin(); iter != fFillBuffers.end(); ) {
+    if (rootfile != nullptr && iter->second->GetFile() == rootfile) {
+      //  Owners may still hold the buffer, but no longer fill it
+      iter->second->Flush();
+      iter->second->Detach();
+      iter = fFillBuffers.erase(iter);
+      released = kTRUE;
+    } else ++iter;
+  }
+  if (released) fFillBufferGeneration++;
+}
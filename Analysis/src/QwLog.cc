@@ -20,9 +20,12 @@
 QwLog gQwLog;
 
 // Set the static flags
-bool QwLog::fScreenAtNewLine = true;
-bool QwLog::fScreenInColor = false;
-bool QwLog::fFileAtNewLine = true;
+thread_local bool QwLog::fScreenAtNewLine = true;
+thread_local bool QwLog::fScreenInColor = false;
+thread_local bool QwLog::fFileAtNewLine = true;
+thread_local QwLog::QwLogLevel QwLog::fLogLevel = QwLog::kMessage;
+thread_local QwLogCapture* QwLog::fCapture = 0;
+thread_local char QwLog::fTimeString[128];
 
 // Log file open modes
 const std::ios_base::openmode QwLog::kTruncate = std::ios::trunc;
@@ -39,8 +42,6 @@ QwLog::QwLog()
   fFileThreshold = kMessage;
   fFile = 0;
 
-  fLogLevel = kMessage;
-
   fUseColor = true;
 
   fPrintFunctionSignature = false;
@@ -134,6 +135,8 @@ void QwLog::ProcessOptions(QwOptions* options)
  */
 bool QwLog::IsDebugFunction(const string func_sig)
 {
+  // The cache is shared by all threads
+  std::lock_guard<std::mutex> lock(fDebugFunctionMutex);
   // If not in our cached list
   if (fIsDebugFunction.find(func_sig) == fIsDebugFunction.end()) {
     // Look through all regexes
@@ -203,25 +206,25 @@ QwLog& QwLog::operator()(
       switch (level) {
       case kError:
         if (fUseColor) {
-          *(fScreen) << QwColor(Qw::kRed);
+          *(GetScreen()) << QwColor(Qw::kRed);
           fScreenInColor = true;
         }
         if (fPrintFunctionSignature)
-          *(fScreen) << "Error (in " << func_sig << "): ";
+          *(GetScreen()) << "Error (in " << func_sig << "): ";
         else
-          *(fScreen) << "Error: ";
+          *(GetScreen()) << "Error: ";
         break;
       case kWarning:
         if (fUseColor) {
-          *(fScreen) << QwColor(Qw::kRed);
+          *(GetScreen()) << QwColor(Qw::kRed);
           fScreenInColor = true;
         }
         if (fPrintFunctionSignature)
-          *(fScreen) << "Warning (in " << func_sig << "): ";
+          *(GetScreen()) << "Warning (in " << func_sig << "): ";
         else
-          *(fScreen) << "Warning: ";
+          *(GetScreen()) << "Warning: ";
         if (fUseColor) {
-          *(fScreen) << QwColor(Qw::kNormal);
+          *(GetScreen()) << QwColor(Qw::kNormal);
           fScreenInColor = false;
         }
         break;
@@ -235,16 +238,16 @@ QwLog& QwLog::operator()(
 
   if (fFile && fLogLevel <= fFileThreshold) {
     if (fFileAtNewLine) {
-      *(fFile) << GetTime();
+      *(GetFile()) << GetTime();
       switch (level) {
-      case kError:   *(fFile) << " EE"; break;
-      case kWarning: *(fFile) << " WW"; break;
-      case kMessage: *(fFile) << " MM"; break;
-      case kVerbose: *(fFile) << " VV"; break;
-      case kDebug:   *(fFile) << " DD"; break;
-      default: *(fFile) << "   "; break;
+      case kError:   *(GetFile()) << " EE"; break;
+      case kWarning: *(GetFile()) << " WW"; break;
+      case kMessage: *(GetFile()) << " MM"; break;
+      case kVerbose: *(GetFile()) << " VV"; break;
+      case kDebug:   *(GetFile()) << " DD"; break;
+      default: *(GetFile()) << "   "; break;
       }
-      *(fFile) << " - ";
+      *(GetFile()) << " - ";
       fFileAtNewLine = false;
     }
   }
@@ -258,7 +261,7 @@ QwLog& QwLog::operator()(
 QwLog& QwLog::operator<<(std::ios_base& (*manip) (std::ios_base&))
 {
   if (fScreen && (fLogLevel <= fScreenThreshold || fLogLevel <= fFileThreshold) ) {
-    *(fScreen) << manip;
+    *(GetScreen()) << manip;
   }
 
 // The following solution leads to double calls to QwLog::endl
@@ -278,7 +281,7 @@ QwLog& QwLog::operator<<(std::ios_base& (*manip) (std::ios_base&))
 QwLog& QwLog::operator<<(std::ostream& (*manip) (std::ostream&))
 {
   if (fScreen && (fLogLevel <= fScreenThreshold || fLogLevel <= fFileThreshold) ) {
-    *(fScreen) << manip;
+    *(GetScreen()) << manip;
   }
 
 // The following solution leads to double calls to QwLog::endl
@@ -298,14 +301,14 @@ std::ostream& QwLog::endl(std::ostream& strm)
 {
   if (gQwLog.fScreen && gQwLog.fLogLevel <= gQwLog.fScreenThreshold) {
     if (fScreenInColor)
-      *(gQwLog.fScreen) << QwColor(Qw::kNormal) << std::endl;
+      *(gQwLog.GetScreen()) << QwColor(Qw::kNormal) << std::endl;
     else
-      *(gQwLog.fScreen) << std::endl;
+      *(gQwLog.GetScreen()) << std::endl;
     fScreenAtNewLine = true;
     fScreenInColor = false;
   }
   if (gQwLog.fFile && gQwLog.fLogLevel <= gQwLog.fFileThreshold) {
-    *(gQwLog.fFile) << std::endl;
+    *(gQwLog.GetFile()) << std::endl;
     fFileAtNewLine = true;
   }
 
@@ -317,22 +320,48 @@ std::ostream& QwLog::endl(std::ostream& strm)
 std::ostream& QwLog::flush(std::ostream& strm)
 {
   if (gQwLog.fScreen) {
-    *(gQwLog.fScreen) << std::flush;
+    *(gQwLog.GetScreen()) << std::flush;
   }
   if (gQwLog.fFile) {
-    *(gQwLog.fFile) << std::flush;
+    *(gQwLog.GetFile()) << std::flush;
   }
   return strm;
 }
 
+/*! Redirect the output of the calling thread into a capture, or back to
+ *  the screen and file with a null pointer
+ */
+QwLogCapture* QwLog::SetCapture(QwLogCapture* capture)
+{
+  QwLogCapture* previous = fCapture;
+  fCapture = capture;
+  return previous;
+}
+
+/*! Write captured output to the screen and file, or to the capture of the
+ *  calling thread if it has one, and clear the capture
+ */
+void QwLog::Replay(QwLogCapture& capture)
+{
+  if (capture.fScreen && capture.fScreen->tellp() > 0) {
+    if (fScreen) *(GetScreen()) << capture.fScreen->str();
+    capture.fScreen->str("");
+  }
+  if (capture.fFile && capture.fFile->tellp() > 0) {
+    if (fFile) *(GetFile()) << capture.fFile->str();
+    capture.fFile->str("");
+  }
+}
+
 /*! Get the local time
  */
 const char* QwLog::GetTime()
 {
   time_t now = time(0);
   if (now >= 0) {
-    struct tm *currentTime = localtime(&now);
-    strftime(fTimeString, 128, "%Y-%m-%d, %T", currentTime);
+    struct tm currentTime;
+    localtime_r(&now, &currentTime);
+    strftime(fTimeString, 128, "%Y-%m-%d, %T", &currentTime);
     return fTimeString;
   } else {
     return "";
@@ -119,9 +119,9 @@ Int_t QwMollerADC_Channel::ApplyHWChecks()
     if (!fEventIsGood)    
       fSequenceNo_Counter=0;//resetting the counter after ApplyHWChecks() a failure
 
-    if ((TMath::Abs(GetRawHardwareSum())*kMollerADC_VoltsPerBit/fNumberOfSamples) > GetMollerADCSaturationLimt()){
+    if ((TMath::Abs(GetRawHardwareSum())*kMollerADC_VoltsPerBit/fData->fNumberOfSamples) > GetMollerADCSaturationLimt()){
       if (bDEBUG) 
-        QwWarning << this->GetElementName()<<" "<<GetRawHardwareSum() << "Saturating MollerADC invoked! " <<TMath::Abs(GetRawHardwareSum())*kMollerADC_VoltsPerBit/fNumberOfSamples<<" Limit "<<GetMollerADCSaturationLimt() << QwLog::endl;
+        QwWarning << this->GetElementName()<<" "<<GetRawHardwareSum() << "Saturating MollerADC invoked! " <<TMath::Abs(GetRawHardwareSum())*kMollerADC_VoltsPerBit/fData->fNumberOfSamples<<" Limit "<<GetMollerADCSaturationLimt() << QwLog::endl;
       fErrorFlag|=kErrorFlag_VQWK_Sat; 
     }
 
@@ -179,7 +179,7 @@ void QwMollerADC_Channel::InitializeChannel(TString name, TString datatosave)
 
   fPreviousSequenceNumber = 0;
   fNumberOfSamples_map    = 0;
-  fNumberOfSamples        = 0;
+  fData->fNumberOfSamples        = 0;
 
   // Use internal random variable by default
   fUseExternalRandomVariable = false;
@@ -247,21 +247,21 @@ void QwMollerADC_Channel::LoadChannelParameters(QwParameterFile &paramfile){
 void QwMollerADC_Channel::ClearEventData()
 {
   for (Int_t i = 0; i < fBlocksPerEvent; i++) {
-    fBlock_raw[i] = 0;
+    fData->fBlock_raw[i] = 0;
     fBlockSumSq_raw[i] = 0;
     fBlock_min[i] = 0;
     fBlock_max[i] = 0;
-    fBlock[i] = 0.0;
-    fBlockM2[i] = 0.0;
+    fData->fBlock[i] = 0.0;
+    fData->fBlockM2[i] = 0.0;
     fBlockError[i] = 0.0;
   }
-  fHardwareBlockSum_raw = 0;
+  fData->fHardwareBlockSum_raw = 0;
   fSoftwareBlockSum_raw = 0;
-  fHardwareBlockSum   = 0.0;
-  fHardwareBlockSumM2 = 0.0;
+  fData->fHardwareBlockSum   = 0.0;
+  fData->fHardwareBlockSumM2 = 0.0;
   fHardwareBlockSumError = 0.0;
   fSequenceNumber   = 0;
-  fNumberOfSamples  = 0;
+  fData->fNumberOfSamples  = 0;
   fGoodEventCount   = 0;
   fErrorFlag=0;
   return;
@@ -269,43 +269,38 @@ void QwMollerADC_Channel::ClearEventData()
 
 void QwMollerADC_Channel::RandomizeEventData(int helicity, double time)
 {
-  // updated to calculate the drift for each block individually
-  Double_t drift = 0.0;
-  for (Int_t i = 0; i < fBlocksPerEvent; i++){
-    drift = 0.0;
-    if (i >= 1){
-      time += (fNumberOfSamples_map/4.0)*kTimePerSample;
-    }
-    for (UInt_t i = 0; i < fMockDriftFrequency.size(); i++) {
-      drift += fMockDriftAmplitude[i] * sin(2.0 * Qw::pi * fMockDriftFrequency[i] * time + fMockDriftPhase[i]);
-      //std::cout << "Drift: " << drift << std::endl;
-    }
-  }
+  // The drift is evaluated at the time of the last block
+  time += (fBlocksPerEvent - 1)*(fNumberOfSamples_map/4.0)*kTimePerSample;
+  Double_t drift = GetRandomEventDrift(time);
+
+  // Random values for all blocks at once
+  Double_t random[4];
+  GetRandomValues(random, fBlocksPerEvent);
 
   // Calculate signal
-  fHardwareBlockSum = 0.0;
-  fHardwareBlockSumM2 = 0.0; // second moment is zero for single events
+  fData->fHardwareBlockSum = 0.0;
+  fData->fHardwareBlockSumM2 = 0.0; // second moment is zero for single events
   fBlock_max[4] = kMinInt;
   fBlock_min[4] = kMaxInt;
 
   for (Int_t i = 0; i < fBlocksPerEvent; i++) {
-    double tmpvar = GetRandomValue();
+    double tmpvar = random[i];
 
-    fBlock[i] = fMockGaussianMean + drift;
+    fData->fBlock[i] = fMockGaussianMean + drift;
 
     if (fCalcMockDataAsDiff) {
-      fBlock[i] += helicity*fMockAsymmetry;
+      fData->fBlock[i] += helicity*fMockAsymmetry;
     } else {
-      fBlock[i] *= 1.0 + helicity*fMockAsymmetry;
+      fData->fBlock[i] *= 1.0 + helicity*fMockAsymmetry;
     }
-    fBlock[i] += fMockGaussianSigma*tmpvar*sqrt(fBlocksPerEvent);
-    fBlockM2[i] = 0.0; // second moment is zero for single events
-    fHardwareBlockSum += fBlock[i];
+    fData->fBlock[i] += fMockGaussianSigma*tmpvar*sqrt(fBlocksPerEvent);
+    fData->fBlockM2[i] = 0.0; // second moment is zero for single events
+    fData->fHardwareBlockSum += fData->fBlock[i];
 
   }
-  fHardwareBlockSum /= fBlocksPerEvent;
+  fData->fHardwareBlockSum /= fBlocksPerEvent;
   fSequenceNumber = 0;
-  fNumberOfSamples = fNumberOfSamples_map;
+  fData->fNumberOfSamples = fNumberOfSamples_map;
   //  SetEventData(block);
   //  delete block;
   return;
@@ -313,19 +308,22 @@ void QwMollerADC_Channel::RandomizeEventData(int helicity, double time)
 
 void QwMollerADC_Channel::SmearByResolution(double resolution){
 
-  fHardwareBlockSum   = 0.0;
-  fHardwareBlockSumM2 = 0.0; // second moment is zero for single events
+  Double_t random[4];
+  GetRandomValues(random, fBlocksPerEvent);
+
+  fData->fHardwareBlockSum   = 0.0;
+  fData->fHardwareBlockSumM2 = 0.0; // second moment is zero for single events
   for (Int_t i = 0; i < fBlocksPerEvent; i++) {
 
-    fBlock[i] += resolution*sqrt(fBlocksPerEvent) * GetRandomValue();
+    fData->fBlock[i] += resolution*sqrt(fBlocksPerEvent) * random[i];
  
-    fBlockM2[i] = 0.0; // second moment is zero for single events
-    fHardwareBlockSum += fBlock[i];
+    fData->fBlockM2[i] = 0.0; // second moment is zero for single events
+    fData->fHardwareBlockSum += fData->fBlock[i];
   }
   // std::cout << std::endl;
-  fHardwareBlockSum /= fBlocksPerEvent;
+  fData->fHardwareBlockSum /= fBlocksPerEvent;
 
-  fNumberOfSamples = fNumberOfSamples_map;
+  fData->fNumberOfSamples = fNumberOfSamples_map;
   // SetRawEventData();
   return;
 }
@@ -348,17 +346,17 @@ void QwMollerADC_Channel::SetHardwareSum(Double_t hwsum, UInt_t sequencenumber)
 
 void QwMollerADC_Channel::SetEventData(Double_t* block, UInt_t sequencenumber)
 {
-  fHardwareBlockSum = 0.0;
-  fHardwareBlockSumM2 = 0.0; // second moment is zero for single events
+  fData->fHardwareBlockSum = 0.0;
+  fData->fHardwareBlockSumM2 = 0.0; // second moment is zero for single events
   for (Int_t i = 0; i < fBlocksPerEvent; i++) {
-    fBlock[i] = block[i];
-    fBlockM2[i] = 0.0; // second moment is zero for single events
-    fHardwareBlockSum += block[i];
+    fData->fBlock[i] = block[i];
+    fData->fBlockM2[i] = 0.0; // second moment is zero for single events
+    fData->fHardwareBlockSum += block[i];
   }
-  fHardwareBlockSum /= fBlocksPerEvent;
+  fData->fHardwareBlockSum /= fBlocksPerEvent;
 
   fSequenceNumber = sequencenumber;
-  fNumberOfSamples = fNumberOfSamples_map;
+  fData->fNumberOfSamples = fNumberOfSamples_map;
 
 //  Double_t thispedestal = 0.0;
 //  thispedestal = fPedestal * fNumberOfSamples;
@@ -369,29 +367,29 @@ void QwMollerADC_Channel::SetEventData(Double_t* block, UInt_t sequencenumber)
 
 __attribute__((no_sanitize("signed-integer-overflow")))
 void QwMollerADC_Channel::SetRawEventData(){
-  fNumberOfSamples = fNumberOfSamples_map;
-  fHardwareBlockSum_raw = 0;
+  fData->fNumberOfSamples = fNumberOfSamples_map;
+  fData->fHardwareBlockSum_raw = 0;
 //  Double_t hwsum_test = 0.0;
 //  std::cout <<  "*******In QwMollerADC_Channel::SetRawEventData for channel:\t" << this->GetElementName() << std::endl;
   for (Int_t i = 0; i < fBlocksPerEvent; i++) 
     {
-     Double_t block_raw = (fBlock[i] / fCalibrationFactor + fPedestal) * fNumberOfSamples / (fBlocksPerEvent * 1.0);
+     Double_t block_raw = (fData->fBlock[i] / fCalibrationFactor + fPedestal) * fData->fNumberOfSamples / (fBlocksPerEvent * 1.0);
      if (std::abs(block_raw) >= pow(2,29)) {
       block_raw = std::copysign(pow(2,29)-1, block_raw);
       QwWarning << "QwMollerADC_Channel::SetRawEventData: Overflow in conversion to raw data for channel "
                 << this->GetElementName() << ": ("
-                << "fBlock[i] = " << fBlock[i] << " / "
+                << "fBlock[i] = " << fData->fBlock[i] << " / "
                 << "fCalibrationFactor = " << fCalibrationFactor << " + "
                 << "fPedestal = " << fPedestal << ") * "
-                << "fNumberOfSamples = " << fNumberOfSamples << " / "
+                << "fNumberOfSamples = " << fData->fNumberOfSamples << " / "
                 << "fBlocksPerEvent = " << fBlocksPerEvent << ". "
                 << "Capping value to " << block_raw << "."
                 << QwLog::endl;
      }
-     fBlock_raw[i] = Int_t(block_raw);
-     fHardwareBlockSum_raw += fBlock_raw[i];
+     fData->fBlock_raw[i] = Int_t(block_raw);
+     fData->fHardwareBlockSum_raw += fData->fBlock_raw[i];
      
-    double_t block = fBlock[i] / fCalibrationFactor;
+    double_t block = fData->fBlock[i] / fCalibrationFactor;
     double_t sigma = fMockGaussianSigma / fCalibrationFactor;
     fBlockSumSq_raw[i] = (sigma*sigma + block*block)*fNumberOfSamples_map / (fBlocksPerEvent * 1.0);
     fBlock_min[i] = (block - 3.0 * sigma) * double_t(fNumberOfSamples_map) / (fBlocksPerEvent * 1.0);
@@ -404,7 +402,7 @@ void QwMollerADC_Channel::SetRawEventData(){
 
 
 
-  fSoftwareBlockSum_raw = fHardwareBlockSum_raw;
+  fSoftwareBlockSum_raw = fData->fHardwareBlockSum_raw;
 
   return;
 }
@@ -419,7 +417,7 @@ void QwMollerADC_Channel::EncodeEventData(std::vector<UInt_t> &buffer)
   } else {
     //    localbuf[4] = 0;
     for (Int_t i = 0; i < 4; i++) {
-      localbuf[i*5] = fBlock_raw[i];
+      localbuf[i*5] = fData->fBlock_raw[i];
       localbuf[i*5+1] = fBlockSumSq_raw[i] & 0xffffffff;
       localbuf[i*5+2] = fBlockSumSq_raw[i] >> 32;
       localbuf[i*5+3] = fBlock_min[i];
@@ -429,12 +427,12 @@ void QwMollerADC_Channel::EncodeEventData(std::vector<UInt_t> &buffer)
     }
     // The following causes many rounding errors and skips due to the check
     // that fHardwareBlockSum_raw == fSoftwareBlockSum_raw in IsGoodEvent().
-    localbuf[20] = fHardwareBlockSum_raw;
+    localbuf[20] = fData->fHardwareBlockSum_raw;
     localbuf[21] = fBlockSumSq_raw[4] & 0xffffffff;
     localbuf[22] = fBlockSumSq_raw[4] >> 32;
     localbuf[23] = fBlock_min[4];
     localbuf[24] = fBlock_max[4];
-    localbuf[25] = (fNumberOfSamples << 16 & 0xFFFF0000)
+    localbuf[25] = (fData->fNumberOfSamples << 16 & 0xFFFF0000)
                 | (fSequenceNumber  << 8  & 0x0000FF00);
 
     for (Int_t i = 0; i < kWordsPerChannel; i++){
@@ -448,10 +446,6 @@ void QwMollerADC_Channel::EncodeEventData(std::vector<UInt_t> &buffer)
 Int_t QwMollerADC_Channel::ProcessEvBuffer(UInt_t* buffer, UInt_t num_words_left, UInt_t index)
 {
   UInt_t words_read = 0;
-  UInt_t localbuf[kWordsPerChannel] = {0};
-  // The conversion from UInt_t to Double_t discards the sign, so we need an intermediate
-  // static_cast from UInt_t to Int_t.
-  Int_t localbuf_signed[kWordsPerChannel] = {0};
 
   if (IsNameEmpty()){
     //  This channel is not used, but is present in the data stream.
@@ -459,56 +453,60 @@ Int_t QwMollerADC_Channel::ProcessEvBuffer(UInt_t* buffer, UInt_t num_words_left
     words_read = fNumberOfDataWords;
   } else if (num_words_left >= fNumberOfDataWords)
     {
-      for (Int_t i=0; i<kWordsPerChannel; i++){
-        localbuf[i] = buffer[i];
-        localbuf_signed[i] = static_cast<Int_t>(localbuf[i]);
-      }
-
-      fSoftwareBlockSum_raw = 0;
-      for (Int_t i=0; i<fBlocksPerEvent; i++){
-        fBlock_raw[i] = localbuf_signed[i*5];
-        fBlockSumSq_raw[i] = localbuf_signed[i*5+1];
-        fBlockSumSq_raw[i] += Long64_t (localbuf_signed[i*5+2]) << 32;
-        fBlock_min[i] = localbuf_signed[i*5+3];
-        fBlock_max[i] = localbuf_signed[i*5+4];
-        fSoftwareBlockSum_raw += fBlock_raw[i];
-      }
-      fHardwareBlockSum_raw = localbuf_signed[20];
-
-      /*  Permanent change in the structure of the 6th word of the ADC readout.
-       *  The upper 16 bits are the number of samples, and the upper 8 of the
-       *  lower 16 are the sequence number.  This matches the structure of
-       *  the ADC readout in block read mode, and now also in register read mode.
-       *  P.King, 2007sep04.
-       */
-      fSequenceNumber   = (localbuf[25]>>8)  & 0xFF;
-      fNumberOfSamples  = (localbuf[25]>>16) & 0xFFFF;
+      QwADCDecoder::MollerADCWords words;
+      QwADCDecoder::DecodeMollerADC(buffer, words);
+      SetRawWords(words);
 
       words_read = fNumberOfDataWords;
 
     } else
       {
-        std::cerr << "QwMollerADC_Channel::ProcessEvBuffer: Not enough words!"
-                  << std::endl;
+        QwError << "QwMollerADC_Channel::ProcessEvBuffer: Not enough words!"
+                << QwLog::endl;
       }
   return words_read;
 }
 
+/**
+ * Set the raw event data from the unpacked words of a CODA buffer, as
+ * returned by QwADCDecoder::DecodeMollerADC.  Only the blocks used by
+ * this channel are copied.
+ *
+ * The structure of the 6th word of the ADC readout (number of samples in
+ * the upper 16 bits, sequence number in the upper 8 of the lower 16 bits)
+ * matches the ADC readout in block read mode, and now also in register
+ * read mode.  P.King, 2007sep04.
+ */
+void QwMollerADC_Channel::SetRawWords(const QwADCDecoder::MollerADCWords& words)
+{
+  fSoftwareBlockSum_raw = 0;
+  for (Int_t i=0; i<fBlocksPerEvent; i++){
+    fData->fBlock_raw[i] = words.fBlock_raw[i];
+    fBlockSumSq_raw[i] = words.fBlockSumSq_raw[i];
+    fBlock_min[i] = words.fBlock_min[i];
+    fBlock_max[i] = words.fBlock_max[i];
+    fSoftwareBlockSum_raw += fData->fBlock_raw[i];
+  }
+  fData->fHardwareBlockSum_raw = words.fHardwareBlockSum_raw;
+  fSequenceNumber   = words.fSequenceNumber;
+  fData->fNumberOfSamples  = words.fNumberOfSamples;
+}
+
 
 
 void QwMollerADC_Channel::ProcessEvent()
 {
-  if (fNumberOfSamples == 0 && fHardwareBlockSum_raw == 0) {
+  if (fData->fNumberOfSamples == 0 && fData->fHardwareBlockSum_raw == 0) {
     //  There isn't valid data for this channel.  Just flag it and
     //  move on.
     for (Int_t i = 0; i < fBlocksPerEvent; i++) {
-      fBlock[i] = 0.0;
-      fBlockM2[i] = 0.0;
+      fData->fBlock[i] = 0.0;
+      fData->fBlockM2[i] = 0.0;
     }
-    fHardwareBlockSum = 0.0;
-    fHardwareBlockSumM2 = 0.0;
+    fData->fHardwareBlockSum = 0.0;
+    fData->fHardwareBlockSumM2 = 0.0;
     fErrorFlag |= kErrorFlag_sample;
-  } else if (fNumberOfSamples == 0) {
+  } else if (fData->fNumberOfSamples == 0) {
     //  This is probably a more serious problem.
     QwWarning << "QwMollerADC_Channel::ProcessEvent:  Channel "
               << this->GetElementName().Data()
@@ -516,19 +514,19 @@ void QwMollerADC_Channel::ProcessEvent()
               << "Flag this as an error."
               << QwLog::endl;
     for (Int_t i = 0; i < fBlocksPerEvent; i++) {
-      fBlock[i] = 0.0;
-      fBlockM2[i] = 0.0;
+      fData->fBlock[i] = 0.0;
+      fData->fBlockM2[i] = 0.0;
     }
-    fHardwareBlockSum = 0.0;
-    fHardwareBlockSumM2 = 0.0;
+    fData->fHardwareBlockSum = 0.0;
+    fData->fHardwareBlockSumM2 = 0.0;
     fErrorFlag|=kErrorFlag_sample;
   } else {
     for (Int_t i = 0; i < fBlocksPerEvent; i++) {
-      fBlock[i] = fCalibrationFactor * ( (1.0 * fBlock_raw[i] * fBlocksPerEvent / fNumberOfSamples) - fPedestal );
-      fBlockM2[i] = 0.0; // second moment is zero for single events
+      fData->fBlock[i] = fCalibrationFactor * ( (1.0 * fData->fBlock_raw[i] * fBlocksPerEvent / fData->fNumberOfSamples) - fPedestal );
+      fData->fBlockM2[i] = 0.0; // second moment is zero for single events
     }
-    fHardwareBlockSum = fCalibrationFactor * ( (1.0 * fHardwareBlockSum_raw / fNumberOfSamples) - fPedestal );
-    fHardwareBlockSumM2 = 0.0; // second moment is zero for single events
+    fData->fHardwareBlockSum = fCalibrationFactor * ( (1.0 * fData->fHardwareBlockSum_raw / fData->fNumberOfSamples) - fPedestal );
+    fData->fHardwareBlockSumM2 = 0.0; // second moment is zero for single events
   }
   return;
 }
@@ -536,7 +534,7 @@ void QwMollerADC_Channel::ProcessEvent()
 Double_t QwMollerADC_Channel::GetAverageVolts() const
 {
   //Double_t avgVolts = (fBlock[0]+fBlock[1]+fBlock[2]+fBlock[3])*kMollerADC_VoltsPerBit/fNumberOfSamples;
-  Double_t avgVolts = fHardwareBlockSum * kMollerADC_VoltsPerBit / fNumberOfSamples;
+  Double_t avgVolts = fData->fHardwareBlockSum * kMollerADC_VoltsPerBit / fData->fNumberOfSamples;
   //std::cout<<"QwMollerADC_Channel::GetAverageVolts() = "<<avgVolts<<std::endl;
   return avgVolts;
 
@@ -552,21 +550,21 @@ void QwMollerADC_Channel::PrintInfo() const
   std::cout<<"fCalibrationFactor= "<<fCalibrationFactor<<"\n";
   std::cout<<"fBlocksPerEvent= "<<fBlocksPerEvent<<"\n"<<"\n";
   std::cout<<"fSequenceNumber= "<<fSequenceNumber<<"\n";
-  std::cout<<"fNumberOfSamples= "<<fNumberOfSamples<<"\n";
+  std::cout<<"fNumberOfSamples= "<<fData->fNumberOfSamples<<"\n";
   std::cout<<"fBlock_raw ";
 
   for (Int_t i = 0; i < fBlocksPerEvent; i++)
-    std::cout << " : " << fBlock_raw[i];
+    std::cout << " : " << fData->fBlock_raw[i];
   std::cout<<"\n";
-  std::cout<<"fHardwareBlockSum_raw= "<<fHardwareBlockSum_raw<<"\n";
+  std::cout<<"fHardwareBlockSum_raw= "<<fData->fHardwareBlockSum_raw<<"\n";
   std::cout<<"fSoftwareBlockSum_raw= "<<fSoftwareBlockSum_raw<<"\n";
   std::cout<<"fBlock ";
   for (Int_t i = 0; i < fBlocksPerEvent; i++)
-    std::cout << " : " <<std::setprecision(8) << fBlock[i];
+    std::cout << " : " <<std::setprecision(8) << fData->fBlock[i];
   std::cout << std::endl;
 
-  std::cout << "fHardwareBlockSum = "<<std::setprecision(8) <<fHardwareBlockSum << std::endl;
-  std::cout << "fHardwareBlockSumM2 = "<<fHardwareBlockSumM2 << std::endl;
+  std::cout << "fHardwareBlockSum = "<<std::setprecision(8) <<fData->fHardwareBlockSum << std::endl;
+  std::cout << "fHardwareBlockSumM2 = "<<fData->fHardwareBlockSumM2 << std::endl;
   std::cout << "fHardwareBlockSumError = "<<fHardwareBlockSumError << std::endl;
 
   return;
@@ -634,43 +632,43 @@ void  QwMollerADC_Channel::FillHistograms()
             for (Int_t i=0; i<fBlocksPerEvent; i++)
               {
                 if (fHistograms[index] != NULL && (fErrorFlag)==0)
-                  fHistograms[index]->Fill(this->GetRawBlockValue(i));
+                  FillHistogram(index, this->GetRawBlockValue(i));
                 if (fHistograms[index+1] != NULL && (fErrorFlag)==0)
-                  fHistograms[index+1]->Fill(this->GetBlockValue(i));
+                  FillHistogram(index+1, this->GetBlockValue(i));
                 index+=2;
               }
             if (fHistograms[index] != NULL && (fErrorFlag)==0)
-              fHistograms[index]->Fill(this->GetRawHardwareSum());
+              FillHistogram(index, this->GetRawHardwareSum());
             if (fHistograms[index+1] != NULL && (fErrorFlag)==0)
-              fHistograms[index+1]->Fill(this->GetHardwareSum());
+              FillHistogram(index+1, this->GetHardwareSum());
             index+=2;
             if (fHistograms[index] != NULL && (fErrorFlag)==0)
-              fHistograms[index]->Fill(this->GetRawSoftwareSum()-this->GetRawHardwareSum());
+              FillHistogram(index, this->GetRawSoftwareSum()-this->GetRawHardwareSum());
           }
         else if(fDataToSave==kDerived)
           {
             for (Int_t i=0; i<fBlocksPerEvent; i++)
               {
                 if (fHistograms[index] != NULL && (fErrorFlag)==0)
-                  fHistograms[index]->Fill(this->GetBlockValue(i));
+                  FillHistogram(index, this->GetBlockValue(i));
                 index+=1;
               }
             if (fHistograms[index] != NULL && (fErrorFlag)==0)
-              fHistograms[index]->Fill(this->GetHardwareSum());
+              FillHistogram(index, this->GetHardwareSum());
             index+=1; 
             if (fHistograms[index] != NULL){
               if ( (kErrorFlag_sample &  fErrorFlag)==kErrorFlag_sample)
-                fHistograms[index]->Fill(kErrorFlag_sample);
+                FillHistogram(index, kErrorFlag_sample);
               if ( (kErrorFlag_SW_HW &  fErrorFlag)==kErrorFlag_SW_HW)
-                fHistograms[index]->Fill(kErrorFlag_SW_HW);
+                FillHistogram(index, kErrorFlag_SW_HW);
               if ( (kErrorFlag_Sequence &  fErrorFlag)==kErrorFlag_Sequence)
-                fHistograms[index]->Fill(kErrorFlag_Sequence);
+                FillHistogram(index, kErrorFlag_Sequence);
               if ( (kErrorFlag_ZeroHW &  fErrorFlag)==kErrorFlag_ZeroHW)
-                fHistograms[index]->Fill(kErrorFlag_ZeroHW);
+                FillHistogram(index, kErrorFlag_ZeroHW);
               if ( (kErrorFlag_VQWK_Sat &  fErrorFlag)==kErrorFlag_VQWK_Sat)
-                fHistograms[index]->Fill(kErrorFlag_VQWK_Sat);
+                FillHistogram(index, kErrorFlag_VQWK_Sat);
               if ( (kErrorFlag_SameHW &  fErrorFlag)==kErrorFlag_SameHW)
-                fHistograms[index]->Fill(kErrorFlag_SameHW);
+                FillHistogram(index, kErrorFlag_SameHW);
             }
             
           }
@@ -746,7 +744,38 @@ void  QwMollerADC_Channel::ConstructBranchAndVector(TTree *tree, TString &prefix
     }
   }
 
-  std::string leaf_list = values.LeafList(fTreeArrayIndex);
+  //  Event values are kept in place for the whole run, so the tree
+  //  may bind its leaves to them directly (moments are calculated)
+  if (fDataToSave != kMoments) {
+    UInt_t index = fTreeArrayIndex;
+    if (bHw_sum)
+      values.SetSource(index++, &fData->fHardwareBlockSum);
+    if (bBlock) {
+      for (Int_t i = 0; i < 4; i++)
+        values.SetSource(index++, &fData->fBlock[i]);
+    }
+    if (bNum_samples)
+      values.SetSource(index++, &fData->fNumberOfSamples);
+    if (bDevice_Error_Code)
+      values.SetSource(index++, &fErrorFlag);
+    if (fDataToSave == kRaw) {
+      if (bHw_sum_raw)
+        values.SetSource(index++, &fData->fHardwareBlockSum_raw);
+      if (bBlock_raw) {
+        for (Int_t i = 0; i < 4; i++)
+          values.SetSource(index++, &fData->fBlock_raw[i]);
+        for (Int_t i = 0; i < 4; i++) {
+          values.SetSource(index++, &fBlockSumSq_raw[i]);
+          values.SetSource(index++, &fBlock_min[i]);
+          values.SetSource(index++, &fBlock_max[i]);
+        }
+      }
+      if (bSequence_number)
+        values.SetSource(index++, &fSequenceNumber);
+    }
+  }
+
+  std::string leaf_list = values.LeafList(fTreeArrayIndex, basename.Data());
 
   fTreeArrayNumEntries = values.size() - fTreeArrayIndex;
 
@@ -755,8 +784,8 @@ void  QwMollerADC_Channel::ConstructBranchAndVector(TTree *tree, TString &prefix
         bHw_sum_raw || bBlock_raw || bSequence_number)) {
 
     // This is for the RT mode
-    if (leaf_list == "hw_sum/D")
-      leaf_list = basename+"/D";
+    if (leaf_list.compare(0, 7, "hw_sum/") == 0 && fTreeArrayNumEntries == 1)
+      leaf_list = basename + leaf_list.substr(6);
 
     if (kDEBUG)
       QwMessage << "base name " << basename << " List " << leaf_list << QwLog::endl;
@@ -779,7 +808,7 @@ void  QwMollerADC_Channel::ConstructBranch(TTree *tree, TString &prefix)
   if (IsNameEmpty()) return;
 
   TString basename = prefix + GetElementName();
-  tree->Branch(basename,&fHardwareBlockSum,basename+"/D");
+  tree->Branch(basename,&fData->fHardwareBlockSum,basename+"/D");
   if (kDEBUG){
     std::cerr << "QwMollerADC_Channel::ConstructBranchAndVector: fTreeArrayIndex==" << fTreeArrayIndex
               << "; fTreeArrayNumEntries==" << fTreeArrayNumEntries
@@ -801,6 +830,8 @@ void  QwMollerADC_Channel::FillTreeVector(QwRootTreeBranchVector& values) const
               << "; fTreeArrayIndex+fTreeArrayNumEntries=="
               << fTreeArrayIndex+fTreeArrayNumEntries
               << std::endl;
+  } else if (values.IsBound(fTreeArrayIndex, fTreeArrayNumEntries)) {
+    //  The tree reads the values of this channel directly
   } else {
 
     UInt_t index = fTreeArrayIndex;
@@ -823,7 +854,7 @@ void  QwMollerADC_Channel::FillTreeVector(QwRootTreeBranchVector& values) const
 
     // num_samples
     if (bNum_samples)
-      values.SetValue(index++, (fDataToSave == kMoments)? this->fGoodEventCount: this->fNumberOfSamples);
+      values.SetValue(index++, (fDataToSave == kMoments)? this->fGoodEventCount: this->fData->fNumberOfSamples);
     // Device_Error_Code
     if (bDevice_Error_Code)
       values.SetValue(index++, this->fErrorFlag);
@@ -1041,7 +1072,7 @@ void  QwMollerADC_Channel::FillNTupleVector(std::vector<Double_t>& values) const
 
     // num_samples
     if (bNum_samples)
-      values[index++] = fDataToSave == kMoments ? this->fGoodEventCount : this->fNumberOfSamples;
+      values[index++] = fDataToSave == kMoments ? this->fGoodEventCount : this->fData->fNumberOfSamples;
 
     // Device_Error_Code
     if (bDevice_Error_Code)
@@ -1081,29 +1112,53 @@ QwMollerADC_Channel& QwMollerADC_Channel::operator= (const QwMollerADC_Channel &
   if (!IsNameEmpty()) {
     VQwHardwareChannel::operator=(value);
     for (Int_t i=0; i<fBlocksPerEvent; i++){
-      this->fBlock[i]     = value.fBlock[i];
-      this->fBlockM2[i]   = value.fBlockM2[i];
+      this->fData->fBlock[i]     = value.fData->fBlock[i];
+      this->fData->fBlockM2[i]   = value.fData->fBlockM2[i];
     }
-    this->fHardwareBlockSum = value.fHardwareBlockSum;
-    this->fHardwareBlockSumM2 = value.fHardwareBlockSumM2;
+    this->fData->fHardwareBlockSum = value.fData->fHardwareBlockSum;
+    this->fData->fHardwareBlockSumM2 = value.fData->fHardwareBlockSumM2;
     this->fHardwareBlockSumError = value.fHardwareBlockSumError;
-    this->fNumberOfSamples = value.fNumberOfSamples;
+    this->fData->fNumberOfSamples = value.fData->fNumberOfSamples;
     this->fSequenceNumber  = value.fSequenceNumber;
    
     if (this->fDataToSave == kRaw){
       for (Int_t i=0; i<fBlocksPerEvent; i++){
-       this->fBlock_raw[i] = value.fBlock_raw[i];
+       this->fData->fBlock_raw[i] = value.fData->fBlock_raw[i];
        this->fBlockSumSq_raw[i] = value.fBlockSumSq_raw[i];
        this->fBlock_min[i]     = value.fBlock_min[i];
        this->fBlock_max[i]     = value.fBlock_max[i];
       }
-      this->fHardwareBlockSum_raw = value.fHardwareBlockSum_raw;
+      this->fData->fHardwareBlockSum_raw = value.fData->fHardwareBlockSum_raw;
       this->fSoftwareBlockSum_raw = value.fSoftwareBlockSum_raw;
     }
   }
   return *this;
 }
 
+/// Transfer the same event-based data as operator= to or from a snapshot
+void QwMollerADC_Channel::Snapshot(QwSnapshot& snapshot)
+{
+  if (!IsNameEmpty()) {
+    VQwHardwareChannel::Snapshot(snapshot);
+    snapshot.Transfer(fData->fBlock, fBlocksPerEvent);
+    snapshot.Transfer(fData->fBlockM2, fBlocksPerEvent);
+    snapshot.Transfer(fData->fHardwareBlockSum);
+    snapshot.Transfer(fData->fHardwareBlockSumM2);
+    snapshot.Transfer(fHardwareBlockSumError);
+    snapshot.Transfer(fData->fNumberOfSamples);
+    snapshot.Transfer(fSequenceNumber);
+
+    if (this->fDataToSave == kRaw){
+      snapshot.Transfer(fData->fBlock_raw, fBlocksPerEvent);
+      snapshot.Transfer(fBlockSumSq_raw, fBlocksPerEvent);
+      snapshot.Transfer(fBlock_min, fBlocksPerEvent);
+      snapshot.Transfer(fBlock_max, fBlocksPerEvent);
+      snapshot.Transfer(fData->fHardwareBlockSum_raw);
+      snapshot.Transfer(fSoftwareBlockSum_raw);
+    }
+  }
+}
+
 void QwMollerADC_Channel::AssignScaledValue(const QwMollerADC_Channel &value,
                                  Double_t scale)
 {
@@ -1111,15 +1166,15 @@ void QwMollerADC_Channel::AssignScaledValue(const QwMollerADC_Channel &value,
 
   if (!IsNameEmpty()) {
     for (Int_t i=0; i<fBlocksPerEvent; i++){
-      this->fBlock[i]   = value.fBlock[i]   * scale;
-      this->fBlockM2[i] = value.fBlockM2[i] * scale * scale;
+      this->fData->fBlock[i]   = value.fData->fBlock[i]   * scale;
+      this->fData->fBlockM2[i] = value.fData->fBlockM2[i] * scale * scale;
 
     }
-    this->fHardwareBlockSum   = value.fHardwareBlockSum * scale;
-    this->fHardwareBlockSumM2 = value.fHardwareBlockSumM2 * scale * scale;
+    this->fData->fHardwareBlockSum   = value.fData->fHardwareBlockSum * scale;
+    this->fData->fHardwareBlockSumM2 = value.fData->fHardwareBlockSumM2 * scale * scale;
     this->fHardwareBlockSumError = value.fHardwareBlockSumError;   // Keep this?
     this->fGoodEventCount  = value.fGoodEventCount;
-    this->fNumberOfSamples = value.fNumberOfSamples;
+    this->fData->fNumberOfSamples = value.fData->fNumberOfSamples;
     this->fSequenceNumber  = value.fSequenceNumber;
     this->fErrorFlag       = value.fErrorFlag;
   }
@@ -1199,12 +1254,12 @@ QwMollerADC_Channel& QwMollerADC_Channel::operator+= (const QwMollerADC_Channel
 
   if (!IsNameEmpty()) {
     for (Int_t i = 0; i < fBlocksPerEvent; i++) {
-      this->fBlock[i] += value.fBlock[i];
-      this->fBlockM2[i] = 0.0;
+      this->fData->fBlock[i] += value.fData->fBlock[i];
+      this->fData->fBlockM2[i] = 0.0;
     }
-    this->fHardwareBlockSum    += value.fHardwareBlockSum;
-    this->fHardwareBlockSumM2   = 0.0;
-    this->fNumberOfSamples     += value.fNumberOfSamples;
+    this->fData->fHardwareBlockSum    += value.fData->fHardwareBlockSum;
+    this->fData->fHardwareBlockSumM2   = 0.0;
+    this->fData->fNumberOfSamples     += value.fData->fNumberOfSamples;
     this->fSequenceNumber       = 0;
     this->fErrorFlag            |= (value.fErrorFlag);
 
@@ -1224,12 +1279,12 @@ QwMollerADC_Channel& QwMollerADC_Channel::operator-= (const QwMollerADC_Channel
 {
   if (!IsNameEmpty()){
     for (Int_t i=0; i<fBlocksPerEvent; i++){
-      this->fBlock[i] -= value.fBlock[i];
-      this->fBlockM2[i] = 0.0;
+      this->fData->fBlock[i] -= value.fData->fBlock[i];
+      this->fData->fBlockM2[i] = 0.0;
     }
-    this->fHardwareBlockSum    -= value.fHardwareBlockSum;
-    this->fHardwareBlockSumM2   = 0.0;
-    this->fNumberOfSamples     += value.fNumberOfSamples;
+    this->fData->fHardwareBlockSum    -= value.fData->fHardwareBlockSum;
+    this->fData->fHardwareBlockSumM2   = 0.0;
+    this->fData->fNumberOfSamples     += value.fData->fNumberOfSamples;
     this->fSequenceNumber       = 0;
     this->fErrorFlag           |= (value.fErrorFlag);
   }
@@ -1248,12 +1303,12 @@ QwMollerADC_Channel& QwMollerADC_Channel::operator*= (const QwMollerADC_Channel
 {
   if (!IsNameEmpty()){
     for (Int_t i=0; i<fBlocksPerEvent; i++){
-      this->fBlock[i] *= value.fBlock[i];
-      this->fBlockM2[i] = 0.0;
+      this->fData->fBlock[i] *= value.fData->fBlock[i];
+      this->fData->fBlockM2[i] = 0.0;
     }
-    this->fHardwareBlockSum     *= value.fHardwareBlockSum;
-    this->fHardwareBlockSumM2    = 0.0;
-    this->fNumberOfSamples      *= value.fNumberOfSamples;
+    this->fData->fHardwareBlockSum     *= value.fData->fHardwareBlockSum;
+    this->fData->fHardwareBlockSumM2    = 0.0;
+    this->fData->fNumberOfSamples      *= value.fData->fNumberOfSamples;
     this->fSequenceNumber        = 0;
     this->fErrorFlag            |= (value.fErrorFlag);
   }
@@ -1331,13 +1386,52 @@ void QwMollerADC_Channel::Difference(const QwMollerADC_Channel &value1, const Qw
   *this -= value2;
 }
 
+/**
+ * Copy the values combined by the helicity pattern kernel: the four block
+ * values followed by the hardware sum.
+ * @param values Array of kPatternValues values
+ */
+void QwMollerADC_Channel::GetPatternValues(Double_t* values) const
+{
+  for (Int_t i = 0; i < 4; i++)
+    values[i] = fData->fBlock[i];
+  values[4] = fData->fHardwareBlockSum;
+}
+
+/**
+ * Set this channel to the (scaled) sum or difference of the phases of a
+ * helicity pattern, with the values calculated by QwPatternKernel.  The
+ * result is the same as assigning the first phase, adding or subtracting
+ * the other phases, and scaling.
+ * @param first     First positive phase
+ * @param samples   Sum of the number of samples of all phases
+ * @param errorflag Error flags of all phases
+ * @param values    Block values and hardware sum, see GetPatternValues
+ */
+void QwMollerADC_Channel::SetPatternSum(const QwMollerADC_Channel& first, UInt_t samples,
+                                        UInt_t errorflag, const Double_t* values)
+{
+  if (!IsNameEmpty()) {
+    *this = first;
+    for (Int_t i = 0; i < fBlocksPerEvent; i++) {
+      fData->fBlock[i]   = values[i];
+      fData->fBlockM2[i] = 0.0;
+    }
+    fData->fHardwareBlockSum   = values[4];
+    fData->fHardwareBlockSumM2 = 0.0;
+    fData->fNumberOfSamples    = samples;
+    fSequenceNumber            = 0;
+    fErrorFlag                 = errorflag;
+  }
+}
+
 void QwMollerADC_Channel::Ratio(const QwMollerADC_Channel &numer, const QwMollerADC_Channel &denom)
 {
   if (!IsNameEmpty()) {
     *this  = numer;
     *this /= denom;
 
-    fNumberOfSamples      = denom.fNumberOfSamples;
+    fData->fNumberOfSamples      = denom.fData->fNumberOfSamples;
     fSequenceNumber       = 0;
     fGoodEventCount       = denom.fGoodEventCount;
     fErrorFlag            = (numer.fErrorFlag|denom.fErrorFlag);
@@ -1357,37 +1451,37 @@ QwMollerADC_Channel& QwMollerADC_Channel::operator/= (const QwMollerADC_Channel
     // This requires that both the numerator and denominator are non-zero!
     //
     for (Int_t i = 0; i < 4; i++) {
-      if (this->fBlock[i] != 0.0 && denom.fBlock[i] != 0.0){
-        ratio    = (this->fBlock[i]) / (denom.fBlock[i]);
+      if (this->fData->fBlock[i] != 0.0 && denom.fData->fBlock[i] != 0.0){
+        ratio    = (this->fData->fBlock[i]) / (denom.fData->fBlock[i]);
         variance =  ratio * ratio *
-           (this->fBlockM2[i] / this->fBlock[i] / this->fBlock[i]
-          + denom.fBlockM2[i] / denom.fBlock[i] / denom.fBlock[i]);
-        fBlock[i]   = ratio;
-        fBlockM2[i] = variance;
-      } else if (this->fBlock[i] == 0.0) {
-        this->fBlock[i]   = 0.0;
-        this->fBlockM2[i] = 0.0;
+           (this->fData->fBlockM2[i] / this->fData->fBlock[i] / this->fData->fBlock[i]
+          + denom.fData->fBlockM2[i] / denom.fData->fBlock[i] / denom.fData->fBlock[i]);
+        fData->fBlock[i]   = ratio;
+        fData->fBlockM2[i] = variance;
+      } else if (this->fData->fBlock[i] == 0.0) {
+        this->fData->fBlock[i]   = 0.0;
+        this->fData->fBlockM2[i] = 0.0;
       } else {
         QwVerbose << "Attempting to divide by zero block in " 
                   << GetElementName() << QwLog::endl;
-        fBlock[i]   = 0.0;
-        fBlockM2[i] = 0.0;
+        fData->fBlock[i]   = 0.0;
+        fData->fBlockM2[i] = 0.0;
       }
     }
-    if (this->fHardwareBlockSum != 0.0 && denom.fHardwareBlockSum != 0.0){
-      ratio    =  (this->fHardwareBlockSum) / (denom.fHardwareBlockSum);
+    if (this->fData->fHardwareBlockSum != 0.0 && denom.fData->fHardwareBlockSum != 0.0){
+      ratio    =  (this->fData->fHardwareBlockSum) / (denom.fData->fHardwareBlockSum);
       variance =  ratio * ratio *
-        (this->fHardwareBlockSumM2 / this->fHardwareBlockSum / this->fHardwareBlockSum
-         + denom.fHardwareBlockSumM2 / denom.fHardwareBlockSum / denom.fHardwareBlockSum);
-      fHardwareBlockSum   = ratio;
-      fHardwareBlockSumM2 = variance;
-    } else if (this->fHardwareBlockSum == 0.0) {
-      fHardwareBlockSum   = 0.0;
-      fHardwareBlockSumM2 = 0.0;
+        (this->fData->fHardwareBlockSumM2 / this->fData->fHardwareBlockSum / this->fData->fHardwareBlockSum
+         + denom.fData->fHardwareBlockSumM2 / denom.fData->fHardwareBlockSum / denom.fData->fHardwareBlockSum);
+      fData->fHardwareBlockSum   = ratio;
+      fData->fHardwareBlockSumM2 = variance;
+    } else if (this->fData->fHardwareBlockSum == 0.0) {
+      fData->fHardwareBlockSum   = 0.0;
+      fData->fHardwareBlockSumM2 = 0.0;
     } else {
       QwVerbose << "Attempting to divide by zero sum in " 
                 << GetElementName() << QwLog::endl;
-      fHardwareBlockSumM2 = 0.0;
+      fData->fHardwareBlockSumM2 = 0.0;
     }
     // Remaining variables
     //  Don't change fNumberOfSamples, fSequenceNumber, fGoodEventCount,
@@ -1396,7 +1490,7 @@ QwMollerADC_Channel& QwMollerADC_Channel::operator/= (const QwMollerADC_Channel
   }
 
   // Nanny
-  if (fHardwareBlockSum != fHardwareBlockSum)
+  if (fData->fHardwareBlockSum != fData->fHardwareBlockSum)
     QwWarning << "Angry Nanny: NaN detected in " << GetElementName() << QwLog::endl;
 
   return *this;
@@ -1407,12 +1501,12 @@ QwMollerADC_Channel& QwMollerADC_Channel::operator/= (const QwMollerADC_Channel
 void QwMollerADC_Channel::ArcTan(const QwMollerADC_Channel &value)
 {
   if (!IsNameEmpty()) {
-    this->fHardwareBlockSum = 0.0;
+    this->fData->fHardwareBlockSum = 0.0;
     for (Int_t i=0; i<fBlocksPerEvent; i++) {
-      this->fBlock[i] = atan(value.fBlock[i]);
-      this->fHardwareBlockSum += this->fBlock[i];
+      this->fData->fBlock[i] = atan(value.fData->fBlock[i]);
+      this->fData->fHardwareBlockSum += this->fData->fBlock[i];
     }
-    this->fHardwareBlockSum /= fBlocksPerEvent;
+    this->fData->fHardwareBlockSum /= fBlocksPerEvent;
   }
 
   return;
@@ -1423,15 +1517,15 @@ void QwMollerADC_Channel::Product(const QwMollerADC_Channel &value1, const QwMol
 {
   if (!IsNameEmpty()){
     for (Int_t i = 0; i < fBlocksPerEvent; i++) {
-      this->fBlock[i] = (value1.fBlock[i]) * (value2.fBlock[i]);
+      this->fData->fBlock[i] = (value1.fData->fBlock[i]) * (value2.fData->fBlock[i]);
       // For a single event the second moment is still zero
-      this->fBlockM2[i] = 0.0;
+      this->fData->fBlockM2[i] = 0.0;
     }
 
     // For a single event the second moment is still zero
-    this->fHardwareBlockSumM2 = 0.0;
-    this->fHardwareBlockSum = value1.fHardwareBlockSum * value2.fHardwareBlockSum;
-    this->fNumberOfSamples = value1.fNumberOfSamples;
+    this->fData->fHardwareBlockSumM2 = 0.0;
+    this->fData->fHardwareBlockSum = value1.fData->fHardwareBlockSum * value2.fData->fHardwareBlockSum;
+    this->fData->fNumberOfSamples = value1.fData->fNumberOfSamples;
     this->fSequenceNumber  = 0;
     this->fErrorFlag       = (value1.fErrorFlag|value2.fErrorFlag);
   }
@@ -1444,9 +1538,9 @@ This function will add a offset to the hw_sum and add the same offset for blocks
 void QwMollerADC_Channel::AddChannelOffset(Double_t offset)
 {
   if (!IsNameEmpty()){
-    fHardwareBlockSum += offset;
+    fData->fHardwareBlockSum += offset;
     for (Int_t i=0; i<fBlocksPerEvent; i++) 
-      fBlock[i] += offset;
+      fData->fBlock[i] += offset;
   }
   return;
 }
@@ -1455,11 +1549,11 @@ void QwMollerADC_Channel::Scale(Double_t scale)
 {
   if (!IsNameEmpty()){
       for (Int_t i = 0; i < fBlocksPerEvent; i++) {
-        fBlock[i] *= scale;
-        fBlockM2[i] *= scale * scale;
+        fData->fBlock[i] *= scale;
+        fData->fBlockM2[i] *= scale * scale;
       }
-      fHardwareBlockSum *= scale;
-      fHardwareBlockSumM2 *= scale * scale;
+      fData->fHardwareBlockSum *= scale;
+      fData->fHardwareBlockSumM2 *= scale * scale;
     }
 }
 
@@ -1575,9 +1669,9 @@ void QwMollerADC_Channel::AccumulateRunningSum(const QwMollerADC_Channel& value,
   Int_t n = n1 + n2;
 
   // Set up variables
-  Double_t M11 = fHardwareBlockSum;
-  Double_t M12 = value.fHardwareBlockSum;
-  Double_t M22 = value.fHardwareBlockSumM2;
+  Double_t M11 = fData->fHardwareBlockSum;
+  Double_t M12 = value.fData->fHardwareBlockSum;
+  Double_t M22 = value.fData->fHardwareBlockSumM2;
 
   //if(this->GetElementName() == "bcm_an_ds3" && ErrorMask == kPreserveError){QwError << "count=" << fGoodEventCount << "  n=" << n << QwLog::endl;    }
   if (n2 == 0) {
@@ -1587,51 +1681,51 @@ void QwMollerADC_Channel::AccumulateRunningSum(const QwMollerADC_Channel& value,
     // simple version for removal of single event from the sum
     fGoodEventCount--;
     if (n > 1) {
-      fHardwareBlockSum -= (M12 - M11) / n;
-      fHardwareBlockSumM2 -= (M12 - M11)
-        * (M12 - fHardwareBlockSum); // note: using updated mean
+      fData->fHardwareBlockSum -= (M12 - M11) / n;
+      fData->fHardwareBlockSumM2 -= (M12 - M11)
+        * (M12 - fData->fHardwareBlockSum); // note: using updated mean
       // and for individual blocks
       for (Int_t i = 0; i < 4; i++) {
-        M11 = fBlock[i];
-        M12 = value.fBlock[i];
-        M22 = value.fBlockM2[i];
-        fBlock[i] -= (M12 - M11) / n;
-        fBlockM2[i] -= (M12 - M11) * (M12 - fBlock[i]); // note: using updated mean
+        M11 = fData->fBlock[i];
+        M12 = value.fData->fBlock[i];
+        M22 = value.fData->fBlockM2[i];
+        fData->fBlock[i] -= (M12 - M11) / n;
+        fData->fBlockM2[i] -= (M12 - M11) * (M12 - fData->fBlock[i]); // note: using updated mean
       }
     } else if (n == 1) {
-      fHardwareBlockSum -= (M12 - M11) / n;
-      fHardwareBlockSumM2 -= (M12 - M11)
-        * (M12 - fHardwareBlockSum); // note: using updated mean
-      if (fabs(fHardwareBlockSumM2) < 10.*std::numeric_limits<double>::epsilon())
-        fHardwareBlockSumM2 = 0; // rounding
+      fData->fHardwareBlockSum -= (M12 - M11) / n;
+      fData->fHardwareBlockSumM2 -= (M12 - M11)
+        * (M12 - fData->fHardwareBlockSum); // note: using updated mean
+      if (fabs(fData->fHardwareBlockSumM2) < 10.*std::numeric_limits<double>::epsilon())
+        fData->fHardwareBlockSumM2 = 0; // rounding
       // and for individual blocks
       for (Int_t i = 0; i < 4; i++) {
-        M11 = fBlock[i];
-        M12 = value.fBlock[i];
-        M22 = value.fBlockM2[i];
-        fBlock[i] -= (M12 - M11) / n;
-        fBlockM2[i] -= (M12 - M11) * (M12 - fBlock[i]); // note: using updated mean
-        if (fabs(fBlockM2[i]) < 10.*std::numeric_limits<double>::epsilon())
-          fBlockM2[i] = 0; // rounding
+        M11 = fData->fBlock[i];
+        M12 = value.fData->fBlock[i];
+        M22 = value.fData->fBlockM2[i];
+        fData->fBlock[i] -= (M12 - M11) / n;
+        fData->fBlockM2[i] -= (M12 - M11) * (M12 - fData->fBlock[i]); // note: using updated mean
+        if (fabs(fData->fBlockM2[i]) < 10.*std::numeric_limits<double>::epsilon())
+          fData->fBlockM2[i] = 0; // rounding
       }
     } else if (n == 0) {
-      fHardwareBlockSum -= M12;
-      fHardwareBlockSumM2 -= M22;
-      if (fabs(fHardwareBlockSum) < 10.*std::numeric_limits<double>::epsilon())
-        fHardwareBlockSum = 0; // rounding
-      if (fabs(fHardwareBlockSumM2) < 10.*std::numeric_limits<double>::epsilon())
-        fHardwareBlockSumM2 = 0; // rounding
+      fData->fHardwareBlockSum -= M12;
+      fData->fHardwareBlockSumM2 -= M22;
+      if (fabs(fData->fHardwareBlockSum) < 10.*std::numeric_limits<double>::epsilon())
+        fData->fHardwareBlockSum = 0; // rounding
+      if (fabs(fData->fHardwareBlockSumM2) < 10.*std::numeric_limits<double>::epsilon())
+        fData->fHardwareBlockSumM2 = 0; // rounding
       // and for individual blocks
       for (Int_t i = 0; i < 4; i++) {
-        M11 = fBlock[i];
-        M12 = value.fBlock[i];
-        M22 = value.fBlockM2[i];
-        fBlock[i] -= M12;
-        fBlockM2[i] -= M22;
-        if (fabs(fBlock[i]) < 10.*std::numeric_limits<double>::epsilon())
-          fBlock[i] = 0; // rounding
-        if (fabs(fBlockM2[i]) < 10.*std::numeric_limits<double>::epsilon())
-          fBlockM2[i] = 0; // rounding
+        M11 = fData->fBlock[i];
+        M12 = value.fData->fBlock[i];
+        M22 = value.fData->fBlockM2[i];
+        fData->fBlock[i] -= M12;
+        fData->fBlockM2[i] -= M22;
+        if (fabs(fData->fBlock[i]) < 10.*std::numeric_limits<double>::epsilon())
+          fData->fBlock[i] = 0; // rounding
+        if (fabs(fData->fBlockM2[i]) < 10.*std::numeric_limits<double>::epsilon())
+          fData->fBlockM2[i] = 0; // rounding
       }
     } else {
       QwWarning << "Running sum has deaccumulated to negative good events." << QwLog::endl;
@@ -1639,34 +1733,34 @@ void QwMollerADC_Channel::AccumulateRunningSum(const QwMollerADC_Channel& value,
   } else if (n2 == 1) {
     // simple version for addition of single event
     fGoodEventCount++;
-    fHardwareBlockSum += (M12 - M11) / n;
-    fHardwareBlockSumM2 += (M12 - M11)
-         * (M12 - fHardwareBlockSum); // note: using updated mean
+    fData->fHardwareBlockSum += (M12 - M11) / n;
+    fData->fHardwareBlockSumM2 += (M12 - M11)
+         * (M12 - fData->fHardwareBlockSum); // note: using updated mean
     // and for individual blocks
     for (Int_t i = 0; i < 4; i++) {
-      M11 = fBlock[i];
-      M12 = value.fBlock[i];
-      M22 = value.fBlockM2[i];
-      fBlock[i] += (M12 - M11) / n;
-      fBlockM2[i] += (M12 - M11) * (M12 - fBlock[i]); // note: using updated mean
+      M11 = fData->fBlock[i];
+      M12 = value.fData->fBlock[i];
+      M22 = value.fData->fBlockM2[i];
+      fData->fBlock[i] += (M12 - M11) / n;
+      fData->fBlockM2[i] += (M12 - M11) * (M12 - fData->fBlock[i]); // note: using updated mean
     }
   } else if (n2 > 1) {
     // general version for addition of multi-event sets
     fGoodEventCount += n2;
-    fHardwareBlockSum += n2 * (M12 - M11) / n;
-    fHardwareBlockSumM2 += M22 + n1 * n2 * (M12 - M11) * (M12 - M11) / n;
+    fData->fHardwareBlockSum += n2 * (M12 - M11) / n;
+    fData->fHardwareBlockSumM2 += M22 + n1 * n2 * (M12 - M11) * (M12 - M11) / n;
     // and for individual blocks
     for (Int_t i = 0; i < 4; i++) {
-      M11 = fBlock[i];
-      M12 = value.fBlock[i];
-      M22 = value.fBlockM2[i];
-      fBlock[i] += n2 * (M12 - M11) / n;
-      fBlockM2[i] += M22 + n1 * n2 * (M12 - M11) * (M12 - M11) / n;
+      M11 = fData->fBlock[i];
+      M12 = value.fData->fBlock[i];
+      M22 = value.fData->fBlockM2[i];
+      fData->fBlock[i] += n2 * (M12 - M11) / n;
+      fData->fBlockM2[i] += M22 + n1 * n2 * (M12 - M11) * (M12 - M11) / n;
     }
   }
 
   // Nanny
-  if (fHardwareBlockSum != fHardwareBlockSum)
+  if (fData->fHardwareBlockSum != fData->fHardwareBlockSum)
     QwWarning << "Angry Nanny: NaN detected in " << GetElementName() << QwLog::endl;
 }
 
@@ -1689,8 +1783,8 @@ void QwMollerADC_Channel::CalculateRunningAverage()
       //    sigma = sqrt(M2 / n);
       //    error = sigma / sqrt (n) = sqrt(M2) / n;
       for (Int_t i = 0; i < fBlocksPerEvent; i++)
-        fBlockError[i] = sqrt(fBlockM2[i]) / fGoodEventCount;
-      fHardwareBlockSumError = sqrt(fHardwareBlockSumM2) / fGoodEventCount;
+        fBlockError[i] = sqrt(fData->fBlockM2[i]) / fGoodEventCount;
+      fHardwareBlockSumError = sqrt(fData->fHardwareBlockSumM2) / fGoodEventCount;
 
       // Stability check 83951872
       if ((fStability>0) &&( (fErrorConfigFlag & kStabilityCut) == kStabilityCut)) {
@@ -1748,13 +1842,13 @@ void QwMollerADC_Channel::Blind(const QwBlinder *blinder)
   if (!IsNameEmpty()) {
     if (blinder->IsBlinderOkay() && ((fErrorFlag)==0) ){
       for (Int_t i = 0; i < fBlocksPerEvent; i++)
-        blinder->BlindValue(fBlock[i]);
-      blinder->BlindValue(fHardwareBlockSum);
+        blinder->BlindValue(fData->fBlock[i]);
+      blinder->BlindValue(fData->fHardwareBlockSum);
     } else {
       blinder->ModifyThisErrorCode(fErrorFlag);
       for (Int_t i = 0; i < fBlocksPerEvent; i++)
-	fBlock[i] = QwBlinder::kValue_BlinderFail;
-      fHardwareBlockSum =  QwBlinder::kValue_BlinderFail;
+	fData->fBlock[i] = QwBlinder::kValue_BlinderFail;
+      fData->fHardwareBlockSum =  QwBlinder::kValue_BlinderFail;
     }
   }
   return;
@@ -1770,13 +1864,13 @@ void QwMollerADC_Channel::Blind(const QwBlinder *blinder, const QwMollerADC_Chan
   if (!IsNameEmpty()) {
     if (blinder->IsBlinderOkay() && ((fErrorFlag) ==0) ){
       for (Int_t i = 0; i < fBlocksPerEvent; i++)
-        blinder->BlindValue(fBlock[i], yield.fBlock[i]);
-      blinder->BlindValue(fHardwareBlockSum, yield.fHardwareBlockSum);
+        blinder->BlindValue(fData->fBlock[i], yield.fData->fBlock[i]);
+      blinder->BlindValue(fData->fHardwareBlockSum, yield.fData->fHardwareBlockSum);
     } else {
       blinder->ModifyThisErrorCode(fErrorFlag);//update the HW error code
       for (Int_t i = 0; i < fBlocksPerEvent; i++)
-	fBlock[i] = QwBlinder::kValue_BlinderFail * yield.fBlock[i];
-      fHardwareBlockSum = QwBlinder::kValue_BlinderFail * yield.fHardwareBlockSum;
+	fData->fBlock[i] = QwBlinder::kValue_BlinderFail * yield.fData->fBlock[i];
+      fData->fHardwareBlockSum = QwBlinder::kValue_BlinderFail * yield.fData->fHardwareBlockSum;
     }
   }
   return;
@@ -1796,12 +1890,12 @@ Bool_t QwMollerADC_Channel::MatchNumberOfSamples(size_t numsamp)
 {
   Bool_t status = kTRUE;
   if (!IsNameEmpty()){
-    status = (fNumberOfSamples==numsamp);
+    status = (fData->fNumberOfSamples==numsamp);
     if (! status){
       if (bDEBUG)
         std::cerr << "QwMollerADC_Channel::MatchNumberOfSamples:  Channel "
                 << GetElementName()
-                << " had fNumberOfSamples==" << fNumberOfSamples
+                << " had fNumberOfSamples==" << fData->fNumberOfSamples
                 << " and was supposed to have " << numsamp
                 << std::endl;
       //      PrintChannel();
@@ -1920,12 +2014,12 @@ void QwMollerADC_Channel::ScaledAdd(Double_t scale, const VQwHardwareChannel *va
     //     PrintValue();
     //     input->PrintValue();
     for(Int_t i = 0; i < fBlocksPerEvent; i++){
-      this -> fBlock[i] += scale * input->fBlock[i];
-      this -> fBlockM2[i] = 0.0;
+      this -> fData->fBlock[i] += scale * input->fData->fBlock[i];
+      this -> fData->fBlockM2[i] = 0.0;
     }
-    this -> fHardwareBlockSum += scale * input->fHardwareBlockSum;
-    this -> fHardwareBlockSumM2 = 0.0;
-    this -> fNumberOfSamples += input->fNumberOfSamples;
+    this -> fData->fHardwareBlockSum += scale * input->fData->fHardwareBlockSum;
+    this -> fData->fHardwareBlockSumM2 = 0.0;
+    this -> fData->fNumberOfSamples += input->fData->fNumberOfSamples;
     this -> fSequenceNumber  =  0;
     this -> fErrorFlag       |= (input->fErrorFlag);   
   } else if (input == NULL && value != NULL) {
@@ -1940,7 +2034,7 @@ void QwMollerADC_Channel::CopyParameters(const VQwHardwareChannel* valueptr){
     const QwMollerADC_Channel* tmpptr;
   tmpptr = dynamic_cast<const QwMollerADC_Channel*>(valueptr);
   if (tmpptr!=NULL){
-    fNumberOfSamples = tmpptr->fNumberOfSamples;
+    fData->fNumberOfSamples = tmpptr->fData->fNumberOfSamples;
     fNumberOfSamples_map = tmpptr->fNumberOfSamples_map;
     fMockGaussianSigma = tmpptr->fMockGaussianSigma;
   } else {
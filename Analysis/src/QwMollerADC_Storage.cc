@@ -0,0 +1,133 @@
+/*!
+ * \file   QwMollerADC_Storage.cc
+ * \brief  Contiguous event data storage for the Moller ADC channels of a subsystem
+ */
+
+#include "QwMollerADC_Storage.h"
+
+/**
+ * Move the event data records of the channels into this storage, and copy
+ * their pedestals and calibrations.  Any previously attached channels are
+ * detached first.
+ * @param channels Channels to attach
+ */
+void QwMollerADC_Storage::Attach(const std::vector<QwMollerADC_Channel*>& channels)
+{
+  Detach();
+  fChannels = channels;
+  fData.resize(fChannels.size());
+  for (size_t i = 0; i < fChannels.size(); i++) {
+    fData[i] = *(fChannels[i]->fData);
+    fChannels[i]->fData = &fData[i];
+  }
+
+  const size_t nchannels = fChannels.size();
+  fBlockRaw.assign(nchannels * kBlocks, 0.0);
+  fHardwareBlockSumRaw.assign(nchannels, 0.0);
+  fNumberOfSamples.assign(nchannels, 0.0);
+  fBlock.assign(nchannels * kBlocks, 0.0);
+  fHardwareBlockSum.assign(nchannels, 0.0);
+  UpdateCalibration();
+}
+
+/**
+ * Copy the event data records back into the channels, and let the
+ * channels use their own records again.
+ */
+void QwMollerADC_Storage::Detach()
+{
+  for (size_t i = 0; i < fChannels.size(); i++) {
+    fChannels[i]->fLocalData = fData[i];
+    fChannels[i]->fData = &(fChannels[i]->fLocalData);
+  }
+  fChannels.clear();
+  fData.clear();
+  fCalibration.clear();
+  fPedestal.clear();
+  fBlocksPerEvent.clear();
+  fBlockRaw.clear();
+  fHardwareBlockSumRaw.clear();
+  fNumberOfSamples.clear();
+  fBlock.clear();
+  fHardwareBlockSum.clear();
+}
+
+/**
+ * Copy the pedestals, calibration factors and numbers of blocks of the
+ * attached channels into the arrays used by ProcessEvent.
+ */
+void QwMollerADC_Storage::UpdateCalibration()
+{
+  const size_t nchannels = fChannels.size();
+  fCalibration.resize(nchannels);
+  fPedestal.resize(nchannels);
+  fBlocksPerEvent.resize(nchannels);
+  for (size_t ch = 0; ch < nchannels; ch++) {
+    fCalibration[ch] = fChannels[ch]->fCalibrationFactor;
+    fPedestal[ch] = fChannels[ch]->fPedestal;
+    fBlocksPerEvent[ch] = fChannels[ch]->fBlocksPerEvent;
+  }
+}
+
+/**
+ * Process the event data of all attached channels; this is equivalent to
+ * calling QwMollerADC_Channel::ProcessEvent for each channel.
+ *
+ * The raw data is gathered from the records into one array per field, and
+ * converted for all channels and blocks without branches: channels without
+ * samples divide by one instead.  These channels are rare and flagged as
+ * errors, so they are handed to the channel itself after the results are
+ * stored in the records.
+ */
+void QwMollerADC_Storage::ProcessEvent()
+{
+  const size_t nchannels = fChannels.size();
+
+  //  Raw data of the event
+  for (size_t ch = 0; ch < nchannels; ch++) {
+    const QwMollerADC_Channel::EventData& data = fData[ch];
+    for (size_t i = 0; i < kBlocks; i++)
+      fBlockRaw[ch * kBlocks + i] = data.fBlock_raw[i];
+    fHardwareBlockSumRaw[ch] = data.fHardwareBlockSum_raw;
+    fNumberOfSamples[ch] = data.fNumberOfSamples;
+  }
+
+  //  Normalisation, pedestal subtraction and calibration, in the same
+  //  order of operations as QwMollerADC_Channel::ProcessEvent; channels
+  //  without samples divide by one
+  const Double_t* __restrict calibration = fCalibration.data();
+  const Double_t* __restrict pedestal = fPedestal.data();
+  const Double_t* __restrict blocksperevent = fBlocksPerEvent.data();
+  const Double_t* __restrict numberofsamples = fNumberOfSamples.data();
+  const Double_t* __restrict blockraw = fBlockRaw.data();
+  const Double_t* __restrict sumraw = fHardwareBlockSumRaw.data();
+  Double_t* __restrict block = fBlock.data();
+  Double_t* __restrict sum = fHardwareBlockSum.data();
+  for (size_t ch = 0; ch < nchannels; ch++) {
+    const Double_t samples = numberofsamples[ch] + (numberofsamples[ch] == 0.0);
+    sum[ch] = calibration[ch] * ( (sumraw[ch] / samples) - pedestal[ch] );
+  }
+  for (size_t j = 0; j < nchannels * kBlocks; j++) {
+    const size_t ch = j / kBlocks;
+    const Double_t samples = numberofsamples[ch] + (numberofsamples[ch] == 0.0);
+    block[j] = calibration[ch] * ( (blockraw[j] * blocksperevent[ch] / samples) - pedestal[ch] );
+  }
+
+  //  Results of the blocks used by each channel
+  for (size_t ch = 0; ch < nchannels; ch++) {
+    QwMollerADC_Channel::EventData& data = fData[ch];
+    const Short_t blocks = fChannels[ch]->fBlocksPerEvent;
+    for (Int_t i = 0; i < blocks; i++) {
+      data.fBlock[i] = fBlock[ch * kBlocks + i];
+      data.fBlockM2[i] = 0.0; // second moment is zero for single events
+    }
+    data.fHardwareBlockSum = fHardwareBlockSum[ch];
+    data.fHardwareBlockSumM2 = 0.0; // second moment is zero for single events
+  }
+
+  //  Channels without samples
+  for (size_t ch = 0; ch < nchannels; ch++) {
+    if (fData[ch].fNumberOfSamples == 0)
+      fChannels[ch]->ProcessEvent();
+  }
+}
@@ -106,7 +106,7 @@ void  QwPMT_Channel::FillHistograms()
     //  This channel is not used, so skip creating the histograms.
   } else {
     if (fHistograms[index] != NULL)
-      fHistograms[index]->Fill(fValue);
+      FillHistogram(index, fValue);
     index++;
   }
 }
@@ -128,7 +128,7 @@ void  QwPMT_Channel::ConstructBranchAndVector(TTree *tree, TString &prefix, QwRo
     values.push_back(basename.Data(), 'D');
 
     fTreeArrayNumEntries = values.size() - fTreeArrayIndex;
-    tree->Branch(basename, &(values[fTreeArrayIndex]), values.LeafList(fTreeArrayIndex).c_str());
+    tree->Branch(basename, &(values[fTreeArrayIndex]), values.LeafList(fTreeArrayIndex, basename.Data()).c_str());
   }
 }
 
@@ -165,6 +165,15 @@ QwPMT_Channel& QwPMT_Channel::operator= (const QwPMT_Channel &value){
   return *this;
 }
 
+/// Transfer the same event-based data as operator= to or from a snapshot
+void QwPMT_Channel::Snapshot(QwSnapshot& snapshot)
+{
+  if (GetElementName()!=""){
+    VQwDataElement::Snapshot(snapshot);
+    snapshot.Transfer(fValue);
+  }
+}
+
 QwPMT_Channel& QwPMT_Channel::operator+= (const QwPMT_Channel &value){
   if (GetElementName()!=""){
     this->fValue += value.fValue;
@@ -0,0 +1,50 @@
+/*!
+ * \file   QwPatternKernel.cc
+ * \brief  Helicity pattern sums over flat arrays of channel values
+ */
+
+#include "QwPatternKernel.h"
+
+/**
+ * Calculate the yield and difference of all values of a pattern in one
+ * pass over the phases.  The positive sum is accumulated in yield and the
+ * negative sum in difference; both are then combined and scaled in place.
+ * The inner loops run over contiguous values and vectorise.
+ * @param phases     Values of each phase, positive phases first
+ * @param nplus      Number of positive phases
+ * @param nphases    Number of phases
+ * @param nvalues    Number of values per phase
+ * @param scale      Normalisation of the sums (usually 1/nphases)
+ * @param yield      Scaled sum of all phases
+ * @param difference Scaled difference of positive and negative phases
+ */
+void QwPatternKernel::Sums(const Double_t* const* phases, std::size_t nplus,
+                           std::size_t nphases, std::size_t nvalues, Double_t scale,
+                           Double_t* yield, Double_t* difference)
+{
+  Double_t* __restrict pos = yield;
+  Double_t* __restrict neg = difference;
+
+  const Double_t* __restrict first_pos = phases[0];
+  const Double_t* __restrict first_neg = phases[nplus];
+  for (std::size_t j = 0; j < nvalues; j++) {
+    pos[j] = first_pos[j];
+    neg[j] = first_neg[j];
+  }
+  for (std::size_t p = 1; p < nplus; p++) {
+    const Double_t* __restrict phase = phases[p];
+    for (std::size_t j = 0; j < nvalues; j++)
+      pos[j] += phase[j];
+  }
+  for (std::size_t p = nplus + 1; p < nphases; p++) {
+    const Double_t* __restrict phase = phases[p];
+    for (std::size_t j = 0; j < nvalues; j++)
+      neg[j] += phase[j];
+  }
+  for (std::size_t j = 0; j < nvalues; j++) {
+    const Double_t sum  = pos[j] + neg[j];
+    const Double_t diff = pos[j] - neg[j];
+    pos[j] = sum * scale;
+    neg[j] = diff * scale;
+  }
+}
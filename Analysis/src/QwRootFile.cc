@@ -6,6 +6,7 @@
 #include "QwRootFile.h"
 #include "QwRunCondition.h"
 #include "TH1.h"
+#include "TROOT.h"
 
 #include <unistd.h>
 #include <cstdio>
@@ -15,6 +16,7 @@ std::string QwRootFile::fDefaultRootFileStem = "Qweak_";
 
 const Long64_t QwRootFile::kMaxTreeSize = 100000000000LL;
 const Int_t QwRootFile::kMaxMapFileSize = 0x3fffffff; // 1 GiB
+std::weak_ptr<QwSharedMemoryPublisher> QwRootFile::fSharedPublisher;
 
 const TString QwRootTree::kUnitsName = "ppm/D:ppb/D:um/D:mm/D:mV_uA/D:V_uA/D";
 Double_t QwRootTree::kUnitsValue[] = { 1e-6, 1e-9, 1e-3, 1 , 1e-3, 1};
@@ -25,9 +27,11 @@ Double_t QwRootTree::kUnitsValue[] = { 1e-6, 1e-9, 1e-3, 1 , 1e-3, 1};
 QwRootFile::QwRootFile(const TString& run_label)
   : fRootFile(0), fMakePermanent(0),
     fMapFile(0), fEnableMapFile(kFALSE),
-    fUpdateInterval(-1)
+    fUpdateInterval(-1),
+    fWriteDepth(0), fWriterStarted(kFALSE), fDirectBinding(kFALSE),
+    fEnablePublisher(kFALSE), fPublishInterval(0), fPublisherDepth(0), fPublishCount(0)
 #ifdef HAS_RNTUPLE_SUPPORT
-    , fEnableRNTuples(kFALSE)
+    , fEnableRNTuples(kFALSE), fParallelNTuples(kFALSE)
 #endif // HAS_RNTUPLE_SUPPORT
 {
   // Process the configuration options
@@ -99,6 +103,15 @@ QwRootFile::QwRootFile(const TString& run_label)
     fRootFile->SetCompressionAlgorithm(fCompressionAlgorithm);
     fRootFile->SetCompressionLevel(fCompressionLevel);
   }
+
+  // All files of this process publish into one segment
+  if (fEnablePublisher && fRootFile) {
+    fPublisher = fSharedPublisher.lock();
+    if (! fPublisher) {
+      fPublisher = std::make_shared<QwSharedMemoryPublisher>(fPublisherName, fPublisherDepth);
+      fSharedPublisher = fPublisher;
+    }
+  }
 }
 
 
@@ -107,6 +120,9 @@ QwRootFile::QwRootFile(const TString& run_label)
  */
 QwRootFile::~QwRootFile()
 {
+  // Write all queued entries before anything else touches the file
+  StopWriter();
+
   // Keep the file on disk if any trees or histograms have been filled.
   // Also respect any other requests to keep the file around.
   if (!fMakePermanent) fMakePermanent = HasAnyFilled();
@@ -123,6 +139,8 @@ QwRootFile::~QwRootFile()
   if (fRootFile) {
     TString rootfilename = fRootFile->GetName();
 
+    StopPublisher();
+    gQwHists.ReleaseFillBuffers(fRootFile);
     fRootFile->Close();
     delete fRootFile;
     fRootFile = 0;
@@ -215,6 +233,9 @@ void QwRootFile::DefineOptions(QwOptions &options)
   options.AddOptions("ROOT output options")
     ("enable-rntuples", po::value<bool>()->default_bool_value(false),
      "enable RNTuple output");
+  options.AddOptions("ROOT output options")
+    ("rntuple-parallel-writer", po::value<bool>()->default_bool_value(false),
+     "write RNTuples with parallel writers (one fill context per thread)");
 #endif // HAS_RNTUPLE_SUPPORT
 
   // Define the tree output prescaling options
@@ -234,6 +255,20 @@ void QwRootFile::DefineOptions(QwOptions &options)
     ("mapfile-update-interval", po::value<int>()->default_value(-1),
      "Events between a map file update");
 
+  // Define the shared memory publisher options
+  options.AddOptions("ROOT output options")
+    ("enable-shm-publisher", po::value<bool>()->default_bool_value(false),
+     "publish histograms and recent tree entries in shared memory");
+  options.AddOptions("ROOT output options")
+    ("shm-publisher-name", po::value<std::string>()->default_value("/QwLivePublisher"),
+     "name of the shared memory segment");
+  options.AddOptions("ROOT output options")
+    ("shm-publisher-interval", po::value<int>()->default_value(1000),
+     "histogram fills between publications of the histograms");
+  options.AddOptions("ROOT output options")
+    ("shm-publisher-depth", po::value<int>()->default_value(100),
+     "number of recent entries published for each tree");
+
   // Define the autoflush and autosave option (default values by ROOT)
   options.AddOptions("ROOT performance options")
     ("autoflush", po::value<int>()->default_value(0),
@@ -253,6 +288,15 @@ void QwRootFile::DefineOptions(QwOptions &options)
   options.AddOptions("ROOT performance options")
     ("compression-level", po::value<int>()->default_value(1),
      "TFile compression level (default = 1, no compression = 0)");
+  options.AddOptions("ROOT performance options")
+    ("tree-writer-depth", po::value<int>()->default_value(0),
+     "tree entries buffered for a writer thread (default = 0, fill trees directly)");
+  options.AddOptions("ROOT performance options")
+    ("tree-direct-binding", po::value<bool>()->default_bool_value(false),
+     "bind tree leaves to the channel values instead of copying them for each fill");
+  options.AddOptions("ROOT performance options")
+    ("tree-precision-map", po::value<std::string>()->default_value(""),
+     "map file with the leaf types of the trees (regex on tree:branch.leaf and type)");
 }
 
 
@@ -285,6 +329,7 @@ void QwRootFile::ProcessOptions(QwOptions &options)
 #ifdef HAS_RNTUPLE_SUPPORT
   // Option 'enable-rntuples' to enable RNTuple output
   fEnableRNTuples = options.GetValue<bool>("enable-rntuples");
+  fParallelNTuples = options.GetValue<bool>("rntuple-parallel-writer");
 #endif // HAS_RNTUPLE_SUPPORT
 
   // Options 'disable-trees' and 'disable-histos' for disabling
@@ -315,6 +360,29 @@ void QwRootFile::ProcessOptions(QwOptions &options)
   fCompressionAlgorithm = options.GetValue<int>("compression-algorithm");
   fCompressionLevel = options.GetValue<int>("compression-level");
   fBasketSize = options.GetValue<int>("basket-size");
+  fWriteDepth = options.GetValue<int>("tree-writer-depth");
+  fDirectBinding = options.GetValue<bool>("tree-direct-binding");
+  fEnablePublisher = options.GetValue<bool>("enable-shm-publisher");
+  fPublisherName = options.GetValue<std::string>("shm-publisher-name");
+  fPublishInterval = options.GetValue<int>("shm-publisher-interval");
+  fPublisherDepth = options.GetValue<int>("shm-publisher-depth");
+  if (fEnablePublisher && fEnableMapFile) {
+    QwWarning << "QwRootFile::ProcessOptions:  "
+              << "The shared memory publisher replaces the map file, so "
+              << "'enable-mapfile' is disabled."
+              << QwLog::endl;
+    fEnableMapFile = kFALSE;
+  }
+  std::string precision_map = options.GetValue<std::string>("tree-precision-map");
+  if (precision_map.size() > 0)
+    fPrecision.LoadFromFile(precision_map);
+  if (fDirectBinding && fWriteDepth > 0) {
+    QwWarning << "QwRootFile::ProcessOptions:  "
+              << "The tree writer thread needs a copy of every entry, so "
+              << "'tree-direct-binding' is disabled."
+              << QwLog::endl;
+    fDirectBinding = kFALSE;
+  }
 
   // Autoflush and autosave
   fAutoFlush = options.GetValue<int>("autoflush");
@@ -334,6 +402,8 @@ void QwRootFile::ProcessOptions(QwOptions &options)
  * histograms.
  */
 Bool_t QwRootFile::HasAnyFilled(void) {
+  DrainWriter();
+  gQwHists.FlushFillBuffers();
   return this->HasAnyFilled(fRootFile);
 }
 Bool_t QwRootFile::HasAnyFilled(TDirectory* d) {
@@ -415,3 +485,117 @@ Bool_t QwRootFile::HasAnyFilled(TDirectory* d) {
   }
   return false;
 }
+
+
+/**
+ * Fill a tree, either directly or by queueing a snapshot of its branch
+ * vectors for the writer thread.  Trees with branches bound outside the
+ * branch vectors are filled directly once the writer has caught up, so
+ * that entries are still written in order.
+ * @param name Name of the tree
+ * @param tree First registered tree with this name, which owns the TTree
+ * @return Number of bytes written, or zero when the entry was queued
+ */
+Int_t QwRootFile::FillTree(const std::string& name, QwRootTree* tree)
+{
+  if (fPublisher) PublishEntry(name, tree);
+
+  if (fWriteDepth <= 0) return tree->Fill();
+  if (! fWriterStarted) StartWriter();
+
+  auto index = fWriterTreeIndex.find(name);
+  if (! fWriter || index == fWriterTreeIndex.end() || index->second < 0) {
+    DrainWriter();
+    return tree->Fill();
+  }
+
+  if (! tree->Accept()) return 0;
+  fWriter->Fill(index->second);
+
+  // Check for errors in earlier entries
+  Int_t status = fWriter->GetStatus();
+  if (status < 0) {
+    QwError << "Writing tree failed!  Check disk space or quota." << QwLog::endl;
+    exit(status);
+  }
+  return 0;
+}
+
+/**
+ * Register all trees with the writer and start the writer thread.  This
+ * is done at the first fill, when all branches have been constructed, and
+ * again at the first fill after branches were added to a tree the writer
+ * filled (see ResetWriter).
+ */
+void QwRootFile::StartWriter()
+{
+  fWriterStarted = kTRUE;
+  if (fWriteDepth <= 0 || ! fRootFile) return;
+
+  // Trees are filled on another thread than the one which created them
+  ROOT::EnableThreadSafety();
+
+  fWriter.reset(new QwRootTreeWriter(fWriteDepth));
+  std::vector<const void*> constants(1, QwRootTree::kUnitsValue);
+  for (auto iter = fTreeByName.begin(); iter != fTreeByName.end(); iter++) {
+    // All objects sharing this tree have their own branch vector
+    std::vector< std::pair<void*,size_t> > buffers;
+    for (auto tree: iter->second) {
+      if (tree->fVector.data_size() > 0)
+        buffers.push_back(std::make_pair(tree->fVector.data(), tree->fVector.data_size()));
+    }
+    Int_t index = fWriter->AddTree(iter->second.front()->GetTree(), buffers, constants);
+    if (index < 0)
+      QwMessage << "Tree " << iter->first << " will be filled without the writer thread"
+                << QwLog::endl;
+    fWriterTreeIndex[iter->first] = index;
+  }
+  fWriter->Start();
+
+  QwMessage << "Started tree writer thread with " << fWriteDepth
+            << " buffered entries" << QwLog::endl;
+}
+
+/**
+ * Copy the current entry of a tree into the ring of recent entries in
+ * shared memory.  All trees of the file are registered at the first call.
+ */
+void QwRootFile::PublishEntry(const std::string& name, QwRootTree* tree)
+{
+  if (fPublisherTreeIndex.empty()) {
+    for (auto iter = fTreeByName.begin(); iter != fTreeByName.end(); iter++) {
+      QwRootTree* front = iter->second.front();
+      fPublisherTreeIndex[iter->first] = fPublisher->AddTree(this, iter->first,
+          front->GetLeafLayout(), front->fVector.data_size());
+    }
+  }
+
+  auto index = fPublisherTreeIndex.find(name);
+  if (index == fPublisherTreeIndex.end() || tree != fTreeByName[name].front()) return;
+  char* slot = fPublisher->BeginEntry(index->second);
+  if (slot == nullptr) return;
+  tree->fVector.CopyTo(slot);
+  fPublisher->EndEntry(index->second);
+}
+
+/**
+ * Publish the final state of the histograms, including the fills still
+ * buffered, and remove the histograms and trees of this file from the
+ * publisher, before the file is closed and its histograms are deleted.
+ */
+void QwRootFile::StopPublisher()
+{
+  if (fPublisher) {
+    PublishHistograms();
+    fPublisher->Remove(this);
+  }
+  fPublisher.reset();
+  fPublisherTreeIndex.clear();
+}
+
+void QwRootFile::StopWriter()
+{
+  if (fWriter) fWriter->Stop();
+  fWriter.reset();
+  fWriterTreeIndex.clear();
+}
@@ -0,0 +1,79 @@
+/*!
+ * \file   QwRootTreePrecision.cc
+ * \brief  Implementation of the precision policy for ROOT tree leaves
+ */
+
+#include "QwRootTreePrecision.h"
+
+// Qweak headers
+#include "QwLog.h"
+#include "QwParameterFile.h"
+
+/**
+ * Load the rules from a map file with a regular expression and a type on
+ * each line.  Lines with an unsupported type are skipped with a warning.
+ * @param filename Name of the map file
+ */
+void QwRootTreePrecision::LoadFromFile(const std::string& filename)
+{
+  QwParameterFile mapstr(filename.c_str());
+  while (mapstr.ReadNextLine()) {
+    mapstr.TrimComment('#');
+    mapstr.TrimWhitespace();
+    if (mapstr.LineIsEmpty()) continue;
+
+    // The ranges contain commas, so only whitespace separates tokens
+    std::string regexp = mapstr.GetNextToken(" \t");
+    std::string type   = mapstr.GetNextToken(" \t");
+    if (! AddRule(regexp, type))
+      QwWarning << "QwRootTreePrecision: unsupported type '" << type
+                << "' for leaves matching " << regexp << QwLog::endl;
+  }
+  QwMessage << "Loaded " << fRules.size() << " tree precision rules from "
+            << filename << QwLog::endl;
+}
+
+/**
+ * @param regexp Regular expression on "tree:branch.leaf"
+ * @param type   Leaf type code, with a range for 'd' and 'f'
+ */
+Bool_t QwRootTreePrecision::AddRule(const std::string& regexp, const std::string& type)
+{
+  if (regexp.empty() || type.empty()) return kFALSE;
+
+  // Two-byte types are not supported: the branch vector aligns to four bytes
+  const char code = type[0];
+  const std::string range = type.substr(1);
+  switch (code) {
+    case 'D': case 'F': case 'L': case 'l': case 'I': case 'i':
+      if (! range.empty()) return kFALSE;
+      break;
+    case 'd': case 'f':
+      if (! range.empty() && (range.front() != '[' || range.back() != ']'))
+        return kFALSE;
+      break;
+    default:
+      return kFALSE;
+  }
+
+  fRules.push_back(Rule{TPRegexp(regexp.c_str()), code, range});
+  return kTRUE;
+}
+
+/**
+ * @param name  Full leaf name "tree:branch.leaf"
+ * @param type  Leaf type code, changed if a rule matches
+ * @param range Range of truncated types, changed if a rule matches
+ * @return Whether a rule matched
+ */
+Bool_t QwRootTreePrecision::Find(const std::string& name, char& type, std::string& range)
+{
+  for (auto& rule: fRules) {
+    if (rule.fRegexp.Match(name)) {
+      type = rule.fType;
+      range = rule.fRange;
+      return kTRUE;
+    }
+  }
+  return kFALSE;
+}
@@ -0,0 +1,188 @@
+/*!
+ * \file   QwRootTreeWriter.cc
+ * \brief  Implementation of the ROOT tree writer thread
+ */
+
+#include "QwRootTreeWriter.h"
+
+// System headers
+#include <algorithm>
+#include <cstring>
+
+// ROOT headers
+#include "TBranch.h"
+#include "TObjArray.h"
+#include "TTree.h"
+
+/**
+ * @param depth Number of snapshots that can be queued before Fill waits
+ */
+QwRootTreeWriter::QwRootTreeWriter(std::size_t depth)
+: fSlots(std::max<std::size_t>(depth, 1)),
+  fRunning(kFALSE),
+  fPending(0),
+  fStatus(0)
+{ }
+
+QwRootTreeWriter::~QwRootTreeWriter()
+{
+  Stop();
+}
+
+/**
+ * Register a tree before the writer is started.  Every top-level branch
+ * must be bound into one of the buffers, or to one of the constant
+ * addresses which are never written during the run.
+ * @param tree      Tree to be filled by the writer thread
+ * @param buffers   Start and size of the buffers the branches are bound to
+ * @param constants Branch addresses which do not change between entries
+ * @return Index of the tree for Fill, or -1 if the tree is not supported
+ */
+Int_t QwRootTreeWriter::AddTree(TTree* tree,
+    const std::vector< std::pair<void*,std::size_t> >& buffers,
+    const std::vector<const void*>& constants)
+{
+  if (fRunning || tree == nullptr) return -1;
+
+  Tree entry;
+  entry.fTree = tree;
+  entry.fSize = 0;
+  for (const auto& buffer: buffers) {
+    entry.fBuffers.push_back(Buffer{static_cast<char*>(buffer.first), buffer.second,
+        std::vector<char>(buffer.second)});
+    entry.fSize += buffer.second;
+  }
+
+  TObjArray* branches = tree->GetListOfBranches();
+  for (Int_t i = 0; i < branches->GetEntriesFast(); i++) {
+    TBranch* branch = static_cast<TBranch*>(branches->UncheckedAt(i));
+    // Split branches of objects have their own addresses
+    if (branch->GetListOfBranches()->GetEntriesFast() > 0) return -1;
+
+    const char* address = branch->GetAddress();
+    if (std::find(constants.begin(), constants.end(), address) != constants.end())
+      continue;
+
+    bool found = false;
+    for (std::size_t b = 0; b < entry.fBuffers.size() && ! found; b++) {
+      const Buffer& buffer = entry.fBuffers[b];
+      if (address >= buffer.fSource && address < buffer.fSource + buffer.fSize) {
+        entry.fBindings.push_back(Binding{branch, b, std::size_t(address - buffer.fSource)});
+        found = true;
+      }
+    }
+    if (! found) return -1;
+  }
+
+  fTrees.push_back(std::move(entry));
+  return fTrees.size() - 1;
+}
+
+/**
+ * Bind the branches of all registered trees to the mirror buffers, size
+ * the snapshot slots for the largest tree, and start the writer thread.
+ */
+void QwRootTreeWriter::Start()
+{
+  if (fRunning) return;
+
+  std::size_t size = 0;
+  for (auto& tree: fTrees) {
+    for (auto& binding: tree.fBindings)
+      binding.fBranch->SetAddress(tree.fBuffers[binding.fBuffer].fMirror.data() + binding.fOffset);
+    size = std::max(size, tree.fSize);
+  }
+
+  fFree.Reset();
+  fReady.Reset();
+  for (auto& slot: fSlots) {
+    slot.fTree = -1;
+    slot.fData.resize(size);
+    fFree.Push(&slot);
+  }
+
+  fRunning = kTRUE;
+  fThread = std::thread(&QwRootTreeWriter::WriterLoop, this);
+}
+
+/**
+ * Write the remaining entries, join the writer thread and bind the
+ * branches back to the buffers of the analysis, so that the trees can
+ * again be filled and written directly.
+ */
+void QwRootTreeWriter::Stop()
+{
+  if (! fRunning) return;
+
+  fReady.Close();
+  if (fThread.joinable()) fThread.join();
+  fRunning = kFALSE;
+
+  for (auto& tree: fTrees)
+    for (auto& binding: tree.fBindings)
+      binding.fBranch->SetAddress(tree.fBuffers[binding.fBuffer].fSource + binding.fOffset);
+}
+
+/**
+ * Take a snapshot of the buffers of a tree and queue it for the writer.
+ * Waits for a free slot when the writer has fallen behind.
+ * @param tree Index returned by AddTree
+ */
+void QwRootTreeWriter::Fill(Int_t tree)
+{
+  Tree& entry = fTrees.at(tree);
+  if (! fRunning) {
+    entry.fTree->Fill();
+    return;
+  }
+
+  Slot* slot = fFree.Pop();
+  if (slot == nullptr) return;
+
+  char* data = slot->fData.data();
+  for (const auto& buffer: entry.fBuffers) {
+    std::memcpy(data, buffer.fSource, buffer.fSize);
+    data += buffer.fSize;
+  }
+  slot->fTree = tree;
+
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    ++fPending;
+  }
+  fReady.Push(slot);
+}
+
+void QwRootTreeWriter::Drain()
+{
+  std::unique_lock<std::mutex> lock(fMutex);
+  fDrained.wait(lock, [this]{ return fPending == 0; });
+}
+
+Int_t QwRootTreeWriter::GetStatus() const
+{
+  std::lock_guard<std::mutex> lock(fMutex);
+  return fStatus;
+}
+
+void QwRootTreeWriter::WriterLoop()
+{
+  while (Slot* slot = fReady.Pop()) {
+    Tree& entry = fTrees[slot->fTree];
+
+    const char* data = slot->fData.data();
+    for (auto& buffer: entry.fBuffers) {
+      std::memcpy(buffer.fMirror.data(), data, buffer.fSize);
+      data += buffer.fSize;
+    }
+    Int_t retval = entry.fTree->Fill();
+
+    fFree.Push(slot);
+    {
+      std::lock_guard<std::mutex> lock(fMutex);
+      if (retval < 0) fStatus = retval;
+      --fPending;
+    }
+    fDrained.notify_all();
+  }
+}
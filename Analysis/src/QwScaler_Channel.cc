@@ -79,10 +79,7 @@ void VQwScaler_Channel::ClearEventData()
 void VQwScaler_Channel::RandomizeEventData(int helicity, double time)
 {
   // Calculate drift (if time is not specified, it stays constant at zero)
-  Double_t drift = 0.0;
-  for (UInt_t i = 0; i < fMockDriftFrequency.size(); i++) {
-    drift += fMockDriftAmplitude[i] * sin(2.0 * Qw::pi * fMockDriftFrequency[i] * time + fMockDriftPhase[i]);
-  }
+  Double_t drift = GetRandomEventDrift(time);
 
   Double_t value = fMockGaussianMean * (1 + helicity * fMockAsymmetry)
     + fMockGaussianSigma * GetRandomValue()
@@ -252,7 +249,7 @@ void  VQwScaler_Channel::FillHistograms()
     //  This channel is not used, so skip creating the histograms.
   } else {
     if (index < fHistograms.size() && fHistograms[index] != NULL  && fErrorFlag==0)
-      fHistograms[index]->Fill(this->fValue);
+      FillHistogram(index, this->fValue);
     index += 1;
   }
 }
@@ -286,7 +283,7 @@ void QwScaler_Channel<data_mask,data_shift>::ConstructBranchAndVector(TTree *tre
     //std::cout << basename <<": first==" << fTreeArrayIndex << ", last==" << values.size() << std::endl;
     fTreeArrayNumEntries = values.size() - fTreeArrayIndex;
     if (gQwHists.MatchDeviceParamsFromList(basename.Data()))
-      tree->Branch(basename, &(values[fTreeArrayIndex]), values.LeafList(fTreeArrayIndex).c_str());
+      tree->Branch(basename, &(values[fTreeArrayIndex]), values.LeafList(fTreeArrayIndex, basename.Data()).c_str());
   }
 }
 
@@ -508,6 +505,19 @@ VQwScaler_Channel& VQwScaler_Channel::operator=(const VQwScaler_Channel &value)
   return *this;
 }
 
+/// Transfer the same event-based data as operator= to or from a snapshot
+void VQwScaler_Channel::Snapshot(QwSnapshot& snapshot)
+{
+  if (!IsNameEmpty()) {
+    VQwHardwareChannel::Snapshot(snapshot);
+    snapshot.Transfer(fHeader);
+    snapshot.Transfer(fValue_Raw);
+    snapshot.Transfer(fValue);
+    snapshot.Transfer(fValueError);
+    snapshot.Transfer(fValueM2);
+  }
+}
+
 void VQwScaler_Channel::AssignScaledValue(const VQwScaler_Channel &value,
 				    Double_t scale)
 {
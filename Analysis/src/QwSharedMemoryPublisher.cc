@@ -0,0 +1,296 @@
+/*!
+ * \file   QwSharedMemoryPublisher.cc
+ * \brief  Implementation of the shared-memory live publisher
+ */
+
+#include "QwSharedMemoryPublisher.h"
+
+// System headers
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <csignal>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// ROOT headers
+#include "TDirectory.h"
+#include "TH1.h"
+#include "TList.h"
+
+// Qweak headers
+#include "QwLog.h"
+
+namespace {
+  /// Round up to the alignment of the data areas
+  std::size_t Align(std::size_t size) { return (size + 7) & ~std::size_t(7); }
+}
+
+/**
+ * @param name  Name of the segment, starting with a slash
+ * @param depth Number of recent entries kept for each tree
+ */
+QwSharedMemoryPublisher::QwSharedMemoryPublisher(const std::string& name, std::size_t depth)
+: fName(name),
+  fDepth(std::max<std::size_t>(depth, 1)),
+  fDirty(kFALSE),
+  fHeader(nullptr),
+  fSize(0)
+{
+  if (fName.empty() || fName[0] != '/') fName = "/" + fName;
+}
+
+QwSharedMemoryPublisher::~QwSharedMemoryPublisher()
+{
+  if (fHeader) munmap(fHeader, fSize);
+}
+
+/**
+ * @param owner Object which removes the histograms again
+ * @param dir   Directory with the histograms
+ * @param path  Path of the directory in the published names
+ */
+void QwSharedMemoryPublisher::AddHistograms(const void* owner, TDirectory* dir, const std::string& path)
+{
+  if (dir == nullptr) return;
+  TIter next(dir->GetList());
+  while (TObject* obj = next()) {
+    if (TDirectory* subdir = dynamic_cast<TDirectory*>(obj))
+      AddHistograms(owner, subdir, path + "/" + subdir->GetName());
+    else if (TH1* h = dynamic_cast<TH1*>(obj))
+      AddHistogram(owner, h, path);
+  }
+}
+
+void QwSharedMemoryPublisher::AddHistogram(const void* owner, TH1* h, const std::string& path)
+{
+  if (h == nullptr || h->GetDimension() != 1 || fRegistered.count(h) > 0) return;
+  std::string name = path + "/" + h->GetName();
+  if (name.size() >= QwSharedMemoryRecord::kNameSize) {
+    QwWarning << "Histogram name " << name << " is too long to be published" << QwLog::endl;
+    return;
+  }
+  fHistograms.push_back(Histogram{owner, h, name, 0});
+  fRegistered.insert(h);
+  fDirty = kTRUE;
+}
+
+/**
+ * @param owner  Object which removes the tree again
+ * @param name   Name of the tree
+ * @param layout Leaves of an entry, one "offset type name" line per leaf
+ * @param size   Size of an entry in bytes
+ * @return Index of the tree for BeginEntry, or -1
+ */
+Int_t QwSharedMemoryPublisher::AddTree(const void* owner, const std::string& name,
+    const std::string& layout, std::size_t size)
+{
+  if (name.size() >= QwSharedMemoryRecord::kNameSize || size == 0) return -1;
+  fTrees.push_back(Tree{owner, name, layout, size, 0});
+  fDirty = kTRUE;
+  return fTrees.size() - 1;
+}
+
+/**
+ * Remove the objects of an owner, e.g. before the file which holds the
+ * histograms is closed.  The segment keeps their last published state
+ * until it is rebuilt.
+ */
+void QwSharedMemoryPublisher::Remove(const void* owner)
+{
+  std::size_t before = fHistograms.size();
+  for (const auto& histogram: fHistograms)
+    if (histogram.fOwner == owner) fRegistered.erase(histogram.fHistogram);
+  fHistograms.erase(std::remove_if(fHistograms.begin(), fHistograms.end(),
+      [owner](const Histogram& h) { return h.fOwner == owner; }), fHistograms.end());
+  if (fHistograms.size() != before) fDirty = kTRUE;
+
+  for (auto& tree: fTrees) {
+    if (tree.fOwner == owner) {
+      tree.fOwner = nullptr;
+      tree.fSize = 0;
+      fDirty = kTRUE;
+    }
+  }
+}
+
+void QwSharedMemoryPublisher::PublishHistograms()
+{
+  if (fDirty) Build();
+  if (fHeader == nullptr) return;
+
+  Double_t stats[TH1::kNstat];
+  for (const auto& histogram: fHistograms) {
+    TH1* h = histogram.fHistogram;
+    QwSharedMemoryRecord* record = GetRecord(histogram.fRecord);
+    std::uint64_t bins = h->GetNbinsX() + 2;
+    if (bins != record->fCount) {
+      // Rebinned histograms are published after the next rebuild
+      fDirty = kTRUE;
+      continue;
+    }
+    double* data = reinterpret_cast<double*>(reinterpret_cast<char*>(fHeader) + record->fOffset);
+
+    h->GetStats(stats);
+    record->BeginWrite();
+    data[QwSharedMemoryRecord::kEntries] = h->GetEntries();
+    data[QwSharedMemoryRecord::kSumW]    = stats[0];
+    data[QwSharedMemoryRecord::kSumW2]   = stats[1];
+    data[QwSharedMemoryRecord::kSumWX]   = stats[2];
+    data[QwSharedMemoryRecord::kSumWX2]  = stats[3];
+    data += QwSharedMemoryRecord::kNumHistogramStats;
+    for (std::uint64_t bin = 0; bin < bins; bin++)
+      data[bin] = h->GetBinContent(bin);
+    record->EndWrite();
+  }
+  fHeader->fUpdates.fetch_add(1, std::memory_order_release);
+}
+
+/**
+ * The entry has to be copied into the returned slot before EndEntry is
+ * called.  Readers retry their copy of this tree in the meantime.
+ * @param tree Index returned by AddTree
+ * @return Slot of the entry, or nullptr when the tree is not published
+ */
+char* QwSharedMemoryPublisher::BeginEntry(Int_t tree)
+{
+  if (fDirty) Build();
+  if (fHeader == nullptr || tree < 0 || fTrees.at(tree).fOwner == nullptr) return nullptr;
+
+  QwSharedMemoryRecord* record = GetRecord(fTrees[tree].fRecord);
+  record->BeginWrite();
+  return reinterpret_cast<char*>(fHeader) + record->fOffset
+       + (record->fWritten % record->fDepth) * record->fCount;
+}
+
+void QwSharedMemoryPublisher::EndEntry(Int_t tree)
+{
+  QwSharedMemoryRecord* record = GetRecord(fTrees.at(tree).fRecord);
+  record->fWritten++;
+  record->EndWrite();
+}
+
+/**
+ * Replace the segment by one with a record for every registered object.
+ * A segment left by an earlier publisher with the same name is marked as
+ * stale and unlinked first, unless that publisher is still running; the
+ * segment of a running publisher is never taken over.
+ */
+Bool_t QwSharedMemoryPublisher::Build()
+{
+  Release();
+  fDirty = kFALSE;
+
+  // Mark the segment of an earlier run as stale
+  int fd = shm_open(fName.c_str(), O_RDWR, 0);
+  if (fd >= 0) {
+    struct stat st;
+    void* old = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size >= off_t(sizeof(QwSharedMemoryHeader)))
+      old = mmap(nullptr, sizeof(QwSharedMemoryHeader), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (old != MAP_FAILED) {
+      QwSharedMemoryHeader* header = static_cast<QwSharedMemoryHeader*>(old);
+      pid_t pid = 0;
+      if (header->fMagic == QwSharedMemoryHeader::kMagic)
+        pid = header->fPid.load(std::memory_order_relaxed);
+      if (pid > 0 && pid != getpid() && (kill(pid, 0) == 0 || errno == EPERM)) {
+        munmap(old, sizeof(QwSharedMemoryHeader));
+        QwError << "Shared memory segment " << fName << " is in use by process "
+                << pid << "; choose another name with --shm-publisher-name"
+                << QwLog::endl;
+        return kFALSE;
+      }
+      if (header->fMagic == QwSharedMemoryHeader::kMagic)
+        header->fState.store(QwSharedMemoryHeader::kStale, std::memory_order_release);
+      munmap(old, sizeof(QwSharedMemoryHeader));
+    }
+    shm_unlink(fName.c_str());
+  }
+
+  // Layout of the records and their data
+  std::size_t records = fHistograms.size();
+  for (const auto& tree: fTrees)
+    if (tree.fOwner) records++;
+  std::size_t size = sizeof(QwSharedMemoryHeader) + records * sizeof(QwSharedMemoryRecord);
+  for (const auto& histogram: fHistograms)
+    size += (QwSharedMemoryRecord::kNumHistogramStats + histogram.fHistogram->GetNbinsX() + 2) * sizeof(double);
+  for (const auto& tree: fTrees)
+    if (tree.fOwner) size += Align(tree.fLayout.size() + 1) + Align(fDepth * tree.fSize);
+
+  fd = shm_open(fName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+  if (fd < 0) {
+    QwError << "Shared memory segment " << fName << " could not be created: "
+            << std::strerror(errno) << QwLog::endl;
+    return kFALSE;
+  }
+  void* segment = MAP_FAILED;
+  if (ftruncate(fd, size) == 0)
+    segment = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (segment == MAP_FAILED) {
+    QwError << "Shared memory segment " << fName << " could not be mapped: "
+            << std::strerror(errno) << QwLog::endl;
+    shm_unlink(fName.c_str());
+    return kFALSE;
+  }
+
+  // The new segment is zero-filled, so the atomics start at zero
+  fHeader = new (segment) QwSharedMemoryHeader;
+  fSize = size;
+  fHeader->fMagic = QwSharedMemoryHeader::kMagic;
+  fHeader->fVersion = QwSharedMemoryHeader::kVersion;
+  fHeader->fSize = size;
+  fHeader->fNumRecords = records;
+  fHeader->fPid.store(getpid(), std::memory_order_relaxed);
+
+  std::size_t index = 0;
+  std::size_t offset = sizeof(QwSharedMemoryHeader) + records * sizeof(QwSharedMemoryRecord);
+  for (auto& histogram: fHistograms) {
+    QwSharedMemoryRecord* record = new (GetRecord(index)) QwSharedMemoryRecord;
+    std::strncpy(record->fName, histogram.fPath.c_str(), QwSharedMemoryRecord::kNameSize - 1);
+    record->fType = QwSharedMemoryRecord::kHistogram;
+    record->fCount = histogram.fHistogram->GetNbinsX() + 2;
+    record->fMin = histogram.fHistogram->GetXaxis()->GetXmin();
+    record->fMax = histogram.fHistogram->GetXaxis()->GetXmax();
+    record->fOffset = offset;
+    record->fSize = (QwSharedMemoryRecord::kNumHistogramStats + record->fCount) * sizeof(double);
+    offset += record->fSize;
+    histogram.fRecord = index++;
+  }
+  for (auto& tree: fTrees) {
+    if (tree.fOwner == nullptr) continue;
+    QwSharedMemoryRecord* record = new (GetRecord(index)) QwSharedMemoryRecord;
+    std::strncpy(record->fName, tree.fName.c_str(), QwSharedMemoryRecord::kNameSize - 1);
+    record->fType = QwSharedMemoryRecord::kTreeEntries;
+    record->fLayoutOffset = offset;
+    record->fLayoutSize = tree.fLayout.size();
+    std::memcpy(reinterpret_cast<char*>(fHeader) + offset, tree.fLayout.c_str(), tree.fLayout.size());
+    offset += Align(tree.fLayout.size() + 1);
+    record->fCount = tree.fSize;
+    record->fDepth = fDepth;
+    record->fOffset = offset;
+    record->fSize = fDepth * tree.fSize;
+    offset += Align(record->fSize);
+    tree.fRecord = index++;
+  }
+
+  fHeader->fState.store(QwSharedMemoryHeader::kReady, std::memory_order_release);
+  QwMessage << "Publishing " << fHistograms.size() << " histograms and "
+            << records - fHistograms.size() << " trees in shared memory segment "
+            << fName << " (" << size / 1024 << " kiB)" << QwLog::endl;
+  return kTRUE;
+}
+
+void QwSharedMemoryPublisher::Release()
+{
+  if (fHeader == nullptr) return;
+  fHeader->fState.store(QwSharedMemoryHeader::kStale, std::memory_order_release);
+  munmap(fHeader, fSize);
+  shm_unlink(fName.c_str());
+  fHeader = nullptr;
+  fSize = 0;
+}
@@ -0,0 +1,227 @@
+/*!
+ * \file   QwSharedMemoryReader.cc
+ * \brief  Implementation of the shared-memory live reader
+ */
+
+#include "QwSharedMemoryReader.h"
+
+// System headers
+#include <cstring>
+#include <sstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// ROOT headers
+#include "TH1D.h"
+
+namespace {
+  /// Name of a record, which need not be terminated in a corrupt segment
+  std::string GetRecordName(const QwSharedMemoryRecord& record)
+  {
+    return std::string(record.fName, strnlen(record.fName, QwSharedMemoryRecord::kNameSize));
+  }
+}
+
+QwSharedMemoryReader::QwSharedMemoryReader()
+: fHeader(nullptr), fSize(0)
+{ }
+
+QwSharedMemoryReader::~QwSharedMemoryReader()
+{
+  Detach();
+}
+
+/**
+ * @param name Name of the segment, as passed to the publisher
+ * @return Whether a complete segment was mapped
+ */
+Bool_t QwSharedMemoryReader::Attach(const std::string& name)
+{
+  Detach();
+  fName = (name.empty() || name[0] != '/')? "/" + name: name;
+
+  int fd = shm_open(fName.c_str(), O_RDONLY, 0);
+  if (fd < 0) return kFALSE;
+  struct stat status;
+  void* segment = MAP_FAILED;
+  if (fstat(fd, &status) == 0 && std::size_t(status.st_size) >= sizeof(QwSharedMemoryHeader))
+    segment = mmap(nullptr, status.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (segment == MAP_FAILED) return kFALSE;
+
+  const QwSharedMemoryHeader* header = static_cast<const QwSharedMemoryHeader*>(segment);
+  if (header->fMagic != QwSharedMemoryHeader::kMagic
+   || header->fVersion != QwSharedMemoryHeader::kVersion
+   || header->fState.load(std::memory_order_acquire) != QwSharedMemoryHeader::kReady
+   || header->fSize != std::size_t(status.st_size)
+   || header->fNumRecords > (header->fSize - sizeof(QwSharedMemoryHeader)) / sizeof(QwSharedMemoryRecord)) {
+    munmap(segment, status.st_size);
+    return kFALSE;
+  }
+  fHeader = header;
+  fSize = status.st_size;
+  return kTRUE;
+}
+
+void QwSharedMemoryReader::Detach()
+{
+  if (fHeader) munmap(const_cast<QwSharedMemoryHeader*>(fHeader), fSize);
+  fHeader = nullptr;
+  fSize = 0;
+}
+
+Bool_t QwSharedMemoryReader::IsStale() const
+{
+  return fHeader == nullptr
+      || fHeader->fState.load(std::memory_order_acquire) != QwSharedMemoryHeader::kReady;
+}
+
+std::uint64_t QwSharedMemoryReader::GetUpdates() const
+{
+  return fHeader? fHeader->fUpdates.load(std::memory_order_acquire): 0;
+}
+
+std::vector<std::string> QwSharedMemoryReader::GetHistogramNames() const
+{
+  std::vector<std::string> names;
+  if (fHeader == nullptr) return names;
+  const QwSharedMemoryRecord* records = fHeader->GetRecords();
+  for (std::uint64_t i = 0; i < fHeader->fNumRecords; i++)
+    if (records[i].fType == QwSharedMemoryRecord::kHistogram)
+      names.push_back(GetRecordName(records[i]));
+  return names;
+}
+
+std::vector<std::string> QwSharedMemoryReader::GetTreeNames() const
+{
+  std::vector<std::string> names;
+  if (fHeader == nullptr) return names;
+  const QwSharedMemoryRecord* records = fHeader->GetRecords();
+  for (std::uint64_t i = 0; i < fHeader->fNumRecords; i++)
+    if (records[i].fType == QwSharedMemoryRecord::kTreeEntries)
+      names.push_back(GetRecordName(records[i]));
+  return names;
+}
+
+const QwSharedMemoryRecord* QwSharedMemoryReader::FindRecord(const std::string& name, std::uint32_t type) const
+{
+  if (IsStale()) return nullptr;
+  const QwSharedMemoryRecord* records = fHeader->GetRecords();
+  for (std::uint64_t i = 0; i < fHeader->fNumRecords; i++)
+    if (records[i].fType == type && name == GetRecordName(records[i]))
+      return &records[i];
+  return nullptr;
+}
+
+/**
+ * @param name Path of the histogram, e.g. "evt_histo/bcm_an_us_hw"
+ * @return New histogram without directory, or nullptr
+ */
+TH1D* QwSharedMemoryReader::GetHistogram(const std::string& name) const
+{
+  const QwSharedMemoryRecord* record = FindRecord(name, QwSharedMemoryRecord::kHistogram);
+  if (record == nullptr) return nullptr;
+
+  // The statistics and all bins must be within the data of the record,
+  // and the data within the segment
+  const std::uint64_t size = record->fSize;
+  const std::uint64_t nvalues = size / sizeof(double);
+  if (! IsInSegment(record->fOffset, size)
+   || record->fCount < 2 || record->fCount > std::uint64_t(kMaxInt)
+   || nvalues < QwSharedMemoryRecord::kNumHistogramStats
+   || record->fCount > nvalues - QwSharedMemoryRecord::kNumHistogramStats)
+    return nullptr;
+
+  std::vector<double> data(nvalues);
+  const char* source = GetData(record->fOffset);
+  if (! record->Read([&]{ std::memcpy(data.data(), source, nvalues * sizeof(double)); }))
+    return nullptr;
+
+  Int_t nbins = record->fCount - 2;
+  TH1D* h = new TH1D(name.c_str(), name.c_str(), nbins, record->fMin, record->fMax);
+  h->SetDirectory(0);
+  const double* contents = data.data() + QwSharedMemoryRecord::kNumHistogramStats;
+  for (Int_t bin = 0; bin < nbins + 2; bin++)
+    h->SetBinContent(bin, contents[bin]);
+  Double_t stats[4] = {
+    data[QwSharedMemoryRecord::kSumW],  data[QwSharedMemoryRecord::kSumW2],
+    data[QwSharedMemoryRecord::kSumWX], data[QwSharedMemoryRecord::kSumWX2] };
+  h->PutStats(stats);
+  h->SetEntries(data[QwSharedMemoryRecord::kEntries]);
+  return h;
+}
+
+/**
+ * @param tree   Name of the tree
+ * @param leaf   Name of the leaf, as "branch.leaf"
+ * @param values Values of the leaf in the entries in the ring, oldest first
+ * @return Whether the leaf was found and a consistent copy was made
+ */
+Bool_t QwSharedMemoryReader::GetLeafValues(const std::string& tree, const std::string& leaf,
+    std::vector<Double_t>& values) const
+{
+  values.clear();
+  const QwSharedMemoryRecord* record = FindRecord(tree, QwSharedMemoryRecord::kTreeEntries);
+  if (record == nullptr) return kFALSE;
+
+  // The description and the ring of entries must be within the segment,
+  // and the ring must hold depth entries of the entry size
+  const std::uint64_t size = record->fSize;
+  const std::uint64_t entrysize = record->fCount;
+  const std::uint64_t depth = record->fDepth;
+  if (! IsInSegment(record->fLayoutOffset, record->fLayoutSize)
+   || ! IsInSegment(record->fOffset, size)
+   || entrysize == 0 || depth == 0 || depth > size / entrysize)
+    return kFALSE;
+
+  // Find the offset and type of the leaf in the description
+  std::istringstream layout(std::string(GetData(record->fLayoutOffset), record->fLayoutSize));
+  std::size_t offset = 0;
+  char type = 0;
+  std::string line;
+  while (std::getline(layout, line)) {
+    std::istringstream fields(line);
+    std::string name;
+    if ((fields >> offset >> type >> name) && name == leaf) break;
+    type = 0;
+  }
+  if (type == 0) return kFALSE;
+
+  // The leaf must be within an entry
+  std::size_t typesize = 0;
+  switch (type) {
+    case 'D': case 'L': case 'l': typesize = 8; break;
+    case 'F': case 'I': case 'i': typesize = 4; break;
+    case 'S': case 's':           typesize = 2; break;
+    default: return kFALSE;
+  }
+  if (offset > entrysize || typesize > entrysize - offset) return kFALSE;
+
+  std::vector<char> ring(size);
+  std::uint64_t written = 0;
+  const char* source = GetData(record->fOffset);
+  if (! record->Read([&]{
+        written = record->fWritten;
+        std::memcpy(ring.data(), source, size);
+      }))
+    return kFALSE;
+
+  std::uint64_t count = (written < depth)? written: depth;
+  for (std::uint64_t i = written - count; i < written; i++) {
+    const char* address = ring.data() + (i % depth) * entrysize + offset;
+    switch (type) {
+      case 'D': { Double_t  v; std::memcpy(&v, address, sizeof(v)); values.push_back(v); break; }
+      case 'F': { Float_t   v; std::memcpy(&v, address, sizeof(v)); values.push_back(v); break; }
+      case 'L': { Long64_t  v; std::memcpy(&v, address, sizeof(v)); values.push_back(v); break; }
+      case 'l': { ULong64_t v; std::memcpy(&v, address, sizeof(v)); values.push_back(v); break; }
+      case 'I': { Int_t     v; std::memcpy(&v, address, sizeof(v)); values.push_back(v); break; }
+      case 'i': { UInt_t    v; std::memcpy(&v, address, sizeof(v)); values.push_back(v); break; }
+      case 'S': { Short_t   v; std::memcpy(&v, address, sizeof(v)); values.push_back(v); break; }
+      case 's': { UShort_t  v; std::memcpy(&v, address, sizeof(v)); values.push_back(v); break; }
+      default: return kFALSE;
+    }
+  }
+  return kTRUE;
+}
@@ -13,6 +13,7 @@
 #include "QwLog.h"
 #include "QwParameterFile.h"
 #include "QwRootFile.h"
+#include "QwThreadPool.h"
 
 //*****************************************************************
 
@@ -20,7 +21,8 @@
  * Create a subsystem array based on the configuration option 'detectors'
  */
 QwSubsystemArray::QwSubsystemArray(QwOptions& options, CanContainFn myCanContain)
-: fCleanParameter{0,0,0},fEventTypeMask(0x0),fnCanContain(myCanContain)
+: fCleanParameter{0,0,0},fEventTypeMask(0x0),fThreadPool(nullptr),fnCanContain(myCanContain),
+  fDispatchTableValid(kFALSE)
 {
   ProcessOptionsToplevel(options);
   QwParameterFile detectors(fSubsystemsMapFile.c_str());
@@ -42,10 +44,12 @@ QwSubsystemArray::QwSubsystemArray(const QwSubsystemArray& source)
   fCodaEventType(source.fCodaEventType),
   fEventTypeMask(source.fEventTypeMask),
   fHasDataLoaded(source.fHasDataLoaded),
+  fThreadPool(nullptr),
   fnCanContain(source.fnCanContain),
   fSubsystemsMapFile(source.fSubsystemsMapFile),
   fSubsystemsDisabledByName(source.fSubsystemsDisabledByName),
-  fSubsystemsDisabledByType(source.fSubsystemsDisabledByType)
+  fSubsystemsDisabledByType(source.fSubsystemsDisabledByType),
+  fDispatchTableValid(kFALSE)
 {
   for (size_t i = 0; i < 3; i++)
     fCleanParameter[i] = source.fCleanParameter[i];
@@ -187,6 +191,9 @@ void QwSubsystemArray::LoadSubsystemsFromParameterFile(QwParameterFile& detector
               << " could be published!" << QwLog::endl;
     }
   }
+
+  //  All channel maps are loaded now
+  BuildDispatchTable();
 }
 
 //*****************************************************************
@@ -221,6 +228,9 @@ void QwSubsystemArray::push_back(VQwSubsystem* subsys)
     // Set the parent of the subsystem to this array
     subsys_tmp->SetParent(this);
 
+    // The new subsystem is not in the dispatch table yet
+    InvalidateDispatchTable();
+
     // Update the event type mask
     // Note: Active bits in the mask indicate event types that are accepted
     fEventTypeMask |= subsys_tmp->GetEventTypeMask();
@@ -404,20 +414,90 @@ Int_t QwSubsystemArray::ProcessEvBuffer(
 {
   if (!empty()) {
     SetDataLoaded(kTRUE);
-    for (iterator subsys = begin(); subsys != end(); ++subsys) {
-      (*subsys)->ProcessEvBuffer(event_type, roc_id, bank_id, buffer, num_words);
+    //  Only offer the bank to the subsystems that read it
+    BankDispatch& dispatch = GetBankDispatch(roc_id, bank_id);
+    for (auto& consumer: dispatch.fConsumers) {
+      consumer.first->SetSubbankIndexHint(roc_id, bank_id, consumer.second);
+      consumer.first->ProcessEvBuffer(event_type, roc_id, bank_id, buffer, num_words);
     }
   }
   return 0;
 }
 
+/**
+ * Get the dispatch table entry for a ROC/bank.  Banks that no subsystem
+ * registered share one entry with the subsystems that read all banks.
+ * @param roc_id ROC ID
+ * @param bank_id Bank ID (with the marker word in the upper 32 bits)
+ * @return Dispatch table entry
+ */
+QwSubsystemArray::BankDispatch& QwSubsystemArray::GetBankDispatch(
+  const ROCID_t roc_id,
+  const BankID_t bank_id)
+{
+  if (! fDispatchTableValid) BuildDispatchTable();
+  auto entry = fDispatchTable.find(std::make_pair(roc_id, bank_id));
+  if (entry == fDispatchTable.end()) return fDispatchDefault;
+  return entry->second;
+}
+
+/**
+ * Build the dispatch table from the ROC/bank registrations of all
+ * subsystems.  The subsystems in each entry are kept in array order.
+ */
+void QwSubsystemArray::BuildDispatchTable()
+{
+  fDispatchTable.clear();
+  fDispatchDefault = BankDispatch();
+
+  //  Collect the registered ROC/banks of all subsystems
+  for (const_iterator subsys = begin(); subsys != end(); ++subsys) {
+    std::vector<ROCID_t> roc_ids = (*subsys)->GetROCIds();
+    const std::vector< std::vector<BankID_t> >& bank_ids = (*subsys)->GetBankIds();
+    for (size_t roc_index = 0; roc_index < roc_ids.size(); roc_index++) {
+      for (size_t bank_index = 0; bank_index < bank_ids.at(roc_index).size(); bank_index++) {
+        fDispatchTable[std::make_pair(roc_ids[roc_index], bank_ids[roc_index][bank_index])];
+      }
+    }
+  }
+
+  //  Assign the consumers and marker words to each ROC/bank
+  for (auto& entry: fDispatchTable) {
+    const ROCID_t roc_id = entry.first.first;
+    const BankID_t bank_id = entry.first.second;
+    BankDispatch& dispatch = entry.second;
+    for (iterator subsys = begin(); subsys != end(); ++subsys) {
+      Int_t index = (*subsys)->GetSubbankIndex(roc_id, bank_id);
+      if (index >= 0 || (*subsys)->ReadsAllBanks())
+        dispatch.fConsumers.push_back(std::make_pair(subsys->get(), index));
+      (*subsys)->GetMarkerWordList(roc_id, bank_id, dispatch.fMarkerWords);
+    }
+    dispatch.fMarkerOffsets.assign(dispatch.fMarkerWords.size(), 0);
+  }
+  for (iterator subsys = begin(); subsys != end(); ++subsys) {
+    if ((*subsys)->ReadsAllBanks())
+      fDispatchDefault.fConsumers.push_back(std::make_pair(subsys->get(), -1));
+  }
+
+  fDispatchTableValid = kTRUE;
+}
+
 
 void  QwSubsystemArray::ProcessEvent()
 {
   if (!empty() && HasDataLoaded()) {
-    std::for_each(begin(), end(), boost::mem_fn(&VQwSubsystem::ProcessEvent));
-    std::for_each(begin(), end(), boost::mem_fn(&VQwSubsystem::ExchangeProcessedData));
-    std::for_each(begin(), end(), boost::mem_fn(&VQwSubsystem::ProcessEvent_2));
+    if (fThreadPool != nullptr) {
+      //  Subsystems only see each other's data in ExchangeProcessedData,
+      //  so the two processing passes can run on the subsystems in
+      //  parallel while the exchange stays serial and in order.
+      fThreadPool->ForEach(size(), [this](std::size_t i){ at(i)->ProcessEvent(); });
+      std::for_each(begin(), end(), boost::mem_fn(&VQwSubsystem::ExchangeProcessedData));
+      fThreadPool->ForEach(size(), [this](std::size_t i){ at(i)->ProcessEvent_2(); });
+    } else {
+      std::for_each(begin(), end(), boost::mem_fn(&VQwSubsystem::ProcessEvent));
+      std::for_each(begin(), end(), boost::mem_fn(&VQwSubsystem::ExchangeProcessedData));
+      std::for_each(begin(), end(), boost::mem_fn(&VQwSubsystem::ProcessEvent_2));
+    }
   }
 }
 
@@ -565,6 +645,11 @@ void  QwSubsystemArray::ConstructBranchAndVector(
   values.push_back("Coda_CleanData", 'D');
   values.push_back("Coda_ScanData1", 'D');
   values.push_back("Coda_ScanData2", 'D');
+  values.SetSource(fTreeArrayIndex,   &fCodaEventNumber);
+  values.SetSource(fTreeArrayIndex+1, &fCodaEventType);
+  values.SetSource(fTreeArrayIndex+2, &fCleanParameter[0]);
+  values.SetSource(fTreeArrayIndex+3, &fCleanParameter[1]);
+  values.SetSource(fTreeArrayIndex+4, &fCleanParameter[2]);
   if (prefix == "" || prefix.Index("yield_") == 0) {
     tree->Branch("CodaEventNumber",&(values[fTreeArrayIndex]),"CodaEventNumber/i");
     tree->Branch("CodaEventType",&(values[fTreeArrayIndex+1]),"CodaEventType/i");
@@ -650,12 +735,14 @@ void QwSubsystemArray::ConstructBranch(
 void QwSubsystemArray::FillTreeVector(QwRootTreeBranchVector &values) const
 {
   // Fill the event number and event type
-  size_t index = fTreeArrayIndex;
-  values.SetValue(index++, this->GetCodaEventNumber());
-  values.SetValue(index++, this->GetCodaEventType());
-  values.SetValue(index++, this->fCleanParameter[0]);
-  values.SetValue(index++, this->fCleanParameter[1]);
-  values.SetValue(index++, this->fCleanParameter[2]);
+  if (! values.IsBound(fTreeArrayIndex, 5)) {
+    size_t index = fTreeArrayIndex;
+    values.SetValue(index++, this->GetCodaEventNumber());
+    values.SetValue(index++, this->GetCodaEventType());
+    values.SetValue(index++, this->fCleanParameter[0]);
+    values.SetValue(index++, this->fCleanParameter[1]);
+    values.SetValue(index++, this->fCleanParameter[2]);
+  }
 
   // Fill the subsystem data
   for (const_iterator subsys = begin(); subsys != end(); ++subsys) {
@@ -0,0 +1,107 @@
+/*!
+ * \file   QwThreadPool.cc
+ * \brief  Implementation of the fixed-size thread pool
+ */
+
+#include "QwThreadPool.h"
+
+/**
+ * Create the worker threads.  A pool with zero threads is valid; ForEach
+ * then executes the whole loop on the calling thread.
+ * @param nthreads Number of worker threads in addition to the caller
+ */
+QwThreadPool::QwThreadPool(std::size_t nthreads)
+: fTask(nullptr),
+  fTaskSize(0),
+  fNextIndex(0),
+  fBusyThreads(0),
+  fGeneration(0),
+  fStop(false)
+{
+  fThreads.reserve(nthreads);
+  for (std::size_t i = 0; i < nthreads; i++)
+    fThreads.emplace_back(&QwThreadPool::WorkerLoop, this);
+}
+
+QwThreadPool::~QwThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    fStop = true;
+  }
+  fStartCondition.notify_all();
+  for (auto& thread: fThreads)
+    if (thread.joinable()) thread.join();
+}
+
+/**
+ * Execute fn(i) for every index, on the worker threads and the calling
+ * thread, and return after the last call has finished.  Calls to ForEach
+ * must not be nested or made concurrently from several threads.  The log
+ * output of each call is captured and written out in index order by the
+ * calling thread after the loop, as if the loop had run serially.
+ * @param n  Number of indices
+ * @param fn Loop body
+ */
+void QwThreadPool::ForEach(std::size_t n, const std::function<void(std::size_t)>& fn)
+{
+  if (n == 0) return;
+  if (fThreads.empty() || n == 1) {
+    for (std::size_t i = 0; i < n; i++) fn(i);
+    return;
+  }
+
+  if (fLogs.size() < n) fLogs.resize(n);
+
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    fTask = &fn;
+    fTaskSize = n;
+    fNextIndex = 0;
+    fBusyThreads = fThreads.size();
+    ++fGeneration;
+  }
+  fStartCondition.notify_all();
+
+  //  The caller takes its share of the work
+  RunTasks();
+
+  std::unique_lock<std::mutex> lock(fMutex);
+  fDoneCondition.wait(lock, [this]{ return fBusyThreads == 0; });
+  fTask = nullptr;
+  lock.unlock();
+
+  for (std::size_t i = 0; i < n; i++)
+    if (! fLogs[i].IsEmpty()) gQwLog.Replay(fLogs[i]);
+}
+
+void QwThreadPool::RunTasks()
+{
+  std::size_t i;
+  while ((i = fNextIndex.fetch_add(1)) < fTaskSize) {
+    QwLogCapture* previous = QwLog::SetCapture(&fLogs[i]);
+    (*fTask)(i);
+    QwLog::SetCapture(previous);
+  }
+}
+
+void QwThreadPool::WorkerLoop()
+{
+  unsigned long generation = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(fMutex);
+      fStartCondition.wait(lock, [&]{ return fStop || fGeneration != generation; });
+      if (fStop) return;
+      generation = fGeneration;
+    }
+
+    RunTasks();
+
+    {
+      std::lock_guard<std::mutex> lock(fMutex);
+      --fBusyThreads;
+    }
+    fDoneCondition.notify_one();
+  }
+}
@@ -280,25 +280,20 @@ void QwVQWK_Channel::RandomizeEventData(int helicity, double time)
   //  drift += fMockDriftAmplitude[i] * sin(2.0 * Qw::pi * fMockDriftFrequency[i] * time + fMockDriftPhase[i]);
   //}
 
-  // updated to calculate the drift for each block individually
-  Double_t drift = 0.0;
-  for (Int_t i = 0; i < fBlocksPerEvent; i++){
-    drift = 0.0;
-    if (i >= 1){
-      time += (fNumberOfSamples_map/4.0)*kTimePerSample;
-    }
-    for (UInt_t i = 0; i < fMockDriftFrequency.size(); i++) {
-      drift += fMockDriftAmplitude[i] * sin(2.0 * Qw::pi * fMockDriftFrequency[i] * time + fMockDriftPhase[i]);
-      //std::cout << "Drift: " << drift << std::endl;
-    }
-  }
+  // The drift is evaluated at the time of the last block
+  time += (fBlocksPerEvent - 1)*(fNumberOfSamples_map/4.0)*kTimePerSample;
+  Double_t drift = GetRandomEventDrift(time);
+
+  // Random values for all blocks at once
+  Double_t random[4];
+  GetRandomValues(random, fBlocksPerEvent);
 
   // Calculate signal
   fHardwareBlockSum = 0.0;
   fHardwareBlockSumM2 = 0.0; // second moment is zero for single events
 
   for (Int_t i = 0; i < fBlocksPerEvent; i++) {
-    double tmpvar = GetRandomValue();
+    double tmpvar = random[i];
     //std::cout << "tmpvar: " << tmpvar << std::endl;
     //std::cout << "->fMockSigma: " << fMockGaussianSigma << std::endl;
 
@@ -336,12 +331,15 @@ void QwVQWK_Channel::RandomizeEventData(int helicity, double time)
 
 void QwVQWK_Channel::SmearByResolution(double resolution){
 
+  Double_t random[4];
+  GetRandomValues(random, fBlocksPerEvent);
+
   fHardwareBlockSum   = 0.0;
   fHardwareBlockSumM2 = 0.0; // second moment is zero for single events
   for (Int_t i = 0; i < fBlocksPerEvent; i++) {
     // std::cout << i << " " << fBlock[i] << "->";
     //std::cout << "resolution = " << resolution << "\t for channel \t" << GetElementName() << std::endl;
-    fBlock[i] += resolution*sqrt(fBlocksPerEvent) * GetRandomValue();
+    fBlock[i] += resolution*sqrt(fBlocksPerEvent) * random[i];
     // std::cout << fBlock[i] << ": ";
     fBlockM2[i] = 0.0; // second moment is zero for single events
     fHardwareBlockSum += fBlock[i];
@@ -483,7 +481,7 @@ void QwVQWK_Channel::EncodeEventData(std::vector<UInt_t> &buffer)
  * 
  * Data Processing Steps:
  * 1. Validates sufficient buffer space (6 words minimum)
- * 2. Copies raw data to local buffer with sign conversion (UInt_t -> Int_t)
+ * 2. Unpacks the words with QwADCDecoder::DecodeVQWK (UInt_t -> Int_t)
  * 3. Extracts individual block sums and hardware sum
  * 4. Decodes sequence number for event ordering verification
  * 5. Extracts sample count for integration time normalization
@@ -502,7 +500,6 @@ void QwVQWK_Channel::EncodeEventData(std::vector<UInt_t> &buffer)
  * Buffer Management:
  * - Always consumes exactly kWordsPerChannel (6) words when successful
  * - Returns 0 on buffer underrun to indicate processing failure
- * - Thread-safe local buffer prevents data corruption
  * 
  * \note This function only processes raw data extraction. Calibration,
  * pedestal subtraction, and physics calculations are performed in ProcessEvent().
@@ -513,10 +510,6 @@ void QwVQWK_Channel::EncodeEventData(std::vector<UInt_t> &buffer)
 Int_t QwVQWK_Channel::ProcessEvBuffer(UInt_t* buffer, UInt_t num_words_left, UInt_t index)
 {
   UInt_t words_read = 0;
-  UInt_t localbuf[kWordsPerChannel] = {0};
-  // The conversion from UInt_t to Double_t discards the sign, so we need an intermediate
-  // static_cast from UInt_t to Int_t.
-  Int_t localbuf_signed[kWordsPerChannel] = {0};
 
   if (IsNameEmpty()){
     //  This channel is not used, but is present in the data stream.
@@ -524,37 +517,46 @@ Int_t QwVQWK_Channel::ProcessEvBuffer(UInt_t* buffer, UInt_t num_words_left, UIn
     words_read = fNumberOfDataWords;
   } else if (num_words_left >= fNumberOfDataWords)
     {
-      for (Int_t i=0; i<kWordsPerChannel; i++){
-        localbuf[i] = buffer[i];
-        localbuf_signed[i] = static_cast<Int_t>(localbuf[i]);
-      }
-
-      fSoftwareBlockSum_raw = 0;
-      for (Int_t i=0; i<fBlocksPerEvent; i++){
-        fBlock_raw[i] = localbuf_signed[i];
-        fSoftwareBlockSum_raw += fBlock_raw[i];
-      }
-      fHardwareBlockSum_raw = localbuf_signed[4];
-
-      /*  Permanent change in the structure of the 6th word of the ADC readout.
-       *  The upper 16 bits are the number of samples, and the upper 8 of the
-       *  lower 16 are the sequence number.  This matches the structure of
-       *  the ADC readout in block read mode, and now also in register read mode.
-       *  P.King, 2007sep04.
-       */
-      fSequenceNumber   = (localbuf[5]>>8)  & 0xFF;
-      fNumberOfSamples  = (localbuf[5]>>16) & 0xFFFF;
+      QwADCDecoder::VQWKWords words;
+      QwADCDecoder::DecodeVQWK(buffer, words);
+      SetRawWords(words);
 
       words_read = fNumberOfDataWords;
 
     } else
       {
-        std::cerr << "QwVQWK_Channel::ProcessEvBuffer: Not enough words!"
-                  << std::endl;
+        QwError << "QwVQWK_Channel::ProcessEvBuffer: Not enough words!"
+                << QwLog::endl;
       }
   return words_read;
 }
 
+/**
+ * \brief Set the raw event data from the unpacked words of a CODA buffer.
+ *
+ * Takes the output of QwADCDecoder::DecodeVQWK and copies the blocks used
+ * by this channel, the hardware sum, the sequence number and the number
+ * of samples, and recomputes the software sum of the blocks.
+ *
+ * The structure of the 6th word of the ADC readout (number of samples in
+ * the upper 16 bits, sequence number in the upper 8 of the lower 16 bits)
+ * matches the ADC readout in block read mode, and now also in register
+ * read mode.  P.King, 2007sep04.
+ *
+ * @param words Unpacked words of this channel
+ */
+void QwVQWK_Channel::SetRawWords(const QwADCDecoder::VQWKWords& words)
+{
+  fSoftwareBlockSum_raw = 0;
+  for (Int_t i=0; i<fBlocksPerEvent; i++){
+    fBlock_raw[i] = words.fBlock_raw[i];
+    fSoftwareBlockSum_raw += fBlock_raw[i];
+  }
+  fHardwareBlockSum_raw = words.fHardwareBlockSum_raw;
+  fSequenceNumber   = words.fSequenceNumber;
+  fNumberOfSamples  = words.fNumberOfSamples;
+}
+
 
 
 void QwVQWK_Channel::ProcessEvent()
@@ -695,43 +697,43 @@ void  QwVQWK_Channel::FillHistograms()
             for (Int_t i=0; i<fBlocksPerEvent; i++)
               {
                 if (fHistograms[index] != NULL && (fErrorFlag)==0)
-                  fHistograms[index]->Fill(this->GetRawBlockValue(i));
+                  FillHistogram(index, this->GetRawBlockValue(i));
                 if (fHistograms[index+1] != NULL && (fErrorFlag)==0)
-                  fHistograms[index+1]->Fill(this->GetBlockValue(i));
+                  FillHistogram(index+1, this->GetBlockValue(i));
                 index+=2;
               }
             if (fHistograms[index] != NULL && (fErrorFlag)==0)
-              fHistograms[index]->Fill(this->GetRawHardwareSum());
+              FillHistogram(index, this->GetRawHardwareSum());
             if (fHistograms[index+1] != NULL && (fErrorFlag)==0)
-              fHistograms[index+1]->Fill(this->GetHardwareSum());
+              FillHistogram(index+1, this->GetHardwareSum());
             index+=2;
             if (fHistograms[index] != NULL && (fErrorFlag)==0)
-              fHistograms[index]->Fill(this->GetRawSoftwareSum()-this->GetRawHardwareSum());
+              FillHistogram(index, this->GetRawSoftwareSum()-this->GetRawHardwareSum());
           }
         else if(fDataToSave==kDerived)
           {
             for (Int_t i=0; i<fBlocksPerEvent; i++)
               {
                 if (fHistograms[index] != NULL && (fErrorFlag)==0)
-                  fHistograms[index]->Fill(this->GetBlockValue(i));
+                  FillHistogram(index, this->GetBlockValue(i));
                 index+=1;
               }
             if (fHistograms[index] != NULL && (fErrorFlag)==0)
-              fHistograms[index]->Fill(this->GetHardwareSum());
+              FillHistogram(index, this->GetHardwareSum());
             index+=1; 
             if (fHistograms[index] != NULL){
               if ( (kErrorFlag_sample &  fErrorFlag)==kErrorFlag_sample)
-                fHistograms[index]->Fill(kErrorFlag_sample);
+                FillHistogram(index, kErrorFlag_sample);
               if ( (kErrorFlag_SW_HW &  fErrorFlag)==kErrorFlag_SW_HW)
-                fHistograms[index]->Fill(kErrorFlag_SW_HW);
+                FillHistogram(index, kErrorFlag_SW_HW);
               if ( (kErrorFlag_Sequence &  fErrorFlag)==kErrorFlag_Sequence)
-                fHistograms[index]->Fill(kErrorFlag_Sequence);
+                FillHistogram(index, kErrorFlag_Sequence);
               if ( (kErrorFlag_ZeroHW &  fErrorFlag)==kErrorFlag_ZeroHW)
-                fHistograms[index]->Fill(kErrorFlag_ZeroHW);
+                FillHistogram(index, kErrorFlag_ZeroHW);
               if ( (kErrorFlag_VQWK_Sat &  fErrorFlag)==kErrorFlag_VQWK_Sat)
-                fHistograms[index]->Fill(kErrorFlag_VQWK_Sat);
+                FillHistogram(index, kErrorFlag_VQWK_Sat);
               if ( (kErrorFlag_SameHW &  fErrorFlag)==kErrorFlag_SameHW)
-                fHistograms[index]->Fill(kErrorFlag_SameHW);
+                FillHistogram(index, kErrorFlag_SameHW);
             }
             
           }
@@ -798,15 +800,15 @@ void  QwVQWK_Channel::ConstructBranchAndVector(TTree *tree, TString &prefix, QwR
 
   fTreeArrayNumEntries = values.size() - fTreeArrayIndex;
 
-  std::string leaf_list = values.LeafList();
+  std::string leaf_list = values.LeafList(fTreeArrayIndex, basename.Data());
 
   if (gQwHists.MatchDeviceParamsFromList(basename.Data())
     && (bHw_sum || bBlock || bNum_samples || bDevice_Error_Code ||
         bHw_sum_raw || bBlock_raw || bSequence_number)) {
 
     // This is for the RT mode
-    if (leaf_list == "hw_sum/D")
-      leaf_list = basename+"/D";
+    if (leaf_list.compare(0, 7, "hw_sum/") == 0 && fTreeArrayNumEntries == 1)
+      leaf_list = basename + leaf_list.substr(6);
 
     if (kDEBUG)
       QwMessage << "base name " << basename << " List " << leaf_list << QwLog::endl;
@@ -1149,6 +1151,35 @@ QwVQWK_Channel& QwVQWK_Channel::operator= (const QwVQWK_Channel &value)
   return *this;
 }
 
+/**
+ * \brief Transfer the event-based data to or from a snapshot.
+ *
+ * Transfers the same values as operator=, so that restoring a snapshot
+ * into a channel with the same configuration is equivalent to assigning
+ * the original channel.
+ *
+ * @param snapshot Snapshot being measured, written or read
+ */
+void QwVQWK_Channel::Snapshot(QwSnapshot& snapshot)
+{
+  if (!IsNameEmpty()) {
+    VQwHardwareChannel::Snapshot(snapshot);
+    snapshot.Transfer(fBlock, fBlocksPerEvent);
+    snapshot.Transfer(fBlockM2, fBlocksPerEvent);
+    snapshot.Transfer(fHardwareBlockSum);
+    snapshot.Transfer(fHardwareBlockSumM2);
+    snapshot.Transfer(fHardwareBlockSumError);
+    snapshot.Transfer(fNumberOfSamples);
+    snapshot.Transfer(fSequenceNumber);
+
+    if (this->fDataToSave == kRaw){
+      snapshot.Transfer(fBlock_raw, fBlocksPerEvent);
+      snapshot.Transfer(fHardwareBlockSum_raw);
+      snapshot.Transfer(fSoftwareBlockSum_raw);
+    }
+  }
+}
+
 void QwVQWK_Channel::AssignScaledValue(const QwVQWK_Channel &value,
                                  Double_t scale)
 {
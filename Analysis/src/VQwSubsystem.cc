@@ -146,12 +146,15 @@ void VQwSubsystem::ClearAllBankRegistrations()
   fROC_IDs.clear();
   fCurrentROC_ID    = kNullROCID;
   fCurrentBank_ID   = kNullBankID;
+  SetSubbankIndexHint(kNullROCID, kNullBankID, -1);
 }
 
 // Compute the flat subbank index from ROC and bank IDs.
 Int_t VQwSubsystem::GetSubbankIndex(const ROCID_t roc_id, const BankID_t bank_id) const
 {
   //  Bool_t lDEBUG=kTRUE;
+  if (roc_id == fHintROC_ID && bank_id == fHintBank_ID)
+    return fHintSubbankIndex;
   Int_t index = -1;
   Int_t roc_index = FindIndex(fROC_IDs, roc_id);//will return the vector index for the Roc from the vector fROC_IDs.
   // std::cout << "------------- roc_index" << roc_index <<std::endl;
@@ -181,6 +184,8 @@ Int_t VQwSubsystem::RegisterROCNumber(const ROCID_t roc_id, const BankID_t bank_
   Int_t stat      = 0;
   Int_t roc_index = 0;
   roc_index = FindIndex(fROC_IDs, roc_id);
+  //  New registrations can shift the subbank indices
+  SetSubbankIndexHint(kNullROCID, kNullBankID, -1);
 
   //will return the vector index for this roc_id on the vector fROC_IDs
   if (roc_index==-1){
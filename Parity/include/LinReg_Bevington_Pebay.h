@@ -15,7 +15,10 @@
 #pragma once
 
 // System headers
+#include <cstdint>
+#include <iosfwd>
 #include <utility>
+#include <vector>
 
 // ROOT headers
 #include <TVectorD.h>
@@ -26,6 +29,20 @@
  * \class LinRegBevPeb
  * \ingroup QwAnalysis_BL
  * \brief Online linear regression with incremental covariance updates
+ *
+ * Events added with addEvent are collected in a block of kBlockEvents
+ * events, stored column-major (the values of one variable are contiguous).
+ * A full block is folded into the means and covariances at once: the block
+ * means and co-moments are computed with plain loops over the block, and
+ * are then combined with the running moments by the pairwise (Pebay)
+ * formula.  Pending events are folded in by flush, which is called by
+ * solve and by the addition operators.
+ *
+ * The state (event count, means and unnormalized covariances) of objects
+ * filled with separate events can be combined exactly with merge, e.g. for
+ * threads or for separate segments of a run.  writeBinary and readBinary
+ * store this state in a compact binary form, so that it can be merged in a
+ * later job.
  */
 class LinRegBevPeb {
   int  nP; // number of independent variables
@@ -63,14 +80,32 @@ class LinRegBevPeb {
   /// slopes
   TMatrixD Axy, Ayx, dAxy, dAyx; // found slopes and their standard errors
 
+  /// block of pending events, one row of kBlockEvents values per variable
+  std::vector<Double_t> fBlock;
+  Int_t fBlockEvents;           ///< number of events in the block
+  /// scratch space for the block means and co-moments
+  std::vector<Double_t> fBlockMean;
+  std::vector<Double_t> fBlockCoMoments;
+
+  /// fold a block of events into the running moments
+  void accumulateBlock(const Double_t* block, Int_t n);
+
+  /// identifier at the start of the binary state ("LRB1")
+  static const uint32_t kBinaryMagic = 0x3142524c;
+  /// largest number of variables of each kind accepted from a binary state
+  static const uint32_t kMaxBinaryDims = 4096;
+
  public:
 
+  /// number of events collected before they are folded into the moments
+  static const Int_t kBlockEvents = 64;
+
   LinRegBevPeb();
   LinRegBevPeb(const LinRegBevPeb& source);
   virtual ~LinRegBevPeb() { };
 
   void solve();
-  bool failed() { return fGoodEventNumber < nP + 1; }
+  bool failed() { return fGoodEventNumber + fBlockEvents < nP + 1; }
 
   // after last event
   void printSummaryP() const;
@@ -100,8 +135,28 @@ class LinRegBevPeb {
   Int_t getCovariancePY(int ip, int iy, Double_t &covar) const;
   Int_t getCovarianceY (int i,  int j,  Double_t &covar) const;
 
+  /// Get slope of a dependent on an independent variable, returns error code
+  Int_t getSlope(int ip, int iy, Double_t &slope, Double_t &error) const;
+
   double  getUsedEve() const { return fGoodEventNumber; };
 
+  /// Add one event, given the independent and dependent values
+  void addEvent(const Double_t* P, const Double_t* Y) {
+    for (int i = 0; i < nP; i++) fBlock[i * kBlockEvents + fBlockEvents] = P[i];
+    for (int i = 0; i < nY; i++) fBlock[(nP + i) * kBlockEvents + fBlockEvents] = Y[i];
+    if (++fBlockEvents == kBlockEvents) flush();
+  }
+  /// Fold the pending events into the means and covariances
+  void flush();
+
+  /// Combine with the events of another object
+  void merge(const LinRegBevPeb& rhs);
+
+  /// Write the state to a binary stream
+  bool writeBinary(std::ostream& stream);
+  /// Read the state from a binary stream
+  bool readBinary(std::istream& stream);
+
   // Addition-assignment
   LinRegBevPeb& operator+=(const std::pair<TVectorD,TVectorD>& rhs);
   LinRegBevPeb& operator+=(const LinRegBevPeb& rhs);
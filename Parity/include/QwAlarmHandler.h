@@ -7,9 +7,15 @@
 
 #pragma once
 
+// System headers
+#include <thread>
+
 // Parent Class
 #include "VQwDataHandler.h"
 
+// Qweak headers
+#include "QwBlockingQueue.h"
+
 /**
  * \class QwAlarmHandler
  * \ingroup QwAnalysis
@@ -18,6 +24,14 @@
  * Connects to configured variables and checks them against user-defined alarm
  * thresholds or patterns. Can periodically write a CSV status file for online
  * monitoring and provides simple state tracking to avoid flapping.
+ *
+ * The alarm definitions of the map file are compiled into numeric limits,
+ * an error code mask and an enumerated status when the map is loaded, so
+ * CheckAlarms does no string handling.  UpdateAlarmFile copies the values
+ * and states into one of two snapshots, which is written to the CSV file
+ * by a writer thread (unless alarm-async-write is 0).  At the end of the
+ * run the writer thread is stopped and the final state is written
+ * directly.
  */
 class QwAlarmHandler:public VQwDataHandler, public MQwDataHandlerCloneable<QwAlarmHandler>
 {
@@ -32,7 +46,7 @@ class QwAlarmHandler:public VQwDataHandler, public MQwDataHandlerCloneable<QwAla
     /// \brief Copy constructor
     QwAlarmHandler(const QwAlarmHandler &source);
     /// Virtual destructor
-    ~QwAlarmHandler() override {};
+    ~QwAlarmHandler() override;
 
     /// \brief Load the channels and sensitivities
     Int_t LoadChannelMap(const std::string& mapfile) override;
@@ -64,6 +78,8 @@ class QwAlarmHandler:public VQwDataHandler, public MQwDataHandlerCloneable<QwAla
     * if enabled by configuration.
     */
     void ProcessData() override;
+    /// \brief Stop the writer thread and write the final alarm state
+    void FinishDataHandler() override;
     void CheckAlarms();
     void UpdateAlarmFile();
     void ParseConfigFile(QwParameterFile&) override;
@@ -79,8 +95,17 @@ class QwAlarmHandler:public VQwDataHandler, public MQwDataHandlerCloneable<QwAla
     UInt_t fCounter = 0;
     int fAlarmNupdate = 350;
     int fAlarmActive = 0; // Default to not actually doing the alarm loop unless specified by the user
+    int fAlarmAsyncWrite = 1; // Write the alarm file on a separate thread
     std::pair<std::string,std::string> ParseAlarmMapVariable(const string&, char);
 
+    /// Alarm states, in order of precedence of the violations
+    enum EQwAlarmStatus {
+      kAlarmOK = 0, kAlarmErrorCode, kAlarmNotExactly,
+      kAlarmHighHigh, kAlarmHigh, kAlarmLowLow, kAlarmLow
+    };
+    /// Name of an alarm state in the alarm file
+    static const char* GetAlarmStatusName(EQwAlarmStatus status);
+
     // List of parameters to use in the alarm handler
     // Cameron's Alarm Stuff
     struct alarmObject {
@@ -92,9 +117,17 @@ class QwAlarmHandler:public VQwDataHandler, public MQwDataHandlerCloneable<QwAla
       // List of resultant objects for data handler to update
       const VQwHardwareChannel* value;
       const UInt_t* eventcutErrorFlag;
-      std::string alarmStatus;
+      EQwAlarmStatus alarmStatus;
+      EQwAlarmStatus lastViolation; // Most recent violation of this alarm
       int Nviolated; // Vector of 0's for history tracking
       int NsinceLastViolation; // Vector of 0's for history tracking
+      // Compiled from the parameter maps
+      bool hasErrorCode, hasExactly, hasHighHigh, hasHigh, hasLowLow, hasLow;
+      UInt_t errorCodeMask;
+      double exactly, highHigh, high, lowLow, low;
+      double ringLength, tolerance;
+      std::string outputPrefix;     // "Kind,Chan,Analysis," or empty if incomplete
+      std::string outputParameters; // Constant lines of the alarm file
       /*
       std::string type;
       std::string channel;
@@ -111,6 +144,27 @@ class QwAlarmHandler:public VQwDataHandler, public MQwDataHandlerCloneable<QwAla
 
     std::vector<alarmObject> fAlarmObjectList; // Vector pointer of objects
 
+    /// \brief Compile the parameter maps of an alarm
+    void CompileAlarm(alarmObject& alarm);
+
+    /// Values and states of all alarms at one update of the alarm file
+    struct alarmSnapshot {
+      std::vector<double> value;
+      std::vector<EQwAlarmStatus> status;
+    };
+    /// \brief Copy the current values and states into a snapshot
+    void FillAlarmSnapshot(alarmSnapshot& snapshot) const;
+    /// \brief Write a snapshot to the alarm file
+    void WriteAlarmFile(const alarmSnapshot& snapshot) const;
+    void AlarmWriterLoop();
+    void StopAlarmWriter();
+    alarmSnapshot fAlarmSnapshot[2];              // Snapshots circulating between the queues
+    QwBlockingQueue<alarmSnapshot> fAlarmFree;    // Snapshots that can be filled
+    QwBlockingQueue<alarmSnapshot> fAlarmReady;   // Snapshots for the writer thread
+    std::thread fAlarmWriterThread;
+    bool fAlarmWriterRunning = false;
+    UInt_t fAlarmSkipped = 0;                     // Updates skipped while the writer was busy
+
 }; // class QwAlarmHandler
 
 inline std::ostream& operator<< (std::ostream& stream, const QwAlarmHandler::EQwHandleType& i) {
@@ -147,6 +147,7 @@ public:
 
   // This class specific operators
   QwBCM& operator=  (const QwBCM &value);
+  void Snapshot(QwSnapshot& snapshot) override;
   QwBCM& operator+= (const QwBCM &value);
   QwBCM& operator-= (const QwBCM &value);
   void Ratio(const VQwBCM &numer, const VQwBCM &denom) override;
@@ -122,6 +122,7 @@ class QwBPMCavity : public VQwBPM {
   VQwBPM& operator-= (const VQwBPM &value) override;
 
   virtual QwBPMCavity& operator=  (const QwBPMCavity &value);
+  void Snapshot(QwSnapshot& snapshot) override;
   virtual QwBPMCavity& operator+= (const QwBPMCavity &value);
   virtual QwBPMCavity& operator-= (const QwBPMCavity &value);
 
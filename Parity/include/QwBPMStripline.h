@@ -149,6 +149,7 @@ class QwBPMStripline : public VQwBPM {
   VQwBPM& operator-= (const VQwBPM &value) override;
 
   virtual QwBPMStripline& operator=  (const QwBPMStripline &value);
+  void Snapshot(QwSnapshot& snapshot) override;
   virtual QwBPMStripline& operator+= (const QwBPMStripline &value);
   virtual QwBPMStripline& operator-= (const QwBPMStripline &value);
 
@@ -49,7 +49,8 @@ class QwBeamLine : public VQwSubsystemParity, public MQwSubsystemCloneable<QwBea
  public:
   /// Constructor with name
   QwBeamLine(const TString& name)
-  : VQwSubsystem(name),VQwSubsystemParity(name)
+  : VQwSubsystem(name),VQwSubsystemParity(name),
+    fDecodePlanBuilt(kFALSE)
   { };
   /// Copy constructor
   QwBeamLine(const QwBeamLine& source)
@@ -59,7 +60,8 @@ class QwBeamLine : public VQwSubsystemParity, public MQwSubsystemCloneable<QwBea
     fCavity(source.fCavity),
     fHaloMonitor(source.fHaloMonitor),
     fECalculator(source.fECalculator),
-    fBeamDetectorID(source.fBeamDetectorID)
+    fBeamDetectorID(source.fBeamDetectorID),
+    fDecodePlanBuilt(kFALSE)
   { this->CopyTemplatedDataElements(&source); }
   /// Virtual destructor
   ~QwBeamLine() override { };
@@ -109,6 +111,7 @@ class QwBeamLine : public VQwSubsystemParity, public MQwSubsystemCloneable<QwBea
   void   EncodeEventData(std::vector<UInt_t> &buffer) override;
 
   VQwSubsystem&  operator=  (VQwSubsystem *value) override;
+  Bool_t Snapshot(QwSnapshot& snapshot) override;
   VQwSubsystem&  operator+= (VQwSubsystem *value) override;
   VQwSubsystem&  operator-= (VQwSubsystem *value) override;
   void   Ratio(VQwSubsystem *numer, VQwSubsystem *denom) override;
@@ -203,6 +206,21 @@ protected:
   std::vector <QwEnergyCalculator> fECalculator;
   std::vector <QwBeamDetectorID> fBeamDetectorID;
 
+  /// One device read from a subbank
+  struct QwDecodeStep {
+    VQwDataElement* fElement;       ///< Device to pass the data to
+    Int_t           fWordInSubbank; ///< Offset of the device data in the subbank
+    UInt_t          fSubelement;    ///< Subelement of the device
+  };
+  /// \brief Build the list of devices in each subbank from fBeamDetectorID
+  void BuildDecodePlan();
+  /// Devices in each subbank, in buffer order (pointers into this object,
+  /// so never copied; rebuilt on first use in a copy)
+  std::vector< std::vector<QwDecodeStep> > fDecodePlan;
+  /// The decode plan was built for the devices of this object (the plan
+  /// itself may be empty, if no device is read from the buffer)
+  Bool_t fDecodePlanBuilt;
+
   
 
 /////
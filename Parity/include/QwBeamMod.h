@@ -165,6 +165,7 @@ class QwBeamMod: public VQwSubsystemParity, public MQwSubsystemCloneable<QwBeamM
   void  ProcessEvent_2() override;
 
   VQwSubsystem&  operator=  (VQwSubsystem *value) override;
+  Bool_t Snapshot(QwSnapshot& snapshot) override;
   VQwSubsystem&  operator+= (VQwSubsystem *value) override;
   VQwSubsystem&  operator-= (VQwSubsystem *value) override;
 
@@ -95,6 +95,8 @@ class QwBlinder {
     void Update(QwParityDB* db);
     /// \brief Update the status with new external information
     void Update(const QwSubsystemArrayParity& detectors);
+    /// \brief Update the status with the beam current on target
+    void Update(const VQwHardwareChannel* q_targ);
     /// \brief Update the status with new external information
     void Update(const QwEPICSEvent& epics);
 
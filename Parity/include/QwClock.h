@@ -124,6 +124,7 @@ class QwClock : public VQwClock {
 
   // This class specific operators
   QwClock& operator=  (const QwClock &value);
+  void Snapshot(QwSnapshot& snapshot) override;
   QwClock& operator+= (const QwClock &value);
   QwClock& operator-= (const QwClock &value);
   void Ratio(const VQwClock &numer, const VQwClock &denom) override;
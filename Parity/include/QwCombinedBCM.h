@@ -8,9 +8,6 @@
 // System headers
 #include <vector>
 
-// Boost math library for random number generation
-#include "boost/random.hpp"
-
 // ROOT headers
 #include <TTree.h>
 
@@ -117,6 +114,7 @@ class QwCombinedBCM : public QwBCM<T> {
   Double_t fSumQweights;
 
   Double_t fLastTripTime;
+  Long64_t fLastTripEvent;      ///< Event counter of the last trip draw
   Double_t fTripPeriod;
   Double_t fTripLength;
   Double_t fTripRamp;
@@ -125,14 +123,14 @@ class QwCombinedBCM : public QwBCM<T> {
  protected:
   /// \name Parity mock data generation
   // @{
-  /// Internal randomness generator
-  static boost::mt19937 fRandomnessGenerator;
-  /// Internal normal probability distribution
-  static boost::random::uniform_real_distribution<double> fDistribution;
-  /// Internal normal random variable
-  static boost::variate_generator
-    < boost::mt19937, boost::random::uniform_real_distribution<double> > fRandomVariable;
+  /// Seed of the beam trip draws
+  static UInt_t fTripSeed;
+  /// Time between events, to convert event times into event counters
+  static Double_t fTripWindowPeriod;
+  /// \brief Uniform random value of the beam trip draw for an event
+  static Double_t GetTripRandomValue(Long64_t event);
 public: 
   static void SetTripSeed(uint seedval);
+  static void SetTripWindowPeriod(Double_t period);
   // @}
 };
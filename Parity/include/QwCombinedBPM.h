@@ -138,6 +138,7 @@ class QwCombinedBPM : public VQwBPM {
   VQwBPM& operator-= (const VQwBPM &value) override;
 
   virtual QwCombinedBPM& operator=  (const QwCombinedBPM &value);
+  void Snapshot(QwSnapshot& snapshot) override;
   virtual QwCombinedBPM& operator+= (const QwCombinedBPM &value);
   virtual QwCombinedBPM& operator-= (const QwCombinedBPM &value);
 
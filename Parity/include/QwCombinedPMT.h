@@ -107,13 +107,14 @@ class QwCombinedPMT : public VQwDataElement {
   void PrintValue() const override;
 
   QwCombinedPMT& operator=  (const QwCombinedPMT &value);
+  void Snapshot(QwSnapshot& snapshot) override;
   QwCombinedPMT& operator+= (const QwCombinedPMT &value);
   QwCombinedPMT& operator-= (const QwCombinedPMT &value);
   void Sum(const QwCombinedPMT &value1, const QwCombinedPMT &value2);
   void Difference(const QwCombinedPMT &value1, const QwCombinedPMT &value2);
   void Ratio(QwCombinedPMT &numer, QwCombinedPMT &denom);
   void Scale(Double_t factor);
-  void Normalize(VQwDataElement* denom);
+  void Normalize(const VQwDataElement* denom);
   void AccumulateRunningSum(const QwCombinedPMT& value, Int_t count=0, Int_t ErrorMask=0xFFFFFFF);
   void DeaccumulateRunningSum(QwCombinedPMT& value, Int_t ErrorMask=0xFFFFFFF);
   void CalculateRunningAverage();
@@ -55,6 +55,7 @@ class QwCombinerSubsystem: public VQwSubsystemParity,
 
       /// \brief Overloaded Operators
       VQwSubsystem& operator=  (VQwSubsystem *value) override;
+      Bool_t Snapshot(QwSnapshot& snapshot) override;
       VQwSubsystem& operator+= (VQwSubsystem *value) override;
       VQwSubsystem& operator-= (VQwSubsystem *value) override;
       VQwSubsystem& operator*= (VQwSubsystem *value);
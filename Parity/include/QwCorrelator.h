@@ -100,6 +100,8 @@ class QwCorrelator : public VQwDataHandler, public MQwDataHandlerCloneable<QwCor
   void CloseAlphaFile();
 
   TTree* fTree;
+  QwRootFile* fTreeFile;
+  std::string fTreeFullName;
 
   std::string fAliasOutputFileBase;
   std::string fAliasOutputFileSuff;
@@ -113,6 +113,7 @@ class QwEnergyCalculator : public VQwDataElement{
     void    Scale(Double_t factor);
 
     QwEnergyCalculator& operator=  (const QwEnergyCalculator &value);
+    void Snapshot(QwSnapshot& snapshot) override;
     QwEnergyCalculator& operator+= (const QwEnergyCalculator &value);
     QwEnergyCalculator& operator-= (const QwEnergyCalculator &value);
     void Sum(const QwEnergyCalculator &value1, const QwEnergyCalculator &value2);
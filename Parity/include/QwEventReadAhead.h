@@ -0,0 +1,145 @@
+/*!
+ * \file   QwEventReadAhead.h
+ * \brief  Reading and processing of CODA events ahead of the output stages
+ */
+
+#pragma once
+
+// System headers
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Qweak headers
+#include "QwOptions.h"
+#include "QwLog.h"
+#include "QwSnapshot.h"
+#include "QwBlockingQueue.h"
+#include "QwEventBuffer.h"
+#include "QwSubsystemArrayParity.h"
+
+// Forward declarations
+class QwEPICSEvent;
+class QwThreadPool;
+
+/**
+ * \class QwEventReadAhead
+ * \ingroup QwAnalysis
+ * \brief Event source for the main loop that reads and processes ahead
+ *
+ * Without read-ahead enabled, this class is a thin wrapper around the
+ * event buffer: each physics event is filled into the detectors, processed,
+ * and checked against the single event cuts on the calling thread.
+ *
+ * With read-ahead enabled, a reader thread copies the raw CODA events
+ * from the event buffer, and a single processing thread fills, processes
+ * and cuts them in order on the detectors array, optionally distributing
+ * the subsystems of one event over a thread pool.  Events that pass the
+ * cuts are copied into one of a fixed number of slots, which are handed in
+ * order to the calling thread for the ring, helicity pattern and output
+ * stages.  This overlaps reading and processing with the output, but the
+ * processing of all events still runs on one thread: several subsystems
+ * carry state from one event to the next (helicity prediction, ADC
+ * sequence and stuck-sum checks, differential scaler counts), so
+ * independent replicas of the detectors array would not reproduce the
+ * serial results.  (This is different from codafile-readahead, which only
+ * reads the raw events of a file ahead.)
+ *
+ * With readahead.snapshots, the slots hold flat snapshots of the event
+ * data (see QwSnapshot) instead of full copies of the detectors array,
+ * which are restored on the calling thread.
+ *
+ * The log output of the reader and processing threads is captured per
+ * slot and written out by the calling thread when it reaches that slot,
+ * so that all messages appear in event order.
+ *
+ * Configuration events are consumed internally; GetNextEvent only returns
+ * EPICS and physics events.
+ */
+class QwEventReadAhead {
+
+ private:
+  QwEventReadAhead();
+
+ public:
+  QwEventReadAhead(QwOptions &options, QwEventBuffer &eventbuffer,
+                   QwSubsystemArrayParity &detectors);
+  virtual ~QwEventReadAhead();
+
+  /// \brief Define options
+  static void DefineOptions(QwOptions &options);
+  /// \brief Process options
+  void ProcessOptions(QwOptions &options);
+
+  /// \brief Advance to the next EPICS or physics event
+  Int_t GetNextEvent();
+
+  /// \brief Is the current event an EPICS event?
+  Bool_t IsEPICSEvent();
+  /// \brief Is the current event a physics event?
+  Bool_t IsPhysicsEvent();
+
+  /// \brief Fill the EPICS event from the current event
+  Bool_t FillEPICSData(QwEPICSEvent &epics);
+  /// \brief Process the current physics event and return the cut decision
+  Bool_t ProcessEvent();
+  /// \brief Processed subsystem array for the current physics event
+  QwSubsystemArrayParity& GetEvent();
+
+  /// Are reading and processing running on separate threads?
+  Bool_t IsEnabled() const { return fEnabled; };
+
+ private:
+
+  /// Event types that are passed through the read-ahead
+  enum EQwReadAheadEventType {
+    kConfigurationEvent,
+    kEPICSEvent,
+    kPhysicsEvent
+  };
+
+  /// One event in flight between the threads
+  struct Slot {
+    QwEventBuffer::RawEvent fRawEvent;
+    EQwReadAheadEventType fType;
+    Bool_t fPassedCuts;
+    std::unique_ptr<QwSubsystemArrayParity> fEvent;  ///< Copy of the processed event
+    std::vector<char> fSnapshot;                     ///< Or its snapshot
+    QwLogCapture fLog;  ///< Messages of the reader and processing threads
+  };
+
+  void Start();
+  void Stop();
+  void ReaderLoop();
+  void ProcessorLoop();
+
+  QwEventBuffer& fEventBuffer;
+  QwSubsystemArrayParity& fDetectors;
+
+  Bool_t fEnabled;         ///< Run reading and processing on own threads
+  Int_t fNumberOfThreads;  ///< Additional threads for subsystem processing
+  Int_t fDepth;            ///< Number of events in flight
+  Bool_t fUseSnapshots;    ///< Pass events as snapshots
+
+  Bool_t fRunning;
+  Int_t fReaderStatus;     ///< Stream status that ended the reader thread
+  QwLogCapture fReaderLog; ///< Messages of the reader after the last event
+
+  std::vector<Slot> fSlots;
+  Slot* fCurrent;          ///< Slot returned by the last GetNextEvent
+  QwBlockingQueue<Slot> fFreeSlots;
+  QwBlockingQueue<Slot> fReadSlots;
+  QwBlockingQueue<Slot> fProcessedSlots;
+
+  std::size_t fSnapshotSize;    ///< Size of one event snapshot in bytes
+  QwSnapshot fProcessorSnapshot;
+  QwSnapshot fOutputSnapshot;
+  std::unique_ptr<QwSubsystemArrayParity> fOutputEvent;  ///< Restored snapshot
+
+  std::unique_ptr<VEventDecoder> fProcessorDecoder; ///< Used by processor thread
+  std::unique_ptr<VEventDecoder> fOutputDecoder;    ///< Used by calling thread
+  std::unique_ptr<QwThreadPool> fThreadPool;
+
+  std::thread fReaderThread;
+  std::thread fProcessorThread;
+};
@@ -49,6 +49,8 @@ class QwEventRing {
   void push(QwSubsystemArrayParity &event);
   /// \brief Return the last subsystem in the ring
   QwSubsystemArrayParity& pop();
+  /// \brief Remove the last subsystem from the ring into an existing array
+  void pop(QwSubsystemArrayParity &event);
 
   /// \brief Print value of rolling average
   void PrintRollingAverage() {
@@ -64,6 +66,9 @@ class QwEventRing {
   /// \brief Return the number of events in the ring
   Int_t GetNumberOfEvents() const { return fNumberOfEvents; }
 
+  /// \brief Are the events stored as snapshots of their event data?
+  Bool_t UsesSnapshots() const { return fUseSnapshots; }
+
   /// \brief Unwind the ring until empty
   void Unwind() {
     while (GetNumberOfEvents() > 0) pop();
@@ -89,6 +94,33 @@ class QwEventRing {
   Bool_t bRING_READY; //set to true after ring is filled with good events and time to process them. Set to kFALSE after processing 
   //all the events in the ring
   std::vector<QwSubsystemArrayParity> fEvent_Ring;
+
+  //  Events stored as flat snapshots of their event data instead of
+  //  full subsystem arrays (see ring.snapshots)
+  Bool_t fUseSnapshots;
+  std::size_t fSnapshotSize;      ///< Size of one event snapshot in bytes
+  std::vector<char> fSnapshots;   ///< Snapshots of all events in the ring
+  QwSnapshot fSnapshot;
+  QwSubsystemArrayParity fSnapshotEvent;  ///< Event restored from a snapshot
+  /// The event passed to push, while its ring entry is unchanged
+  QwSubsystemArrayParity* fPushedEvent;
+  Int_t fPushedIndex;
+
+  /// \brief Advance the read position and return the position to read
+  Int_t NextToBeRead();
+  /// \brief Event at a ring position, for reading
+  QwSubsystemArrayParity& GetEvent(Int_t index);
+  /// \brief Restore the event at a ring position into an array
+  void RestoreEvent(Int_t index, QwSubsystemArrayParity& event);
+  /// \brief Store an event (possibly returned by GetEvent) at a ring position
+  void StoreEvent(Int_t index, QwSubsystemArrayParity& event);
+  /// \brief Global error flag of the event at a ring position
+  UInt_t GetEventcutErrorFlag(Int_t index);
+  /// \brief Add to the global error flag of the event at a ring position
+  void UpdateErrorFlag(Int_t index, UInt_t errorflag);
+  /// \brief Update the error flags of the event at a ring position from another array
+  void UpdateErrorFlag(Int_t index, const QwSubsystemArrayParity& ev_error);
+
   //to track all the rolling averages for stability checks
   QwSubsystemArrayParity fRollingAvg;
   
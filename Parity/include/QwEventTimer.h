@@ -0,0 +1,99 @@
+/*!
+ * \file   QwEventTimer.h
+ * \brief  Per-stage timing of the event loop for throughput benchmarks
+ */
+
+#pragma once
+
+// System headers
+#include <chrono>
+#include <string>
+#include <vector>
+
+// ROOT headers
+#include "Rtypes.h"
+
+// Qweak headers
+#include "QwOptions.h"
+
+/**
+ * \class QwEventTimer
+ * \ingroup QwAnalysis
+ * \brief Accumulates the time spent in each stage of the event loop
+ *
+ * The event loop calls Lap at the end of each stage, which charges the
+ * time since the previous lap to that stage.  The kRead lap marks the
+ * start of a new event; the time between the starts of two consecutive
+ * events is recorded as the latency of the first one.  Each lap costs a
+ * single clock read, and nothing is done when no report was requested.
+ * With the event read-ahead enabled, the read and process stages measure
+ * the time spent waiting for the read-ahead threads.
+ *
+ * At the end of the analysis the report is written as JSON with the
+ * event rate, the median and 99th percentile latency, the peak resident
+ * set size and the time per stage.  The qwbenchmark target runs the
+ * analysis over mock data and collects these reports.
+ */
+class QwEventTimer {
+
+ public:
+  /// Stages of the event loop
+  enum EQwEventStage {
+    kRead,       ///< Waiting for the next event from the stream or read-ahead
+    kEPICS,      ///< EPICS events and the slow tree
+    kProcess,    ///< Filling, processing and cutting the physics event
+    kRing,       ///< Event ring
+    kEvent,      ///< Running sums, histograms, trees and data handlers per event
+    kPattern,    ///< Helicity pairs, patterns and bursts
+    kNumStages
+  };
+
+  QwEventTimer(QwOptions &options);
+  virtual ~QwEventTimer() { };
+
+  /// \brief Define options
+  static void DefineOptions(QwOptions &options);
+  /// \brief Process options
+  void ProcessOptions(QwOptions &options);
+
+  /// Is a report requested?
+  Bool_t IsEnabled() const { return ! fReportFile.empty(); };
+
+  /// \brief Start timing the event loop of a run
+  void Start();
+  /// \brief Charge the time since the previous lap to a stage
+  void Lap(EQwEventStage stage) {
+    if (! IsEnabled()) return;
+    Clock::time_point now = Clock::now();
+    fStageTime[stage] += now - fLast;
+    if (stage == kRead) {
+      if (fEventStarted) fLatency.push_back(Seconds(fLast - fEventStart).count());
+      fEventStart = fLast;
+      fEventStarted = kTRUE;
+      fEvents++;
+    }
+    fLast = now;
+  };
+  /// \brief Stop timing at the end of the event loop of a run
+  void Stop();
+
+  /// \brief Write the report, if requested
+  void WriteReport() const;
+
+ private:
+  typedef std::chrono::steady_clock Clock;
+  typedef std::chrono::duration<Double_t> Seconds;
+
+  static const char* const kStageNames[kNumStages];
+
+  std::string fReportFile;
+
+  Clock::time_point fCreated;
+  Clock::time_point fLast;
+  Clock::time_point fEventStart;
+  Bool_t fEventStarted;
+
+  Long64_t fEvents;
+  Clock::duration fStageTime[kNumStages];
+  std::vector<Float_t> fLatency;  ///< Seconds per event
+};
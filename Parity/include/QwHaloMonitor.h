@@ -77,6 +77,7 @@ class  QwHaloMonitor : public VQwDataElement{
   void  ProcessEvent();
 
   QwHaloMonitor& operator=  (const QwHaloMonitor &value);
+  void Snapshot(QwSnapshot& snapshot) override;
   QwHaloMonitor& operator+= (const QwHaloMonitor &value);
   QwHaloMonitor& operator-= (const QwHaloMonitor &value);
   void Sum(QwHaloMonitor &value1, QwHaloMonitor &value2);
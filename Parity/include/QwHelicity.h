@@ -126,6 +126,7 @@ class QwHelicity: public VQwSubsystemParity, public MQwSubsystemCloneable<QwHeli
   void SetEventPatternPhase(Int_t event, Int_t pattern, Int_t phase);
 
   VQwSubsystem&  operator=  (VQwSubsystem *value) override;
+  Bool_t Snapshot(QwSnapshot& snapshot) override;
   VQwSubsystem&  operator+=  (VQwSubsystem *value) override;
 
   //the following functions do nothing really : adding and subtracting helicity doesn't mean anything
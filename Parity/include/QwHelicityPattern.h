@@ -156,6 +156,12 @@ class QwHelicityPattern {
   void UpdateBlinder(const QwEPICSEvent& epics) {
     fBlinder.Update(epics);
   };
+  /// Update the blinder status with the beam current in a yield array
+  void UpdateBlinder(const QwSubsystemArrayParity& yield,
+                     QwPublishedChannel<VQwHardwareChannel>& q_targ) {
+    if (! q_targ.IsConnected()) yield.ConnectExternalValue(q_targ);
+    fBlinder.Update(q_targ.Get());
+  };
 
   // wish these could be const references, but ConstructBranchAndVector messes with object
   QwSubsystemArrayParity& GetYield()      { return fYield; };
@@ -272,6 +278,16 @@ class QwHelicityPattern {
   QwSubsystemArrayParity fAlternateDiff;
   QwSubsystemArrayParity fPositiveHelicitySum;
   QwSubsystemArrayParity fNegativeHelicitySum;
+  /// Beam current on target in the pattern and pair yields, for the blinder
+  QwPublishedChannel<VQwHardwareChannel> fYieldCharge;
+  QwPublishedChannel<VQwHardwareChannel> fPairYieldCharge;
+
+  /// Helicity subsystem of the array last passed to LoadEventData
+  const QwSubsystemArrayParity* fHelicityArray;
+  QwHelicity* fHelicitySubsystem;
+
+  /// Events of the current pattern ordered by helicity, positive first
+  std::vector<QwSubsystemArrayParity*> fPatternPhases;
 
   Long_t fLastWindowNumber;
   Long_t fLastPatternNumber;
@@ -79,6 +79,8 @@ class QwIntegrationPMT : public VQwDataElement{
     if (fTriumf_ADC.GetElementName() == name) return &fTriumf_ADC;
     else return 0;
   };
+  /// ADC channel of this PMT, e.g. to attach it to a QwMollerADC_Storage
+  QwMollerADC_Channel* GetADCChannel() { return &fTriumf_ADC; };
 
 
 
@@ -146,13 +148,23 @@ void RandomizeMollerEvent(int helicity, const QwBeamCharge& charge, const QwBeam
 
 
   QwIntegrationPMT& operator=  (const QwIntegrationPMT &value);
+  void Snapshot(QwSnapshot& snapshot) override;
   QwIntegrationPMT& operator+= (const QwIntegrationPMT &value);
   QwIntegrationPMT& operator-= (const QwIntegrationPMT &value);
   void Sum(const QwIntegrationPMT &value1, const QwIntegrationPMT &value2);
   void Difference(const QwIntegrationPMT &value1, const QwIntegrationPMT &value2);
+
+  /// Number of values per event used by the helicity pattern kernel
+  static const size_t kPatternValues = QwMollerADC_Channel::kPatternValues;
+  /// \brief Copy the values combined by the helicity pattern kernel
+  void GetPatternValues(Double_t* values) const { fTriumf_ADC.GetPatternValues(values); };
+  /// \brief Set this PMT to the yield or difference of a helicity pattern
+  void SetPatternSum(const QwIntegrationPMT* const* phases, size_t nplus, size_t nphases,
+                     Bool_t difference, const Double_t* values);
+
   void Ratio(QwIntegrationPMT &numer, QwIntegrationPMT &denom);
   void Scale(Double_t factor);
-  void Normalize(VQwDataElement* denom);
+  void Normalize(const VQwDataElement* denom);
   void AccumulateRunningSum(const QwIntegrationPMT& value, Int_t count=0, Int_t ErrorMask=0xFFFFFFF);
   void DeaccumulateRunningSum(QwIntegrationPMT& value, Int_t ErrorMask=0xFFFFFFF);
   void CalculateRunningAverage();
@@ -120,6 +120,7 @@ class QwLinearDiodeArray : public VQwBPM {
   VQwBPM& operator-= (const VQwBPM &value) override;
 
   virtual QwLinearDiodeArray& operator=  (const QwLinearDiodeArray &value);
+  void Snapshot(QwSnapshot& snapshot) override;
   virtual QwLinearDiodeArray& operator+= (const QwLinearDiodeArray &value);
   virtual QwLinearDiodeArray& operator-= (const QwLinearDiodeArray &value);
 
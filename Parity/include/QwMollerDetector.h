@@ -100,6 +100,8 @@ class QwMollerDetector:
     Int_t ProcessConfigurationBuffer(UInt_t ev_type, const ROCID_t roc_id, const BankID_t bank_id, UInt_t* buffer, UInt_t num_words);
     Int_t ProcessEvBuffer(const ROCID_t roc_id, const BankID_t bank_id, UInt_t *buffer, UInt_t num_words) override;
     Int_t ProcessEvBuffer(UInt_t ev_type, const ROCID_t roc_id, const BankID_t bank_id, UInt_t* buffer, UInt_t num_words) override;
+    /// The subbank index is not checked in ProcessEvBuffer, so all banks are read
+    Bool_t ReadsAllBanks() const override { return kTRUE; };
     void  ClearEventData() override;
     void  ProcessEvent() override;
 
@@ -108,6 +110,7 @@ class QwMollerDetector:
     void  FillHistograms() override;
 
     VQwSubsystem& operator=  (VQwSubsystem *value) override;
+    Bool_t Snapshot(QwSnapshot& snapshot) override;
     VQwSubsystem& operator+= (VQwSubsystem *value) override;
     VQwSubsystem& operator-= (VQwSubsystem *value) override;
     void  Ratio(VQwSubsystem  *value1, VQwSubsystem  *value2) override;
@@ -18,6 +18,8 @@
 
 // Qweak headers
 #include "QwEventRing.h"
+#include "QwEventReadAhead.h"
+#include "QwEventTimer.h"
 #include "QwHelicity.h"
 #include "QwHelicityPattern.h"
 #include "QwDetectorArray.h"
@@ -37,6 +39,8 @@ void DefineOptionsParity(QwOptions& options)
   VQwDetectorArray::DefineOptions(options);
   //QwBlindDetectorArray::DefineOptions(options);
   QwEventRing::DefineOptions(options);
+  QwEventReadAhead::DefineOptions(options);
+  QwEventTimer::DefineOptions(options);
   QwHelicity::DefineOptions(options);
   QwHelicityPattern::DefineOptions(options);
   QwDataHandlerArray::DefineOptions(options);
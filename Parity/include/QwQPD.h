@@ -120,6 +120,7 @@ class QwQPD : public VQwBPM {
   VQwBPM& operator-= (const VQwBPM &value) override;
 
   virtual QwQPD& operator=  (const QwQPD &value);
+  void Snapshot(QwSnapshot& snapshot) override;
   virtual QwQPD& operator+= (const QwQPD &value);
   virtual QwQPD& operator-= (const QwQPD &value);
 
@@ -88,6 +88,7 @@ class QwScaler: public VQwSubsystemParity, public MQwSubsystemCloneable<QwScaler
     Bool_t Compare(VQwSubsystem *source);
 
     VQwSubsystem& operator=(VQwSubsystem *value) override;
+    Bool_t Snapshot(QwSnapshot& snapshot) override;
     VQwSubsystem& operator+=(VQwSubsystem *value) override;
     VQwSubsystem& operator-=(VQwSubsystem *value) override;
     void Ratio(VQwSubsystem *value1, VQwSubsystem  *value2) override;
@@ -74,6 +74,8 @@ class QwSubsystemArrayParity: public QwSubsystemArray {
 
     /// \brief Assignment operator
     QwSubsystemArrayParity& operator=  (const QwSubsystemArrayParity &value);
+    /// \brief Transfer the event data to or from a snapshot
+    Bool_t Snapshot(QwSnapshot& snapshot);
     /// \brief Addition-assignment operator
     QwSubsystemArrayParity& operator+= (const QwSubsystemArrayParity &value);
     /// \brief Subtraction-assignment operator
@@ -82,6 +84,10 @@ class QwSubsystemArrayParity: public QwSubsystemArray {
     void Sum(const QwSubsystemArrayParity &value1, const QwSubsystemArrayParity &value2);
     /// \brief Difference of two subsystem arrays
     void Difference(const QwSubsystemArrayParity &value1, const QwSubsystemArrayParity &value2);
+    /// \brief Yield and difference of the phases of a helicity pattern
+    void CalculatePatternSums(const std::vector<QwSubsystemArrayParity*>& phases, size_t nplus,
+                              QwSubsystemArrayParity& difference,
+                              QwSubsystemArrayParity& positive, QwSubsystemArrayParity& negative);
     /// \brief Ratio of two subsystem arrays
     void Ratio(const QwSubsystemArrayParity &numer, const QwSubsystemArrayParity &denom);
     /// \brief Scale this subsystem array
@@ -115,6 +115,9 @@ class VQwBPM : public VQwDataElement {
   }
   void SetGains(TString pos, Double_t value);
 
+  /// Transfer the event-based data of the base class to or from a snapshot
+  void Snapshot(QwSnapshot& snapshot) override;
+
   // Operators subclasses MUST support!
   virtual VQwBPM& operator=  (const VQwBPM &value) =0;
   virtual VQwBPM& operator+= (const VQwBPM &value) =0;
@@ -166,6 +166,13 @@ class VQwDataHandler:  virtual public VQwDataHandlerCloneable, public MQwPublish
                        std::vector< const VQwHardwareChannel* > &ivs,
                        std::vector< Double_t > &sens);
 
+   /// \brief Prepare CalcOutputs for the same independent variables for all outputs
+   void PrepareCorrections(const std::vector< const VQwHardwareChannel* > &ivs);
+   /// \brief Prepare CalcOutputs for separate independent variables per output
+   void PrepareCorrections(const std::vector< std::vector< const VQwHardwareChannel* > > &ivs);
+   /// \brief Calculate all outputs, with the same results as CalcOneOutput
+   void CalcOutputs(const std::vector< std::vector< Double_t > > &sens);
+
  protected:
    //
    Int_t fPriority; ///  When a datahandler array is processed, handlers with lower priority will be processed before handlers with higher priority
@@ -204,6 +211,20 @@ class VQwDataHandler:  virtual public VQwDataHandlerCloneable, public MQwPublish
 
    std::string ParseSeparator;  // Used as space between tokens in ParseHandledVariable
 
+ private:
+   /// Independent variables of CalcOutputs, each only once
+   std::vector< const VQwHardwareChannel* > fCorrectionVar;
+   /// Index in fCorrectionVar of each independent variable of each output
+   std::vector< std::vector< size_t > > fCorrectionIndex;
+   /// Is the independent variable a Moller ADC channel?
+   std::vector< Bool_t > fCorrectionVarFused;
+   /// Can the output be calculated from the gathered values?
+   std::vector< Bool_t > fCorrectionFused;
+   /// Gathered values, error flags and numbers of samples of the independent variables
+   std::vector< Double_t > fCorrectionValues;
+   std::vector< UInt_t > fCorrectionErrorFlags;
+   std::vector< UInt_t > fCorrectionSamples;
+
  protected:
    Bool_t fKeepRunningSum;
    Bool_t fRunningsumFillsTree;
@@ -27,6 +27,7 @@
 #include "VQwSubsystemParity.h"
 #include "QwIntegrationPMT.h"
 #include "QwCombinedPMT.h"
+#include "QwMollerADC_Storage.h"
 
 
 class QwDetectorArrayID {
@@ -93,14 +94,10 @@ class VQwDetectorArray: virtual public VQwSubsystemParity {
 
     /// Constructor with name
     VQwDetectorArray(const TString& name) 
-     :VQwSubsystem(name),VQwSubsystemParity(name),bNormalization(kFALSE) {
-
-        fTargetCharge.InitializeChannel("q_targ","derived");
-        fTargetX.InitializeChannel("x_targ","derived");
-        fTargetY.InitializeChannel("y_targ","derived");
-        fTargetXprime.InitializeChannel("xp_targ","derived");
-        fTargetYprime.InitializeChannel("yp_targ","derived");
-        fTargetEnergy.InitializeChannel("e_targ","derived");
+     :VQwSubsystem(name),VQwSubsystemParity(name),
+     fTargetCharge("q_targ"),fTargetX("x_targ"),fTargetY("y_targ"),
+     fTargetXprime("xp_targ"),fTargetYprime("yp_targ"),fTargetEnergy("e_targ"),
+     bNormalization(kFALSE),bChannelStorage(kFALSE) {
 
     };
     
@@ -110,7 +107,11 @@ class VQwDetectorArray: virtual public VQwSubsystemParity {
      :VQwSubsystem(source),VQwSubsystemParity(source),
      fIntegrationPMT(source.fIntegrationPMT),
      fCombinedPMT(source.fCombinedPMT),
-     fMainDetID(source.fMainDetID){}
+     fMainDetID(source.fMainDetID),
+     fTargetCharge(source.fTargetCharge),fTargetX(source.fTargetX),fTargetY(source.fTargetY),
+     fTargetXprime(source.fTargetXprime),fTargetYprime(source.fTargetYprime),
+     fTargetEnergy(source.fTargetEnergy),
+     bChannelStorage(source.bChannelStorage){}
 
     /// Virtual destructor
 
@@ -192,13 +193,16 @@ class VQwDetectorArray: virtual public VQwSubsystemParity {
 
 
     VQwSubsystem&  operator=  ( VQwSubsystem *value) override;
+    Bool_t Snapshot(QwSnapshot& snapshot) override;
+    Bool_t CalculatePatternSums(const std::vector<VQwSubsystem*>& phases,
+                                size_t nplus, VQwSubsystem* difference) override;
     VQwSubsystem&  operator+= ( VQwSubsystem *value) override;
     VQwSubsystem&  operator-= ( VQwSubsystem *value) override;
 
 
     void Ratio(VQwSubsystem* numer, VQwSubsystem* denom) override;
     void Scale(Double_t factor) override;
-    void Normalize(VQwDataElement* denom);
+    void Normalize(const VQwDataElement* denom);
 
     void AccumulateRunningSum(VQwSubsystem* value, Int_t count=0, Int_t ErrorMask=0xFFFFFFF) override;
     //remove one entry from the running sums for devices
@@ -262,21 +266,41 @@ class VQwDetectorArray: virtual public VQwSubsystemParity {
 
  protected:
 
-    QwBeamCharge   fTargetCharge;
-    QwBeamPosition fTargetX;
-    QwBeamPosition fTargetY;
-    QwBeamAngle    fTargetXprime;
-    QwBeamAngle    fTargetYprime;
-    QwBeamEnergy   fTargetEnergy;
+    /// Beam parameters on target published by other subsystems, connected
+    /// on first use (copies of this subsystem are not connected)
+    QwPublishedChannel<QwBeamCharge>   fTargetCharge;
+    QwPublishedChannel<QwBeamPosition> fTargetX;
+    QwPublishedChannel<QwBeamPosition> fTargetY;
+    QwPublishedChannel<QwBeamAngle>    fTargetXprime;
+    QwPublishedChannel<QwBeamAngle>    fTargetYprime;
+    QwPublishedChannel<QwBeamEnergy>   fTargetEnergy;
 
     Bool_t bIsExchangedDataValid;
 
     Bool_t bNormalization;
     Double_t fNormThreshold;
 
+    /// Keep the ADC data of all integration PMTs in one contiguous block
+    Bool_t bChannelStorage;
+    /// Contiguous ADC data of the integration PMTs (attached on first use)
+    QwMollerADC_Storage fADCStorage;
+
  private:
 
   static const Bool_t bDEBUG=kFALSE;
+
+  /// PMTs and word offsets of the ADC data in the current subbank
+  std::vector<size_t> fDecodePMT;
+  std::vector<UInt_t> fDecodeOffsets;
+  /// Unpacked ADC data of the PMTs in the current subbank
+  std::vector<QwADCDecoder::MollerADCWords> fDecodeWords;
+
+  /// Phases of the current helicity pattern and their flat PMT values
+  std::vector<VQwDetectorArray*> fPatternPhases;
+  std::vector<const QwIntegrationPMT*> fPatternPMT;
+  std::vector<const Double_t*> fPatternValuePtr;
+  std::vector<Double_t> fPatternValues;
+
   Int_t fMainDetErrorCount;
 
 };
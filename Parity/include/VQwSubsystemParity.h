@@ -13,6 +13,7 @@
 // Qweak headers
 #include "VQwSubsystem.h"
 #include "QwParameterFile.h"
+#include "QwSnapshot.h"
 
 // Forward declarations
 class QwBlinder;
@@ -84,6 +85,16 @@ class VQwSubsystemParity: virtual public VQwSubsystem {
     /// \brief Calculate the average for all good events
     virtual void CalculateRunningAverage() = 0;
 
+    /// \brief Transfer the event data (as copied by operator=) to or from a
+    ///        snapshot; returns kFALSE if the subsystem has no snapshot support
+    virtual Bool_t Snapshot(QwSnapshot& /*snapshot*/) { return kFALSE; };
+
+    /// \brief Set this subsystem to the yield, and another to the difference,
+    ///        of the phases of a helicity pattern (positive phases first);
+    ///        returns kFALSE if the subsystem leaves this to its operators
+    virtual Bool_t CalculatePatternSums(const std::vector<VQwSubsystem*>& /*phases*/,
+                                        size_t /*nplus*/, VQwSubsystem* /*difference*/) { return kFALSE; };
+
     /// \brief Load the event cuts file
     Int_t LoadEventCuts(TString filename) override{
       Int_t eventcut_flag = 1;
@@ -7,11 +7,18 @@
 *//*-------------------------------------------------------------------------*/
 
 // C and C++ headers
+#include <algorithm>
 #include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
 
 // Boost math library for random number generation
 #include <boost/random.hpp>
 
+// ROOT headers
+#include "TROOT.h"
+
 // Qweak headers
 #include "QwLog.h"
 #include "QwBeamLine.h"
@@ -23,6 +30,10 @@
 //#include "QwScanner.h"
 #include "QwSubsystemArrayParity.h"
 #include "QwDetectorArray.h"
+#include "QwCombinedBCM.h"
+#include "QwVQWK_Channel.h"
+#include "QwMollerADC_Channel.h"
+#include "QwThreadPool.h"
 
 
 // Number of variables to correlate
@@ -45,10 +56,168 @@ inline std::string stringify(int i) {
   return stream.str();
 }
 
+/**
+ * Subsystems and encoded events of one generation thread
+ *
+ * Every thread generates whole blocks of events with its own copy of the
+ * subsystems.  The random streams are reseeded at the start of every block
+ * from the run and block number only, so the generated events do not depend
+ * on the number of threads.
+ */
+struct QwMockDataContext {
+  QwMockDataContext(QwOptions& options): detectors(options) {
+    detectors.ProcessOptions(options);
+
+    // Get the helicity
+    helicity = dynamic_cast<QwHelicity*>(detectors.GetSubsystemByName("Helicity Info"));
+    if (! helicity) QwWarning << "No helicity subsystem defined!" << QwLog::endl;
+
+    // Get the beamline channels we want to correlate
+    detectors.LoadMockDataParameters("mock_parameters_list.map");
+
+    // new vectors for GetSubsystemByType
+    std::vector <VQwSubsystem*> tempvector = detectors.GetSubsystemByType("QwDetectorArray");
+    for (std::size_t i = 0; i < tempvector.size(); i++)
+      detchannels.push_back(dynamic_cast<QwDetectorArray*>(tempvector[i]));
+
+    detectors.GetROCIDList(roclist);
+  }
+
+  QwSubsystemArrayParity detectors;
+  QwHelicity* helicity;
+  std::vector <QwDetectorArray*> detchannels;
+  std::vector<ROCID_t> roclist;
+
+  /// Encoded events of the current block
+  std::vector< std::vector<UInt_t> > events;
+};
+
+// Generate and encode the events [first, last] of a block
+void GenerateBlock(QwMockDataContext& context, UInt_t run, Long64_t block,
+    Int_t first, Int_t last)
+{
+  QwSubsystemArrayParity& detectors = context.detectors;
+  QwHelicity* helicity = context.helicity;
+
+  // Independent random streams for every block of every run
+  std::seed_seq mockable_seed{run, UInt_t(block), UInt_t(block >> 32), 0u};
+  MQwMockable::SetRandomSeed(mockable_seed);
+
+  // Initialize randomness provider and distribution
+  std::seed_seq correlation_seed{run, UInt_t(block), UInt_t(block >> 32), 1u};
+  boost::mt19937 randomnessGenerator(correlation_seed); // Mersenne twister with seed (see above)
+  boost::normal_distribution<double> normalDistribution;
+  boost::variate_generator
+    < boost::mt19937, boost::normal_distribution<double> >
+      normal(randomnessGenerator, normalDistribution);
+  // WARNING: This variate_generator would return the SAME random values as the
+  // variate_generator in MQwMockable when used with the same seed!
+  // Therefore the seed sequences differ in their last element.
+
+  context.events.resize(last - first + 1);
+  for (Int_t event = first; event <= last; event++) {
+
+    // First clear the event
+    detectors.ClearEventData();
+
+    // Set the event, pattern and phase number
+    // - event number increments for every event
+    // - pattern number increments for every multiplet
+    // - phase number gives position in multiplet
+    helicity->SetEventPatternPhase(event, event / kMultiplet, event % kMultiplet + 1);
+
+    // Run the helicity predictor
+    helicity->RunPredictor();
+    // Concise helicity printout
+    if (kDebug) {
+      // - actual helicity
+      if      (helicity->GetHelicityActual() == 0) std::cout << "-";
+      else if (helicity->GetHelicityActual() == 1) std::cout << "+";
+      else std::cout << "?";
+      // - delayed helicity
+      if      (helicity->GetHelicityDelayed() == 0) std::cout << "(-) ";
+      else if (helicity->GetHelicityDelayed() == 1) std::cout << "(+) ";
+      else std::cout << "(?) ";
+      if (event % kMultiplet + 1 == 4) {
+        std::cout << std::hex << helicity->GetRandomSeedActual()  << std::dec << ",  \t";
+        std::cout << std::hex << helicity->GetRandomSeedDelayed() << std::dec << std::endl;
+      }
+    }
+
+    // Calculate the time assuming one ms for every helicity window
+    double time = event * detectors.GetWindowPeriod();
+
+    // Fill the detectors with randomized data
+    
+    int myhelicity = helicity->GetHelicityActual() ? +1 : -1;
+    //std::cout << myhelicity << std::endl;
+
+    // Secondly introduce correlations between variables
+    //
+    // N-dimensional correlated normal random variables:
+    //   X = C' * Z
+    // with
+    //   X correlated and normally distributed,
+    //   Z independent and normally distributed,
+    //   C the Cholesky decomposition of the positive-definite covariance matrix
+    //     (C should probably be calculated offline)
+    //
+    /* Sigma =
+         1.00000   0.50000   0.50000
+         0.50000   2.00000   0.30000
+         0.50000   0.30000   1.50000
+
+       C =
+         1.00000   0.50000   0.50000
+         0.00000   1.32288   0.03780
+         0.00000   0.00000   1.11739
+
+       Sigma = C' * C
+     */
+    double z[NVARS], x[NVARS];
+    double C[NVARS][NVARS];
+    for (int var = 0; var < NVARS; var++) {
+      x[var] = 0.0;
+      z[var] = normal();
+      C[var][var] = 1.0;
+    }
+    C[0][0] = 1.0; C[0][1] = 0.5;     C[0][2] = 0.5;
+    C[1][0] = 0.0; C[1][1] = 1.32288; C[1][2] = 0.03780;
+    C[2][0] = 0.0; C[2][1] = 0.0;     C[2][2] = 1.11739;
+    for (int i = 0; i < NVARS; i++)
+      for (int j = 0; j < NVARS; j++)
+        x[i] += C[j][i] * z[j];
+
+    // Assign to data elements
+    //maindetector->GetChannel("MD2Neg")->SetExternalRandomVariable(x[0]);
+    //lumidetector->GetChannel("dlumi1")->SetExternalRandomVariable(x[1]);
+    //beamline->GetBCM("qwk_bcm0l07")->SetExternalRandomVariable(x[2]);
+
+
+    // Randomize data for this event
+    detectors.RandomizeEventData(myhelicity, time);
+//      detectors.ProcessEvent();
+//      beamline-> ProcessEvent(); //Do we need to keep this line now?  Check the maindetector correlation with beamline devices with and without it.
+    
+    for (std::size_t i = 0; i < context.detchannels.size(); i++){
+      context.detchannels[i]->ExchangeProcessedData();
+      context.detchannels[i]->RandomizeMollerEvent(myhelicity);
+    }
+
+    // Encode this event
+    std::vector<UInt_t>& buffer = context.events[event - first];
+    buffer.clear();
+    detectors.EncodeEventData(buffer);
+
+  } // end of event loop
+}
+
 int main(int argc, char* argv[])
 {
   // Define the command line options
   DefineOptionsParity(gQwOptions);
+  gQwOptions.AddOptions()("mock-threads", po::value<int>()->default_value(1), "Number of threads generating mock events");
+  gQwOptions.AddOptions()("mock-block-size", po::value<int>()->default_value(1000), "Number of events in each independently seeded block");
 
   ///  Without anything, print usage
   if (argc == 1) {
@@ -73,13 +242,15 @@ int main(int argc, char* argv[])
   QwEventBuffer eventbuffer;
   eventbuffer.ProcessOptions(gQwOptions);
 
-  // Detector array
-  QwSubsystemArrayParity detectors(gQwOptions);
-  detectors.ProcessOptions(gQwOptions);
-
-  // Get the helicity
-  QwHelicity* helicity = dynamic_cast<QwHelicity*>(detectors.GetSubsystemByName("Helicity Info"));
-  if (! helicity) QwWarning << "No helicity subsystem defined!" << QwLog::endl;
+  // Generation threads, each with its own detector array
+  int nthreads = std::max(gQwOptions.GetValue<int>("mock-threads"), 1);
+  Int_t blocksize = std::max(gQwOptions.GetValue<int>("mock-block-size"), 1);
+  if (nthreads > 1) ROOT::EnableThreadSafety();
+  std::vector< std::unique_ptr<QwMockDataContext> > contexts;
+  for (int i = 0; i < nthreads; i++)
+    contexts.push_back(std::make_unique<QwMockDataContext>(gQwOptions));
+  QwThreadPool pool(nthreads - 1);
+  QwSubsystemArrayParity& detectors = contexts.front()->detectors;
 
   // Possible scenarios:
   // - everything is random, no correlations at all, no asymmetries at all
@@ -92,26 +263,12 @@ int main(int argc, char* argv[])
   // - two parameters have correlated helicity-correlated asymmetries
   // - beam modulation
 
-  // Get the beamline channels we want to correlate
-  detectors.LoadMockDataParameters("mock_parameters_list.map");
-
 //-----------------------------------------------------------------------------------------------
   // Get the main detector channels we want to correlate
 //  QwDetectorArray* maindetector = 
 //    dynamic_cast<QwDetectorArray*>(detectors.GetSubsystemByName("Main Detector"));
 //  if (! maindetector) QwWarning << "No main detector subsystem defined!" << QwLog::endl;
 
-  // new vectors for GetSubsystemByType
-  std::vector <QwDetectorArray*> detchannels;
-  std::vector <VQwSubsystem*> tempvector = detectors.GetSubsystemByType("QwDetectorArray");
-  //  detectors.GetSubsystemByType;
-
-  for (std::size_t i = 0; i < tempvector.size(); i++){
-    detchannels.push_back(dynamic_cast<QwDetectorArray*>(tempvector[i]));
-
-  //return detchannels;
-  }
-
 /*
 if(1==2){
   Double_t bar_mean = 2.0e4;
@@ -149,19 +306,6 @@ if(1==2){
 */
 
 
-  // Initialize randomness provider and distribution
-  boost::mt19937 randomnessGenerator(999); // Mersenne twister with seed (see below)
-  boost::normal_distribution<double> normalDistribution;
-  boost::variate_generator
-    < boost::mt19937, boost::normal_distribution<double> >
-      normal(randomnessGenerator, normalDistribution);
-  // WARNING: This variate_generator will return the SAME random values as the
-  // variate_generator in QwVQWK_Channel when used with the same default seed!
-  // Therefore you really should give an explicitly different seed for the
-  // mt19937 randomness generator.
-
-
-
   // Loop over all runs
   UInt_t runnumber_min = (UInt_t) gQwOptions.GetIntValuePairFirst("run");
   UInt_t runnumber_max = (UInt_t) gQwOptions.GetIntValuePairLast("run");
@@ -169,9 +313,11 @@ if(1==2){
               run <= runnumber_max;
               run++) {
 
-    // Set the random seed for this run
-    randomnessGenerator.seed(run);
+    // Set the random seed for this run (the other streams are seeded per block)
     QwCombinedBCM<QwVQWK_Channel>::SetTripSeed(0x56781234 ^ (run*run));
+    QwCombinedBCM<QwVQWK_Channel>::SetTripWindowPeriod(detectors.GetWindowPeriod());
+    QwCombinedBCM<QwMollerADC_Channel>::SetTripSeed(0x56781234 ^ (run*run));
+    QwCombinedBCM<QwMollerADC_Channel>::SetTripWindowPeriod(detectors.GetWindowPeriod());
 
     // Open new output file
     // (giving run number as argument to OpenDataFile confuses the segment search)
@@ -188,12 +334,15 @@ if(1==2){
 
 
     // Helicity initialization loop
-    helicity->SetEventPatternPhase(-1, -1, -1);
     // 24-bit seed, should be larger than 0x1, 0x55 = 0101 0101
     // Consecutive runs should have no trivially related seeds:
     // e.g. with 0x2 * run, the first two files will be just 1 MPS offset...
+    // Each thread runs its own predictor over the skipped patterns.
     unsigned int seed = 0x1234 ^ run;
-    helicity->SetFirstBits(24, seed & 0xFFFFFF);
+    for (auto& context: contexts) {
+      context->helicity->SetEventPatternPhase(-1, -1, -1);
+      context->helicity->SetFirstBits(24, seed & 0xFFFFFF);
+    }
 
 
     // Retrieve the requested range of event numbers
@@ -206,105 +355,34 @@ if(1==2){
       QwWarning << "Only " << abs(eventnumber_max - eventnumber_min)
                 << " events will be generated." << QwLog::endl;
 
-    // Event generation loop
-    for (Int_t event = eventnumber_min; event <= eventnumber_max; event++) {
-
-      // First clear the event
-      detectors.ClearEventData();
-
-      // Set the event, pattern and phase number
-      // - event number increments for every event
-      // - pattern number increments for every multiplet
-      // - phase number gives position in multiplet
-      helicity->SetEventPatternPhase(event, event / kMultiplet, event % kMultiplet + 1);
-
-      // Run the helicity predictor
-      helicity->RunPredictor();
-      // Concise helicity printout
-      if (kDebug) {
-        // - actual helicity
-        if      (helicity->GetHelicityActual() == 0) std::cout << "-";
-        else if (helicity->GetHelicityActual() == 1) std::cout << "+";
-        else std::cout << "?";
-        // - delayed helicity
-        if      (helicity->GetHelicityDelayed() == 0) std::cout << "(-) ";
-        else if (helicity->GetHelicityDelayed() == 1) std::cout << "(+) ";
-        else std::cout << "(?) ";
-        if (event % kMultiplet + 1 == 4) {
-          std::cout << std::hex << helicity->GetRandomSeedActual()  << std::dec << ",  \t";
-          std::cout << std::hex << helicity->GetRandomSeedDelayed() << std::dec << std::endl;
+    // Event generation loop, in blocks at fixed event numbers: each round
+    // generates one block per thread, after which the events are written
+    // in order
+    Long64_t block_min = eventnumber_min / blocksize;
+    Long64_t block_max = eventnumber_max / blocksize;
+    for (Long64_t round = block_min; round <= block_max; round += nthreads) {
+      std::size_t nblocks = std::min<Long64_t>(nthreads, block_max - round + 1);
+      pool.ForEach(nblocks, [&](std::size_t i) {
+        Long64_t block = round + i;
+        Int_t first = std::max<Long64_t>(eventnumber_min, block * blocksize);
+        Int_t last  = std::min<Long64_t>(eventnumber_max, (block + 1) * blocksize - 1);
+        GenerateBlock(*contexts[i], run, block, first, last);
+      });
+
+      // Write these events to file
+      for (std::size_t i = 0; i < nblocks; i++) {
+        Int_t event = std::max<Long64_t>(eventnumber_min, (round + i) * blocksize);
+        for (auto& buffer: contexts[i]->events) {
+          eventbuffer.EncodeSubsystemData(buffer, contexts[i]->roclist);
+
+          // Periodically print event number
+          if ((kDebug && event % 1000 == 0)
+                      || event % 10000 == 0)
+            std::cout << "Generated " << event << " events." << std::endl;
+          event++;
         }
       }
 
-      // Calculate the time assuming one ms for every helicity window
-      double time = event * detectors.GetWindowPeriod();
-
-      // Fill the detectors with randomized data
-      
-      int myhelicity = helicity->GetHelicityActual() ? +1 : -1;
-      //std::cout << myhelicity << std::endl;
-
-      // Secondly introduce correlations between variables
-      //
-      // N-dimensional correlated normal random variables:
-      //   X = C' * Z
-      // with
-      //   X correlated and normally distributed,
-      //   Z independent and normally distributed,
-      //   C the Cholesky decomposition of the positive-definite covariance matrix
-      //     (C should probably be calculated offline)
-      //
-      /* Sigma =
-           1.00000   0.50000   0.50000
-           0.50000   2.00000   0.30000
-           0.50000   0.30000   1.50000
-
-         C =
-           1.00000   0.50000   0.50000
-           0.00000   1.32288   0.03780
-           0.00000   0.00000   1.11739
-
-         Sigma = C' * C
-       */
-      double z[NVARS], x[NVARS];
-      double C[NVARS][NVARS];
-      for (int var = 0; var < NVARS; var++) {
-        x[var] = 0.0;
-        z[var] = normal();
-        C[var][var] = 1.0;
-      }
-      C[0][0] = 1.0; C[0][1] = 0.5;     C[0][2] = 0.5;
-      C[1][0] = 0.0; C[1][1] = 1.32288; C[1][2] = 0.03780;
-      C[2][0] = 0.0; C[2][1] = 0.0;     C[2][2] = 1.11739;
-      for (int i = 0; i < NVARS; i++)
-        for (int j = 0; j < NVARS; j++)
-          x[i] += C[j][i] * z[j];
-
-      // Assign to data elements
-      //maindetector->GetChannel("MD2Neg")->SetExternalRandomVariable(x[0]);
-      //lumidetector->GetChannel("dlumi1")->SetExternalRandomVariable(x[1]);
-      //beamline->GetBCM("qwk_bcm0l07")->SetExternalRandomVariable(x[2]);
-
-
-      // Randomize data for this event
-      detectors.RandomizeEventData(myhelicity, time);
-//      detectors.ProcessEvent();
-//      beamline-> ProcessEvent(); //Do we need to keep this line now?  Check the maindetector correlation with beamline devices with and without it.
-      
-     for (std::size_t i = 0; i < detchannels.size(); i++){
-      detchannels[i]->ExchangeProcessedData();
-      detchannels[i]->RandomizeMollerEvent(myhelicity);
-      }
-
-      // Write this event to file
-      eventbuffer.EncodeSubsystemData(detectors);
-
-      // Periodically print event number
-      if ((kDebug && event % 1000 == 0)
-                  || event % 10000 == 0)
-        std::cout << "Generated " << event << " events." << std::endl;
-
-
     } // end of event loop
 
 
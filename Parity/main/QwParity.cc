@@ -27,6 +27,8 @@
 #include "QwRootFile.h"
 #include "QwOptionsParity.h"
 #include "QwEventBuffer.h"
+#include "QwEventReadAhead.h"
+#include "QwEventTimer.h"
 #ifdef __USE_DATABASE__
 #include "QwParityDB.h"
 #endif //__USE_DATABASE__
@@ -106,6 +108,9 @@ Int_t main(Int_t argc, Char_t* argv[])
   QwParityDB database(gQwOptions);
   #endif //__USE_DATABASE__
 
+  ///  Create the event loop timer for benchmark reports
+  QwEventTimer timer(gQwOptions);
+
   //  QwPromptSummary promptsummary;
 
   ///  Start loop over all runs
@@ -285,14 +290,12 @@ Int_t main(Int_t argc, Char_t* argv[])
     //  the blinder, but only for disk files, not online.
     if (! eventbuffer.IsOnline() ){
       QwMessage << "Finding first EPICS event" << QwLog::endl;
-      while (eventbuffer.GetNextEvent() == CODA_OK) {
-	if (eventbuffer.IsEPICSEvent()) {
-	  eventbuffer.FillEPICSData(epicsevent);
-	  if (epicsevent.HasDataLoaded()) {
-	    helicitypattern.UpdateBlinder(epicsevent);
-	    // and break out of this event loop
-	    break;
-	  }
+      while (eventbuffer.GetNextEPICSEvent() == CODA_OK) {
+	eventbuffer.FillEPICSData(epicsevent);
+	if (epicsevent.HasDataLoaded()) {
+	  helicitypattern.UpdateBlinder(epicsevent);
+	  // and break out of this event loop
+	  break;
 	}
       }
       epicsevent.ResetCounters();
@@ -301,6 +304,9 @@ Int_t main(Int_t argc, Char_t* argv[])
       eventbuffer.ReOpenStream();
     }
 
+    ///  Create the event read-ahead (after the EPICS prescan rewound the stream)
+    QwEventReadAhead readahead(gQwOptions, eventbuffer, detectors);
+
     // Start event loop instrumentation
 #ifdef CALLGRIND_START_INSTRUMENTATION
     if (gQwOptions.GetValue<bool>("callgrind-instr-start-event-loop")) {
@@ -310,19 +316,16 @@ Int_t main(Int_t argc, Char_t* argv[])
 #endif
 
     ///  Start loop over events
-    while (eventbuffer.GetNextEvent() == CODA_OK) {
-
-      //  First, do processing of non-physics events...
-      if (eventbuffer.IsROCConfigurationEvent()) {
-        //  Send ROC configuration event data to the subsystem objects.
-        eventbuffer.FillSubsystemConfigurationData(detectors);
-      }
+    ///  (ROC configuration events are passed to the detectors by the read-ahead)
+    timer.Start();
+    while (readahead.GetNextEvent() == CODA_OK) {
+      timer.Lap(QwEventTimer::kRead);
 
-      //  Secondly, process EPICS events, but not for online running,
+      //  First, process EPICS events, but not for online running,
       //  because the EPICS events get messed up by our 32-bit to 64-bit
       //  double ET system.
-      if (! eventbuffer.IsOnline() && eventbuffer.IsEPICSEvent()) {
-        eventbuffer.FillEPICSData(epicsevent);
+      if (! eventbuffer.IsOnline() && readahead.IsEPICSEvent()) {
+        readahead.FillEPICSData(epicsevent);
 	if (epicsevent.HasDataLoaded()){
 	  epicsevent.CalculateRunningValues();
 	  helicitypattern.UpdateBlinder(epicsevent);
@@ -336,30 +339,29 @@ Int_t main(Int_t argc, Char_t* argv[])
 	  treerootfile->FillNTuple("slow");
 #endif
 	}
+        timer.Lap(QwEventTimer::kEPICS);
       }
 
 
       //  Now, if this is not a physics event, go back and get a new event.
-      if (! eventbuffer.IsPhysicsEvent()) continue;
-
-
-      //  Fill the subsystem objects with their respective data for this event.
-      eventbuffer.FillSubsystemData(detectors);
+      if (! readahead.IsPhysicsEvent()) continue;
 
-      //  Process the subsystem data
-      detectors.ProcessEvent();
 
-
-      // The event pass the event cut constraints
-      if (detectors.ApplySingleEventCuts()) {
+      //  Fill, process and apply the event cuts to the subsystem data;
+      //  the event pass the event cut constraints
+      Bool_t passed = readahead.ProcessEvent();
+      timer.Lap(QwEventTimer::kProcess);
+      if (passed) {
 	
         // Add event to the ring
-        eventring.push(detectors);
+        eventring.push(readahead.GetEvent());
+        timer.Lap(QwEventTimer::kRing);
 
         // Check to see ring is ready
         if (eventring.IsReady()) {
-	  ringoutput = eventring.pop();
+	  eventring.pop(ringoutput);
 	  ringoutput.IncrementErrorCounters();
+	  timer.Lap(QwEventTimer::kRing);
 
 
 	  // Accumulate the running sum to calculate the event based running average
@@ -391,6 +393,7 @@ Int_t main(Int_t argc, Char_t* argv[])
 #ifdef HAS_RNTUPLE_SUPPORT
           datahandlerarray_evt.FillNTupleFields(treerootfile);
 #endif
+          timer.Lap(QwEventTimer::kEvent);
 
           // Load the event into the helicity pattern
           helicitypattern.LoadEventData(ringoutput);
@@ -508,12 +511,14 @@ Int_t main(Int_t argc, Char_t* argv[])
               helicitypattern.ClearEventData();
 
 	  } // helicitypattern.IsGoodAsymmetry()
+          timer.Lap(QwEventTimer::kPattern);
 
         } // eventring.IsReady()
 
       } // detectors.ApplySingleEventCuts()
 
     } // end of loop over events
+    timer.Stop();
     
     // Unwind event ring
     QwMessage << "Unwinding event ring" << QwLog::endl;
@@ -723,6 +728,9 @@ Int_t main(Int_t argc, Char_t* argv[])
     eventbuffer.PrintRunTimes();
   } // end of loop over runs
 
+  //  Write the benchmark report over all runs
+  timer.WriteReport();
+
   QwMessage << "I have done everything I can do..." << QwLog::endl;
 
   return 0;
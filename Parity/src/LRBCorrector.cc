@@ -217,6 +217,10 @@ Int_t LRBCorrector::ConnectChannels(
 
   QwMessage << "In LRBCorrector::ConnectChannels; Number of IVs: " << fIndependentVar.size()
             << " Number of DVs: " << fDependentVar.size() << QwLog::endl;
+
+  // Gather the independent variables once for all dependent variables
+  PrepareCorrections(fIndependentVar);
+
   return 0;
 }
 
@@ -224,7 +228,5 @@ Int_t LRBCorrector::ConnectChannels(
 void LRBCorrector::ProcessData() {
   Short_t cycle = fBurstCounter+1;
   if (fSensitivity.count(cycle) == 0) return;
-  for (size_t i = 0; i < fDependentVar.size(); ++i) {
-    CalcOneOutput(fDependentVar[i], fOutputVar[i], fIndependentVar, fSensitivity[cycle][i]);
-  }
+  CalcOutputs(fSensitivity[cycle]);
 }
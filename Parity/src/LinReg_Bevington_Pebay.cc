@@ -8,6 +8,11 @@
 #include <assert.h>
 #include <math.h>
 
+#include <algorithm>
+#include <ios>
+#include <istream>
+#include <ostream>
+
 #include "TString.h"
 
 #include "LinReg_Bevington_Pebay.h"
@@ -19,7 +24,8 @@
 LinRegBevPeb::LinRegBevPeb()
 : nP(0),nY(0),
   fErrorFlag(-1),
-  fGoodEventNumber(0)
+  fGoodEventNumber(0),
+  fBlockEvents(0)
 { }
 
 //=================================================
@@ -27,7 +33,8 @@ LinRegBevPeb::LinRegBevPeb()
 LinRegBevPeb::LinRegBevPeb(const LinRegBevPeb& source)
 : nP(source.nP),nY(source.nY),
   fErrorFlag(-1),
-  fGoodEventNumber(0)
+  fGoodEventNumber(0),
+  fBlockEvents(0)
 {
   QwMessage << fGoodEventNumber << QwLog::endl;
 }
@@ -70,6 +77,11 @@ void LinRegBevPeb::init()
   mRYY.ResizeTo(mVYY);
   mRYYp.ResizeTo(mVYYp);
 
+  fBlock.assign(kBlockEvents * (nP + nY), 0.0);
+  fBlockMean.assign(nP + nY, 0.0);
+  fBlockCoMoments.assign((nP + nY) * (nP + nY), 0.0);
+  fBlockEvents = 0;
+
   fGoodEventNumber = 0;
 }
 
@@ -111,6 +123,7 @@ void LinRegBevPeb::clear()
 
   fErrorFlag = -1;
   fGoodEventNumber = 0;
+  fBlockEvents = 0;
 }
 
 //=================================================
@@ -132,6 +145,9 @@ void LinRegBevPeb::print()
 //==========================================================
 LinRegBevPeb& LinRegBevPeb::operator+=(const std::pair<TVectorD,TVectorD>& rhs)
 {
+  // Keep the pending events before this one
+  flush();
+
   // Get independent and dependent components
   const TVectorD& P = rhs.first;
   const TVectorD& Y = rhs.second;
@@ -170,41 +186,267 @@ LinRegBevPeb& LinRegBevPeb::operator+=(const std::pair<TVectorD,TVectorD>& rhs)
 //==========================================================
 //==========================================================
 LinRegBevPeb& LinRegBevPeb::operator+=(const LinRegBevPeb& rhs)
+{
+  merge(rhs);
+  return *this;
+}
+
+
+//==========================================================
+//==========================================================
+void LinRegBevPeb::merge(const LinRegBevPeb& rhs)
 {
   // If set X = A + B, then
   //   Cov[X] = Cov[A] + Cov[B]
-  //          + (E[x_A] - E[x_B]) * (E[y_A] - E[y_B]) * n_A * n_B / n_X
-  // Ref: E. Schubert, M. Gertz (9 July 2018).
-  // "Numerically stable parallel computation of (co-)variance".
-  // SSDBM '18 Proceedings of the 30th International Conference
-  // on Scientific and Statistical Database Management.
-  // https://doi.org/10.1145/3221269.3223036
-
-  if(fGoodEventNumber + rhs.fGoodEventNumber == 0)
-    return *this;
-
-  // Deviations from mean
-  TVectorD delta_y(mMY - rhs.mMY);
-  TVectorD delta_p(mMP - rhs.mMP);
-
-  // Update covariances
-  Double_t alpha = fGoodEventNumber * rhs.fGoodEventNumber
-                / (fGoodEventNumber + rhs.fGoodEventNumber);
-  mVYY += rhs.mVYY;
-  mVYY.Rank1Update(delta_y, alpha);
-  mVPY += rhs.mVPY;
-  mVPY.Rank1Update(delta_p, delta_y, alpha);
-  mVPP += rhs.mVPP;
-  mVPP.Rank1Update(delta_p, alpha);
+  //          + (E[x_B] - E[x_A]) * (E[y_B] - E[y_A]) * n_A * n_B / n_X
+  //   E[x_X] = E[x_A] + (E[x_B] - E[x_A]) * n_B / n_X
+  // Ref: T. F. Chan, G. H. Golub, R. J. LeVeque (1979), "Updating formulae
+  // and a pairwise algorithm for computing sample variances", and
+  // P. Pebay, SAND2008-6212.
 
-  // Update means
-  Double_t beta = rhs.fGoodEventNumber / (fGoodEventNumber + rhs.fGoodEventNumber);
-  mMY += delta_y * beta;
-  mMP += delta_p * beta;
+  flush();
 
-  fGoodEventNumber += rhs.fGoodEventNumber;
+  if (rhs.fGoodEventNumber + rhs.fBlockEvents == 0)
+    return;
 
-  return *this;
+  // An empty object takes the dimensions of the other one
+  if (fGoodEventNumber == 0 && (nP != rhs.nP || nY != rhs.nY || mMP.GetNrows() != nP)) {
+    setDims(rhs.nP, rhs.nY);
+    init();
+  }
+  if (nP != rhs.nP || nY != rhs.nY) {
+    QwError << "LRB: cannot merge nP=" << rhs.nP << " nY=" << rhs.nY
+            << " into nP=" << nP << " nY=" << nY << QwLog::endl;
+    return;
+  }
+
+  if (fGoodEventNumber == 0) {
+    mMP = rhs.mMP;
+    mMY = rhs.mMY;
+    mVPP = rhs.mVPP;
+    mVPY = rhs.mVPY;
+    mVYY = rhs.mVYY;
+    fGoodEventNumber = rhs.fGoodEventNumber;
+  } else if (rhs.fGoodEventNumber > 0) {
+    const Double_t nA = fGoodEventNumber;
+    const Double_t nB = rhs.fGoodEventNumber;
+
+    // Deviations from mean
+    TVectorD delta_y(rhs.mMY - mMY);
+    TVectorD delta_p(rhs.mMP - mMP);
+
+    // Update covariances
+    Double_t alpha = nA * nB / (nA + nB);
+    mVYY += rhs.mVYY;
+    mVYY.Rank1Update(delta_y, alpha);
+    mVPY += rhs.mVPY;
+    mVPY.Rank1Update(delta_p, delta_y, alpha);
+    mVPP += rhs.mVPP;
+    mVPP.Rank1Update(delta_p, alpha);
+
+    // Update means
+    Double_t beta = nB / (nA + nB);
+    mMY += delta_y * beta;
+    mMP += delta_p * beta;
+
+    fGoodEventNumber += rhs.fGoodEventNumber;
+  }
+
+  // Pending events of the other object
+  accumulateBlock(rhs.fBlock.data(), rhs.fBlockEvents);
+}
+
+
+//==========================================================
+//==========================================================
+/**
+ * Write the event count, means and unnormalized covariances to a binary
+ * stream.  Only the upper triangles of the symmetric covariances are
+ * written.  Values are written in the byte order of this machine.
+ * @param stream Output stream
+ * @return True if written successfully
+ */
+bool LinRegBevPeb::writeBinary(std::ostream& stream)
+{
+  flush();
+
+  uint32_t magic = kBinaryMagic;
+  uint32_t np = nP, ny = nY;
+  int64_t n = fGoodEventNumber;
+  stream.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
+  stream.write(reinterpret_cast<const char*>(&np), sizeof(np));
+  stream.write(reinterpret_cast<const char*>(&ny), sizeof(ny));
+  stream.write(reinterpret_cast<const char*>(&n), sizeof(n));
+  if (n > 0) {
+    stream.write(reinterpret_cast<const char*>(mMP.GetMatrixArray()), nP * sizeof(Double_t));
+    stream.write(reinterpret_cast<const char*>(mMY.GetMatrixArray()), nY * sizeof(Double_t));
+    for (int i = 0; i < nP; i++)
+      stream.write(reinterpret_cast<const char*>(mVPP.GetMatrixArray() + i * nP + i), (nP - i) * sizeof(Double_t));
+    stream.write(reinterpret_cast<const char*>(mVPY.GetMatrixArray()), nP * nY * sizeof(Double_t));
+    for (int i = 0; i < nY; i++)
+      stream.write(reinterpret_cast<const char*>(mVYY.GetMatrixArray() + i * nY + i), (nY - i) * sizeof(Double_t));
+  }
+  return stream.good();
+}
+
+
+//==========================================================
+//==========================================================
+/**
+ * Read the state written by writeBinary, replacing the current state.
+ * An object with other dimensions takes those of the stream when it holds
+ * no events.  States with no variables, more than kMaxBinaryDims of either
+ * kind, or fewer values left in a seekable stream than their dimensions
+ * imply are rejected before the object is resized.
+ * @param stream Input stream
+ * @return True if read successfully
+ */
+bool LinRegBevPeb::readBinary(std::istream& stream)
+{
+  uint32_t magic, np, ny;
+  int64_t n;
+  stream.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+  stream.read(reinterpret_cast<char*>(&np), sizeof(np));
+  stream.read(reinterpret_cast<char*>(&ny), sizeof(ny));
+  stream.read(reinterpret_cast<char*>(&n), sizeof(n));
+  if (! stream.good() || magic != kBinaryMagic || n < 0) return false;
+  // Dimensions must be sane, and the stream must hold the state they imply,
+  // before anything is allocated for them
+  if (np == 0 || ny == 0 || np > kMaxBinaryDims || ny > kMaxBinaryDims) {
+    QwError << "LinRegBevPeb: invalid dimensions " << np << " x " << ny
+            << " in binary state" << QwLog::endl;
+    return false;
+  }
+  if (n > 0) {
+    const uint64_t values = uint64_t(np) + ny + uint64_t(np) * (np + 1) / 2
+                          + uint64_t(np) * ny + uint64_t(ny) * (ny + 1) / 2;
+    const std::streampos start = stream.tellg();
+    if (start != std::streampos(-1)) {
+      stream.seekg(0, std::ios::end);
+      const std::streamoff remaining = stream.tellg() - start;
+      stream.seekg(start);
+      if (! stream.good() || remaining < 0
+          || uint64_t(remaining) < values * sizeof(Double_t)) {
+        QwError << "LinRegBevPeb: binary state of " << np << " x " << ny
+                << " variables is truncated" << QwLog::endl;
+        return false;
+      }
+    }
+  }
+  if (int(np) != nP || int(ny) != nY || mMP.GetNrows() != nP) {
+    if (fGoodEventNumber + fBlockEvents > 0) return false; // not same dimensionality
+    setDims(np, ny);
+    init();
+  }
+  clear();
+  if (n > 0) {
+    stream.read(reinterpret_cast<char*>(mMP.GetMatrixArray()), nP * sizeof(Double_t));
+    stream.read(reinterpret_cast<char*>(mMY.GetMatrixArray()), nY * sizeof(Double_t));
+    for (int i = 0; i < nP; i++)
+      stream.read(reinterpret_cast<char*>(mVPP.GetMatrixArray() + i * nP + i), (nP - i) * sizeof(Double_t));
+    stream.read(reinterpret_cast<char*>(mVPY.GetMatrixArray()), nP * nY * sizeof(Double_t));
+    for (int i = 0; i < nY; i++)
+      stream.read(reinterpret_cast<char*>(mVYY.GetMatrixArray() + i * nY + i), (nY - i) * sizeof(Double_t));
+    if (! stream.good()) {
+      clear();
+      return false;
+    }
+    // Lower triangles
+    for (int i = 0; i < nP; i++)
+      for (int j = 0; j < i; j++) mVPP(i,j) = mVPP(j,i);
+    for (int i = 0; i < nY; i++)
+      for (int j = 0; j < i; j++) mVYY(i,j) = mVYY(j,i);
+  }
+  fGoodEventNumber = n;
+  return true;
+}
+
+
+//==========================================================
+//==========================================================
+void LinRegBevPeb::flush()
+{
+  accumulateBlock(fBlock.data(), fBlockEvents);
+  fBlockEvents = 0;
+}
+
+
+//==========================================================
+//==========================================================
+void LinRegBevPeb::accumulateBlock(const Double_t* block, Int_t n)
+{
+  if (n == 0) return;
+
+  // Block layout: variable v of event e is at block[v * kBlockEvents + e],
+  // with the nP independent variables before the nY dependent ones
+  const int nV = nP + nY;
+  Double_t* mean = fBlockMean.data();
+  Double_t* C = fBlockCoMoments.data();
+
+  // Block means
+  for (int v = 0; v < nV; v++) {
+    const Double_t* x = block + v * kBlockEvents;
+    Double_t sum = 0.0;
+    for (int e = 0; e < n; e++) sum += x[e];
+    mean[v] = sum / n;
+  }
+
+  // Block co-moments (upper triangle), in tiles of variables so that the
+  // rows of both tiles stay in cache
+  const int kTile = 8;
+  Double_t di[kBlockEvents];
+  for (int it = 0; it < nV; it += kTile) {
+    const int iend = std::min(it + kTile, nV);
+    for (int jt = it; jt < nV; jt += kTile) {
+      const int jend = std::min(jt + kTile, nV);
+      for (int i = it; i < iend; i++) {
+        const Double_t* xi = block + i * kBlockEvents;
+        for (int e = 0; e < n; e++) di[e] = xi[e] - mean[i];
+        for (int j = std::max(i, jt); j < jend; j++) {
+          const Double_t* xj = block + j * kBlockEvents;
+          const Double_t mj = mean[j];
+          Double_t sum = 0.0;
+          for (int e = 0; e < n; e++) sum += di[e] * (xj[e] - mj);
+          C[i * nV + j] = sum;
+        }
+      }
+    }
+  }
+
+  // Combine with the running moments: if X = A + B, then
+  //   M2[X] = M2[A] + M2[B] + (E[x_B] - E[x_A]) * (E[y_B] - E[y_A]) * n_A * n_B / n_X
+  //   E[x_X] = E[x_A] + (E[x_B] - E[x_A]) * n_B / n_X
+  const Double_t nA = fGoodEventNumber;
+  const Double_t nX = nA + n;
+  const Double_t alpha = nA * n / nX;
+  const Double_t beta = n / nX;
+  Double_t* MP = mMP.GetMatrixArray();
+  Double_t* MY = mMY.GetMatrixArray();
+  Double_t* VPP = mVPP.GetMatrixArray();
+  Double_t* VPY = mVPY.GetMatrixArray();
+  Double_t* VYY = mVYY.GetMatrixArray();
+  // Deviations of the block means from the running means
+  for (int v = 0; v < nV; v++)
+    mean[v] -= (v < nP) ? MP[v] : MY[v - nP];
+  for (int i = 0; i < nV; i++) {
+    for (int j = i; j < nV; j++) {
+      const Double_t c = C[i * nV + j] + mean[i] * mean[j] * alpha;
+      if (j < nP) {
+        VPP[i * nP + j] += c;
+        if (i != j) VPP[j * nP + i] += c;
+      } else if (i < nP) {
+        VPY[i * nY + (j - nP)] += c;
+      } else {
+        VYY[(i - nP) * nY + (j - nP)] += c;
+        if (i != j) VYY[(j - nP) * nY + (i - nP)] += c;
+      }
+    }
+  }
+  // Update means
+  for (int i = 0; i < nP; i++) MP[i] += mean[i] * beta;
+  for (int i = 0; i < nY; i++) MY[i] += mean[nP + i] * beta;
+
+  fGoodEventNumber += n;
 }
 
 
@@ -314,6 +556,20 @@ Int_t LinRegBevPeb::getCovarianceY( int i, int j, Double_t &covar) const
     return 0;
 }
 
+//==========================================================
+//==========================================================
+Int_t LinRegBevPeb::getSlope( int ip, int iy, Double_t &slope, Double_t &error) const
+{
+    slope=-1e50;
+    error=-1e50;
+    if(ip<0 || ip >= nP ) return -11;
+    if(iy<0 || iy >= nY ) return -12;
+    if( fErrorFlag!=0) return -13;
+    slope=Axy(ip,iy);
+    error=dAxy(ip,iy);
+    return 0;
+}
+
 //==========================================================
 //==========================================================
 void LinRegBevPeb::printSummaryP() const
@@ -451,6 +707,9 @@ void LinRegBevPeb::printSummaryMeansWithUncCorrected() const
 //==========================================================
 void LinRegBevPeb::solve()
 {
+  // pending events
+  flush();
+
   // off-diagonal raw covariance
   mVYP.Transpose(mVPY);
 
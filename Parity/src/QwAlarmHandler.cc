@@ -7,6 +7,11 @@
 
 #include "QwAlarmHandler.h"
 
+// System headers
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
 // Qweak headers
 #include "VQwDataElement.h"
 #include "QwVQWK_Channel.h"
@@ -28,6 +33,11 @@ QwAlarmHandler::QwAlarmHandler(const QwAlarmHandler &source):VQwDataHandler(sour
 {
 }
 
+QwAlarmHandler::~QwAlarmHandler()
+{
+  StopAlarmWriter();
+}
+
 //  Just use the base class version for now....
 
 void QwAlarmHandler::ParseConfigFile(QwParameterFile& file)
@@ -39,6 +49,7 @@ void QwAlarmHandler::ParseConfigFile(QwParameterFile& file)
   file.PopValue("alarm-output-file",fAlarmOutputFile);
   file.PopValue("alarm-loop-N-update",fAlarmNupdate);
   file.PopValue("alarm-active",fAlarmActive);
+  file.PopValue("alarm-async-write",fAlarmAsyncWrite);
   // Check for and process key-value pairs
   //file.PopValue("new-key-word",fsomething); // These need = signs in map files
 }
@@ -136,11 +147,13 @@ Int_t QwAlarmHandler::LoadChannelMap(const std::string& mapfile)
     tmpAlarmObject.tolerance    = map.GetNextToken(" "); // This is all hardcoded.... how to do with keywords? FIXME
     */
     // Default Initializations
-    tmpAlarmObject.alarmStatus  = "OK";
+    tmpAlarmObject.alarmStatus  = kAlarmOK;
+    tmpAlarmObject.lastViolation = kAlarmOK;
     tmpAlarmObject.Nviolated    = 0;
     tmpAlarmObject.NsinceLastViolation = 1e9;
     tmpAlarmObject.value = NULL;
     tmpAlarmObject.eventcutErrorFlag = NULL;
+    CompileAlarm(tmpAlarmObject);
     fAlarmObjectList.push_back(tmpAlarmObject);
 
     /*else if (primary_token == "treetype") {
@@ -153,6 +166,54 @@ Int_t QwAlarmHandler::LoadChannelMap(const std::string& mapfile)
   return 0;
 }
 
+/** Compile the parameter maps of an alarm into the limits and the error code
+ * mask used by CheckAlarms, and the constant lines of the alarm file.
+ *
+ * @param alarm Alarm with filled parameter maps
+ */
+void QwAlarmHandler::CompileAlarm(alarmObject& alarm)
+{
+  const std::map<std::string,double>& par = alarm.alarmParameterMap;
+  const std::map<std::string,std::string>& str = alarm.alarmParameterMapStr;
+
+  // Error code mask, only used when given as hexadecimal digits
+  alarm.hasErrorCode = false;
+  alarm.errorCodeMask = 0;
+  if (str.count("Error-Code") != 0 && ((TString)str.at("Error-Code")).IsHex()) {
+    alarm.hasErrorCode = true;
+    alarm.errorCodeMask = std::stoul(str.at("Error-Code"),nullptr,16);
+  }
+
+  // Limits
+  alarm.hasExactly  = (par.count("Exactly") != 0);
+  alarm.hasHighHigh = (par.count("HighHigh") != 0);
+  alarm.hasHigh     = (par.count("High") != 0);
+  alarm.hasLowLow   = (par.count("LowLow") != 0);
+  alarm.hasLow      = (par.count("Low") != 0);
+  alarm.exactly  = alarm.hasExactly?  par.at("Exactly"):  0;
+  alarm.highHigh = alarm.hasHighHigh? par.at("HighHigh"): 0;
+  alarm.high     = alarm.hasHigh?     par.at("High"):     0;
+  alarm.lowLow   = alarm.hasLowLow?   par.at("LowLow"):   0;
+  alarm.low      = alarm.hasLow?      par.at("Low"):      0;
+  alarm.ringLength = par.at("Ring-Length");
+  alarm.tolerance  = par.at("Tolerance");
+
+  // Constant part of the alarm file
+  alarm.outputPrefix.clear();
+  alarm.outputParameters.clear();
+  if (str.count("Kind") && str.count("Chan") && str.count("Analysis")) {
+    alarm.outputPrefix = str.at("Kind") + "," + str.at("Chan") + "," + str.at("Analysis") + ",";
+    std::ostringstream lines;
+    if (str.count("Error-Code")) {
+      lines << alarm.outputPrefix << "Error-Code" << "," << str.at("Error-Code") << std::endl;
+    }
+    for (auto jte : par){ // Loop through parameter list
+      lines << alarm.outputPrefix << jte.first << "," << jte.second << std::endl;
+    }
+    alarm.outputParameters = lines.str();
+  }
+}
+
 // Connect to the dependent and independent channels (implementation). Parameters are documented in the header.
 Int_t QwAlarmHandler::ConnectChannels(
     QwSubsystemArrayParity& yield,
@@ -275,6 +336,19 @@ void QwAlarmHandler::ProcessData() {
   }
 }  // FIXME do I even need a process data method? Probably not
 
+/** At the end of the run, write the pending snapshots and stop the writer
+ * thread, then write the final alarm state directly, so that the alarm file
+ * reflects the last patterns of the run even when updates were skipped.
+ */
+void QwAlarmHandler::FinishDataHandler() {
+  VQwDataHandler::FinishDataHandler();
+  StopAlarmWriter();
+  if (fAlarmActive) {
+    FillAlarmSnapshot(fAlarmSnapshot[0]);
+    WriteAlarmFile(fAlarmSnapshot[0]);
+  }
+}
+
 /* Want to define new methods that will evaluate alarm status of config file variables (and combined variables -> correlations)
  * Per multiplet calculate the asym, diffs, and yields, and compare these results to user set defined high or low values (if defined)
  * Per multiplet check device_error_code and check eventCuts failed due to device in question and compare with tolerances defined by user
@@ -322,96 +396,149 @@ void QwAlarmHandler::ProcessData() {
 
 void QwAlarmHandler::CheckAlarms() {
   // If user-name-of-variable exists then grab it, grab its value from memory, and then compare to the upper and lower limits defined by user (if they were defined) 
-  std::string tmpAlarmStat = "OK";
-  for ( size_t numAna = 0; numAna < fAlarmObjectList.size() ; numAna++ ) {
-    if (fAlarmObjectList.at(numAna).value != NULL){
-      //QwWarning << "fAlarmObjectList.at("<<numAna<<").value == " << fAlarmObjectList.at(numAna).value  <<QwLog::endl;
-      //QwWarning << "fAlarmObjectList.at("<<numAna<<").value->GetValue() == " << fAlarmObjectList.at(numAna).value->GetValue()  <<QwLog::endl;
-      if ( fAlarmObjectList.at(numAna).alarmParameterMapStr.count("Error-Code") != 0 
-          && ((TString)fAlarmObjectList.at(numAna).alarmParameterMapStr.at("Error-Code")).IsHex() && ((std::stoul(fAlarmObjectList.at(numAna).alarmParameterMapStr.at("Error-Code"),nullptr,16)) & *fAlarmObjectList.at(numAna).eventcutErrorFlag) != 0 ) { 
-        fAlarmObjectList.at(numAna).Nviolated++;
-        fAlarmObjectList.at(numAna).NsinceLastViolation = 0;
-        tmpAlarmStat = "Error-Code";
-      }
-      else if (fAlarmObjectList.at(numAna).alarmParameterMap.count("Exactly") != 0 
-          && fAlarmObjectList.at(numAna).value->GetValue() != fAlarmObjectList.at(numAna).alarmParameterMap.at("Exactly"))  {
-        fAlarmObjectList.at(numAna).Nviolated++;
-        fAlarmObjectList.at(numAna).NsinceLastViolation = 0;
-        tmpAlarmStat = "Not-Exactly";
-      }
-      else if ( fAlarmObjectList.at(numAna).alarmParameterMap.count("HighHigh") != 0 
-          && fAlarmObjectList.at(numAna).value->GetValue() >= fAlarmObjectList.at(numAna).alarmParameterMap.at("HighHigh") ) { 
-        fAlarmObjectList.at(numAna).Nviolated++;
-        fAlarmObjectList.at(numAna).NsinceLastViolation = 0;
-        tmpAlarmStat = "HighHigh";
-      }
-      else if ( fAlarmObjectList.at(numAna).alarmParameterMap.count("High") != 0 
-          && fAlarmObjectList.at(numAna).value->GetValue() >= fAlarmObjectList.at(numAna).alarmParameterMap.at("High") ) {
-        fAlarmObjectList.at(numAna).Nviolated++;
-        fAlarmObjectList.at(numAna).NsinceLastViolation = 0;
-        tmpAlarmStat = "High";
-      }
-      else if ( fAlarmObjectList.at(numAna).alarmParameterMap.count("LowLow") != 0 
-          && fAlarmObjectList.at(numAna).value->GetValue() <= fAlarmObjectList.at(numAna).alarmParameterMap.at("LowLow") ) {
-        fAlarmObjectList.at(numAna).Nviolated++;
-        fAlarmObjectList.at(numAna).NsinceLastViolation = 0;
-        tmpAlarmStat = "LowLow";
-      }
-      else if ( fAlarmObjectList.at(numAna).alarmParameterMap.count("Low") != 0 
-          &&  fAlarmObjectList.at(numAna).value->GetValue() <= fAlarmObjectList.at(numAna).alarmParameterMap.at("Low") ) {
-        fAlarmObjectList.at(numAna).Nviolated++;
-        fAlarmObjectList.at(numAna).NsinceLastViolation = 0;
-        tmpAlarmStat = "Low";
-      }
-      else {
-        fAlarmObjectList.at(numAna).NsinceLastViolation++;
-      }
-      if ( fAlarmObjectList.at(numAna).Nviolated > 0 && fAlarmObjectList.at(numAna).NsinceLastViolation > fAlarmObjectList.at(numAna).alarmParameterMap.at("Ring-Length") ) { 
-        fAlarmObjectList.at(numAna).Nviolated--;
-      }
-      if ( fAlarmObjectList.at(numAna).Nviolated > fAlarmObjectList.at(numAna).alarmParameterMap.at("Tolerance") ) {
-        fAlarmObjectList.at(numAna).alarmStatus = tmpAlarmStat;
-      }
-      else {
-        fAlarmObjectList.at(numAna).alarmStatus = "OK";
-      }
+  for (auto& alarm: fAlarmObjectList) {
+    if (alarm.value == NULL) {
+      QwError << "Null: fAlarmObjectList.at("<<(&alarm - &fAlarmObjectList[0])<<").value == NULL" <<QwLog::endl;
+      continue;
     }
-    else {
-      QwError << "Null: fAlarmObjectList.at("<<numAna<<").value == NULL" <<QwLog::endl;
+    const double value = alarm.value->GetValue();
+    EQwAlarmStatus violation = kAlarmOK;
+    if (alarm.hasErrorCode && (alarm.errorCodeMask & *alarm.eventcutErrorFlag) != 0)
+      violation = kAlarmErrorCode;
+    else if (alarm.hasExactly && value != alarm.exactly)
+      violation = kAlarmNotExactly;
+    else if (alarm.hasHighHigh && value >= alarm.highHigh)
+      violation = kAlarmHighHigh;
+    else if (alarm.hasHigh && value >= alarm.high)
+      violation = kAlarmHigh;
+    else if (alarm.hasLowLow && value <= alarm.lowLow)
+      violation = kAlarmLowLow;
+    else if (alarm.hasLow && value <= alarm.low)
+      violation = kAlarmLow;
+
+    if (violation != kAlarmOK) {
+      alarm.Nviolated++;
+      alarm.NsinceLastViolation = 0;
+      alarm.lastViolation = violation;
+    } else {
+      alarm.NsinceLastViolation++;
+    }
+    if (alarm.Nviolated > 0 && alarm.NsinceLastViolation > alarm.ringLength) {
+      alarm.Nviolated--;
+    }
+    if (alarm.Nviolated > alarm.tolerance) {
+      alarm.alarmStatus = alarm.lastViolation;
+    } else {
+      alarm.alarmStatus = kAlarmOK;
     }
   }
 }
 
+const char* QwAlarmHandler::GetAlarmStatusName(EQwAlarmStatus status)
+{
+  switch (status) {
+  case kAlarmErrorCode:  return "Error-Code";
+  case kAlarmNotExactly: return "Not-Exactly";
+  case kAlarmHighHigh:   return "HighHigh";
+  case kAlarmHigh:       return "High";
+  case kAlarmLowLow:     return "LowLow";
+  case kAlarmLow:        return "Low";
+  default:               return "OK";
+  }
+}
+
+/** Take a snapshot of the alarm values and states, and write it to the alarm
+ * file.  With the writer thread, the file is written while the event loop
+ * continues; when the thread is still busy with both snapshots, this update
+ * is skipped (and counted) and the next one carries the newer state.
+ */
 void QwAlarmHandler::UpdateAlarmFile(){
-  std::ofstream file_out;
-  // Format of alarmObject struct contents
-  // std::map <std::string,std::string> alarmParameterMap;
-  // VQwDataHandler::EQwHandleType analysisType;
-  // const VQwHardwareChannel* value;
-  // UInt_t eventcutErrorFlag;
-  // std::string alarmStatus;
-  // int Nviolated; // Vector of 0's for history tracking
-  // int NsinceLastViolation; // Vector of 0's for history tracking
-
-  file_out.open(fAlarmOutputFile,std::ofstream::trunc);
-  for (size_t ite = 0 ; ite<fAlarmObjectList.size(); ite++){
-    if (fAlarmObjectList.at(ite).value != NULL && fAlarmObjectList.at(ite).alarmParameterMapStr.count("Kind") && fAlarmObjectList.at(ite).alarmParameterMapStr.count("Chan") && fAlarmObjectList.at(ite).alarmParameterMapStr.count("Analysis")) {
-      if (fAlarmObjectList.at(ite).value != 0) { // Check if non-trivial value object...
-        file_out<<fAlarmObjectList.at(ite).alarmParameterMapStr.at("Kind")<<","<<fAlarmObjectList.at(ite).alarmParameterMapStr.at("Chan")<<","<<fAlarmObjectList.at(ite).alarmParameterMapStr.at("Analysis")<<","<<"Value"<<","<<fAlarmObjectList.at(ite).value->GetValue()<<std::endl;
-      }
-      else continue;
-      if (fAlarmObjectList.at(ite).alarmStatus != "") { // Check if non-trivial value object...
-        file_out<<fAlarmObjectList.at(ite).alarmParameterMapStr.at("Kind")<<","<<fAlarmObjectList.at(ite).alarmParameterMapStr.at("Chan")<<","<<fAlarmObjectList.at(ite).alarmParameterMapStr.at("Analysis")<<","<<"Alarm Status"<<","<<fAlarmObjectList.at(ite).alarmStatus<<std::endl;
-      }
-      else continue;
-      if (fAlarmObjectList.at(ite).alarmParameterMapStr.count("Error-Code")) { // Check if non-trivial value object...
-        file_out<<fAlarmObjectList.at(ite).alarmParameterMapStr.at("Kind")<<","<<fAlarmObjectList.at(ite).alarmParameterMapStr.at("Chan")<<","<<fAlarmObjectList.at(ite).alarmParameterMapStr.at("Analysis")<<","<<"Error-Code"<<","<<fAlarmObjectList.at(ite).alarmParameterMapStr.at("Error-Code")<<std::endl;
-      }
+  alarmSnapshot* snapshot = &fAlarmSnapshot[0];
+  if (fAlarmAsyncWrite) {
+    if (! fAlarmWriterRunning) {
+      fAlarmFree.Reset();
+      fAlarmReady.Reset();
+      fAlarmFree.Push(&fAlarmSnapshot[0]);
+      fAlarmFree.Push(&fAlarmSnapshot[1]);
+      fAlarmWriterRunning = true;
+      fAlarmWriterThread = std::thread(&QwAlarmHandler::AlarmWriterLoop, this);
     }
-    else continue;
-    for (auto jte : fAlarmObjectList.at(ite).alarmParameterMap){ // Loop through parameter list
-      file_out<<fAlarmObjectList.at(ite).alarmParameterMapStr.at("Kind")<<","<<fAlarmObjectList.at(ite).alarmParameterMapStr.at("Chan")<<","<<fAlarmObjectList.at(ite).alarmParameterMapStr.at("Analysis")<<","<<jte.first<<","<<jte.second<<std::endl;
+    snapshot = fAlarmFree.TryPop();
+    if (snapshot == nullptr) {
+      if (fAlarmSkipped++ == 0)
+        QwWarning << "QwAlarmHandler: alarm file writer is busy, skipping the update "
+                  << "at pattern " << fCounter << " (further skips are counted)"
+                  << QwLog::endl;
+      return;
     }
   }
+
+  FillAlarmSnapshot(*snapshot);
+
+  if (fAlarmAsyncWrite) fAlarmReady.Push(snapshot);
+  else WriteAlarmFile(*snapshot);
+}
+
+/** Copy the current values and states of all alarms into a snapshot.
+ *
+ * @param snapshot Snapshot to fill
+ */
+void QwAlarmHandler::FillAlarmSnapshot(alarmSnapshot& snapshot) const
+{
+  const size_t n = fAlarmObjectList.size();
+  snapshot.value.resize(n);
+  snapshot.status.resize(n);
+  for (size_t ite = 0; ite < n; ite++) {
+    const alarmObject& alarm = fAlarmObjectList[ite];
+    snapshot.value[ite]  = (alarm.value != NULL)? alarm.value->GetValue(): 0;
+    snapshot.status[ite] = alarm.alarmStatus;
+  }
+}
+
+/** Writer thread: write the snapshots handed over by UpdateAlarmFile. */
+void QwAlarmHandler::AlarmWriterLoop()
+{
+  alarmSnapshot* snapshot;
+  while ((snapshot = fAlarmReady.Pop()) != nullptr) {
+    WriteAlarmFile(*snapshot);
+    fAlarmFree.Push(snapshot);
+  }
+}
+
+/** Write the remaining snapshots and stop the writer thread, and report
+ * the number of updates that were skipped while the writer was busy.
+ */
+void QwAlarmHandler::StopAlarmWriter()
+{
+  if (! fAlarmWriterRunning) return;
+  fAlarmReady.Close();
+  if (fAlarmWriterThread.joinable()) fAlarmWriterThread.join();
+  fAlarmWriterRunning = false;
+  if (fAlarmSkipped > 0) {
+    QwWarning << "QwAlarmHandler: " << fAlarmSkipped << " alarm file updates "
+              << "were skipped while the writer was busy" << QwLog::endl;
+    fAlarmSkipped = 0;
+  }
+}
+
+/** Write the alarm file.  The file is written under a temporary name and
+ * renamed, so the alarm GUI never reads a partially written file.
+ *
+ * @param snapshot Values and states of all alarms
+ */
+void QwAlarmHandler::WriteAlarmFile(const alarmSnapshot& snapshot) const
+{
+  const std::string tmpfile = fAlarmOutputFile + ".tmp";
+  std::ofstream file_out(tmpfile,std::ofstream::trunc);
+  for (size_t ite = 0 ; ite<fAlarmObjectList.size() && ite<snapshot.value.size(); ite++){
+    const alarmObject& alarm = fAlarmObjectList[ite];
+    if (alarm.value == NULL || alarm.outputPrefix.empty()) continue;
+    file_out<<alarm.outputPrefix<<"Value"<<","<<snapshot.value[ite]<<std::endl;
+    file_out<<alarm.outputPrefix<<"Alarm Status"<<","<<GetAlarmStatusName(snapshot.status[ite])<<std::endl;
+    file_out<<alarm.outputParameters;
+  }
   file_out.close();
+  if (std::rename(tmpfile.c_str(), fAlarmOutputFile.c_str()) != 0) {
+    QwWarning << "QwAlarmHandler: could not write alarm file " << fAlarmOutputFile << QwLog::endl;
+  }
 }
@@ -358,6 +358,16 @@ QwBCM<T>& QwBCM<T>::operator= (const QwBCM<T> &value)
   return *this;
 }
 
+/// Transfer the same event-based data as operator= to or from a snapshot
+template<typename T>
+void QwBCM<T>::Snapshot(QwSnapshot& snapshot)
+{
+  if (this->GetElementName()!="")
+    {
+      this->fBeamCurrent.Snapshot(snapshot);
+    }
+}
+
 /** \brief Polymorphic copy-assign from VQwBCM if types match. */
 template<typename T>
 VQwBCM& QwBCM<T>::operator= (const VQwBCM &value)
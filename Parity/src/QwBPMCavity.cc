@@ -609,6 +609,23 @@ QwBPMCavity& QwBPMCavity::operator= (const QwBPMCavity &value)
   return *this;
 }
 
+/// Transfer the same event-based data as operator= to or from a snapshot
+void QwBPMCavity::Snapshot(QwSnapshot& snapshot)
+{
+  VQwBPM::Snapshot(snapshot);
+
+  if (GetElementName()!=""){
+    size_t i = 0;
+    for(i=0;i<kNumElements;i++) {
+      fElement[i].Snapshot(snapshot);
+    }
+    for(i=0;i<kNumAxes;i++){
+      fRelPos[i].Snapshot(snapshot);
+      fAbsPos[i].Snapshot(snapshot);
+    }
+  }
+}
+
 
 /** Element-wise addition of raw and derived channels. */
 QwBPMCavity& QwBPMCavity::operator+= (const QwBPMCavity &value)
@@ -448,11 +448,11 @@ template<typename T>
 void  QwBPMStripline<T>::ProcessEvent()
 {
   Bool_t localdebug = kFALSE;
-  static T numer("numerator","derived"), denom("denominator","derived");
-  static T tmp1("tmp1","derived"), tmp2("tmp2","derived");
-  static T tmp3("tmp3","derived"), tmp4("tmp4","derived");
-  static T tmp5("tmp3","derived");
-  static T rawpos[2] = {T("rawpos_0","derived"),T("rawpos_1","derived")};
+  static thread_local T numer("numerator","derived"), denom("denominator","derived");
+  static thread_local T tmp1("tmp1","derived"), tmp2("tmp2","derived");
+  static thread_local T tmp3("tmp3","derived"), tmp4("tmp4","derived");
+  static thread_local T tmp5("tmp3","derived");
+  static thread_local T rawpos[2] = {T("rawpos_0","derived"),T("rawpos_1","derived")};
 
   Short_t i = 0;
 
@@ -685,6 +685,25 @@ QwBPMStripline<T>& QwBPMStripline<T>::operator= (const QwBPMStripline<T> &value)
   return *this;
 }
 
+/// Transfer the same event-based data as operator= to or from a snapshot
+template<typename T>
+void QwBPMStripline<T>::Snapshot(QwSnapshot& snapshot)
+{
+  VQwBPM::Snapshot(snapshot);
+
+  snapshot.Transfer(this->bRotated);
+  if (this->GetElementName()!=""){
+    Short_t i = 0;
+    fEffectiveCharge.Snapshot(snapshot);
+    fEllipticity.Snapshot(snapshot);
+    for(i=0;i<4;i++) fWire[i].Snapshot(snapshot);
+    for(i=kXAxis;i<kNumAxes;i++) {
+      fRelPos[i].Snapshot(snapshot);
+      fAbsPos[i].Snapshot(snapshot);
+    }
+  }
+}
+
 template<typename T>
 VQwBPM& QwBPMStripline<T>::operator+= (const VQwBPM &value)
 {
@@ -11,6 +11,7 @@
 #include "QwBeamLine.h"
 
 // System headers
+#include <algorithm>
 #include <iostream>
 #include <stdexcept>
 
@@ -439,11 +440,78 @@ Int_t QwBeamLine::LoadChannelMap(TString mapfile)
     }
   }
   ldebug=kFALSE;
-  
+
+  BuildDecodePlan();
+
   mapstr.Close(); // Close the file (ifstream)
   return 0;
 }
 
+//*****************************************************************//
+/**
+ * Build the decode plan: for each subbank, the devices that read from it
+ * with their word offset and subelement, sorted by word offset.  Decoding a
+ * subbank is then a single pass over its plan, instead of a search through
+ * all of fBeamDetectorID.  The plan holds pointers into the device vectors,
+ * so it must be rebuilt whenever devices are added.
+ */
+void QwBeamLine::BuildDecodePlan()
+{
+  fDecodePlan.clear();
+  for (size_t i = 0; i < fBeamDetectorID.size(); i++) {
+    const QwBeamDetectorID& id = fBeamDetectorID[i];
+    if (id.fSubbankIndex < 0 || id.fIndex < 0) continue;
+
+    VQwDataElement* element = 0;
+    UInt_t subelement = 0;
+    switch (id.fTypeID) {
+      case kQwBPMStripline:
+        element = fStripline[id.fIndex].get();
+        subelement = id.fSubelement;
+        break;
+      case kQwQPD:
+        element = &(fQPD[id.fIndex]);
+        subelement = id.fSubelement;
+        break;
+      case kQwLinearArray:
+        element = &(fLinearArray[id.fIndex]);
+        subelement = id.fSubelement;
+        break;
+      case kQwBPMCavity:
+        element = &(fCavity[id.fIndex]);
+        subelement = id.fSubelement;
+        break;
+      case kQwBCM:
+        element = fBCM[id.fIndex].get();
+        break;
+      case kQwClock:
+        element = fClock[id.fIndex].get();
+        break;
+      case kQwHaloMonitor:
+        element = &(fHaloMonitor[id.fIndex]);
+        break;
+      default:
+        //  Combined devices and calculators are not read from the buffer
+        break;
+    }
+    if (element == 0) continue;
+
+    if (fDecodePlan.size() <= size_t(id.fSubbankIndex))
+      fDecodePlan.resize(id.fSubbankIndex + 1);
+    QwDecodeStep step = { element, id.fWordInSubbank, subelement };
+    fDecodePlan[id.fSubbankIndex].push_back(step);
+  }
+
+  //  Read the devices of each subbank in buffer order
+  for (auto& plan: fDecodePlan) {
+    std::stable_sort(plan.begin(), plan.end(),
+                     [](const QwDecodeStep& a, const QwDecodeStep& b) {
+                       return a.fWordInSubbank < b.fWordInSubbank;
+                     });
+  }
+  fDecodePlanBuilt = kTRUE;
+}
+
 
 //*****************************************************************//
 /**
@@ -1139,7 +1207,8 @@ void QwBeamLine::EncodeEventData(std::vector<UInt_t> &buffer)
  * 
  * - Maps ROC/bank combinations to internal subbank indices using GetSubbankIndex()
  * - Handles data alignment by skipping padding words (0xf0f0f0f0) at buffer start
- * - Iterates through all registered beam detector IDs to find matching devices
+ * - Walks the decode plan of the subbank (see BuildDecodePlan()), which lists
+ *   the devices in this subbank in buffer order
  * - Routes data to device-specific ProcessEvBuffer() methods based on device type:
  *   - kQwBPMStripline: 4-channel stripline beam position monitors
  *   - kQwQPD: Quad photodiode detectors  
@@ -1185,102 +1254,21 @@ Int_t QwBeamLine::ProcessEvBuffer(const ROCID_t roc_id, const BankID_t bank_id,
 		  << std::endl;
     }
 
-    for(size_t i=0;i<fBeamDetectorID.size();i++)
-      {
-	if(fBeamDetectorID[i].fSubbankIndex==index)
-	  {
-
-	    if(fBeamDetectorID[i].fTypeID==kQwBPMStripline)
-	      {
-		if (lkDEBUG)
-		  {
-		    std::cout<<"found stripline data for "<<fBeamDetectorID[i].fdetectorname<<std::endl;
-		    std::cout<<"word left to read in this buffer:"<<num_words-fBeamDetectorID[i].fWordInSubbank<<std::endl;
-		  }
-		fStripline[fBeamDetectorID[i].fIndex].get()->
-		  ProcessEvBuffer(&(buffer[fBeamDetectorID[i].fWordInSubbank]),
-				  num_words-fBeamDetectorID[i].fWordInSubbank,
-				  fBeamDetectorID[i].fSubelement);
-	      }
-
-	    if(fBeamDetectorID[i].fTypeID==kQwQPD)
-	      {
-		if (lkDEBUG)
-		  {
-		    std::cout<<"found qpd data for "<<fBeamDetectorID[i].fdetectorname<<std::endl;
-		    std::cout<<"word left to read in this buffer:"<<num_words-fBeamDetectorID[i].fWordInSubbank<<std::endl;
-		  }
-		fQPD[fBeamDetectorID[i].fIndex].
-		  ProcessEvBuffer(&(buffer[fBeamDetectorID[i].fWordInSubbank]),
-				  num_words-fBeamDetectorID[i].fWordInSubbank,
-				  fBeamDetectorID[i].fSubelement);
-	      }
-
-	    if(fBeamDetectorID[i].fTypeID==kQwLinearArray)
-	      {
-		if (lkDEBUG)
-		  {
-		    std::cout<<"found linear array data for "<<fBeamDetectorID[i].fdetectorname<<fBeamDetectorID[i].fIndex<<std::endl;
-		    std::cout<<"word left to read in this buffer:"<<num_words-fBeamDetectorID[i].fWordInSubbank<<std::endl;
-		  }
-		fLinearArray[fBeamDetectorID[i].fIndex].
-		  ProcessEvBuffer(&(buffer[fBeamDetectorID[i].fWordInSubbank]),
-				  num_words-fBeamDetectorID[i].fWordInSubbank,
-				  fBeamDetectorID[i].fSubelement);
-
-	      }
-
-	    if(fBeamDetectorID[i].fTypeID==kQwBPMCavity)
-	      {
-		if (lkDEBUG)
-		  {
-		    std::cout<<"found stripline data for "<<fBeamDetectorID[i].fdetectorname<<std::endl;
-		    std::cout<<"word left to read in this buffer:"<<num_words-fBeamDetectorID[i].fWordInSubbank<<std::endl;
-		  }
-		fCavity[fBeamDetectorID[i].fIndex].
-		  ProcessEvBuffer(&(buffer[fBeamDetectorID[i].fWordInSubbank]),
-				  num_words-fBeamDetectorID[i].fWordInSubbank,
-				  fBeamDetectorID[i].fSubelement);
-	      }
-
-	    if(fBeamDetectorID[i].fTypeID==kQwBCM)
-	      {
-		if (lkDEBUG)
-		  {
-		    std::cout<<"found bcm data for "<<fBeamDetectorID[i].fdetectorname<<std::endl;
-		    std::cout<<"word left to read in this buffer:"<<num_words-fBeamDetectorID[i].fWordInSubbank<<std::endl;
-		  }
-		fBCM[fBeamDetectorID[i].fIndex].get()->
-		  ProcessEvBuffer(&(buffer[fBeamDetectorID[i].fWordInSubbank]),
-				  num_words-fBeamDetectorID[i].fWordInSubbank);
-	      }
+    //  Build the decode plan if this object was copied from another
+    if (! fDecodePlanBuilt) BuildDecodePlan();
 
-	    if(fBeamDetectorID[i].fTypeID==kQwClock)
-	      {
-		if (lkDEBUG)
-		  {
-		    std::cout<<"found clock data for "<<fBeamDetectorID[i].fdetectorname<<std::endl;
-		    std::cout<<"word left to read in this buffer:"<<num_words-fBeamDetectorID[i].fWordInSubbank<<std::endl;
-		  }
-		fClock[fBeamDetectorID[i].fIndex].get()->
-		  ProcessEvBuffer(&(buffer[fBeamDetectorID[i].fWordInSubbank]),
-				  num_words-fBeamDetectorID[i].fWordInSubbank);
-	      }
-
-	    if(fBeamDetectorID[i].fTypeID==kQwHaloMonitor)
-	      {
-		if (lkDEBUG)
-		  {
-		    std::cout<<"found halo monitor data for "<<fBeamDetectorID[i].fdetectorname<<std::endl;
-		    std::cout<<"word left to read in this buffer:"<<num_words-fBeamDetectorID[i].fWordInSubbank<<std::endl;
-		  }
-		fHaloMonitor[fBeamDetectorID[i].fIndex].
-		  ProcessEvBuffer(&(buffer[fBeamDetectorID[i].fWordInSubbank]),
-				  num_words-fBeamDetectorID[i].fWordInSubbank);
-	      }
-
-	  }
+    if (index < static_cast<Int_t>(fDecodePlan.size())) {
+      for (const auto& step: fDecodePlan[index]) {
+        if (lkDEBUG)
+          {
+            std::cout<<"found data for "<<step.fElement->GetElementName()<<std::endl;
+            std::cout<<"word left to read in this buffer:"<<num_words-step.fWordInSubbank<<std::endl;
+          }
+        step.fElement->ProcessEvBuffer(&(buffer[step.fWordInSubbank]),
+                                       num_words-step.fWordInSubbank,
+                                       step.fSubelement);
       }
+    }
   }
 
   return 0;
@@ -2167,6 +2155,37 @@ VQwSubsystem&  QwBeamLine::operator=  (VQwSubsystem *value)
   return *this;
 }
 
+//*****************************************************************//
+/**
+ * Transfer the event data of all devices to or from a snapshot, in the
+ * same order as operator=.  The publish list is configuration and is not
+ * part of the snapshot.
+ */
+Bool_t QwBeamLine::Snapshot(QwSnapshot& snapshot)
+{
+  for(size_t i=0;i<fClock.size();i++)
+    fClock[i]->Snapshot(snapshot);
+  for(size_t i=0;i<fStripline.size();i++)
+    fStripline[i]->Snapshot(snapshot);
+  for(size_t i=0;i<fQPD.size();i++)
+    fQPD[i].Snapshot(snapshot);
+  for(size_t i=0;i<fLinearArray.size();i++)
+    fLinearArray[i].Snapshot(snapshot);
+  for(size_t i=0;i<fCavity.size();i++)
+    fCavity[i].Snapshot(snapshot);
+  for(size_t i=0;i<fBCM.size();i++)
+    fBCM[i]->Snapshot(snapshot);
+  for(size_t i=0;i<fHaloMonitor.size();i++)
+    fHaloMonitor[i].Snapshot(snapshot);
+  for(size_t i=0;i<fBCMCombo.size();i++)
+    fBCMCombo[i]->Snapshot(snapshot);
+  for(size_t i=0;i<fBPMCombo.size();i++)
+    fBPMCombo[i]->Snapshot(snapshot);
+  for(size_t i=0;i<fECalculator.size();i++)
+    fECalculator[i].Snapshot(snapshot);
+  return kTRUE;
+}
+
 
 //*****************************************************************//
 VQwSubsystem&  QwBeamLine::operator+=  (VQwSubsystem *value)
@@ -642,6 +642,16 @@ VQwSubsystem&  QwBeamMod::operator=  (VQwSubsystem *value)
     }
   return *this;
 }
+//*****************************************************************
+Bool_t QwBeamMod::Snapshot(QwSnapshot& snapshot)
+{
+  for(size_t i=0;i<fModChannel.size();i++)
+    fModChannel[i]->Snapshot(snapshot);
+  for(size_t i=0;i<fWord.size();i++)
+    snapshot.Transfer(fWord[i].fValue);
+  snapshot.Transfer(fFFB_ErrorFlag);
+  return kTRUE;
+}
 
 VQwSubsystem&  QwBeamMod::operator+=  (VQwSubsystem *value)
 {
@@ -809,7 +819,7 @@ void QwBeamMod::ConstructBranchAndVector(TTree *tree, TString & prefix, QwRootTr
     basename = prefix(0, (prefix.First("|") >= 0)? prefix.First("|"): prefix.Length());
     basename += fWord[i].fWordName;
     values.push_back(basename.Data(), 'D');
-    tree->Branch(basename, &(values[fTreeArrayIndex + i]), values.LeafList(fTreeArrayIndex + i).c_str());
+    tree->Branch(basename, &(values[fTreeArrayIndex + i]), values.LeafList(fTreeArrayIndex + i, basename.Data()).c_str());
   }
 }
 
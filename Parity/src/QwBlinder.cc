@@ -20,7 +20,6 @@
 #include "QwParitySchema.h"
 #include "QwParityDB.h"
 #endif // __USE_DATABASE__
-#include "QwVQWK_Channel.h"
 #include "QwParameterFile.h"
 
 ///  Run table aliases for seed query
@@ -300,18 +299,28 @@ void QwBlinder::Update()
  */
 void QwBlinder::Update(const QwSubsystemArrayParity& detectors)
 {
-  static QwVQWK_Channel q_targ("q_targ");
+  if (fBlindingStrategy != kDisabled && fTargetBlindability==kBlindable) {
+    Update(detectors.RequestExternalPointer("q_targ"));
+  }
+}
+
+/**
+ * Update the blinder status with the beam current on target
+ *
+ * @param q_targ Beam current on target, or null if it is not available
+ */
+void QwBlinder::Update(const VQwHardwareChannel* q_targ)
+{
   if (fBlindingStrategy != kDisabled && fTargetBlindability==kBlindable) {
     // Check for the target blindability flag
     
 
     // Check that the current on target is above acceptable limit
     Bool_t tmp_beam = kFALSE;
-    //    if (detectors.RequestExternalValue(q_targ.GetElementName(), &q_targ)) {
-    if (detectors.RequestExternalValue("q_targ", &q_targ)) {
-      if (q_targ.GetValue() > fBeamCurrentThreshold){
-	// 	std::cerr << "q_targ.GetValue()==" 
-	// 		  << q_targ.GetValue() << std::endl;
+    if (q_targ != 0) {
+      if (q_targ->GetValue() > fBeamCurrentThreshold){
+	// 	std::cerr << "q_targ->GetValue()==" 
+	// 		  << q_targ->GetValue() << std::endl;
 	tmp_beam = kTRUE;
       }
     }
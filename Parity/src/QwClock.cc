@@ -164,6 +164,18 @@ QwClock<T>& QwClock<T>::operator= (const QwClock<T> &value)
   return *this;
 }
 
+/// Transfer the same event-based data as operator= to or from a snapshot
+template<typename T>
+void QwClock<T>::Snapshot(QwSnapshot& snapshot)
+{
+  if (this->GetElementName()!="")
+    {
+      this->fClock.Snapshot(snapshot);
+      snapshot.Transfer(fPedestal);
+      snapshot.Transfer(fCalibration);
+    }
+}
+
 template<typename T>
 VQwClock& QwClock<T>::operator= (const VQwClock &value)
 {
@@ -11,6 +11,7 @@
 #include "QwCombinedBCM.h"
 
 // System headersF
+#include <cmath>
 #include <stdexcept>
 
 // Qweak headers
@@ -25,28 +26,38 @@
 #include "QwMollerADC_Channel.h"
 
 
-// Randomness generator: Mersenne twister with period 2^19937 - 1
+// Beam trip draws: counter-based stream indexed by the event counter
 //
-// This is defined as static to avoid getting stuck with 100% correlated
-// ADC channels when each channel goes through the same list of pseudo-
-// random numbers...
-
-template<typename T> boost::mt19937 QwCombinedBCM<T>::fRandomnessGenerator;
-template<typename T> boost::random::uniform_real_distribution<double> QwCombinedBCM<T>::fDistribution;
-
-// The boost::variate_generator has operator() overloaded to get a new random
-// value according to the distribution in the second template argument, based
-// on the uniform random value generated by the first template argument.
-// For example: fNormalRandomVariable() will return a random normal variable.
-
-template<typename T> boost::variate_generator < boost::mt19937, boost::random::uniform_real_distribution<double> >
-  QwCombinedBCM<T>::fRandomVariable(fRandomnessGenerator, fDistribution);
+// Every event has its own uniform random value, derived from the seed and
+// the event counter, so that events can be generated in any order and on
+// any number of threads with identical beam trips.
+template<typename T> UInt_t QwCombinedBCM<T>::fTripSeed = 0;
+template<typename T> Double_t QwCombinedBCM<T>::fTripWindowPeriod = 1.0 * Qw::ms;
 
 /** Set random number generator seed for beam trip simulation. */
 template<typename T>
 void QwCombinedBCM<T>::SetTripSeed(uint seedval)
 {
-  fRandomVariable.engine().seed(seedval);
+  fTripSeed = seedval;
+}
+
+/** Set the time between events, which defines the event counter of a time. */
+template<typename T>
+void QwCombinedBCM<T>::SetTripWindowPeriod(Double_t period)
+{
+  if (period > 0.0) fTripWindowPeriod = period;
+}
+
+/** Uniform random value in [0,1) for the beam trip draw in an event (splitmix64). */
+template<typename T>
+Double_t QwCombinedBCM<T>::GetTripRandomValue(Long64_t event)
+{
+  ULong64_t z = (ULong64_t(fTripSeed) << 32) ^ ULong64_t(event);
+  z += 0x9e3779b97f4a7c15ULL;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  z = z ^ (z >> 31);
+  return (z >> 11) * (1.0 / 9007199254740992.0);
 }
 
 /********************************************************/
@@ -79,6 +90,9 @@ void  QwCombinedBCM<T>::InitializeChannel(TString name, TString datatosave)
   SetPedestal(0.);
   SetCalibrationFactor(1.);
   fLastTripTime = -99999.9;
+  fLastTripEvent = -1;
+  fTripPeriod = fTripLength = fTripRamp = 0.0;
+  fProbabilityOfTrip = 0.0;
   this->SetElementName(name);
   this->fBeamCurrent.InitializeChannel(name,"derived");
 }
@@ -90,6 +104,9 @@ void  QwCombinedBCM<T>::InitializeChannel(TString subsystem, TString name, TStri
   SetPedestal(0.);
   SetCalibrationFactor(1.);
   fLastTripTime = -99999.9;
+  fLastTripEvent = -1;
+  fTripPeriod = fTripLength = fTripRamp = 0.0;
+  fProbabilityOfTrip = 0.0;
   this->SetElementName(name);
   this->fBeamCurrent.InitializeChannel(subsystem, "QwCombinedBCM", name,"derived");
 }
@@ -101,6 +118,9 @@ void  QwCombinedBCM<T>::InitializeChannel(TString subsystem, TString name,
   SetPedestal(0.);
   SetCalibrationFactor(1.);
   fLastTripTime = -99999.9;
+  fLastTripEvent = -1;
+  fTripPeriod = fTripLength = fTripRamp = 0.0;
+  fProbabilityOfTrip = 0.0;
   this->SetElementName(name);
   this->SetModuleType(type);
   this->fBeamCurrent.InitializeChannel(subsystem, "QwCombinedBCM", name,"derived");
@@ -115,7 +135,7 @@ void  QwCombinedBCM<T>::InitializeChannel(TString subsystem, TString name,
 template<typename T>
 void  QwCombinedBCM<T>::ProcessEvent()
 {
-  static T tmpADC;
+  static thread_local T tmpADC;
   tmpADC.InitializeChannel("tmp","derived");
 
   this->ClearEventData();
@@ -174,16 +194,29 @@ void  QwCombinedBCM<T>::RandomizeEventData(int helicity, double time)
 
 
   //  Determine the probability of having a beam trip
-  if (fLastTripTime<=-99999.9) {
-     fLastTripTime = time - fTripLength - fTripRamp;
+  if (fProbabilityOfTrip <= 0.0) return;
+  Long64_t event = std::llround(time / fTripWindowPeriod);
+  if (event != fLastTripEvent + 1) {
+    //  The previous events were not generated here (first event, new run, or
+    //  a new block of events on this thread): look back for the most recent
+    //  trip that still affects this event
+    fLastTripTime = time - fTripLength - fTripRamp;
+    Long64_t lookback = std::ceil((fTripLength + fTripRamp) / fTripWindowPeriod);
+    for (Long64_t previous = event - 1; previous >= 0 && previous >= event - lookback; previous--) {
+      if (GetTripRandomValue(previous) < fProbabilityOfTrip) {
+        fLastTripTime = previous * fTripWindowPeriod;
+        break;
+      }
+    }
   }
-//  if ( ((time-fLastTripTime) > (fTripPeriod)) ){ //  Make some comparison to a probablilty instead of the time
+  fLastTripEvent = event;
 //  Probability of a trip happening in one event:  # of trips per hour/3600 * eventtime_in_seconds (which is 0.001s)
-  Double_t tmp = fRandomVariable();
+  Double_t tmp = GetTripRandomValue(event);
 //  std::cout << "random value=="<<tmp << "; fProbabilityOfTrip=="<<fProbabilityOfTrip<<std::endl;
   if (tmp < fProbabilityOfTrip) {
      fLastTripTime = time;
-     std::cout << "random value=="<<tmp << "; fProbabilityOfTrip=="<<fProbabilityOfTrip<<"; time=="<<time<<std::endl;
+     QwDebug << "random value==" << tmp << "; fProbabilityOfTrip==" << fProbabilityOfTrip
+             << "; time==" << time << QwLog::endl;
   }
 
   Double_t time_since_trip = time - fLastTripTime;
@@ -530,7 +530,7 @@ void  QwCombinedBPM<T>::ProcessEvent()
 {
   Bool_t ldebug = kFALSE;
 
-  static T  tmpQADC("tmpQADC"), tmpADC("tmpADC");
+  static thread_local T  tmpQADC("tmpQADC"), tmpADC("tmpADC");
 
   this->ClearEventData();
   //check to see if the fixed parameters are calculated
@@ -690,12 +690,12 @@ template<typename T>
    **/
 
    Bool_t ldebug = kFALSE;
-   static Double_t zpos = 0;
-   static T tmp1("tmp1","derived");
-   static T tmp2("tmp2","derived");
-   static T tmp3("tmp3","derived");
-   static T C[kNumAxes];
-   static T E[kNumAxes];
+   static thread_local Double_t zpos = 0;
+   static thread_local T tmp1("tmp1","derived");
+   static thread_local T tmp2("tmp2","derived");
+   static thread_local T tmp3("tmp3","derived");
+   static thread_local T C[kNumAxes];
+   static thread_local T E[kNumAxes];
 
    // initialize the VQWK_Channel arrays
    C[kXAxis].InitializeChannel("cx","derived");
@@ -899,6 +899,22 @@ QwCombinedBPM<T>& QwCombinedBPM<T>::operator= (const QwCombinedBPM<T> &value)
   return *this;
 }
 
+/// Transfer the same event-based data as operator= to or from a snapshot
+template<typename T>
+void QwCombinedBPM<T>::Snapshot(QwSnapshot& snapshot)
+{
+  VQwBPM::Snapshot(snapshot);
+  if (this->GetElementName()!=""){
+    fEffectiveCharge.Snapshot(snapshot);
+    for(Short_t axis=kXAxis;axis<kNumAxes;axis++){
+      fSlope[axis].Snapshot(snapshot);
+      fIntercept[axis].Snapshot(snapshot);
+      fAbsPos[axis].Snapshot(snapshot);
+      fMinimumChiSquare[axis].Snapshot(snapshot);
+    }
+  }
+}
+
 
 template<typename T>
 VQwBPM& QwCombinedBPM<T>::operator+= (const VQwBPM &value)
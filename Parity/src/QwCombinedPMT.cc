@@ -113,7 +113,7 @@ void QwCombinedPMT::CalculateSumAndAverage()
   Double_t  total_weights=0.0;
 
   fSumADC.ClearEventData();
-  static QwIntegrationPMT tmpADC("tmpADC");
+  static thread_local QwIntegrationPMT tmpADC("tmpADC");
 
   for (size_t i=0;i<fElement.size();i++)
     {
@@ -299,6 +299,19 @@ QwCombinedPMT& QwCombinedPMT::operator= (const QwCombinedPMT &value)
   return *this;
 }
 
+/**
+ * Transfer the event-based data to or from a snapshot.  The element
+ * pointers are configuration and are not part of the snapshot.
+ */
+void QwCombinedPMT::Snapshot(QwSnapshot& snapshot)
+{
+  if (GetElementName()!="")
+    {
+      snapshot.Transfer(fWeights.data(), fWeights.size());
+      fSumADC.Snapshot(snapshot);
+    }
+}
+
 QwCombinedPMT& QwCombinedPMT::operator+= (const QwCombinedPMT &value)
 {
   //std::cout<<"Calling QwCombinedPMT::operator+="<<std::endl;
@@ -371,7 +384,7 @@ void QwCombinedPMT::Scale(Double_t factor)
 //  fAvgADC.Scale(factor);
   return;
 }
-void QwCombinedPMT::Normalize(VQwDataElement* denom)
+void QwCombinedPMT::Normalize(const VQwDataElement* denom)
 {
   fSumADC.Normalize(denom);
 
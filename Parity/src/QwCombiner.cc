@@ -285,6 +285,9 @@ Int_t QwCombiner::ConnectChannels(
   QwMessage << "Using asymmetry error flag" << QwLog::endl;
   fErrorFlagPointer = asym.GetEventcutErrorFlagPointer();
 
+  // Gather each independent variable once for all outputs
+  PrepareCorrections(fIndependentVar);
+
   return 0;
 }
 
@@ -373,6 +376,9 @@ Int_t QwCombiner::ConnectChannels(QwSubsystemArrayParity& event)
   QwMessage << "Using event error flag" << QwLog::endl;
   fErrorFlagPointer = event.GetEventcutErrorFlagPointer();
 
+  // Gather each independent variable once for all outputs
+  PrepareCorrections(fIndependentVar);
+
   return 0;
 }
 
@@ -381,16 +387,12 @@ void QwCombiner::ProcessData()
   if (fErrorFlagMask!=0 && fErrorFlagPointer!=NULL) {
     if ((*fErrorFlagPointer & fErrorFlagMask)!=0) {
       //QwMessage << "0x" << std::hex << *fErrorFlagPointer << " passed mask " << "0x" << fErrorFlagMask << std::dec << QwLog::endl;
-      for (size_t i = 0; i < fDependentVar.size(); ++i) {
-        CalcOneOutput(fDependentVar[i], fOutputVar[i], fIndependentVar[i], fSensitivity[i]);
-      }
+      CalcOutputs(fSensitivity);
     //} else {
       //QwMessage << "0x" << std::hex << *fErrorFlagPointer << " failed mask " << "0x" << fErrorFlagMask << std::dec << QwLog::endl;
     }
   }
   else{
-    for (size_t i = 0; i < fDependentVar.size(); ++i) {
-      CalcOneOutput(fDependentVar[i], fOutputVar[i], fIndependentVar[i], fSensitivity[i]);
-    }
+    CalcOutputs(fSensitivity);
   }
 }
@@ -38,6 +38,14 @@ VQwSubsystem& QwCombinerSubsystem::operator=(VQwSubsystem* value)
   return *this;
 }
 
+Bool_t QwCombinerSubsystem::Snapshot(QwSnapshot& snapshot)
+{
+  for(size_t i = 0; i < fDependentVar.size(); i++) {
+    fOutputVar.at(i)->Snapshot(snapshot);
+  }
+  return kTRUE;
+}
+
 VQwSubsystem& QwCombinerSubsystem::operator+=(VQwSubsystem* value)
 {
   QwCombinerSubsystem* input = dynamic_cast<QwCombinerSubsystem*>(value);
@@ -37,6 +37,7 @@ QwCorrelator::QwCorrelator(const TString& name)
   fAlphaOutputPath("."),
   fAlphaOutputFile(0),
   fTree(0),
+  fTreeFile(0),
   fAliasOutputFileBase("regalias_"),
   fAliasOutputFileSuff(""),
   fAliasOutputPath("."),
@@ -64,6 +65,7 @@ QwCorrelator::QwCorrelator(const QwCorrelator& source)
   fAlphaOutputPath(source.fAlphaOutputPath),
   fAlphaOutputFile(0),
   fTree(0),
+  fTreeFile(0),
   fAliasOutputFileBase(source.fAliasOutputFileBase),
   fAliasOutputFileSuff(source.fAliasOutputFileSuff),
   fAliasOutputPath(source.fAliasOutputPath),
@@ -137,10 +139,7 @@ void QwCorrelator::ProcessData()
   // If good, process event
   if (fGoodEvent == 0) {
     fGoodCount++;
-
-    TVectorD P(fIndependentValues.size(), fIndependentValues.data());
-    TVectorD Y(fDependentValues.size(),   fDependentValues.data());
-    linReg += std::make_pair(P, Y);
+    linReg.addEvent(fIndependentValues.data(), fDependentValues.data());
   }
 }
 
@@ -214,6 +213,9 @@ void QwCorrelator::CalcCorrelations()
     }
   }
 
+  // Fold the pending events into the regression
+  linReg.flush();
+
   if (! linReg.failed()) {
 
     if (fPrintCorrelations) {
@@ -230,8 +232,8 @@ void QwCorrelator::CalcCorrelations()
     }
   }
 
-  // Fill tree
-  if (fTree) fTree->Fill();
+  // Fill tree, without prescaling, after the entries queued for the writer
+  if (fTree) fTreeFile->FillTreeDirect(fTreeFullName);
   else QwWarning << "No tree" << QwLog::endl;
 
   // Write alpha and alias file
@@ -406,6 +408,8 @@ void QwCorrelator::ConstructTreeBranches(
   fTree = treerootfile->GetTree(name);
   // Check to make sure the tree was created successfully
   if (fTree == NULL) return;
+  fTreeFile = treerootfile;
+  fTreeFullName = name;
 
   // Set up branches
   fTree->Branch(TString(branchprefix + "total_count"), &fTotalCount);
@@ -104,7 +104,7 @@ void QwEnergyCalculator::ProcessEvent()
 {
   //Bool_t ldebug = kFALSE;
   //Double_t targetbeamangle = 0.0;
-  static QwMollerADC_Channel tmp;
+  static thread_local QwMollerADC_Channel tmp;
   tmp.InitializeChannel("tmp","derived");
   tmp.ClearEventData();
 
@@ -389,6 +389,12 @@ QwEnergyCalculator& QwEnergyCalculator::operator= (const QwEnergyCalculator &val
   return *this;
 }
 
+/// Transfer the same event-based data as operator= to or from a snapshot
+void QwEnergyCalculator::Snapshot(QwSnapshot& snapshot){
+  if (GetElementName()!="")
+    fEnergyChange.Snapshot(snapshot);
+}
+
 /** \brief Add-assign from another calculator (sum energy change). */
 QwEnergyCalculator& QwEnergyCalculator::operator+= (const QwEnergyCalculator &value){
 
@@ -0,0 +1,324 @@
+/*!
+ * \file   QwEventReadAhead.cc
+ * \brief  Reading and processing of CODA events ahead of the output stages
+ */
+
+#include "QwEventReadAhead.h"
+
+// ROOT headers
+#include "TROOT.h"
+
+// Qweak headers
+#include "QwEPICSEvent.h"
+#include "QwThreadPool.h"
+
+/**
+ * Construct the read-ahead for the detectors array.  The slots hold copies
+ * or snapshots of the detectors array, so the read-ahead must be
+ * constructed after the detectors are fully configured.
+ */
+QwEventReadAhead::QwEventReadAhead(QwOptions &options,
+                                   QwEventBuffer &eventbuffer,
+                                   QwSubsystemArrayParity &detectors)
+: fEventBuffer(eventbuffer),
+  fDetectors(detectors),
+  fEnabled(kFALSE),
+  fNumberOfThreads(0),
+  fDepth(16),
+  fUseSnapshots(kFALSE),
+  fRunning(kFALSE),
+  fReaderStatus(CODA_OK),
+  fCurrent(nullptr),
+  fSnapshotSize(0)
+{
+  ProcessOptions(options);
+  if (! fEnabled) return;
+
+  //  Subsystems are processed and written from several threads
+  ROOT::EnableThreadSafety();
+
+  if (fUseSnapshots) {
+    //  Measure the size of a snapshot; this fails if any subsystem
+    //  does not support snapshots
+    fProcessorSnapshot.Measure();
+    if (fDetectors.Snapshot(fProcessorSnapshot)) {
+      fSnapshotSize = fProcessorSnapshot.GetSize();
+      fOutputEvent.reset(new QwSubsystemArrayParity(fDetectors));
+    } else {
+      QwWarning << "QwEventReadAhead: Not all subsystems support snapshots; "
+                << "the events will be passed as full copies." << QwLog::endl;
+      fUseSnapshots = kFALSE;
+    }
+  }
+
+  fSlots.resize(fDepth);
+  for (auto& slot: fSlots) {
+    slot.fType = kPhysicsEvent;
+    slot.fPassedCuts = kFALSE;
+    if (fUseSnapshots)
+      slot.fSnapshot.resize(fSnapshotSize);
+    else
+      slot.fEvent.reset(new QwSubsystemArrayParity(fDetectors));
+  }
+
+  fProcessorDecoder.reset(fEventBuffer.CreateDecoder());
+  fOutputDecoder.reset(fEventBuffer.CreateDecoder());
+
+  if (fNumberOfThreads > 0) {
+    fThreadPool.reset(new QwThreadPool(fNumberOfThreads));
+    fDetectors.SetThreadPool(fThreadPool.get());
+  }
+
+  QwMessage << "Event read-ahead enabled with " << fDepth << " events in flight"
+            << " and " << fNumberOfThreads << " additional processing threads"
+            << QwLog::endl;
+}
+
+QwEventReadAhead::~QwEventReadAhead()
+{
+  Stop();
+  if (fThreadPool) fDetectors.SetThreadPool(nullptr);
+}
+
+/**
+ * Define the command line options of the event read-ahead
+ * @param options Options object
+ */
+void QwEventReadAhead::DefineOptions(QwOptions &options)
+{
+  options.AddOptions()("readahead.enable",
+      po::value<bool>()->default_bool_value(false),
+      "QwEventReadAhead: read and process events ahead on separate threads");
+  options.AddOptions()("readahead.threads",
+      po::value<int>()->default_value(0),
+      "QwEventReadAhead: additional threads for processing the subsystems of an event");
+  options.AddOptions()("readahead.depth",
+      po::value<int>()->default_value(16),
+      "QwEventReadAhead: number of events in flight between the threads");
+  options.AddOptions()("readahead.snapshots",
+      po::value<bool>()->default_bool_value(false),
+      "QwEventReadAhead: pass only the event data of the processed events");
+}
+
+/**
+ * Process the command line options of the event read-ahead
+ * @param options Options object
+ */
+void QwEventReadAhead::ProcessOptions(QwOptions &options)
+{
+  fEnabled = options.GetValue<bool>("readahead.enable");
+  fNumberOfThreads = options.GetValue<int>("readahead.threads");
+  fDepth = options.GetValue<int>("readahead.depth");
+  fUseSnapshots = options.GetValue<bool>("readahead.snapshots");
+
+  if (fNumberOfThreads < 0) {
+    QwWarning << "QwEventReadAhead: negative number of threads, using none" << QwLog::endl;
+    fNumberOfThreads = 0;
+  }
+  if (fDepth < 2) {
+    QwWarning << "QwEventReadAhead: depth must be at least 2, using 2" << QwLog::endl;
+    fDepth = 2;
+  }
+}
+
+/**
+ * Advance to the next EPICS or physics event.  Configuration events are
+ * passed to the detectors array directly, and other events are skipped.
+ * @return Status of the event stream (CODA_OK while events are available)
+ */
+Int_t QwEventReadAhead::GetNextEvent()
+{
+  if (! fEnabled) {
+    Int_t status;
+    while ((status = fEventBuffer.GetNextEvent()) == CODA_OK) {
+      if (fEventBuffer.IsROCConfigurationEvent()) {
+        //  Send ROC configuration event data to the subsystem objects.
+        fEventBuffer.FillSubsystemConfigurationData(fDetectors);
+      }
+      if (fEventBuffer.IsEPICSEvent() || fEventBuffer.IsPhysicsEvent()) break;
+    }
+    return status;
+  }
+
+  //  Return the previous event to the reader
+  if (fCurrent != nullptr) {
+    fFreeSlots.Push(fCurrent);
+    fCurrent = nullptr;
+  }
+
+  if (! fRunning) {
+    if (fReaderStatus != CODA_OK) return fReaderStatus;
+    Start();
+  }
+
+  while ((fCurrent = fProcessedSlots.Pop()) != nullptr) {
+    //  Messages of the other threads for this event, in order
+    gQwLog.Replay(fCurrent->fLog);
+    if (fCurrent->fType != kConfigurationEvent) break;
+    fFreeSlots.Push(fCurrent);
+  }
+  if (fCurrent == nullptr) {
+    //  End of the stream: the reader status is visible after the join
+    Stop();
+    return fReaderStatus;
+  }
+
+  if (fUseSnapshots && fCurrent->fType == kPhysicsEvent && fCurrent->fPassedCuts) {
+    fOutputSnapshot.Read(fCurrent->fSnapshot.data(), fSnapshotSize);
+    fOutputEvent->Snapshot(fOutputSnapshot);
+    if (fOutputSnapshot.HasOverflow() || fOutputSnapshot.GetSize() != fSnapshotSize)
+      QwError << "QwEventReadAhead: Event data does not match the "
+              << "snapshot size of " << fSnapshotSize << " bytes" << QwLog::endl;
+  }
+  return CODA_OK;
+}
+
+Bool_t QwEventReadAhead::IsEPICSEvent()
+{
+  if (! fEnabled) return fEventBuffer.IsEPICSEvent();
+  return (fCurrent != nullptr && fCurrent->fType == kEPICSEvent);
+}
+
+Bool_t QwEventReadAhead::IsPhysicsEvent()
+{
+  if (! fEnabled) return fEventBuffer.IsPhysicsEvent();
+  return (fCurrent != nullptr && fCurrent->fType == kPhysicsEvent);
+}
+
+Bool_t QwEventReadAhead::FillEPICSData(QwEPICSEvent &epics)
+{
+  if (! fEnabled) return fEventBuffer.FillEPICSData(epics);
+  if (! IsEPICSEvent()) return kFALSE;
+  return fEventBuffer.FillEPICSData(epics, fCurrent->fRawEvent, *fOutputDecoder);
+}
+
+/**
+ * Fill, process and cut the current physics event.  With read-ahead this
+ * work has already been done by the processing thread.
+ * @return kTRUE if the event passed the single event cuts
+ */
+Bool_t QwEventReadAhead::ProcessEvent()
+{
+  if (! fEnabled) {
+    //  Fill the subsystem objects with their respective data for this event.
+    fEventBuffer.FillSubsystemData(fDetectors);
+    //  Process the subsystem data
+    fDetectors.ProcessEvent();
+    return fDetectors.ApplySingleEventCuts();
+  }
+  return (IsPhysicsEvent() && fCurrent->fPassedCuts);
+}
+
+/**
+ * Subsystem array of the current physics event.  With read-ahead this is
+ * a copy, valid until the next call to GetNextEvent, and only filled for
+ * events that passed the single event cuts.
+ */
+QwSubsystemArrayParity& QwEventReadAhead::GetEvent()
+{
+  if (! fEnabled || fCurrent == nullptr) return fDetectors;
+  if (fUseSnapshots) return *fOutputEvent;
+  return *(fCurrent->fEvent);
+}
+
+void QwEventReadAhead::Start()
+{
+  fFreeSlots.Reset();
+  fReadSlots.Reset();
+  fProcessedSlots.Reset();
+  for (auto& slot: fSlots) fFreeSlots.Push(&slot);
+
+  fRunning = kTRUE;
+  fReaderThread = std::thread(&QwEventReadAhead::ReaderLoop, this);
+  fProcessorThread = std::thread(&QwEventReadAhead::ProcessorLoop, this);
+}
+
+void QwEventReadAhead::Stop()
+{
+  if (! fRunning) return;
+
+  //  Unblock the threads if the caller stops before the end of the stream
+  fFreeSlots.Close(true);
+  fReadSlots.Close(true);
+  fProcessedSlots.Close(true);
+
+  if (fReaderThread.joinable()) fReaderThread.join();
+  if (fProcessorThread.joinable()) fProcessorThread.join();
+  fCurrent = nullptr;
+  fRunning = kFALSE;
+
+  //  Messages of the reader at the end of the stream
+  gQwLog.Replay(fReaderLog);
+}
+
+/**
+ * Reader thread: copy the events from the stream into free slots.  Only
+ * this thread touches the event stream while the read-ahead is running.
+ */
+void QwEventReadAhead::ReaderLoop()
+{
+  Int_t status = CODA_OK;
+  Slot* slot;
+  while ((slot = fFreeSlots.Pop()) != nullptr) {
+    QwLog::SetCapture(&slot->fLog);
+    while ((status = fEventBuffer.GetNextEvent()) == CODA_OK) {
+      if (fEventBuffer.IsROCConfigurationEvent()) {
+        slot->fType = kConfigurationEvent;
+      } else if (fEventBuffer.IsEPICSEvent()) {
+        slot->fType = kEPICSEvent;
+      } else if (fEventBuffer.IsPhysicsEvent()) {
+        slot->fType = kPhysicsEvent;
+      } else {
+        continue;
+      }
+      fEventBuffer.CopyCurrentEvent(slot->fRawEvent);
+      break;
+    }
+    if (status != CODA_OK) {
+      //  The slot is not passed on, so keep its messages for Stop
+      QwLog::SetCapture(&fReaderLog);
+      gQwLog.Replay(slot->fLog);
+      break;
+    }
+    QwLog::SetCapture(nullptr);
+    fReadSlots.Push(slot);
+  }
+  QwLog::SetCapture(nullptr);
+  fReaderStatus = status;
+  fReadSlots.Close();
+}
+
+/**
+ * Processing thread: decode the events in order on the detectors array and
+ * keep a copy of the events that pass the single event cuts.
+ */
+void QwEventReadAhead::ProcessorLoop()
+{
+  Slot* slot;
+  while ((slot = fReadSlots.Pop()) != nullptr) {
+    QwLog::SetCapture(&slot->fLog);
+    switch (slot->fType) {
+      case kConfigurationEvent:
+        fEventBuffer.FillSubsystemConfigurationData(fDetectors, slot->fRawEvent, *fProcessorDecoder);
+        break;
+      case kPhysicsEvent:
+        fEventBuffer.FillSubsystemData(fDetectors, slot->fRawEvent, *fProcessorDecoder);
+        fDetectors.ProcessEvent();
+        slot->fPassedCuts = fDetectors.ApplySingleEventCuts();
+        if (slot->fPassedCuts) {
+          if (fUseSnapshots) {
+            fProcessorSnapshot.Write(slot->fSnapshot.data(), fSnapshotSize);
+            fDetectors.Snapshot(fProcessorSnapshot);
+          } else {
+            *(slot->fEvent) = fDetectors;
+          }
+        }
+        break;
+      case kEPICSEvent:
+        break;
+    }
+    QwLog::SetCapture(nullptr);
+    fProcessedSlots.Push(slot);
+  }
+  fProcessedSlots.Close();
+}
@@ -4,19 +4,40 @@
  * Event ring buffer for burp detection and stability monitoring.
  * Maintains a circular buffer of recent events, applies rolling averages
  * for stability cuts, and implements burp detection with configurable
- * extent and precut parameters. Documentation-only edits; runtime
- * behavior unchanged.
+ * extent and precut parameters.  With ring.snapshots, events are stored
+ * as flat snapshots of their event data when all subsystems support this.
  */
 
 #include "QwEventRing.h"
 
+// System headers
+#include <cstring>
+
 /** Constructor: initialize ring buffer with specified size and options. */
 QwEventRing::QwEventRing(QwOptions &options, QwSubsystemArrayParity &event)
-  : fRollingAvg(event), fBurpAvg(event)
+  : fUseSnapshots(kFALSE), fSnapshotSize(0), fSnapshotEvent(event),
+    fPushedEvent(0), fPushedIndex(-1),
+    fRollingAvg(event), fBurpAvg(event)
 {
   ProcessOptions(options);
 
-  fEvent_Ring.resize(fRING_SIZE,event);
+  if (fUseSnapshots) {
+    //  Measure the size of a snapshot; this fails if any subsystem
+    //  does not support snapshots
+    fSnapshot.Measure();
+    if (fSnapshotEvent.Snapshot(fSnapshot)) {
+      fSnapshotSize = fSnapshot.GetSize();
+      fSnapshots.resize(fRING_SIZE * fSnapshotSize);
+      for (Int_t i = 0; i < fRING_SIZE; i++)
+        StoreEvent(i, fSnapshotEvent);
+    } else {
+      QwWarning << "QwEventRing: Not all subsystems support snapshots; "
+                << "the ring will hold full copies of the events." << QwLog::endl;
+      fUseSnapshots = kFALSE;
+    }
+  }
+  if (! fUseSnapshots)
+    fEvent_Ring.resize(fRING_SIZE,event);
 
   bRING_READY = kFALSE;
   bEVENT_READY = kTRUE;
@@ -61,6 +82,9 @@ void QwEventRing::DefineOptions(QwOptions &options)
   options.AddOptions()("ring.holdoff",
       po::value<int>()->default_value(200),
       "QwEventRing: number of events ignored after the beam trips");
+  options.AddOptions()("ring.snapshots",
+      po::value<bool>()->default_bool_value(false),
+      "QwEventRing: store only the event data of the events in the ring");
 }
 
 /** Process options and validate ring/burp parameter consistency. */
@@ -110,6 +134,8 @@ void QwEventRing::ProcessOptions(QwOptions &options)
     bStability=kFALSE;
 
   fPrintAfterUnwind = gQwOptions.GetValue<bool>("ring.print-after-unwind");
+
+  fUseSnapshots = gQwOptions.GetValue<bool>("ring.snapshots");
 }
 /**
  * Add an event to the ring buffer, applying stability cuts and burp detection.
@@ -124,7 +150,9 @@ void QwEventRing::push(QwSubsystemArrayParity &event)
   if (bEVENT_READY){
     Int_t thisevent = fNextToBeFilled;
     Int_t prevevent = (thisevent+fRING_SIZE-1)%fRING_SIZE;
-    fEvent_Ring[thisevent]=event;//copy the current good event to the ring 
+    StoreEvent(thisevent, event);//copy the current good event to the ring 
+    fPushedEvent = &event;
+    fPushedIndex = thisevent;
     if (bStability){
       fRollingAvg.AccumulateAllRunningSum(event);
     }
@@ -162,35 +190,34 @@ void QwEventRing::push(QwSubsystemArrayParity &event)
 	      //  might have a local stability cut failure, instead of just this
 	      //  global stability cut failure.
 	      for(Int_t i=0;i<fRING_SIZE;i++){
-	        fEvent_Ring[i].UpdateErrorFlag(fRollingAvg);
-	        fEvent_Ring[i].UpdateErrorFlag();
+	        UpdateErrorFlag(i, fRollingAvg);
 	      }
 	    }
-	    if ((fEvent_Ring[thisevent].GetEventcutErrorFlag() & kBCMErrorFlag)!=0 &&
-	        (fEvent_Ring[prevevent].GetEventcutErrorFlag() & kBCMErrorFlag)!=0){
+	    if ((GetEventcutErrorFlag(thisevent) & kBCMErrorFlag)!=0 &&
+	        (GetEventcutErrorFlag(prevevent) & kBCMErrorFlag)!=0){
         countdown = holdoff;
       }
       if (countdown > 0) {
         --countdown;
   	    for(Int_t i=0;i<fRING_SIZE;i++){
-	        fEvent_Ring[i].UpdateErrorFlag(kBeamTripError);
+	        UpdateErrorFlag(i, kBeamTripError);
 	      }
     	}
     }
     //ring processing is done at a separate location
 
     this->CheckBurpCut(thisevent);
+    fPushedIndex = -1;
   }
 }
 
 
 /**
- * Retrieve the next event from the ring buffer and deaccumulate from
- * rolling average if stability monitoring is enabled.
+ * Advance the read position of the ring buffer.
  *
- * @return Reference to the retrieved event.
+ * @return Ring position of the event to be read.
  */
-QwSubsystemArrayParity& QwEventRing::pop(){
+Int_t QwEventRing::NextToBeRead(){
   Int_t tempIndex;
   tempIndex=fNextToBeRead;  
   if (bDEBUG) QwMessage<<" Read at "<<fNextToBeRead<<QwLog::endl; 
@@ -199,16 +226,43 @@ QwSubsystemArrayParity& QwEventRing::pop(){
   if (fNextToBeRead==(fRING_SIZE-1)){
     bRING_READY=kFALSE;//setting to false is an extra measure of security to prevent reading a NULL value. 
   }
-  if (bStability){
-     fRollingAvg.DeaccumulateRunningSum(fEvent_Ring[tempIndex]);
-  }
 
   // Increment read index
   fNumberOfEvents --;
   fNextToBeRead = (fNextToBeRead + 1) % fRING_SIZE;
 
+  return tempIndex;
+}
+
+/**
+ * Retrieve the next event from the ring buffer and deaccumulate from
+ * rolling average if stability monitoring is enabled.
+ *
+ * @return Reference to the retrieved event, valid until the next call.
+ */
+QwSubsystemArrayParity& QwEventRing::pop(){
+  QwSubsystemArrayParity& event = GetEvent(NextToBeRead());
+  if (bStability){
+     fRollingAvg.DeaccumulateRunningSum(event);
+  }
+
   // Return the event
-  return fEvent_Ring[tempIndex];  
+  return event;
+}
+
+/**
+ * Retrieve the next event from the ring buffer into an existing subsystem
+ * array, and deaccumulate it from the rolling average if stability
+ * monitoring is enabled.  With snapshots, the event data is restored
+ * directly into the array, without an intermediate copy.
+ *
+ * @param event Subsystem array with the same configuration as the ring
+ */
+void QwEventRing::pop(QwSubsystemArrayParity &event){
+  RestoreEvent(NextToBeRead(), event);
+  if (bStability){
+     fRollingAvg.DeaccumulateRunningSum(event);
+  }
 }
 
 
@@ -224,16 +278,102 @@ Bool_t QwEventRing::IsReady(){ //Check for readiness to read data from the ring
 void QwEventRing::CheckBurpCut(Int_t thisevent)
 {
   if (bRING_READY || thisevent>fBurpExtent){
-    if (fBurpAvg.CheckForBurpFail(fEvent_Ring[thisevent])){
+    if (fBurpAvg.CheckForBurpFail(GetEvent(thisevent))){
       Int_t precut_start = (thisevent+fRING_SIZE-fBurpPrecut)%fRING_SIZE;
       for(Int_t i=precut_start;i!=(thisevent+1)%fRING_SIZE;i=(i+1)%fRING_SIZE){
-	      fEvent_Ring[i].UpdateErrorFlag(fBurpAvg);
-	      fEvent_Ring[i].UpdateErrorFlag();
+	      UpdateErrorFlag(i, fBurpAvg);
       }
     }
     Int_t beforeburp = (thisevent+fRING_SIZE-fBurpExtent-1)%fRING_SIZE;
-    fBurpAvg.DeaccumulateRunningSum(fEvent_Ring[beforeburp], kPreserveError);
+    fBurpAvg.DeaccumulateRunningSum(GetEvent(beforeburp), kPreserveError);
   }
-  fBurpAvg.AccumulateAllRunningSum(fEvent_Ring[thisevent], 0, kPreserveError);
+  fBurpAvg.AccumulateAllRunningSum(GetEvent(thisevent), 0, kPreserveError);
 
 }
+
+
+/**
+ * Return the event at a ring position, for reading only.  With snapshots,
+ * this is the event passed to push while its ring entry is unchanged, or
+ * otherwise a scratch array into which the event is restored.
+ */
+QwSubsystemArrayParity& QwEventRing::GetEvent(Int_t index)
+{
+  if (! fUseSnapshots)
+    return fEvent_Ring[index];
+  if (index == fPushedIndex)
+    return *fPushedEvent;
+  RestoreEvent(index, fSnapshotEvent);
+  return fSnapshotEvent;
+}
+
+/** Restore the event at a ring position into a subsystem array. */
+void QwEventRing::RestoreEvent(Int_t index, QwSubsystemArrayParity& event)
+{
+  if (! fUseSnapshots) {
+    event = fEvent_Ring[index];
+    return;
+  }
+  fSnapshot.Read(fSnapshots.data() + index * fSnapshotSize, fSnapshotSize);
+  event.Snapshot(fSnapshot);
+  if (fSnapshot.HasOverflow() || fSnapshot.GetSize() != fSnapshotSize)
+    QwError << "QwEventRing::RestoreEvent: Event data does not match the "
+            << "snapshot size of " << fSnapshotSize << " bytes" << QwLog::endl;
+}
+
+/** Store an event at a ring position. */
+void QwEventRing::StoreEvent(Int_t index, QwSubsystemArrayParity& event)
+{
+  if (! fUseSnapshots) {
+    if (&event != &fEvent_Ring[index]) fEvent_Ring[index] = event;
+    return;
+  }
+  fSnapshot.Write(fSnapshots.data() + index * fSnapshotSize, fSnapshotSize);
+  event.Snapshot(fSnapshot);
+  if (fSnapshot.HasOverflow() || fSnapshot.GetSize() != fSnapshotSize)
+    QwError << "QwEventRing::StoreEvent: Event data does not match the "
+            << "snapshot size of " << fSnapshotSize << " bytes" << QwLog::endl;
+}
+
+/**
+ * Update the error flags of the event at a ring position from the error
+ * flags in another subsystem array, and refresh its global error flag.
+ */
+void QwEventRing::UpdateErrorFlag(Int_t index, const QwSubsystemArrayParity& ev_error)
+{
+  QwSubsystemArrayParity& event = fUseSnapshots ? fSnapshotEvent : fEvent_Ring[index];
+  if (fUseSnapshots) RestoreEvent(index, event);
+  event.UpdateErrorFlag(ev_error);
+  event.UpdateErrorFlag();
+  StoreEvent(index, event);
+  if (index == fPushedIndex) fPushedIndex = -1;
+}
+
+//  The global error flag is the first word of a snapshot (see
+//  QwSubsystemArrayParity::Snapshot), so it can be read and updated
+//  without restoring the event.
+
+/** Global error flag of the event at a ring position. */
+UInt_t QwEventRing::GetEventcutErrorFlag(Int_t index)
+{
+  if (! fUseSnapshots)
+    return fEvent_Ring[index].GetEventcutErrorFlag();
+  UInt_t errorflag = 0;
+  std::memcpy(&errorflag, fSnapshots.data() + index * fSnapshotSize, sizeof(errorflag));
+  return errorflag;
+}
+
+/** Add to the global error flag of the event at a ring position. */
+void QwEventRing::UpdateErrorFlag(Int_t index, UInt_t errorflag)
+{
+  if (! fUseSnapshots) {
+    fEvent_Ring[index].UpdateErrorFlag(errorflag);
+    return;
+  }
+  char* header = fSnapshots.data() + index * fSnapshotSize;
+  UInt_t flag = 0;
+  std::memcpy(&flag, header, sizeof(flag));
+  flag |= errorflag;
+  std::memcpy(header, &flag, sizeof(flag));
+  if (index == fPushedIndex) fPushedIndex = -1;
+}
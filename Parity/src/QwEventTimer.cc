@@ -0,0 +1,131 @@
+/*!
+ * \file   QwEventTimer.cc
+ * \brief  Per-stage timing of the event loop for throughput benchmarks
+ */
+
+#include "QwEventTimer.h"
+
+// System headers
+#include <algorithm>
+#include <fstream>
+#include <sys/resource.h>
+
+// Qweak headers
+#include "QwLog.h"
+
+const char* const QwEventTimer::kStageNames[kNumStages] = {
+  "read", "epics", "process", "ring", "event", "pattern"
+};
+
+QwEventTimer::QwEventTimer(QwOptions &options)
+: fCreated(Clock::now()),
+  fLast(fCreated),
+  fEventStart(fCreated),
+  fEventStarted(kFALSE),
+  fEvents(0)
+{
+  std::fill(fStageTime, fStageTime + kNumStages, Clock::duration::zero());
+  ProcessOptions(options);
+}
+
+/**
+ * Define the command line options of the event timer
+ * @param options Options object
+ */
+void QwEventTimer::DefineOptions(QwOptions &options)
+{
+  options.AddOptions()("benchmark.report",
+      po::value<std::string>()->default_value(""),
+      "QwEventTimer: write the event rate, latency and stage timing as JSON to this file");
+}
+
+/**
+ * Process the command line options of the event timer
+ * @param options Options object
+ */
+void QwEventTimer::ProcessOptions(QwOptions &options)
+{
+  fReportFile = options.GetValue<std::string>("benchmark.report");
+}
+
+void QwEventTimer::Start()
+{
+  if (! IsEnabled()) return;
+  fLast = Clock::now();
+  fEventStarted = kFALSE;
+}
+
+/**
+ * The time since the last lap is spent waiting for the end of the stream,
+ * and the last event ends with its last lap.
+ */
+void QwEventTimer::Stop()
+{
+  if (! IsEnabled()) return;
+  Clock::time_point now = Clock::now();
+  fStageTime[kRead] += now - fLast;
+  if (fEventStarted) fLatency.push_back(Seconds(fLast - fEventStart).count());
+  fEventStarted = kFALSE;
+  fLast = now;
+}
+
+void QwEventTimer::WriteReport() const
+{
+  if (! IsEnabled()) return;
+
+  Double_t loop = 0.0;
+  for (Int_t stage = 0; stage < kNumStages; stage++)
+    loop += Seconds(fStageTime[stage]).count();
+  Double_t total = Seconds(Clock::now() - fCreated).count();
+
+  //  Latency percentiles from the sorted per-event latencies
+  std::vector<Float_t> latency(fLatency);
+  std::sort(latency.begin(), latency.end());
+  auto percentile = [&latency](Double_t p) {
+    if (latency.empty()) return 0.0;
+    std::size_t index = std::min(latency.size() - 1, std::size_t(p * latency.size()));
+    return 1e6 * latency[index];
+  };
+  Double_t mean = 0.0;
+  for (Float_t l: latency) mean += l;
+  if (! latency.empty()) mean *= 1e6 / latency.size();
+
+  //  Peak resident set size in kB (Linux) or bytes (macOS)
+  struct rusage usage;
+  Long64_t maxrss = (getrusage(RUSAGE_SELF, &usage) == 0)? usage.ru_maxrss: -1;
+#ifdef __APPLE__
+  if (maxrss > 0) maxrss /= 1024;
+#endif
+
+  std::ofstream report(fReportFile);
+  if (! report) {
+    QwError << "Could not write benchmark report to " << fReportFile << QwLog::endl;
+    return;
+  }
+  report << "{\n"
+         << "  \"events\": " << fEvents << ",\n"
+         << "  \"loop_seconds\": " << loop << ",\n"
+         << "  \"total_seconds\": " << total << ",\n"
+         << "  \"events_per_second\": " << (loop > 0.0? fEvents / loop: 0.0) << ",\n"
+         << "  \"latency_us\": {"
+         << " \"mean\": " << mean
+         << ", \"p50\": " << percentile(0.50)
+         << ", \"p99\": " << percentile(0.99)
+         << ", \"max\": " << (latency.empty()? 0.0: 1e6 * latency.back())
+         << " },\n"
+         << "  \"peak_rss_kb\": " << maxrss << ",\n"
+         << "  \"stages\": {\n";
+  for (Int_t stage = 0; stage < kNumStages; stage++) {
+    Double_t seconds = Seconds(fStageTime[stage]).count();
+    report << "    \"" << kStageNames[stage] << "\": {"
+           << " \"seconds\": " << seconds
+           << ", \"fraction\": " << (loop > 0.0? seconds / loop: 0.0)
+           << " }" << (stage + 1 < kNumStages? ",": "") << "\n";
+  }
+  report << "  }\n"
+         << "}\n";
+
+  QwMessage << "Benchmark report written to " << fReportFile << ": "
+            << fEvents << " events, " << (loop > 0.0? fEvents / loop: 0.0)
+            << " events/s" << QwLog::endl;
+}
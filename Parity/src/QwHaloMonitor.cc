@@ -95,6 +95,14 @@ QwHaloMonitor& QwHaloMonitor::operator= (const QwHaloMonitor &value)
   return *this;
 }
 
+/// Transfer the same event-based data as operator= to or from a snapshot
+void QwHaloMonitor::Snapshot(QwSnapshot& snapshot)
+{
+  if (GetElementName()!=""){
+    fHalo_Counter.Snapshot(snapshot);
+  }
+}
+
 /** \brief Add-assign from another halo monitor (sum counters). */
 QwHaloMonitor& QwHaloMonitor::operator+= (const QwHaloMonitor &value)
 {
@@ -1257,12 +1257,12 @@ void  QwHelicity::FillHistograms()
       QwDebug << "QwHelicity::FillHistograms helicity info " << QwLog::endl;
       QwDebug << "QwHelicity::FillHistograms  pattern polarity=" << fActualPatternPolarity << QwLog::endl;
       if (fHistograms[index]!=NULL)
-	fHistograms[index]->Fill(fActualPatternPolarity);
+	FillHistogram(index, fActualPatternPolarity);
       index+=1;
       
       for (size_t i=0; i<fWord.size(); i++){
 	if (fHistograms[index]!=NULL)
-	  fHistograms[index]->Fill(fWord[i].fValue);
+	  FillHistogram(index, fWord[i].fValue);
 	index+=1;	
 	QwDebug << "QwHelicity::FillHistograms " << fWord[i].fWordName << "=" << fWord[i].fValue << QwLog::endl;
       }
@@ -1271,20 +1271,20 @@ void  QwHelicity::FillHistograms()
     {
       QwDebug << "QwHelicity::FillHistograms mps info " << QwLog::endl;
       if (fHistograms[index]!=NULL)
-	fHistograms[index]->Fill(fEventNumber-fEventNumberOld);
+	FillHistogram(index, fEventNumber-fEventNumberOld);
       index+=1;
       if (fHistograms[index]!=NULL)
-	fHistograms[index]->Fill(fPatternNumber-fPatternNumberOld);
+	FillHistogram(index, fPatternNumber-fPatternNumberOld);
       index+=1;
       if (fHistograms[index]!=NULL)
-	fHistograms[index]->Fill(fPatternPhaseNumber);
+	FillHistogram(index, fPatternPhaseNumber);
       index+=1;
       if (fHistograms[index]!=NULL)
-	fHistograms[index]->Fill(fHelicityActual);
+	FillHistogram(index, fHelicityActual);
       index+=1;
       for (size_t i=0; i<fWord.size(); i++){
 	if (fHistograms[index]!=NULL)
-	  fHistograms[index]->Fill(fWord[i].fValue);
+	  FillHistogram(index, fWord[i].fValue);
 	index+=1;
 	QwDebug << "QwHelicity::FillHistograms " << fWord[i].fWordName << "=" << fWord[i].fValue << QwLog::endl;
       }
@@ -2181,6 +2181,41 @@ VQwSubsystem&  QwHelicity::operator=  (VQwSubsystem *value)
   return *this;
 }
 
+/**
+ * Transfer the helicity words and the decoded helicity state to or from a
+ * snapshot; the same values as copied by operator=.
+ */
+Bool_t QwHelicity::Snapshot(QwSnapshot& snapshot)
+{
+  snapshot.Transfer(fIsDataLoaded);
+  for(size_t i=0;i<fWord.size();i++)
+    snapshot.Transfer(fWord[i].fValue);
+  snapshot.Transfer(fHelicityActual);
+  snapshot.Transfer(fPatternNumber);
+  snapshot.Transfer(fPatternSeed);
+  snapshot.Transfer(fPatternPhaseNumber);
+  snapshot.Transfer(fEventNumber);
+  snapshot.Transfer(fActualPatternPolarity);
+  snapshot.Transfer(fDelayedPatternPolarity);
+  snapshot.Transfer(fPreviousPatternPolarity);
+  snapshot.Transfer(fHelicityReported);
+  snapshot.Transfer(fHelicityDelayed);
+  snapshot.Transfer(fHelicityBitPlus);
+  snapshot.Transfer(fHelicityBitMinus);
+  snapshot.Transfer(fGoodHelicity);
+  snapshot.Transfer(fGoodPattern);
+  snapshot.Transfer(fIgnoreHelicity);
+
+  snapshot.Transfer(fErrorFlag);
+  snapshot.Transfer(fEventNumberFirst);
+  snapshot.Transfer(fPatternNumberFirst);
+  snapshot.Transfer(fNumMissedGates);
+  snapshot.Transfer(fNumMissedEventBlocks);
+  snapshot.Transfer(fNumMultSyncErrors);
+  snapshot.Transfer(fNumHelicityErrors);
+  return kTRUE;
+}
+
 VQwSubsystem&  QwHelicity::operator+=  (VQwSubsystem *value)
 {
   //  Bool_t localdebug=kFALSE;
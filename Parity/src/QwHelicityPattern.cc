@@ -131,6 +131,10 @@ QwHelicityPattern::QwHelicityPattern(QwSubsystemArrayParity &event, const TStrin
     fAlternateDiff(event),
     fPositiveHelicitySum(event), 
     fNegativeHelicitySum(event),
+    fYieldCharge("q_targ"),
+    fPairYieldCharge("q_targ"),
+    fHelicityArray(0),
+    fHelicitySubsystem(0),
     fLastWindowNumber(0),
     fLastPatternNumber(0),
     fLastPhaseNumber(0),
@@ -250,14 +254,19 @@ void QwHelicityPattern::LoadEventData(QwSubsystemArrayParity &event)
   Bool_t localIgnoreHelicity = kFALSE;
   
   
-  // Get the list of helicity subsystems
+  // Get the helicity subsystem; this is looked up only when the pattern
+  // is loaded from a different subsystem array than before
   if (! fHelicityIsMissing){
-    std::vector<VQwSubsystem*> subsys_helicity = event.GetSubsystemByType("QwHelicity");
-    QwHelicity* helicity = 0;
-    
-    if (subsys_helicity.size() > 0) {
+    if (&event != fHelicityArray) {
+      std::vector<VQwSubsystem*> subsys_helicity = event.GetSubsystemByType("QwHelicity");
       // Take the first helicity subsystem
-      helicity = dynamic_cast<QwHelicity*>(subsys_helicity.at(0));
+      fHelicitySubsystem = (subsys_helicity.size() > 0) ?
+        dynamic_cast<QwHelicity*>(subsys_helicity.at(0)) : 0;
+      fHelicityArray = &event;
+    }
+    QwHelicity* helicity = fHelicitySubsystem;
+    
+    if (helicity != 0) {
       if (helicity->HasDataLoaded()){
 	localIgnoreHelicity = helicity->IsHelicityIgnored();
 	// Get the event, pattern, phase number and helicity
@@ -419,7 +428,7 @@ void  QwHelicityPattern::CalculatePairAsymmetry()
   if (fPairIsGood){
     if (! fIgnoreHelicity){
       //      // Update the blinder if conditions have changed
-      UpdateBlinder(fPairYield);
+      UpdateBlinder(fPairYield, fPairYieldCharge);
       //  Only blind the difference if we're using the real helicity.
       fBlinder.BlindPair(fPairDifference,fPairYield);
       //  Update the global error code in fDifference, and use it
@@ -488,12 +497,14 @@ void  QwHelicityPattern::CalculateAsymmetry()
   Int_t plushel  = 1;
   Int_t minushel = 0;
   Int_t checkhel = 0;
-  Bool_t firstplushel=kTRUE;
-  Bool_t firstminushel=kTRUE;
 
   fPositiveHelicitySum.ClearEventData();
   fNegativeHelicitySum.ClearEventData();
 
+  //  Order the events by helicity: the positive helicity events first,
+  //  followed by the negative helicity events, each in pattern order.
+  fPatternPhases.clear();
+  size_t nplus = 0;
   if (fIgnoreHelicity){
     //  Don't check to see if we have equal numbers of even and odd helicity states in this pattern.
     //  Build an asymmetry with even-parity phases as "+" and odd-parity phases as "-"
@@ -503,45 +514,23 @@ void  QwHelicityPattern::CalculateAsymmetry()
 	localhel ^= ((i >> j)&0x1);
       }
       if (localhel == plushel) {
-	if (firstplushel) {
-	  fPositiveHelicitySum = fEvents.at(i);
-	  firstplushel = kFALSE;
-	} else {
-	  fPositiveHelicitySum += fEvents.at(i);
-	}
+	fPatternPhases.insert(fPatternPhases.begin() + nplus, &fEvents.at(i));
+	nplus++;
       } else if (localhel == minushel) {
-	if (firstminushel) {
-	  fNegativeHelicitySum = fEvents.at(i);
-	  firstminushel = kFALSE;
-	} else {
-	  fNegativeHelicitySum += fEvents.at(i);
-	}
+	fPatternPhases.push_back(&fEvents.at(i));
       }
     }
   } else {
     //  
     for (size_t i = 0; i < fPatternSize; i++) {
       if (fHelicity[i] == plushel) {
-	if (localdebug) std::cout<<"QwHelicityPattern::CalculateAsymmetry:  here filling fPositiveHelicitySum \n";
-	if (firstplushel) {
-	  if (localdebug) std::cout<<"QwHelicityPattern::CalculateAsymmetry:  with = \n";
-	  fPositiveHelicitySum = fEvents.at(i);
-	  firstplushel = kFALSE;
-	} else {
-	  if (localdebug) std::cout<<"QwHelicityPattern::CalculateAsymmetry:  with += \n";
-	  fPositiveHelicitySum += fEvents.at(i);
-	}
+	if (localdebug) std::cout<<"QwHelicityPattern::CalculateAsymmetry:  positive helicity event "<<i<<"\n";
+	fPatternPhases.insert(fPatternPhases.begin() + nplus, &fEvents.at(i));
+	nplus++;
 	checkhel += 1;
       } else if (fHelicity[i] == minushel) {
-	if (localdebug) std::cout<<"QwHelicityPattern::CalculateAsymmetry:  here filling fNegativeHelicitySum \n";
-	if (firstminushel) {
-	  if (localdebug) std::cout<<"QwHelicityPattern::CalculateAsymmetry:  with = \n";
-	  fNegativeHelicitySum = fEvents.at(i);
-	  firstminushel = kFALSE;
-	} else {
-	  if (localdebug) std::cout<<"QwHelicityPattern::CalculateAsymmetry:  with += \n";
-	  fNegativeHelicitySum += fEvents.at(i);
-	}
+	if (localdebug) std::cout<<"QwHelicityPattern::CalculateAsymmetry:  negative helicity event "<<i<<"\n";
+	fPatternPhases.push_back(&fEvents.at(i));
 	checkhel -= 1;
       } else {
 	QwDebug << "QwHelicityPattern::CalculateAsymmetry:  "
@@ -573,16 +562,14 @@ void  QwHelicityPattern::CalculateAsymmetry()
     fQuartetNumber++;//Then increment the quartet number
     //std::cout<<" quartet count ="<<fQuartetNumber<<"\n";
 
-    fYield.Sum(fPositiveHelicitySum,fNegativeHelicitySum);
-    fYield.Scale(1.0/fPatternSize);
-    fDifference.Difference(fPositiveHelicitySum,fNegativeHelicitySum);
-    fDifference.Scale(1.0/fPatternSize);
+    //  Yield and difference of the positive and negative helicity sums,
+    //  scaled by the pattern size
+    fYield.CalculatePatternSums(fPatternPhases, nplus, fDifference,
+                                fPositiveHelicitySum, fNegativeHelicitySum);
 
-    
-    
     if (! fIgnoreHelicity){
       // Update the blinder if conditions have changed
-      UpdateBlinder(fYield);
+      UpdateBlinder(fYield, fYieldCharge);
       //  Only blind the difference if we're using the real helicity.
       fBlinder.Blind(fDifference,fYield);
       //  Update the global error code in fDifference, and use it
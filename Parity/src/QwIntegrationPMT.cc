@@ -454,6 +454,17 @@ QwIntegrationPMT& QwIntegrationPMT::operator= (const QwIntegrationPMT &value)
   return *this;
 }
 
+/// Transfer the same event-based data as operator= to or from a snapshot
+void QwIntegrationPMT::Snapshot(QwSnapshot& snapshot)
+{
+  if (GetElementName()!="")
+    {
+      fTriumf_ADC.Snapshot(snapshot);
+      snapshot.Transfer(fPedestal);
+      snapshot.Transfer(fCalibration);
+    }
+}
+
 /** \brief Add-assign from another PMT (sum raw channels). */
 QwIntegrationPMT& QwIntegrationPMT::operator+= (const QwIntegrationPMT &value)
 {
@@ -487,6 +498,42 @@ void QwIntegrationPMT::Difference(const QwIntegrationPMT &value1, const QwIntegr
   *this -= value2;
 }
 
+/**
+ * Set this PMT to the yield or difference of a helicity pattern, with the
+ * values calculated by QwPatternKernel.  The result is the same as for
+ * Sum or Difference of the positive and negative helicity sums, followed
+ * by Scale.
+ * @param phases     PMT in each phase, positive phases first
+ * @param nplus      Number of positive phases
+ * @param nphases    Number of phases
+ * @param difference Set the difference instead of the yield
+ * @param values     Values calculated by the kernel, see GetPatternValues
+ */
+void QwIntegrationPMT::SetPatternSum(const QwIntegrationPMT* const* phases, size_t nplus,
+                                     size_t nphases, Bool_t difference, const Double_t* values)
+{
+  if (GetElementName()!="")
+    {
+      Double_t pedestal_pos = phases[0]->fPedestal;
+      Double_t pedestal_neg = phases[nplus]->fPedestal;
+      for (size_t p = 1; p < nplus; p++)
+        pedestal_pos += phases[p]->fPedestal;
+      for (size_t p = nplus + 1; p < nphases; p++)
+        pedestal_neg += phases[p]->fPedestal;
+
+      UInt_t samples = 0;
+      UInt_t errorflag = 0;
+      for (size_t p = 0; p < nphases; p++) {
+        samples   += phases[p]->fTriumf_ADC.GetNumberOfSamples();
+        errorflag |= phases[p]->fTriumf_ADC.GetErrorCode();
+      }
+
+      this->fTriumf_ADC.SetPatternSum(phases[0]->fTriumf_ADC, samples, errorflag, values);
+      this->fPedestal = difference ? (pedestal_pos - pedestal_neg) : (pedestal_pos + pedestal_neg);
+      this->fCalibration = 0;
+    }
+}
+
 void QwIntegrationPMT::Ratio(QwIntegrationPMT &numer, QwIntegrationPMT &denom)
 {
   //  std::cout<<"QwIntegrationPMT::Ratio element name ="<<GetElementName()<<" \n";
@@ -506,10 +553,10 @@ void QwIntegrationPMT::Scale(Double_t factor)
   return;
 }
 
-void QwIntegrationPMT::Normalize(VQwDataElement* denom)
+void QwIntegrationPMT::Normalize(const VQwDataElement* denom)
 {
   if (fIsNormalizable) {
-    QwMollerADC_Channel* denom_ptr = dynamic_cast<QwMollerADC_Channel*>(denom);
+    const QwMollerADC_Channel* denom_ptr = dynamic_cast<const QwMollerADC_Channel*>(denom);
     QwMollerADC_Channel vqwk_denom(*denom_ptr);
     fTriumf_ADC.DivideBy(vqwk_denom);
   }
@@ -357,9 +357,9 @@ void QwLinearDiodeArray::UpdateErrorFlag(const VQwBPM *ev_error){
 void  QwLinearDiodeArray::ProcessEvent()
 {
   Bool_t localdebug = kFALSE;
-  static QwVQWK_Channel mean, meansqr;
-  static QwVQWK_Channel tmp("tmp");
-  static QwVQWK_Channel tmp2("tmp2");
+  static thread_local QwVQWK_Channel mean, meansqr;
+  static thread_local QwVQWK_Channel tmp("tmp");
+  static thread_local QwVQWK_Channel tmp2("tmp2");
 
   mean.InitializeChannel("mean","raw");
   meansqr.InitializeChannel("meansqr","raw");
@@ -520,6 +520,21 @@ QwLinearDiodeArray& QwLinearDiodeArray::operator= (const QwLinearDiodeArray &val
   return *this;
 }
 
+/// Transfer the same event-based data as operator= to or from a snapshot
+void QwLinearDiodeArray::Snapshot(QwSnapshot& snapshot)
+{
+  VQwBPM::Snapshot(snapshot);
+
+  if (GetElementName()!=""){
+    size_t i = 0;
+    fEffectiveCharge.Snapshot(snapshot);
+    for(i=0;i<8;i++) fPhotodiode[i].Snapshot(snapshot);
+    for(i=kXAxis;i<kNumAxes;i++) {
+      fRelPos[i].Snapshot(snapshot);
+    }
+  }
+}
+
 VQwBPM& QwLinearDiodeArray::operator+= (const VQwBPM &value)
 {
   *(dynamic_cast<QwLinearDiodeArray*>(this)) +=
@@ -175,7 +175,7 @@ Int_t QwMollerDetector::ProcessEvBuffer(const ROCID_t roc_id, const BankID_t ban
 
         fSTR7200_Channel[mod_index][chan_index].ProcessEvBuffer(&(buffer[fMollerChannelID[i].fWordInSubbank]), wordsLeft);
       } else {
-        std::cout << "Problem reading buffer, incorrect structure of map file?" << std::endl;
+        QwError << "Problem reading buffer, incorrect structure of map file?" << QwLog::endl;
       }
 
     }
@@ -270,6 +270,15 @@ VQwSubsystem&  QwMollerDetector::operator=(VQwSubsystem *value){
   return *this; 
 }
 
+Bool_t QwMollerDetector::Snapshot(QwSnapshot& snapshot){
+  for(size_t i = 0; i < fSTR7200_Channel.size(); i++){
+    for(size_t j = 0; j < fSTR7200_Channel[i].size(); j++){
+      fSTR7200_Channel[i][j].Snapshot(snapshot);
+    }
+  }
+  return kTRUE;
+}
+
 VQwSubsystem&  QwMollerDetector::operator+=(VQwSubsystem *value){
   //std::cout << "QwMollerDetector addition assignment (operator+=)" << std::endl;
   if(Compare(value)){
@@ -343,7 +352,7 @@ void QwMollerDetector::CalculateRunningAverage(){
 Int_t QwMollerDetector::LoadEventCuts(TString filename){return 0;}
 
 Bool_t QwMollerDetector::ApplySingleEventCuts(){
-  std::cout << "QwMoller::ApplySingleEventCuts() ";
+  QwDebug << "QwMoller::ApplySingleEventCuts()" << QwLog::endl;
   Bool_t test = kTRUE, test_1 = kTRUE;
 
   for (size_t i = 0; i < fSTR7200_Channel.size(); i++){
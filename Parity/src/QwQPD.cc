@@ -614,6 +614,20 @@ QwQPD& QwQPD::operator= (const QwQPD &value)
   return *this;
 }
 
+/// Transfer the same event-based data as operator= to or from a snapshot
+void QwQPD::Snapshot(QwSnapshot& snapshot)
+{
+  if (GetElementName()!=""){
+    Short_t i = 0;
+    fEffectiveCharge.Snapshot(snapshot);
+    for(i=0;i<4;i++) fPhotodiode[i].Snapshot(snapshot);
+    for(i=kXAxis;i<kNumAxes;i++){
+      fRelPos[i].Snapshot(snapshot);
+      fAbsPos[i].Snapshot(snapshot);
+    }
+  }
+}
+
 VQwBPM& QwQPD::operator+= (const VQwBPM &value)
 {
   *(dynamic_cast<QwQPD*>(this)) += *(dynamic_cast<const QwQPD*>(&value));
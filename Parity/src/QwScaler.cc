@@ -419,6 +419,18 @@ VQwSubsystem& QwScaler::operator=(VQwSubsystem *value)
   return *this; 
 }
 
+/**
+ * Snapshot: transfer all scaler channel values.
+ */
+Bool_t QwScaler::Snapshot(QwSnapshot& snapshot)
+{
+  snapshot.Transfer(fIsDataLoaded);
+  for (size_t i = 0; i < fScaler.size(); i++) {
+    fScaler.at(i)->Snapshot(snapshot);
+  }
+  return kTRUE;
+}
+
 /**
  * Addition-assignment: element-wise addition of scaler channels.
  */
@@ -13,6 +13,7 @@
 // Qweak headers
 #include "VQwSubsystemParity.h"
 #include "QwRootFile.h"
+#include "QwThreadPool.h"
 
 //*****************************************************************//
 
@@ -99,6 +100,31 @@ QwSubsystemArrayParity& QwSubsystemArrayParity::operator= (const QwSubsystemArra
   return *this;
 }
 
+//*****************************************************************//
+
+/**
+ * Transfer the event data of all subsystems to or from a snapshot.  After
+ * reading a snapshot, this array is in the same state as after assigning
+ * the array from which the snapshot was written.  The global error flag is
+ * always the first word of the snapshot.
+ * @param snapshot Snapshot being measured, written or read
+ * @return kFALSE if a subsystem does not support snapshots
+ */
+Bool_t QwSubsystemArrayParity::Snapshot(QwSnapshot& snapshot)
+{
+  Bool_t status = kTRUE;
+  snapshot.Transfer(fErrorFlag);
+  snapshot.Transfer(fCodaEventNumber);
+  snapshot.Transfer(fCodaEventType);
+  for (iterator subsys = begin(); subsys != end(); ++subsys) {
+    if (subsys->get() == NULL) continue;
+    VQwSubsystemParity* subsys_parity = dynamic_cast<VQwSubsystemParity*>(subsys->get());
+    if (subsys_parity == NULL || ! subsys_parity->Snapshot(snapshot))
+      status = kFALSE;
+  }
+  return status;
+}
+
 
 /**
  * Addition-assignment operator
@@ -212,6 +238,85 @@ void QwSubsystemArrayParity::Difference(
   }
 }
 
+/**
+ * Set this array to the yield, and another array to the difference, of the
+ * phases of a helicity pattern: the sum of all phases and the difference
+ * of the positive and negative phases, both divided by the number of
+ * phases.  Subsystems which implement CalculatePatternSums do this in one
+ * pass; for the others the positive and negative helicity sums are built
+ * with the subsystem operators.  Either way the result is the same as
+ * for Sum and Difference of the helicity sums followed by Scale.
+ * @param phases     Subsystem arrays of the phases, positive phases first
+ * @param nplus      Number of positive phases
+ * @param difference Subsystem array to hold the difference
+ * @param positive   Work space for the sum of the positive phases
+ * @param negative   Work space for the sum of the negative phases
+ */
+void QwSubsystemArrayParity::CalculatePatternSums(
+  const std::vector<QwSubsystemArrayParity*>& phases, size_t nplus,
+  QwSubsystemArrayParity& difference,
+  QwSubsystemArrayParity& positive,
+  QwSubsystemArrayParity& negative)
+{
+  const size_t nphases = phases.size();
+  if (nplus == 0 || nplus >= nphases) {
+    QwError << "QwSubsystemArrayParity::CalculatePatternSums: "
+            << "need positive and negative phases" << QwLog::endl;
+    return;
+  }
+
+  //  Event number, type and error flag as set by operator= and operator+=
+  auto first_event = [](UInt_t current, UInt_t next) {
+    return (current == 0) ? next : std::min(current, next);
+  };
+  UInt_t eventnumber_pos = phases[0]->fCodaEventNumber;
+  UInt_t eventnumber_neg = phases[nplus]->fCodaEventNumber;
+  for (size_t p = 1; p < nplus; p++)
+    eventnumber_pos = first_event(eventnumber_pos, phases[p]->fCodaEventNumber);
+  for (size_t p = nplus + 1; p < nphases; p++)
+    eventnumber_neg = first_event(eventnumber_neg, phases[p]->fCodaEventNumber);
+  UInt_t errorflag = 0;
+  for (size_t p = 0; p < nphases; p++)
+    errorflag |= phases[p]->fErrorFlag;
+  for (QwSubsystemArrayParity* result: {this, &difference}) {
+    result->fCodaEventNumber = first_event(eventnumber_pos, eventnumber_neg);
+    result->fCodaEventType   = phases[0]->fCodaEventType;
+    result->fErrorFlag       = errorflag;
+  }
+
+  std::vector<VQwSubsystem*> subsys_phases(nphases);
+  for (size_t i = 0; i < size(); i++) {
+    if (this->at(i) == NULL || difference.at(i) == NULL) continue;
+    for (size_t p = 0; p < nphases; p++)
+      subsys_phases[p] = phases[p]->at(i).get();
+
+    VQwSubsystemParity *yield =
+      dynamic_cast<VQwSubsystemParity*>(this->at(i).get());
+    VQwSubsystemParity *diff =
+      dynamic_cast<VQwSubsystemParity*>(difference.at(i).get());
+    if (yield->CalculatePatternSums(subsys_phases, nplus, diff))
+      continue;
+
+    VQwSubsystemParity *pos =
+      dynamic_cast<VQwSubsystemParity*>(positive.at(i).get());
+    VQwSubsystemParity *neg =
+      dynamic_cast<VQwSubsystemParity*>(negative.at(i).get());
+    *(positive.at(i)) = subsys_phases[0];
+    for (size_t p = 1; p < nplus; p++)
+      *pos += subsys_phases[p];
+    *(negative.at(i)) = subsys_phases[nplus];
+    for (size_t p = nplus + 1; p < nphases; p++)
+      *neg += subsys_phases[p];
+
+    *(this->at(i)) = pos;
+    *yield += neg;
+    yield->Scale(1.0/nphases);
+    *(difference.at(i)) = pos;
+    *diff -= neg;
+    diff->Scale(1.0/nphases);
+  }
+}
+
 /**
  * Scale this subsystem array
  * @param factor Scale factor
@@ -473,9 +578,21 @@ Bool_t QwSubsystemArrayParity::ApplySingleEventCuts(){
   VQwSubsystemParity *subsys_parity = nullptr;
   CountFalse=0;
   if (!empty()){
-    for (iterator subsys = begin(); subsys != end(); ++subsys){
-      subsys_parity=dynamic_cast<VQwSubsystemParity*>((subsys)->get());
-      status=subsys_parity->ApplySingleEventCuts();
+    //  The cuts of each subsystem only depend on its own data, so they
+    //  may be evaluated in parallel; the results are combined in order.
+    //  (Char_t rather than Bool_t: std::vector<bool> elements share words.)
+    std::vector<Char_t> subsys_status(size(), kTRUE);
+    if (fThreadPool != nullptr) {
+      fThreadPool->ForEach(size(), [this,&subsys_status](std::size_t i){
+        subsys_status[i] = dynamic_cast<VQwSubsystemParity*>(at(i).get())->ApplySingleEventCuts();
+      });
+    } else {
+      for (size_t i = 0; i < size(); i++)
+        subsys_status[i] = dynamic_cast<VQwSubsystemParity*>(at(i).get())->ApplySingleEventCuts();
+    }
+    for (size_t i = 0; i < size(); i++){
+      subsys_parity=dynamic_cast<VQwSubsystemParity*>(at(i).get());
+      status=subsys_status[i];
       ErrorFlag = subsys_parity->GetEventcutErrorFlag();
       if ((ErrorFlag & kEventCutMode3)==kEventCutMode3)//we only care about the event cut flag in event cut mode 3
 	fErrorFlag |= ErrorFlag; 
@@ -175,6 +175,29 @@ VQwBPM& VQwBPM::operator= (const VQwBPM &value)
   return *this;
 }
 
+/**
+ * \brief Transfer the event-based data of the base class to or from a snapshot.
+ *
+ * Transfers the same values as VQwBPM::operator=; derived classes call this
+ * before transferring their own channels.
+ *
+ * @param snapshot Snapshot being measured, written or read
+ */
+void VQwBPM::Snapshot(QwSnapshot& snapshot)
+{
+  if (GetElementName()!=""){
+    snapshot.Transfer(fQwStriplineCalibration);
+    snapshot.Transfer(fQwStriplineCorrection);
+    snapshot.Transfer(bRotated);
+    snapshot.Transfer(fRotationAngle);
+    snapshot.Transfer(fCosRotation);
+    snapshot.Transfer(fSinRotation);
+    snapshot.Transfer(fGoodEvent);
+    snapshot.Transfer(fRelativeGains, kNumAxes);
+    snapshot.Transfer(fPositionCenter, 3);
+  }
+}
+
 // VQwBPM& VQwBPM::operator+= (const VQwBPM &value)
 // {
 //   if (GetElementName()!=""){
@@ -9,6 +9,7 @@
  * behavior unchanged.
  */
 
+#include <algorithm>
 #include <iostream>
 
 using namespace std;
@@ -25,6 +26,7 @@ using namespace std;
 #include "QwParameterFile.h"
 #include "QwRootFile.h"
 #include "QwVQWK_Channel.h"
+#include "QwMollerADC_Channel.h"
 #include "QwPromptSummary.h"
 
 #ifdef __USE_DATABASE__
@@ -65,6 +67,12 @@ VQwDataHandler::VQwDataHandler(const VQwDataHandler &source)
   fDependentVar  = source.fDependentVar;
   fDependentType = source.fDependentType;
   fDependentName = source.fDependentName;
+  //  The outputs below are clones of the same type, so the corrections
+  //  prepared for the source apply
+  fCorrectionVar      = source.fCorrectionVar;
+  fCorrectionIndex    = source.fCorrectionIndex;
+  fCorrectionVarFused = source.fCorrectionVarFused;
+  fCorrectionFused    = source.fCorrectionFused;
   //  Create new objects for the the outputs.
   fOutputVar.resize(source.fOutputVar.size());
   for (size_t i = 0; i < this->fDependentVar.size(); i++) {
@@ -139,6 +147,110 @@ void VQwDataHandler::CalcOneOutput(const VQwHardwareChannel* dv, VQwHardwareChan
   
 }
 
+/**
+ * Prepare CalcOutputs for outputs that are all corrected with the same
+ * independent variables.
+ * @param ivs Independent variables
+ */
+void VQwDataHandler::PrepareCorrections(const vector< const VQwHardwareChannel* > &ivs)
+{
+  PrepareCorrections(vector< vector< const VQwHardwareChannel* > >(fOutputVar.size(), ivs));
+}
+
+/**
+ * Prepare CalcOutputs, given the independent variables of each output.
+ * Each independent variable is gathered only once per event, even when it
+ * is used for several outputs.  An output is calculated from the gathered
+ * values when the dependent variable, the output and all its independent
+ * variables are Moller ADC channels; other outputs use CalcOneOutput.
+ * @param ivs Independent variables of each output
+ */
+void VQwDataHandler::PrepareCorrections(const vector< vector< const VQwHardwareChannel* > > &ivs)
+{
+  fCorrectionVar.clear();
+  fCorrectionVarFused.clear();
+  fCorrectionIndex.assign(fOutputVar.size(), vector< size_t >());
+  fCorrectionFused.assign(fOutputVar.size(), kFALSE);
+  for (size_t i = 0; i < fOutputVar.size() && i < ivs.size(); i++) {
+    Bool_t fused = (i < fDependentVar.size()
+                    && dynamic_cast<const QwMollerADC_Channel*>(fDependentVar[i]) != NULL
+                    && dynamic_cast<const QwMollerADC_Channel*>(fOutputVar[i]) != NULL
+                    && ! ivs[i].empty());
+    for (size_t iv = 0; iv < ivs[i].size(); iv++) {
+      size_t index = std::find(fCorrectionVar.begin(), fCorrectionVar.end(), ivs[i][iv])
+                   - fCorrectionVar.begin();
+      if (index == fCorrectionVar.size()) {
+        fCorrectionVar.push_back(ivs[i][iv]);
+        fCorrectionVarFused.push_back(dynamic_cast<const QwMollerADC_Channel*>(ivs[i][iv]) != NULL);
+      }
+      fCorrectionIndex[i].push_back(index);
+      fused = fused && fCorrectionVarFused[index];
+    }
+    fCorrectionFused[i] = fused;
+  }
+}
+
+/**
+ * Calculate all outputs with the corrections prepared by PrepareCorrections.
+ * The block values and hardware sums of the independent variables are
+ * gathered into one array, and each output is the dependent variable plus
+ * the product of its row of sensitivities with that array, accumulated in
+ * the same order as by the ScaledAdd calls of CalcOneOutput.
+ * @param sens Sensitivities of each output to its independent variables
+ */
+void VQwDataHandler::CalcOutputs(const vector< vector< Double_t > > &sens)
+{
+  const size_t nvalues = QwMollerADC_Channel::kPatternValues;
+
+  // Gather the independent variables
+  const size_t nvar = fCorrectionVar.size();
+  fCorrectionValues.resize(nvar * nvalues);
+  fCorrectionErrorFlags.resize(nvar);
+  fCorrectionSamples.resize(nvar);
+  for (size_t k = 0; k < nvar; k++) {
+    if (! fCorrectionVarFused[k]) continue;
+    const QwMollerADC_Channel* iv = static_cast<const QwMollerADC_Channel*>(fCorrectionVar[k]);
+    iv->GetPatternValues(&fCorrectionValues[k * nvalues]);
+    fCorrectionErrorFlags[k] = iv->GetErrorCode();
+    fCorrectionSamples[k] = iv->GetNumberOfSamples();
+  }
+
+  // Apply the sensitivities
+  Double_t values[nvalues];
+  const size_t noutputs = std::min(fDependentVar.size(), fCorrectionIndex.size());
+  for (size_t i = 0; i < noutputs; i++) {
+    const vector< size_t >& index = fCorrectionIndex[i];
+    if (! fCorrectionFused[i] || sens.at(i).size() < index.size()) {
+      // Same calls as CalcOneOutput
+      if (fOutputVar[i] == NULL) {
+        QwError<<"Second is value is NULL, unable to calculate corrector."<<QwLog::endl;
+        continue;
+      }
+      if (fDependentVar[i] == NULL)
+        fOutputVar[i]->ClearEventData();
+      else
+        fOutputVar[i]->AssignValueFrom(fDependentVar[i]);
+      for (size_t iv = 0; iv < index.size(); iv++)
+        fOutputVar[i]->ScaledAdd(sens.at(i).at(iv), fCorrectionVar[index[iv]]);
+      continue;
+    }
+    const QwMollerADC_Channel* dv = static_cast<const QwMollerADC_Channel*>(fDependentVar[i]);
+    QwMollerADC_Channel* output = static_cast<QwMollerADC_Channel*>(fOutputVar[i]);
+    const Double_t* s = sens[i].data();
+    dv->GetPatternValues(values);
+    UInt_t errorflag = dv->GetErrorCode();
+    UInt_t samples = dv->GetNumberOfSamples();
+    for (size_t iv = 0; iv < index.size(); iv++) {
+      const Double_t* x = &fCorrectionValues[index[iv] * nvalues];
+      for (size_t j = 0; j < nvalues; j++)
+        values[j] += s[iv] * x[j];
+      errorflag |= fCorrectionErrorFlags[index[iv]];
+      samples += fCorrectionSamples[index[iv]];
+    }
+    output->SetPatternSum(*dv, samples, errorflag, values);
+  }
+}
+
 /** Copy dependent variables to output variables (default processing). */
 void VQwDataHandler::ProcessData() {
   
@@ -27,6 +27,7 @@
 #include "QwParityDB.h"
 #endif
 #include "QwPromptSummary.h"
+#include "QwPatternKernel.h"
 
 /**
  * Define command-line options for detector array normalization.
@@ -44,6 +45,11 @@ void VQwDetectorArray::DefineOptions(QwOptions &options){
     ("QwDetectorArray.norm_threshold",
      po::value<double>()->default_value(2.5),
      "Normalize the detectors for currents above this value");
+
+  options.AddOptions()
+    ("QwDetectorArray.channel-storage",
+     po::value<bool>()->default_bool_value(false),
+     "Keep the ADC data of all detectors contiguous and process it in one pass");
 }
 
 /**
@@ -65,6 +71,8 @@ void VQwDetectorArray::ProcessOptions(QwOptions &options) {
 
   fNormThreshold = options.GetValue<double>("QwDetectorArray.norm_threshold");
 
+  bChannelStorage = options.GetValue<bool>("QwDetectorArray.channel-storage");
+
 }
 
 
@@ -678,6 +686,10 @@ Int_t VQwDetectorArray::LoadInputParameters(TString pedestalfile) {
     if (ldebug) 
      std::cout<<" line read in the pedestal + cal file ="<<lineread<<" \n";
 
+    //  The ADC storage keeps its own copy of the calibrations
+    if (fADCStorage.IsAttached())
+     fADCStorage.UpdateCalibration();
+
     ldebug=kFALSE;
     mapstr.Close(); // Close the file (ifstream)
     return 0;
@@ -911,58 +923,58 @@ void  VQwDetectorArray::RandomizeMollerEvent(int helicity /*, const QwBeamCharge
         fTargetYprime.PrintInfo();
         fTargetEnergy.PrintInfo();*/
 
-    if(RequestExternalValue("x_targ", &fTargetX)){
+    if(fTargetX.IsConnected() || ConnectExternalValue(fTargetX)){
         
         if (bDEBUG){
             
-            dynamic_cast<QwMollerADC_Channel*>(&fTargetX)->PrintInfo();
-            QwWarning << "VQwDetectorArray::RandomizeMollerEvent Found "<<fTargetX.GetElementName()<< QwLog::endl;  
+            fTargetX->PrintInfo();
+            QwWarning << "VQwDetectorArray::RandomizeMollerEvent Found "<<fTargetX.GetName()<< QwLog::endl;  
         }
 
     }else{
 
         bIsExchangedDataValid = kFALSE;
         QwError << GetName() << " could not get external value for "
-	     << fTargetX.GetElementName() << QwLog::endl;
+	     << fTargetX.GetName() << QwLog::endl;
 
     }
   
-    if(RequestExternalValue("y_targ", &fTargetY)){
+    if(fTargetY.IsConnected() || ConnectExternalValue(fTargetY)){
         
         if (bDEBUG){
-            dynamic_cast<QwMollerADC_Channel*>(&fTargetY)->PrintInfo();
-            QwWarning << "VQwDetectorArray::RandomizeMollerEvent Found "<<fTargetY.GetElementName()<< QwLog::endl;
+            fTargetY->PrintInfo();
+            QwWarning << "VQwDetectorArray::RandomizeMollerEvent Found "<<fTargetY.GetName()<< QwLog::endl;
         }
 
     }else{
 
         bIsExchangedDataValid = kFALSE;
         QwError << GetName() << " could not get external value for "
-	     << fTargetY.GetElementName() << QwLog::endl;
+	     << fTargetY.GetName() << QwLog::endl;
     }
   
-    if(RequestExternalValue("xp_targ", &fTargetXprime)){
+    if(fTargetXprime.IsConnected() || ConnectExternalValue(fTargetXprime)){
         
         if (bDEBUG){
             
-            dynamic_cast<QwMollerADC_Channel*>(&fTargetXprime)->PrintInfo();
-            QwWarning << "VQwDetectorArray::RandomizeMollerEvent Found "<<fTargetXprime.GetElementName()<< QwLog::endl;
+            fTargetXprime->PrintInfo();
+            QwWarning << "VQwDetectorArray::RandomizeMollerEvent Found "<<fTargetXprime.GetName()<< QwLog::endl;
         }
 
     }else{
 
         bIsExchangedDataValid = kFALSE;
         QwError << GetName() << " could not get external value for "
-	     << fTargetXprime.GetElementName() << QwLog::endl;
+	     << fTargetXprime.GetName() << QwLog::endl;
     
     }
 
-    if(RequestExternalValue("yp_targ", &fTargetYprime)){
+    if(fTargetYprime.IsConnected() || ConnectExternalValue(fTargetYprime)){
 
         if (bDEBUG){
 
-            dynamic_cast<QwMollerADC_Channel*>(&fTargetYprime)->PrintInfo();
-            QwWarning << "VQwDetectorArray::RandomizeMollerEvent Found "<<fTargetYprime.GetElementName()<< QwLog::endl;
+            fTargetYprime->PrintInfo();
+            QwWarning << "VQwDetectorArray::RandomizeMollerEvent Found "<<fTargetYprime.GetName()<< QwLog::endl;
         
         }
 
@@ -970,16 +982,16 @@ void  VQwDetectorArray::RandomizeMollerEvent(int helicity /*, const QwBeamCharge
 
         bIsExchangedDataValid = kFALSE;
         QwError << GetName() << " could not get external value for "
-	     << fTargetYprime.GetElementName() << QwLog::endl;
+	     << fTargetYprime.GetName() << QwLog::endl;
 
     }
 
-    if(RequestExternalValue("e_targ", &fTargetEnergy)){
+    if(fTargetEnergy.IsConnected() || ConnectExternalValue(fTargetEnergy)){
 
         if (bDEBUG){
 
-            dynamic_cast<QwMollerADC_Channel*>(&fTargetEnergy)->PrintInfo();
-            QwWarning << "VQwDetectorArray::RandomizeMollerEvent Found "<<fTargetEnergy.GetElementName()<< QwLog::endl;
+            fTargetEnergy->PrintInfo();
+            QwWarning << "VQwDetectorArray::RandomizeMollerEvent Found "<<fTargetEnergy.GetName()<< QwLog::endl;
         
         }
 
@@ -987,13 +999,15 @@ void  VQwDetectorArray::RandomizeMollerEvent(int helicity /*, const QwBeamCharge
 
         bIsExchangedDataValid = kFALSE;
         QwError << GetName() << " could not get external value for "
-	     << fTargetEnergy.GetElementName() << QwLog::endl;
+	     << fTargetEnergy.GetName() << QwLog::endl;
 
     }
     
+    if (! bIsExchangedDataValid || ! fTargetCharge.IsConnected()) return;
+
     for (size_t i = 0; i < fMainDetID.size(); i++) {
 
-        fIntegrationPMT[i].RandomizeMollerEvent(helicity, fTargetCharge, fTargetX, fTargetY, fTargetXprime, fTargetYprime, fTargetEnergy);
+        fIntegrationPMT[i].RandomizeMollerEvent(helicity, *fTargetCharge, *fTargetX, *fTargetY, *fTargetXprime, *fTargetYprime, *fTargetEnergy);
         //fIntegrationPMT[i].PrintInfo();
     
     }
@@ -1031,6 +1045,9 @@ Int_t VQwDetectorArray::ProcessEvBuffer(const ROCID_t roc_id, const BankID_t ban
              << " and subbank "<<bank_id
              << " number of words="<<num_words<<std::endl;
 
+        fDecodePMT.clear();
+        fDecodeOffsets.clear();
+
         for (size_t i=0;i<fMainDetID.size();i++) {
 
             if (fMainDetID[i].fSubbankIndex==index) {
@@ -1044,8 +1061,16 @@ Int_t VQwDetectorArray::ProcessEvBuffer(const ROCID_t roc_id, const BankID_t ban
                     
                     }
 
-                    fIntegrationPMT[fMainDetID[i].fIndex].ProcessEvBuffer(&(buffer[fMainDetID[i].fWordInSubbank]),
-                     num_words-fMainDetID[i].fWordInSubbank);
+                    size_t pmt = fMainDetID[i].fIndex;
+                    UInt_t offset = fMainDetID[i].fWordInSubbank;
+                    if (offset + QwADCDecoder::kMollerADCWords <= num_words
+                        && ! fIntegrationPMT[pmt].GetADCChannel()->IsNameEmpty()) {
+                        //  Unpacked below, together with the other PMTs in this subbank
+                        fDecodePMT.push_back(pmt);
+                        fDecodeOffsets.push_back(offset);
+                    } else {
+                        fIntegrationPMT[pmt].ProcessEvBuffer(&(buffer[offset]), num_words-offset);
+                    }
 
                 }
 
@@ -1053,6 +1078,12 @@ Int_t VQwDetectorArray::ProcessEvBuffer(const ROCID_t roc_id, const BankID_t ban
 
         }
 
+        //  Unpack the ADC words of all PMTs in this subbank at once
+        fDecodeWords.resize(fDecodePMT.size());
+        QwADCDecoder::DecodeMollerADC(buffer, fDecodeOffsets.data(), fDecodePMT.size(), fDecodeWords.data());
+        for (size_t j=0;j<fDecodePMT.size();j++)
+            fIntegrationPMT[fDecodePMT[j]].GetADCChannel()->SetRawWords(fDecodeWords[j]);
+
     }
 
   return 0;
@@ -1190,8 +1221,28 @@ void VQwDetectorArray::UpdateErrorFlag(const VQwSubsystem *ev_error){
 
 void  VQwDetectorArray::ProcessEvent() {
 
-    for (size_t i=0;i<fIntegrationPMT.size();i++)
-     fIntegrationPMT[i].ProcessEvent();
+    if (bChannelStorage) {
+
+        //  The channel map is complete by now, so the PMTs will not move
+        if (! fADCStorage.IsAttached()) {
+            std::vector<QwMollerADC_Channel*> channels;
+            for (size_t i=0;i<fIntegrationPMT.size();i++)
+             channels.push_back(fIntegrationPMT[i].GetADCChannel());
+            fADCStorage.Attach(channels);
+        }
+
+        //  Same as QwIntegrationPMT::ProcessEvent, with the ADC data of
+        //  all PMTs processed in a single pass
+        for (size_t i=0;i<fIntegrationPMT.size();i++)
+         fIntegrationPMT[i].ApplyHWChecks();
+        fADCStorage.ProcessEvent();
+
+    } else {
+
+        for (size_t i=0;i<fIntegrationPMT.size();i++)
+         fIntegrationPMT[i].ProcessEvent();
+
+    }
 
     for (size_t i=0;i<fCombinedPMT.size();i++) {
 
@@ -1215,13 +1266,13 @@ void  VQwDetectorArray::ExchangeProcessedData() {
 
     if (1==1 || bNormalization) {
 
-        if(RequestExternalValue("q_targ", &fTargetCharge)) {
+        if(fTargetCharge.IsConnected() || ConnectExternalValue(fTargetCharge)) {
 
             if (bDEBUG) {
 
-	            QwWarning << "VQwDetectorArray::ExchangeProcessedData Found "<<fTargetCharge.GetElementName()<< QwLog::endl;
+	            QwWarning << "VQwDetectorArray::ExchangeProcessedData Found "<<fTargetCharge.GetName()<< QwLog::endl;
 	            //QwWarning <<"****VQwDetectorArray****"<< QwLog::endl;
-	            (dynamic_cast<QwMollerADC_Channel*>(&fTargetCharge))->PrintInfo();
+	            fTargetCharge->PrintInfo();
       
             }
 
@@ -1229,7 +1280,7 @@ void  VQwDetectorArray::ExchangeProcessedData() {
 
             bIsExchangedDataValid = kFALSE;
             QwError << GetName() << " could not get external value for "
-	         << fTargetCharge.GetElementName() << QwLog::endl;
+	         << fTargetCharge.GetName() << QwLog::endl;
 
         }
     
@@ -1246,16 +1297,16 @@ void  VQwDetectorArray::ProcessEvent_2() {
       
         if (bDEBUG) {
 
-            Double_t  pedestal = fTargetCharge.GetPedestal();
-            Double_t  calfactor = fTargetCharge.GetCalibrationFactor();
-            Double_t  volts = fTargetCharge.GetAverageVolts();
+            Double_t  pedestal = fTargetCharge->GetPedestal();
+            Double_t  calfactor = fTargetCharge->GetCalibrationFactor();
+            Double_t  volts = fTargetCharge->GetAverageVolts();
         
             std::cout<<"VQwDetectorArray::ProcessEvent_2(): processing with exchanged data"<<std::endl;
             std::cout<<"pedestal, calfactor, average volts = "<<pedestal<<", "<<calfactor<<", "<<volts<<std::endl;
         
         }
       
-        if (bNormalization && fTargetCharge.GetValue()>fNormThreshold)
+        if (bNormalization && fTargetCharge->GetValue()>fNormThreshold)
 	     this->DoNormalization();
 
     } else {
@@ -1449,6 +1500,82 @@ VQwSubsystem&  VQwDetectorArray::operator=  (VQwSubsystem *value) {
 }
 
 
+/**
+ * Transfer the event data of all PMTs to or from a snapshot, in the same
+ * order as operator=.
+ */
+Bool_t VQwDetectorArray::Snapshot(QwSnapshot& snapshot) {
+
+    for (size_t i=0;i<fIntegrationPMT.size();i++)
+     fIntegrationPMT[i].Snapshot(snapshot);
+
+    for (size_t i=0;i<fCombinedPMT.size();i++)
+     fCombinedPMT[i].Snapshot(snapshot);
+
+    return kTRUE;
+
+}
+
+
+/**
+ * Calculate the yield and difference of the integration PMTs over the
+ * phases of a helicity pattern.  The block values and hardware sums of all
+ * PMTs are gathered into one flat array per phase and combined in a single
+ * pass by QwPatternKernel; the results are the same as with operator+=,
+ * Sum, Difference and Scale.  Combined PMTs refer to the PMTs of the arrays
+ * they were assigned from, so arrays with combined PMTs use the operators.
+ * @param phases     This subsystem in each phase, positive phases first
+ * @param nplus      Number of positive phases
+ * @param difference Subsystem to hold the difference
+ * @return kFALSE if the sums were not calculated
+ */
+Bool_t VQwDetectorArray::CalculatePatternSums(const std::vector<VQwSubsystem*>& phases,
+                                              size_t nplus, VQwSubsystem* difference) {
+
+    if (! fCombinedPMT.empty() || ! Compare(difference))
+     return kFALSE;
+
+    const size_t nphases = phases.size();
+    fPatternPhases.resize(nphases);
+    for (size_t p=0;p<nphases;p++) {
+     if (! Compare(phases[p]))
+      return kFALSE;
+     fPatternPhases[p] = dynamic_cast<VQwDetectorArray*>(phases[p]);
+    }
+    VQwDetectorArray* diff = dynamic_cast<VQwDetectorArray*>(difference);
+
+    //  Gather the values of each phase into one flat array
+    const size_t npmt = fIntegrationPMT.size();
+    const size_t nvalues = npmt * QwIntegrationPMT::kPatternValues;
+    fPatternValues.resize((nphases+2) * nvalues);
+    fPatternValuePtr.resize(nphases);
+    for (size_t p=0;p<nphases;p++) {
+     Double_t* values = &fPatternValues[p * nvalues];
+     for (size_t i=0;i<npmt;i++)
+      fPatternPhases[p]->fIntegrationPMT[i].GetPatternValues(values + i*QwIntegrationPMT::kPatternValues);
+     fPatternValuePtr[p] = values;
+    }
+
+    Double_t* yield_values = &fPatternValues[nphases * nvalues];
+    Double_t* diff_values  = yield_values + nvalues;
+    QwPatternKernel::Sums(fPatternValuePtr.data(), nplus, nphases, nvalues,
+                          1.0/nphases, yield_values, diff_values);
+
+    //  Fill the PMTs of the yield and the difference
+    fPatternPMT.resize(nphases);
+    for (size_t i=0;i<npmt;i++) {
+     for (size_t p=0;p<nphases;p++)
+      fPatternPMT[p] = &(fPatternPhases[p]->fIntegrationPMT[i]);
+     const size_t offset = i*QwIntegrationPMT::kPatternValues;
+     this->fIntegrationPMT[i].SetPatternSum(fPatternPMT.data(), nplus, nphases, kFALSE, yield_values + offset);
+     diff->fIntegrationPMT[i].SetPatternSum(fPatternPMT.data(), nplus, nphases, kTRUE, diff_values + offset);
+    }
+
+    return kTRUE;
+
+}
+
+
 VQwSubsystem&  VQwDetectorArray::operator+=  (VQwSubsystem *value) {
 
     if (Compare(value)) {
@@ -1521,7 +1648,7 @@ void VQwDetectorArray::Scale(Double_t factor) {
 
 //*****************************************************************//
 
-void VQwDetectorArray::Normalize(VQwDataElement* denom) {
+void VQwDetectorArray::Normalize(const VQwDataElement* denom) {
 
     for (size_t i = 0; i < fIntegrationPMT.size(); i++)
      fIntegrationPMT[i].Normalize(denom);
@@ -1667,7 +1794,7 @@ void VQwDetectorArray::DoNormalization(Double_t factor) {
 
         try {
 
-	        this->Normalize(&fTargetCharge);
+	        this->Normalize(fTargetCharge.Get());
         
         }
         
@@ -0,0 +1,17 @@
+#!/bin/bash
+
+# Test 005:
+#
+#   Run the unit tests (Tests/test_*.cc) that were built with the framework.
+#
+
+builddir=${1:-build}
+
+if [ ! -e ${builddir}/CTestTestfile.cmake ] ; then
+  echo "No unit tests found in ${builddir}."
+  exit -1
+fi
+
+(cd ${builddir} && ctest --output-on-failure) || exit -1
+
+exit 0
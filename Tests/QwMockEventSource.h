@@ -0,0 +1,138 @@
+/*!
+ * \file   QwMockEventSource.h
+ * \brief  Mock events for the unit tests, generated and decoded in memory
+ */
+
+#pragma once
+
+// System headers
+#include <list>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// Qweak headers
+#include "QwOptionsParity.h"
+#include "QwParameterFile.h"
+#include "QwEventBuffer.h"
+#include "QwSubsystemArrayParity.h"
+#include "QwHelicity.h"
+#include "QwDetectorArray.h"
+#include "QwCombinedBCM.h"
+#include "QwVQWK_Channel.h"
+#include "QwMollerADC_Channel.h"
+#include "MQwMockable.h"
+
+/**
+ * \class QwMockEventSource
+ * \ingroup QwAnalysis
+ * \brief Mock events passed through the same steps as in the analysis
+ *
+ * The events are generated as by qwmockdatagenerator, on a subsystem array
+ * of its own: randomized, encoded and given a CODA event header.  Instead
+ * of being written to a file, each event is decoded into the subsystem
+ * array of the test, processed and checked against the single event cuts,
+ * as by qwparity.  The parameter files are taken from Parity/prminput and
+ * Analysis/prminput relative to the working directory (the source
+ * directory under ctest).
+ */
+class QwMockEventSource {
+
+ public:
+  /// Multiplet structure of the generated helicity
+  static const Int_t kMultiplet = 64;
+
+  /// \brief Define the options of the analysis and set the command line
+  static void SetCommandLine(const std::vector<std::string>& args) {
+    //  The options object keeps pointers to the arguments
+    static std::list<std::string> storage;
+    static Bool_t defined = kFALSE;
+    if (! defined) {
+      DefineOptionsParity(gQwOptions);
+      QwParameterFile::AppendToSearchPath("Parity/prminput");
+      QwParameterFile::AppendToSearchPath("Analysis/prminput");
+      defined = kTRUE;
+    }
+    std::vector<char*> argv;
+    for (const auto& arg: args) {
+      storage.push_back(arg);
+      argv.push_back(&storage.back()[0]);
+    }
+    gQwOptions.SetCommandLine(argv.size(), argv.data(), false);
+  }
+
+  /// \brief Prepare the generation of a mock run
+  QwMockEventSource(QwOptions& options, UInt_t run)
+  : fGenerator(options), fHelicity(0), fEvent(0)
+  {
+    fGenerator.ProcessOptions(options);
+    fGenerator.LoadMockDataParameters("mock_parameters_list.map");
+    fGenerator.GetROCIDList(fROCList);
+    fHelicity = dynamic_cast<QwHelicity*>(fGenerator.GetSubsystemByName("Helicity Info"));
+    for (auto subsys: fGenerator.GetSubsystemByType("QwDetectorArray"))
+      fDetectorArrays.push_back(dynamic_cast<QwDetectorArray*>(subsys));
+
+    fEventBuffer.ProcessOptions(options);
+    fEncoder.reset(fEventBuffer.CreateDecoder());
+    fDecoder.reset(fEventBuffer.CreateDecoder());
+    fRawEvent.fRunNumber = run;
+
+    std::seed_seq seed{run, 0u};
+    MQwMockable::SetRandomSeed(seed);
+    QwCombinedBCM<QwVQWK_Channel>::SetTripSeed(0x56781234 ^ (run*run));
+    QwCombinedBCM<QwVQWK_Channel>::SetTripWindowPeriod(fGenerator.GetWindowPeriod());
+    QwCombinedBCM<QwMollerADC_Channel>::SetTripSeed(0x56781234 ^ (run*run));
+    QwCombinedBCM<QwMollerADC_Channel>::SetTripWindowPeriod(fGenerator.GetWindowPeriod());
+    if (fHelicity) {
+      fHelicity->SetEventPatternPhase(-1, -1, -1);
+      fHelicity->SetFirstBits(24, (0x1234 ^ run) & 0xFFFFFF);
+    }
+  }
+
+  /// \brief Generate the next event and fill, process and cut it in an array
+  Bool_t ProcessNextEvent(QwSubsystemArrayParity& detectors) {
+    fEvent++;
+    fGenerator.ClearEventData();
+    Int_t helicity = +1;
+    if (fHelicity) {
+      fHelicity->SetEventPatternPhase(fEvent, fEvent / kMultiplet, fEvent % kMultiplet + 1);
+      fHelicity->RunPredictor();
+      helicity = fHelicity->GetHelicityActual()? +1: -1;
+    }
+    fGenerator.RandomizeEventData(helicity, fEvent * fGenerator.GetWindowPeriod());
+    for (auto detectorarray: fDetectorArrays) {
+      detectorarray->ExchangeProcessedData();
+      detectorarray->RandomizeMollerEvent(helicity);
+    }
+
+    //  Encode the event with its CODA header, as in QwEventBuffer
+    std::vector<UInt_t> buffer;
+    fGenerator.EncodeEventData(buffer);
+    std::vector<UInt_t> header = fEncoder->EncodePHYSEventHeader(fROCList);
+    fRawEvent.fWords.clear();
+    fRawEvent.fWords.push_back(header.size() + buffer.size());
+    fRawEvent.fWords.insert(fRawEvent.fWords.end(), header.begin(), header.end());
+    fRawEvent.fWords.insert(fRawEvent.fWords.end(), buffer.begin(), buffer.end());
+
+    fEventBuffer.FillSubsystemData(detectors, fRawEvent, *fDecoder);
+    detectors.ProcessEvent();
+    return detectors.ApplySingleEventCuts();
+  }
+
+  /// Number of the last generated event
+  Int_t GetEventNumber() const { return fEvent; }
+
+ private:
+  QwSubsystemArrayParity fGenerator;
+  QwHelicity* fHelicity;
+  std::vector<QwDetectorArray*> fDetectorArrays;
+  std::vector<ROCID_t> fROCList;
+
+  QwEventBuffer fEventBuffer;
+  std::unique_ptr<VEventDecoder> fEncoder;
+  std::unique_ptr<VEventDecoder> fDecoder;
+  QwEventBuffer::RawEvent fRawEvent;
+
+  Int_t fEvent;
+};
@@ -0,0 +1,99 @@
+#!/bin/bash
+
+# Throughput benchmark:
+#
+#   Generate a reproducible mock data run on tmpfs, analyze it several times
+#   with qwparity, and collect the benchmark reports of the analysis (event
+#   rate, per-event latency, peak resident set size and time per stage) in
+#   a single JSON file.  The summary contains the median over the repetitions.
+#
+#   Usage: Tests/qwbenchmark.sh [bindir] [additional qwparity options]
+#
+#   Environment:
+#     QW_BENCHMARK_RUN      run number of the mock data (default 4)
+#     QW_BENCHMARK_EVENTS   number of events (default 20000)
+#     QW_BENCHMARK_REPEAT   number of analysis passes (default 5)
+#     QW_BENCHMARK_OUTPUT   JSON output file (default qwbenchmark.json)
+#     QW_BENCHMARK_DIR      directory for the mock data (default on /dev/shm)
+#
+
+bindir=${1:-build}
+shift
+run=${QW_BENCHMARK_RUN:-4}
+events=${QW_BENCHMARK_EVENTS:-20000}
+repeat=${QW_BENCHMARK_REPEAT:-5}
+output=${QW_BENCHMARK_OUTPUT:-qwbenchmark.json}
+
+setupscript=SetupFiles/SET_ME_UP.bash
+if [ -e ${setupscript} ] ; then
+  source ${setupscript} || exit -1
+else
+  export QWANALYSIS=${QWANALYSIS:-`pwd`}
+fi
+
+# Keep the mock data in memory, so the benchmark does not measure the disk
+if [ -n "${QW_BENCHMARK_DIR}" ] ; then
+  workdir=${QW_BENCHMARK_DIR}
+  mkdir -p ${workdir} || exit -1
+elif [ -d /dev/shm -a -w /dev/shm ] ; then
+  workdir=`mktemp -d /dev/shm/qwbenchmark.XXXXXX` || exit -1
+  trap "rm -rf ${workdir}" EXIT
+else
+  workdir=`mktemp -d -t qwbenchmark.XXXXXX` || exit -1
+  trap "rm -rf ${workdir}" EXIT
+fi
+
+options="--config qwparity_simple.conf --detectors mock_newdets.map --data ${workdir}"
+
+echo "Generating ${events} mock events for run ${run} in ${workdir}..."
+${bindir}/qwmockdatagenerator -r ${run} -e 1:${events} ${options} > ${workdir}/qwmockdatagenerator.log 2>&1 || {
+  echo "Mock data generation failed, see ${workdir}/qwmockdatagenerator.log"
+  trap - EXIT
+  exit -1
+}
+
+mkdir -p ${workdir}/rootfiles
+for i in `seq 1 ${repeat}` ; do
+  echo "Analysis pass ${i} of ${repeat}..."
+  ${bindir}/qwparity -r ${run} ${options} \
+    --datahandlers mock_datahandlers.map \
+    --rootfiles ${workdir}/rootfiles \
+    --benchmark.report ${workdir}/report.${i}.json \
+    "$@" > ${workdir}/qwparity.${i}.log 2>&1 || {
+    echo "Analysis failed, see ${workdir}/qwparity.${i}.log"
+    trap - EXIT
+    exit -1
+  }
+  rm -f ${workdir}/rootfiles/*
+done
+
+# Median of a top-level value or latency percentile over the reports of
+# this benchmark; reports of earlier benchmarks with more passes are ignored
+median() {
+  for i in `seq 1 ${repeat}` ; do
+    sed -n -e "s/.*\"$1\": \([-0-9.e+]*\).*/\1/p" ${workdir}/report.${i}.json
+  done | sort -g | awk '{ v[NR] = $1 } END { if (NR > 0) print v[int((NR + 1) / 2)]; else print 0 }'
+}
+
+{
+  echo "{"
+  echo "  \"run\": ${run},"
+  echo "  \"events\": ${events},"
+  echo "  \"repetitions\": ${repeat},"
+  echo "  \"summary\": {"
+  echo "    \"events_per_second\": `median events_per_second`,"
+  echo "    \"latency_p50_us\": `median p50`,"
+  echo "    \"latency_p99_us\": `median p99`,"
+  echo "    \"peak_rss_kb\": `median peak_rss_kb`"
+  echo "  },"
+  echo "  \"reports\": ["
+  for i in `seq 1 ${repeat}` ; do
+    sed -e 's/^/    /' ${workdir}/report.${i}.json
+    [ ${i} -lt ${repeat} ] && echo "    ,"
+  done
+  echo "  ]"
+  echo "}"
+} > ${output}
+
+cat ${output}
+exit 0
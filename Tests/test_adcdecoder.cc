@@ -0,0 +1,209 @@
+/*------------------------------------------------------------------------*//*!
+
+ \file test_adcdecoder.cc
+
+ \brief Test of the batch decoder of Moller ADC and VQWK raw words
+
+ Unpacks random banks and banks with boundary words with the single channel
+ and batch functions of QwADCDecoder, and compares every block sum, sum of
+ squares, minimum and maximum, hardware sum, sequence number and number of
+ samples with the unpacking of the former ProcessEvBuffer of
+ QwMollerADC_Channel and QwVQWK_Channel.  The test is built once for the
+ instruction set of the library, and once for the scalar and AVX2 code.
+
+*//*-------------------------------------------------------------------------*/
+
+// C and C++ headers
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Qweak headers
+#include "QwADCDecoder.h"
+
+namespace {
+
+  typedef QwADCDecoder::MollerADCWords MollerADCWords;
+  typedef QwADCDecoder::VQWKWords VQWKWords;
+  const Int_t kBlocks = QwADCDecoder::kBlocks;
+
+  /// Unpacking of QwMollerADC_Channel::ProcessEvBuffer before the decoder
+  void OldMollerADC(const UInt_t* buffer, MollerADCWords& words)
+  {
+    UInt_t localbuf[QwADCDecoder::kMollerADCWords] = {0};
+    Int_t localbuf_signed[QwADCDecoder::kMollerADCWords] = {0};
+    for (UInt_t i = 0; i < QwADCDecoder::kMollerADCWords; i++) {
+      localbuf[i] = buffer[i];
+      localbuf_signed[i] = static_cast<Int_t>(localbuf[i]);
+    }
+    for (Int_t i = 0; i < kBlocks; i++) {
+      words.fBlock_raw[i] = localbuf_signed[i*5];
+      words.fBlockSumSq_raw[i] = localbuf_signed[i*5+1];
+      words.fBlockSumSq_raw[i] += Long64_t (localbuf_signed[i*5+2]) << 32;
+      words.fBlock_min[i] = localbuf_signed[i*5+3];
+      words.fBlock_max[i] = localbuf_signed[i*5+4];
+    }
+    words.fHardwareBlockSum_raw = localbuf_signed[20];
+    words.fSequenceNumber  = (localbuf[25]>>8)  & 0xFF;
+    words.fNumberOfSamples = (localbuf[25]>>16) & 0xFFFF;
+  }
+
+  /// Unpacking of QwVQWK_Channel::ProcessEvBuffer before the decoder
+  void OldVQWK(const UInt_t* buffer, VQWKWords& words)
+  {
+    UInt_t localbuf[QwADCDecoder::kVQWKWords] = {0};
+    Int_t localbuf_signed[QwADCDecoder::kVQWKWords] = {0};
+    for (UInt_t i = 0; i < QwADCDecoder::kVQWKWords; i++) {
+      localbuf[i] = buffer[i];
+      localbuf_signed[i] = static_cast<Int_t>(localbuf[i]);
+    }
+    for (Int_t i = 0; i < kBlocks; i++) {
+      words.fBlock_raw[i] = localbuf_signed[i];
+    }
+    words.fHardwareBlockSum_raw = localbuf_signed[4];
+    words.fSequenceNumber  = (localbuf[5]>>8)  & 0xFF;
+    words.fNumberOfSamples = (localbuf[5]>>16) & 0xFFFF;
+  }
+
+  Bool_t Equal(const MollerADCWords& a, const MollerADCWords& b)
+  {
+    for (Int_t i = 0; i < kBlocks; i++) {
+      if (a.fBlock_raw[i] != b.fBlock_raw[i]
+       || a.fBlockSumSq_raw[i] != b.fBlockSumSq_raw[i]
+       || a.fBlock_min[i] != b.fBlock_min[i]
+       || a.fBlock_max[i] != b.fBlock_max[i]) return kFALSE;
+    }
+    return (a.fHardwareBlockSum_raw == b.fHardwareBlockSum_raw
+         && a.fSequenceNumber == b.fSequenceNumber
+         && a.fNumberOfSamples == b.fNumberOfSamples);
+  }
+
+  Bool_t Equal(const VQWKWords& a, const VQWKWords& b)
+  {
+    for (Int_t i = 0; i < kBlocks; i++) {
+      if (a.fBlock_raw[i] != b.fBlock_raw[i]) return kFALSE;
+    }
+    return (a.fHardwareBlockSum_raw == b.fHardwareBlockSum_raw
+         && a.fSequenceNumber == b.fSequenceNumber
+         && a.fNumberOfSamples == b.fNumberOfSamples);
+  }
+
+  /// Words at the limits of the signed and unsigned ranges
+  const UInt_t kBoundaryWords[] = {
+    0x00000000, 0x00000001, 0x7FFFFFFF, 0x80000000, 0x80000001,
+    0xFFFFFFFE, 0xFFFFFFFF, 0x0000FFFF, 0xFFFF0000, 0x00FF00FF
+  };
+  const std::size_t kNumBoundaryWords = sizeof(kBoundaryWords) / sizeof(UInt_t);
+
+  /// Fill a bank with random words, boundary words, or a mix of both
+  void FillBank(std::vector<UInt_t>& bank, Int_t mode, std::mt19937& rng)
+  {
+    std::uniform_int_distribution<UInt_t> word;
+    std::uniform_int_distribution<std::size_t> boundary(0, kNumBoundaryWords - 1);
+    for (std::size_t i = 0; i < bank.size(); i++) {
+      if (mode == 0 || (mode == 2 && (rng() & 1)))
+        bank[i] = word(rng);
+      else
+        bank[i] = kBoundaryWords[boundary(rng)];
+    }
+  }
+
+  /**
+   * Offsets of the channels in a bank: packed one after the other, with
+   * gaps, or in random order.  The last channel always ends on the last
+   * word of the bank, so that reads past the channel would be out of bounds.
+   */
+  std::vector<UInt_t> MakeOffsets(std::size_t nchannels, UInt_t words,
+                                  Int_t layout, std::mt19937& rng,
+                                  std::size_t& banksize)
+  {
+    std::vector<UInt_t> offsets(nchannels);
+    UInt_t next = 0;
+    for (std::size_t ch = 0; ch < nchannels; ch++) {
+      if (layout > 0) next += rng() % 3;
+      offsets[ch] = next;
+      next += words;
+    }
+    banksize = next;
+    if (layout > 1) std::shuffle(offsets.begin(), offsets.end(), rng);
+    return offsets;
+  }
+
+  /// Compare all decoders on one bank, and report the first mismatch
+  template <class Words>
+  Bool_t Compare(const char* name, const std::vector<UInt_t>& bank,
+                 const std::vector<UInt_t>& offsets,
+                 void (*old)(const UInt_t*, Words&),
+                 void (*single)(const UInt_t*, Words&),
+                 void (*batch)(const UInt_t*, const UInt_t*, std::size_t, Words*))
+  {
+    std::size_t n = offsets.size();
+    std::vector<Words> batchwords(n);
+    batch(bank.data(), offsets.data(), n, batchwords.data());
+    for (std::size_t ch = 0; ch < n; ch++) {
+      Words expected, singlewords;
+      old(bank.data() + offsets[ch], expected);
+      single(bank.data() + offsets[ch], singlewords);
+      if (! Equal(expected, singlewords) || ! Equal(expected, batchwords[ch])) {
+        std::cout << name << ": channel " << ch << " of " << n
+                  << " at offset " << offsets[ch] << " differs from "
+                  << (Equal(expected, singlewords)? "the batch": "the single channel")
+                  << " decoder" << std::endl;
+        return kFALSE;
+      }
+    }
+    return kTRUE;
+  }
+
+}
+
+Int_t main(Int_t argc, Char_t* argv[])
+{
+#if defined(__AVX2__) && ! defined(QW_ADC_DECODER_SCALAR) && (defined(__GNUC__) || defined(__clang__))
+  if (! __builtin_cpu_supports("avx2")) {
+    std::cout << "AVX2 is not supported on this processor, skipping" << std::endl;
+    return 77;
+  }
+#endif
+
+  std::cout << "Testing the " << QwADCDecoder::GetInstructionSet()
+            << " batch decoder" << std::endl;
+
+  std::mt19937 rng(20240917);
+  Int_t failures = 0;
+  Int_t banks = 0;
+  //  Channel counts cover the remainders of the two, four and eight
+  //  channel vector loops
+  for (std::size_t nchannels = 0; nchannels <= 19; nchannels++) {
+    for (Int_t layout = 0; layout < 3; layout++) {
+      for (Int_t mode = 0; mode < 3; mode++) {
+        for (Int_t repeat = 0; repeat < 20; repeat++) {
+          std::size_t banksize;
+          std::vector<UInt_t> offsets =
+            MakeOffsets(nchannels, QwADCDecoder::kMollerADCWords, layout, rng, banksize);
+          std::vector<UInt_t> bank(banksize);
+          FillBank(bank, mode, rng);
+          void (*single_moller)(const UInt_t*, MollerADCWords&) = &QwADCDecoder::DecodeMollerADC;
+          void (*batch_moller)(const UInt_t*, const UInt_t*, std::size_t, MollerADCWords*) = &QwADCDecoder::DecodeMollerADC;
+          if (! Compare("Moller ADC", bank, offsets, &OldMollerADC, single_moller, batch_moller))
+            failures++;
+
+          offsets = MakeOffsets(nchannels, QwADCDecoder::kVQWKWords, layout, rng, banksize);
+          bank.resize(banksize);
+          FillBank(bank, mode, rng);
+          void (*single_vqwk)(const UInt_t*, VQWKWords&) = &QwADCDecoder::DecodeVQWK;
+          void (*batch_vqwk)(const UInt_t*, const UInt_t*, std::size_t, VQWKWords*) = &QwADCDecoder::DecodeVQWK;
+          if (! Compare("VQWK", bank, offsets, &OldVQWK, single_vqwk, batch_vqwk))
+            failures++;
+
+          banks += 2;
+        }
+      }
+    }
+  }
+
+  std::cout << failures << " of " << banks << " banks differ" << std::endl;
+  return (failures == 0)? EXIT_SUCCESS: EXIT_FAILURE;
+}
@@ -0,0 +1,159 @@
+/*------------------------------------------------------------------------*//*!
+
+ \file test_adcstorage.cc
+
+ \brief Test of the Moller ADC storage against the channel processing
+
+ Sets the same random raw words in Moller ADC channels attached to a
+ QwMollerADC_Storage and in channels that are processed one by one with
+ QwMollerADC_Channel::ProcessEvent, and compares the hardware sums, the
+ block values and the error codes of every channel.  The events include
+ channels without samples, with and without a hardware sum, and the
+ calibrations are changed during the test.
+
+*//*-------------------------------------------------------------------------*/
+
+// C and C++ headers
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+// Qweak headers
+#include "QwLog.h"
+#include "QwMollerADC_Channel.h"
+#include "QwMollerADC_Storage.h"
+
+namespace {
+
+  /// Number of channels and events
+  const size_t kChannels = 37;
+  const Int_t kEvents = 2000;
+
+  /// Random raw words of one channel; a few channels have no samples
+  QwADCDecoder::MollerADCWords RandomWords(std::mt19937& rng)
+  {
+    std::uniform_int_distribution<Int_t> block(-(1 << 24), 1 << 24);
+    std::uniform_int_distribution<UInt_t> samples(1, 16000);
+    std::uniform_int_distribution<Int_t> kind(0, 99);
+    QwADCDecoder::MollerADCWords words = {};
+    words.fHardwareBlockSum_raw = 0;
+    for (Int_t i = 0; i < QwADCDecoder::kBlocks; i++) {
+      words.fBlock_raw[i] = block(rng);
+      words.fHardwareBlockSum_raw += words.fBlock_raw[i];
+    }
+    words.fNumberOfSamples = samples(rng);
+    switch (kind(rng)) {
+      case 0:   // no data at all
+        for (Int_t i = 0; i < QwADCDecoder::kBlocks; i++) words.fBlock_raw[i] = 0;
+        words.fHardwareBlockSum_raw = 0;
+        words.fNumberOfSamples = 0;
+        break;
+      case 1:   // a hardware sum without samples
+        words.fNumberOfSamples = 0;
+        break;
+      default:
+        break;
+    }
+    return words;
+  }
+
+  /// Compare a channel processed by the storage with one processed alone
+  Bool_t CompareChannels(Int_t n, size_t ch,
+                         const QwMollerADC_Channel& storage,
+                         const QwMollerADC_Channel& channel)
+  {
+    Bool_t equal = kTRUE;
+    //  Element 0 is the hardware sum, elements 1 to 4 are the blocks
+    for (size_t element = 0; element <= 4; element++) {
+      Double_t a = storage.GetValue(element), b = channel.GetValue(element);
+      if (std::memcmp(&a, &b, sizeof(Double_t)) != 0) {
+        QwError << "Event " << n << ", channel " << ch << ": element " << element
+                << " is " << a << " with the storage and " << b
+                << " with the channel" << QwLog::endl;
+        equal = kFALSE;
+      }
+    }
+    if (storage.GetErrorCode() != channel.GetErrorCode()) {
+      QwError << "Event " << n << ", channel " << ch << ": error code 0x" << std::hex
+              << storage.GetErrorCode() << " with the storage and 0x"
+              << channel.GetErrorCode() << " with the channel" << std::dec << QwLog::endl;
+      equal = kFALSE;
+    }
+    return equal;
+  }
+
+  /// Random pedestals and calibrations for both sets of channels
+  void SetCalibrations(std::mt19937& rng,
+                       std::vector<QwMollerADC_Channel>& storage,
+                       std::vector<QwMollerADC_Channel>& channels)
+  {
+    std::uniform_real_distribution<Double_t> pedestal(-500.0, 500.0);
+    std::uniform_real_distribution<Double_t> calibration(1e-6, 1e-3);
+    for (size_t ch = 0; ch < channels.size(); ch++) {
+      Double_t ped = pedestal(rng), cal = calibration(rng);
+      storage[ch].SetPedestal(ped);
+      storage[ch].SetCalibrationFactor(cal);
+      channels[ch].SetPedestal(ped);
+      channels[ch].SetCalibrationFactor(cal);
+    }
+  }
+
+}
+
+Int_t main(Int_t argc, Char_t* argv[])
+{
+  //  The storage refers to its channels, so their vector must not grow
+  std::vector<QwMollerADC_Channel> storagechannels, channels;
+  storagechannels.reserve(kChannels);
+  channels.reserve(kChannels);
+  for (size_t ch = 0; ch < kChannels; ch++) {
+    TString name = Form("adc%zu", ch);
+    storagechannels.emplace_back(name, "raw");
+    channels.emplace_back(name, "raw");
+  }
+
+  std::mt19937 rng(20241017);
+  SetCalibrations(rng, storagechannels, channels);
+
+  QwMollerADC_Storage storage;
+  std::vector<QwMollerADC_Channel*> attached;
+  for (auto& channel: storagechannels) attached.push_back(&channel);
+  storage.Attach(attached);
+
+  Int_t failed = 0, nosamples = 0;
+  for (Int_t n = 0; n < kEvents; n++) {
+    //  New calibrations half way through
+    if (n == kEvents / 2) {
+      SetCalibrations(rng, storagechannels, channels);
+      storage.UpdateCalibration();
+    }
+
+    for (size_t ch = 0; ch < kChannels; ch++) {
+      QwADCDecoder::MollerADCWords words = RandomWords(rng);
+      if (words.fNumberOfSamples == 0) nosamples++;
+      storagechannels[ch].ClearEventData();
+      storagechannels[ch].SetRawWords(words);
+      channels[ch].ClearEventData();
+      channels[ch].SetRawWords(words);
+    }
+
+    storage.ProcessEvent();
+    for (auto& channel: channels) channel.ProcessEvent();
+
+    Bool_t equal = kTRUE;
+    for (size_t ch = 0; ch < kChannels; ch++)
+      equal &= CompareChannels(n, ch, storagechannels[ch], channels[ch]);
+    if (! equal) failed++;
+  }
+
+  //  The channels keep the results of the last event when detached
+  storage.Detach();
+  for (size_t ch = 0; ch < kChannels; ch++)
+    if (! CompareChannels(kEvents, ch, storagechannels[ch], channels[ch])) failed++;
+
+  QwMessage << kEvents << " events of " << kChannels << " channels compared ("
+            << nosamples << " channels without samples), " << failed
+            << " differ" << QwLog::endl;
+  return (failed == 0)? EXIT_SUCCESS: EXIT_FAILURE;
+}
@@ -0,0 +1,171 @@
+/*------------------------------------------------------------------------*//*!
+
+ \file test_calcoutputs.cc
+
+ \brief Test of the fused corrections of the data handlers
+
+ Fills Moller ADC dependent and independent variables with random block
+ values, numbers of samples and error flags, and corrects them with
+ VQwDataHandler::CalcOutputs and with one VQwDataHandler::CalcOneOutput
+ call per output, as LRBCorrector and QwCombiner did before.  The
+ hardware sums, block values, numbers of samples and error codes of all
+ outputs must be identical.  The corrections are prepared once with the
+ same independent variables for all outputs, and once with a different
+ subset and order of the independent variables for each output, which
+ includes an output without dependent variable.
+
+*//*-------------------------------------------------------------------------*/
+
+// C and C++ headers
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+// Qweak headers
+#include "QwLog.h"
+#include "QwMollerADC_Channel.h"
+#include "VQwDataHandler.h"
+
+namespace {
+
+  /// Numbers of variables and events
+  const size_t kDependent = 12;
+  const size_t kIndependent = 7;
+  const Int_t kEvents = 500;
+
+  /// Handler with direct access to its dependent and output variables
+  class TestHandler: public VQwDataHandler, public MQwDataHandlerCloneable<TestHandler> {
+   public:
+    TestHandler(): VQwDataHandler("TestHandler") { }
+    TestHandler(const TestHandler& source): VQwDataHandler(source) { }
+
+    /// Use these dependent variables, with new outputs owned by the handler
+    void Connect(const std::vector<const VQwHardwareChannel*>& dvs) {
+      fDependentVar = dvs;
+      for (size_t i = 0; i < dvs.size(); i++)
+        fOutputVar.push_back(new QwMollerADC_Channel(Form("cor_dv%zu", i), "derived"));
+    }
+    VQwHardwareChannel* GetOutput(size_t i) { return fOutputVar.at(i); }
+  };
+
+  /// Random values, number of samples and error flag of a channel
+  void Randomize(std::mt19937& rng, QwMollerADC_Channel& channel)
+  {
+    std::normal_distribution<Double_t> value(0.0, 1e-3);
+    std::uniform_int_distribution<Int_t> samples(1, 16000);
+    std::uniform_int_distribution<Int_t> flag(0, 19);
+    Double_t block[4];
+    for (Int_t i = 0; i < 4; i++) block[i] = value(rng);
+    channel.ClearEventData();
+    channel.SetDefaultSampleSize(samples(rng));
+    channel.SetEventData(block);
+    //  Some variables carry an error flag
+    if (flag(rng) == 0) channel.UpdateErrorFlag(UInt_t(1) << flag(rng));
+  }
+
+  /// Compare an output of CalcOutputs with an output of CalcOneOutput
+  Bool_t CompareOutputs(Int_t n, size_t i, const VQwHardwareChannel* fused,
+                        const VQwHardwareChannel* reference)
+  {
+    Bool_t equal = kTRUE;
+    //  Element 0 is the hardware sum, elements 1 to 4 are the blocks
+    for (size_t element = 0; element <= 4; element++) {
+      Double_t a = fused->GetValue(element), b = reference->GetValue(element);
+      if (std::memcmp(&a, &b, sizeof(Double_t)) != 0) {
+        QwError << "Event " << n << ", output " << i << ": element " << element
+                << " is " << a << " with CalcOutputs and " << b
+                << " with CalcOneOutput" << QwLog::endl;
+        equal = kFALSE;
+      }
+    }
+    if (fused->GetErrorCode() != reference->GetErrorCode()) {
+      QwError << "Event " << n << ", output " << i << ": error code 0x" << std::hex
+              << fused->GetErrorCode() << " with CalcOutputs and 0x"
+              << reference->GetErrorCode() << " with CalcOneOutput" << std::dec << QwLog::endl;
+      equal = kFALSE;
+    }
+    const QwMollerADC_Channel* a = dynamic_cast<const QwMollerADC_Channel*>(fused);
+    const QwMollerADC_Channel* b = dynamic_cast<const QwMollerADC_Channel*>(reference);
+    if (a->GetNumberOfSamples() != b->GetNumberOfSamples()) {
+      QwError << "Event " << n << ", output " << i << ": " << a->GetNumberOfSamples()
+              << " samples with CalcOutputs and " << b->GetNumberOfSamples()
+              << " with CalcOneOutput" << QwLog::endl;
+      equal = kFALSE;
+    }
+    return equal;
+  }
+
+  /// Correct random events with both methods
+  Int_t TestCorrections(UInt_t seed, Bool_t shared)
+  {
+    std::mt19937 rng(seed);
+    std::vector<QwMollerADC_Channel> dependent, independent;
+    dependent.reserve(kDependent);
+    independent.reserve(kIndependent);
+    for (size_t i = 0; i < kDependent; i++)
+      dependent.emplace_back(Form("dv%zu", i), "derived");
+    for (size_t k = 0; k < kIndependent; k++)
+      independent.emplace_back(Form("iv%zu", k), "derived");
+
+    //  Dependent variables; the last output has none
+    std::vector<const VQwHardwareChannel*> dvs;
+    for (auto& dv: dependent) dvs.push_back(&dv);
+    dvs.back() = NULL;
+
+    //  Independent variables of each output: all of them, or a random
+    //  subset in random order
+    std::vector<const VQwHardwareChannel*> all;
+    for (auto& iv: independent) all.push_back(&iv);
+    std::vector< std::vector<const VQwHardwareChannel*> > ivs(kDependent, all);
+    if (! shared) {
+      for (auto& list: ivs) {
+        std::shuffle(list.begin(), list.end(), rng);
+        list.resize(1 + rng() % kIndependent);
+      }
+    }
+
+    //  Sensitivities, with some exact zeros
+    std::normal_distribution<Double_t> sensitivity(0.0, 10.0);
+    std::vector< std::vector<Double_t> > sens(kDependent);
+    for (size_t i = 0; i < kDependent; i++) {
+      for (size_t iv = 0; iv < ivs[i].size(); iv++)
+        sens[i].push_back((rng() % 10 == 0)? 0.0: sensitivity(rng));
+    }
+
+    TestHandler fused, reference;
+    fused.Connect(dvs);
+    reference.Connect(dvs);
+    if (shared) fused.PrepareCorrections(all);
+    else fused.PrepareCorrections(ivs);
+
+    Int_t failed = 0;
+    for (Int_t n = 0; n < kEvents; n++) {
+      for (auto& dv: dependent) Randomize(rng, dv);
+      for (auto& iv: independent) Randomize(rng, iv);
+
+      fused.CalcOutputs(sens);
+      for (size_t i = 0; i < kDependent; i++)
+        reference.CalcOneOutput(dvs[i], reference.GetOutput(i), ivs[i], sens[i]);
+
+      Bool_t equal = kTRUE;
+      for (size_t i = 0; i < kDependent; i++)
+        equal &= CompareOutputs(n, i, fused.GetOutput(i), reference.GetOutput(i));
+      if (! equal) failed++;
+    }
+    QwMessage << kEvents << " events with " << (shared? "shared": "separate")
+              << " independent variables compared, " << failed << " differ" << QwLog::endl;
+    return failed;
+  }
+
+}
+
+REGISTER_DATA_HANDLER_FACTORY(TestHandler);
+
+Int_t main(Int_t argc, Char_t* argv[])
+{
+  Int_t failed = TestCorrections(20241017, kTRUE);
+  failed += TestCorrections(20241018, kFALSE);
+  return (failed == 0)? EXIT_SUCCESS: EXIT_FAILURE;
+}
@@ -0,0 +1,173 @@
+/*------------------------------------------------------------------------*//*!
+
+ \file test_eventring.cc
+
+ \brief Test of the event ring with and without event snapshots
+
+ Pushes the same mock events through an event ring that holds full copies
+ of the subsystem arrays and through one that holds snapshots of their
+ event data (ring.snapshots), and compares every event that comes out of
+ the rings: all values of the tree vector (channel values, raw words,
+ sequence numbers and device error codes) and the global error flag,
+ which includes the stability, beam trip and burp cuts of the ring.
+
+*//*-------------------------------------------------------------------------*/
+
+// C and C++ headers
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// ROOT headers
+#include "TTree.h"
+
+// Qweak headers
+#include "QwLog.h"
+#include "QwRootFile.h"
+#include "QwEventRing.h"
+#include "QwSubsystemArrayParity.h"
+#include "QwMockEventSource.h"
+
+namespace {
+
+  /// Number of mock events pushed through the rings
+  const Int_t kEvents = 3000;
+
+  /// Size of the value of a tree vector entry in memory
+  std::size_t ValueSize(char type)
+  {
+    switch (type) {
+      case 'D': case 'L': case 'l': return 8;
+      case 'S': case 's': return 2;
+      case 'B': case 'b': case 'O': return 1;
+      default: return 4;
+    }
+  }
+
+  /// Compare two events from the rings; report up to a few differences
+  Bool_t CompareEvents(Int_t n,
+                       const QwSubsystemArrayParity& copy, QwRootTreeBranchVector& copyvalues,
+                       const QwSubsystemArrayParity& snapshot, QwRootTreeBranchVector& snapshotvalues)
+  {
+    Bool_t equal = kTRUE;
+    if (copy.GetEventcutErrorFlag() != snapshot.GetEventcutErrorFlag()) {
+      QwError << "Event " << n << ": global error flag 0x" << std::hex
+              << copy.GetEventcutErrorFlag() << " with copies, 0x"
+              << snapshot.GetEventcutErrorFlag() << " with snapshots"
+              << std::dec << QwLog::endl;
+      equal = kFALSE;
+    }
+    if (copy.GetCodaEventNumber() != snapshot.GetCodaEventNumber()) {
+      QwError << "Event " << n << ": CODA event number "
+              << copy.GetCodaEventNumber() << " with copies, "
+              << snapshot.GetCodaEventNumber() << " with snapshots" << QwLog::endl;
+      equal = kFALSE;
+    }
+
+    copy.FillTreeVector(copyvalues);
+    snapshot.FillTreeVector(snapshotvalues);
+    Int_t differences = 0;
+    for (std::size_t i = 0; i < copyvalues.size(); i++) {
+      std::size_t size = ValueSize(copyvalues.GetValueType(i));
+      if (std::memcmp(&copyvalues[i], &snapshotvalues[i], size) != 0) {
+        if (differences++ < 5)
+          QwError << "Event " << n << ": tree vector entry " << i
+                  << " differs between copies and snapshots" << QwLog::endl;
+        equal = kFALSE;
+      }
+    }
+    return equal;
+  }
+
+}
+
+Int_t main(Int_t argc, Char_t* argv[])
+{
+  std::vector<std::string> args = {
+    argv[0],
+    "--detectors", "mock_newdets.map",
+    "--ring.size", "64",
+    "--ring.holdoff", "20",
+    "--burp.extent", "10",
+    "--burp.precut", "5"
+  };
+
+  //  Ring with full copies of the events (the default)
+  QwMockEventSource::SetCommandLine(args);
+  QwSubsystemArrayParity detectors(gQwOptions);
+  detectors.ProcessOptions(gQwOptions);
+  QwMockEventSource source(gQwOptions, 10);
+  QwEventRing copyring(gQwOptions, detectors);
+
+  //  Ring with snapshots of the events
+  args.push_back("--ring.snapshots");
+  QwMockEventSource::SetCommandLine(args);
+  QwEventRing snapshotring(gQwOptions, detectors);
+
+  if (copyring.UsesSnapshots() || ! snapshotring.UsesSnapshots()) {
+    QwError << "The rings do not use the requested event storage" << QwLog::endl;
+    return EXIT_FAILURE;
+  }
+
+  //  Events out of the rings, with their tree vectors
+  QwSubsystemArrayParity copyoutput(detectors);
+  QwSubsystemArrayParity snapshotoutput(detectors);
+  TTree copytree("copy", "events from the ring with copies");
+  TTree snapshottree("snapshot", "events from the ring with snapshots");
+  QwRootTreeBranchVector copyvalues, snapshotvalues;
+  copyvalues.reserve(BRANCH_VECTOR_MAX_SIZE);
+  snapshotvalues.reserve(BRANCH_VECTOR_MAX_SIZE);
+  TString prefix = "";
+  copyoutput.ConstructBranchAndVector(&copytree, prefix, copyvalues);
+  snapshotoutput.ConstructBranchAndVector(&snapshottree, prefix, snapshotvalues);
+  if (copyvalues.size() == 0 || copyvalues.size() != snapshotvalues.size()) {
+    QwError << "The tree vectors have " << copyvalues.size() << " and "
+            << snapshotvalues.size() << " entries" << QwLog::endl;
+    return EXIT_FAILURE;
+  }
+
+  Int_t pushed = 0, compared = 0, failed = 0, flagged = 0;
+  for (Int_t event = 0; event < kEvents; event++) {
+    if (! source.ProcessNextEvent(detectors)) continue;
+    copyring.push(detectors);
+    snapshotring.push(detectors);
+    pushed++;
+
+    if (copyring.IsReady() != snapshotring.IsReady()) {
+      QwError << "The rings are not ready at the same event" << QwLog::endl;
+      return EXIT_FAILURE;
+    }
+    if (copyring.IsReady()) {
+      copyring.pop(copyoutput);
+      snapshotring.pop(snapshotoutput);
+      if (! CompareEvents(compared, copyoutput, copyvalues, snapshotoutput, snapshotvalues))
+        failed++;
+      if (copyoutput.GetEventcutErrorFlag() != 0) flagged++;
+      compared++;
+    }
+  }
+
+  //  Unwind both rings
+  while (copyring.GetNumberOfEvents() > 0 || snapshotring.GetNumberOfEvents() > 0) {
+    if (copyring.GetNumberOfEvents() != snapshotring.GetNumberOfEvents()) {
+      QwError << "The rings hold different numbers of events" << QwLog::endl;
+      return EXIT_FAILURE;
+    }
+    copyring.pop(copyoutput);
+    snapshotring.pop(snapshotoutput);
+    if (! CompareEvents(compared, copyoutput, copyvalues, snapshotoutput, snapshotvalues))
+      failed++;
+    if (copyoutput.GetEventcutErrorFlag() != 0) flagged++;
+    compared++;
+  }
+
+  QwMessage << pushed << " events pushed, " << compared << " compared ("
+            << flagged << " with error flags), " << failed << " differ"
+            << QwLog::endl;
+  if (compared != pushed) {
+    QwError << "Not all events came out of the rings" << QwLog::endl;
+    return EXIT_FAILURE;
+  }
+  return (failed == 0)? EXIT_SUCCESS: EXIT_FAILURE;
+}
@@ -0,0 +1,281 @@
+/*------------------------------------------------------------------------*//*!
+
+ \file test_linregbevpeb.cc
+
+ \brief Test of the block accumulation and merging of the correlator regression
+
+ Fills one LinRegBevPeb with the block update (addEvent, with flush before
+ the results are used, as in QwCorrelator::CalcCorrelations) and one with
+ the per-event update (operator+= with a pair of vectors) from the same
+ correlated random events, and compares the event counts, means,
+ covariances and slopes.  The numbers of events are not multiples of
+ kBlockEvents, so that the last block is partial, and include an extra
+ flush in the middle of a block.
+
+ The same events are also split in two halves at several points; the
+ merged halves must agree with a single pass, and the state written with
+ writeBinary and read back with readBinary must be identical.
+
+*//*-------------------------------------------------------------------------*/
+
+// C and C++ headers
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+// ROOT headers
+#include "TVectorD.h"
+
+// Qweak headers
+#include "QwLog.h"
+#include "LinReg_Bevington_Pebay.h"
+
+namespace {
+
+  /// Number of independent and dependent variables
+  const int kNP = 3;
+  const int kNY = 4;
+
+  /// Relative tolerance, in units of the spread of the compared quantity
+  const Double_t kTolerance = 1e-9;
+
+  /// Correlated events with large offsets, as for detector yields
+  class EventGenerator {
+   public:
+    EventGenerator(UInt_t seed): fRng(seed) { }
+    void Next(Double_t* P, Double_t* Y) {
+      for (int i = 0; i < kNP; i++)
+        P[i] = 1000.0 * (i + 1) + (i + 1) * fNormal(fRng);
+      for (int i = 0; i < kNY; i++) {
+        Y[i] = 500.0 - 100.0 * i + 0.1 * fNormal(fRng);
+        for (int j = 0; j < kNP; j++)
+          Y[i] += 0.01 * (i - j + 1) * (P[j] - 1000.0 * (j + 1));
+      }
+    }
+   private:
+    std::mt19937 fRng;
+    std::normal_distribution<Double_t> fNormal;
+  };
+
+  /// Check that two values agree within the tolerance on a scale
+  Bool_t Agree(const char* what, int i, int j, Double_t a, Double_t b, Double_t scale)
+  {
+    if (std::fabs(a - b) <= kTolerance * scale) return kTRUE;
+    QwError << what << "(" << i << "," << j << "): " << a << " and " << b
+            << " differ" << QwLog::endl;
+    return kFALSE;
+  }
+
+  /// Compare the means, covariances and slopes of two regressions
+  Bool_t CompareRegressions(LinRegBevPeb& test, LinRegBevPeb& reference)
+  {
+    Bool_t equal = kTRUE;
+    if (test.getUsedEve() != reference.getUsedEve()) {
+      QwError << "Events: " << test.getUsedEve() << " and "
+              << reference.getUsedEve() << " differ" << QwLog::endl;
+      return kFALSE;
+    }
+
+    Double_t sigmaP[kNP], sigmaY[kNY];
+    for (int i = 0; i < kNP; i++) {
+      Double_t a, b;
+      reference.getSigmaP(i, sigmaP[i]);
+      test.getMeanP(i, a); reference.getMeanP(i, b);
+      equal &= Agree("MeanP", i, 0, a, b, sigmaP[i]);
+    }
+    for (int i = 0; i < kNY; i++) {
+      Double_t a, b;
+      reference.getSigmaY(i, sigmaY[i]);
+      test.getMeanY(i, a); reference.getMeanY(i, b);
+      equal &= Agree("MeanY", i, 0, a, b, sigmaY[i]);
+    }
+    for (int i = 0; i < kNP; i++) {
+      for (int j = 0; j < kNP; j++) {
+        Double_t a, b;
+        test.getCovarianceP(i, j, a); reference.getCovarianceP(i, j, b);
+        equal &= Agree("CovarianceP", i, j, a, b, sigmaP[i] * sigmaP[j]);
+      }
+      for (int j = 0; j < kNY; j++) {
+        Double_t a, b;
+        test.getCovariancePY(i, j, a); reference.getCovariancePY(i, j, b);
+        equal &= Agree("CovariancePY", i, j, a, b, sigmaP[i] * sigmaY[j]);
+      }
+    }
+    for (int i = 0; i < kNY; i++) {
+      for (int j = 0; j < kNY; j++) {
+        Double_t a, b;
+        test.getCovarianceY(i, j, a); reference.getCovarianceY(i, j, b);
+        equal &= Agree("CovarianceY", i, j, a, b, sigmaY[i] * sigmaY[j]);
+      }
+    }
+
+    test.solve();
+    reference.solve();
+    for (int ip = 0; ip < kNP; ip++) {
+      for (int iy = 0; iy < kNY; iy++) {
+        Double_t a, da, b, db;
+        if (test.getSlope(ip, iy, a, da) != 0 || reference.getSlope(ip, iy, b, db) != 0) {
+          QwError << "Slope(" << ip << "," << iy << ") was not solved" << QwLog::endl;
+          return kFALSE;
+        }
+        equal &= Agree("Slope", ip, iy, a, b, db);
+        equal &= Agree("SlopeError", ip, iy, da, db, db);
+      }
+    }
+    return equal;
+  }
+
+  /// Fill a regression with the block update and one with the per-event update
+  Bool_t TestBlockUpdate(UInt_t seed, Int_t events, Int_t extraflush)
+  {
+    LinRegBevPeb blocks, reference;
+    blocks.setDims(kNP, kNY);
+    blocks.init();
+    reference.setDims(kNP, kNY);
+    reference.init();
+
+    EventGenerator generator(seed);
+    Double_t P[kNP], Y[kNY];
+    for (Int_t n = 0; n < events; n++) {
+      generator.Next(P, Y);
+      blocks.addEvent(P, Y);
+      reference += std::make_pair(TVectorD(kNP, P), TVectorD(kNY, Y));
+      if (n == extraflush) blocks.flush();
+    }
+    if (blocks.failed() != reference.failed()) {
+      QwError << "Only one regression failed with " << events << " events" << QwLog::endl;
+      return kFALSE;
+    }
+
+    //  Pending events, as in QwCorrelator::CalcCorrelations
+    blocks.flush();
+    Bool_t equal = CompareRegressions(blocks, reference);
+    if (! equal)
+      QwError << "Block update differs with " << events << " events" << QwLog::endl;
+    return equal;
+  }
+
+  /// Merge two halves of the events and compare with a single pass
+  Bool_t TestMerge(UInt_t seed, Int_t events, Int_t split)
+  {
+    LinRegBevPeb single, first, second;
+    for (LinRegBevPeb* lrb: {&single, &first, &second}) {
+      lrb->setDims(kNP, kNY);
+      lrb->init();
+    }
+
+    EventGenerator generator(seed);
+    Double_t P[kNP], Y[kNY];
+    for (Int_t n = 0; n < events; n++) {
+      generator.Next(P, Y);
+      single.addEvent(P, Y);
+      if (n < split) first.addEvent(P, Y);
+      else second.addEvent(P, Y);
+    }
+
+    //  The halves still hold pending events, which merge must fold in;
+    //  an empty object takes the dimensions of the first half
+    LinRegBevPeb merged;
+    merged.merge(first);
+    merged += second;
+    single.flush();
+    Bool_t equal = CompareRegressions(merged, single);
+    if (! equal)
+      QwError << "Merged halves of " << split << " and " << events - split
+              << " events differ from a single pass" << QwLog::endl;
+    return equal;
+  }
+
+  /// Write the state of a regression, read it back, and compare
+  Bool_t TestBinary(UInt_t seed, Int_t events)
+  {
+    LinRegBevPeb written;
+    written.setDims(kNP, kNY);
+    written.init();
+    EventGenerator generator(seed);
+    Double_t P[kNP], Y[kNY];
+    for (Int_t n = 0; n < events; n++) {
+      generator.Next(P, Y);
+      written.addEvent(P, Y);
+    }
+
+    std::stringstream stream;
+    if (! written.writeBinary(stream)) {
+      QwError << "Cannot write the state of " << events << " events" << QwLog::endl;
+      return kFALSE;
+    }
+    const std::string state = stream.str();
+
+    //  An empty object takes the dimensions of the stream
+    LinRegBevPeb read;
+    if (! read.readBinary(stream)) {
+      QwError << "Cannot read the state of " << events << " events" << QwLog::endl;
+      return kFALSE;
+    }
+    //  The state must be restored exactly
+    std::stringstream rewritten;
+    read.writeBinary(rewritten);
+    if (rewritten.str() != state) {
+      QwError << "The state of " << events << " events changed in the round trip"
+              << QwLog::endl;
+      return kFALSE;
+    }
+    if (! CompareRegressions(read, written)) return kFALSE;
+
+    //  A stream with a corrupted header or a truncated state is rejected
+    std::string corrupted = state;
+    corrupted[0] ^= 0xFF;
+    std::stringstream badmagic(corrupted);
+    std::stringstream truncated(state.substr(0, state.size() - 1));
+    LinRegBevPeb rejected;
+    if (rejected.readBinary(badmagic) || rejected.readBinary(truncated)) {
+      QwError << "A corrupted state was accepted" << QwLog::endl;
+      return kFALSE;
+    }
+
+    //  So are dimensions that are zero, too large, or larger than the
+    //  values in the stream; the number of independent variables follows
+    //  the magic number
+    for (uint32_t np: {0u, 0xFFFFFFFFu, 1000u}) {
+      corrupted = state;
+      std::memcpy(&corrupted[sizeof(uint32_t)], &np, sizeof(np));
+      std::stringstream baddims(corrupted);
+      LinRegBevPeb empty;
+      if (empty.readBinary(baddims)) {
+        QwError << "A state with " << np << " independent variables was accepted"
+                << QwLog::endl;
+        return kFALSE;
+      }
+    }
+    return kTRUE;
+  }
+
+}
+
+Int_t main(Int_t argc, Char_t* argv[])
+{
+  Int_t failures = 0;
+  const Int_t block = LinRegBevPeb::kBlockEvents;
+  //  Fewer events than a block, one more than a block, many blocks and a
+  //  partial block, with and without a flush in the middle of a block
+  for (Int_t events: {block - 9, block + 1, 17 * block + 23}) {
+    if (! TestBlockUpdate(events, events, -1)) failures++;
+    if (! TestBlockUpdate(events, events, events / 2)) failures++;
+  }
+  //  Halves split inside and at the end of a block, and an empty half
+  const Int_t events = 17 * block + 23;
+  for (Int_t split: {0, 1, block, 5 * block + 7, events / 2, events - 1, events}) {
+    if (! TestMerge(split, events, split)) failures++;
+  }
+  for (Int_t n: {block - 9, events}) {
+    if (! TestBinary(n, n)) failures++;
+  }
+
+  QwMessage << failures << " comparisons failed" << QwLog::endl;
+  return (failures == 0)? EXIT_SUCCESS: EXIT_FAILURE;
+}
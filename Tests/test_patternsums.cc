@@ -0,0 +1,206 @@
+/*------------------------------------------------------------------------*//*!
+
+ \file test_patternsums.cc
+
+ \brief Test of the helicity pattern sums against the subsystem operators
+
+ Builds helicity patterns from mock events and calculates their yield and
+ difference with QwSubsystemArrayParity::CalculatePatternSums, which uses
+ QwPatternKernel for the detector arrays, and with the sequence of
+ operator=, operator+=, Sum, Difference and Scale that QwHelicityPattern
+ used before.  Every value of the tree vectors of the yield and the
+ difference (block values, hardware sums, numbers of samples and device
+ error codes), the global error flags and the CODA event numbers must be
+ identical.
+
+*//*-------------------------------------------------------------------------*/
+
+// C and C++ headers
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+// ROOT headers
+#include "TTree.h"
+
+// Qweak headers
+#include "QwLog.h"
+#include "QwRootFile.h"
+#include "QwSubsystemArrayParity.h"
+#include "QwMockEventSource.h"
+
+namespace {
+
+  /// Number of patterns of each size
+  const Int_t kPatterns = 200;
+
+  /// Size of the value of a tree vector entry in memory
+  std::size_t ValueSize(char type)
+  {
+    switch (type) {
+      case 'D': case 'L': case 'l': return 8;
+      case 'S': case 's': return 2;
+      case 'B': case 'b': case 'O': return 1;
+      default: return 4;
+    }
+  }
+
+  /// Compare one result of both calculations; report up to a few differences
+  Bool_t CompareResults(const char* name, Int_t n,
+                        const QwSubsystemArrayParity& kernel, QwRootTreeBranchVector& kernelvalues,
+                        const QwSubsystemArrayParity& operators, QwRootTreeBranchVector& operatorvalues)
+  {
+    Bool_t equal = kTRUE;
+    if (kernel.GetEventcutErrorFlag() != operators.GetEventcutErrorFlag()) {
+      QwError << "Pattern " << n << ": global error flag of the " << name
+              << " 0x" << std::hex << kernel.GetEventcutErrorFlag()
+              << " with the pattern sums, 0x" << operators.GetEventcutErrorFlag()
+              << " with the operators" << std::dec << QwLog::endl;
+      equal = kFALSE;
+    }
+    if (kernel.GetCodaEventNumber() != operators.GetCodaEventNumber()) {
+      QwError << "Pattern " << n << ": CODA event number of the " << name
+              << " " << kernel.GetCodaEventNumber() << " with the pattern sums, "
+              << operators.GetCodaEventNumber() << " with the operators" << QwLog::endl;
+      equal = kFALSE;
+    }
+
+    kernel.FillTreeVector(kernelvalues);
+    operators.FillTreeVector(operatorvalues);
+    Int_t differences = 0;
+    for (std::size_t i = 0; i < kernelvalues.size(); i++) {
+      std::size_t size = ValueSize(kernelvalues.GetValueType(i));
+      if (std::memcmp(&kernelvalues[i], &operatorvalues[i], size) != 0) {
+        if (differences++ < 5)
+          QwError << "Pattern " << n << ": tree vector entry " << i << " of the "
+                  << name << " differs between the pattern sums and the operators"
+                  << QwLog::endl;
+        equal = kFALSE;
+      }
+    }
+    return equal;
+  }
+
+  /// Tree vector of a result array
+  void ConstructVector(QwSubsystemArrayParity& array, TTree& tree,
+                       QwRootTreeBranchVector& values)
+  {
+    TString prefix = "";
+    values.reserve(BRANCH_VECTOR_MAX_SIZE);
+    array.ConstructBranchAndVector(&tree, prefix, values);
+  }
+
+}
+
+Int_t main(Int_t argc, Char_t* argv[])
+{
+  QwMockEventSource::SetCommandLine({argv[0], "--detectors", "mock_newdets.map"});
+  QwSubsystemArrayParity detectors(gQwOptions);
+  detectors.ProcessOptions(gQwOptions);
+  QwMockEventSource source(gQwOptions, 10);
+
+  //  Results of both calculations, with their tree vectors
+  QwSubsystemArrayParity yield(detectors), difference(detectors);
+  QwSubsystemArrayParity positive(detectors), negative(detectors);
+  QwSubsystemArrayParity oldyield(detectors), olddifference(detectors);
+  QwSubsystemArrayParity oldpositive(detectors), oldnegative(detectors);
+  TTree tree("patterns", "pattern sums");
+  QwRootTreeBranchVector yieldvalues, differencevalues;
+  QwRootTreeBranchVector oldyieldvalues, olddifferencevalues;
+  ConstructVector(yield, tree, yieldvalues);
+  ConstructVector(difference, tree, differencevalues);
+  ConstructVector(oldyield, tree, oldyieldvalues);
+  ConstructVector(olddifference, tree, olddifferencevalues);
+  if (yieldvalues.size() == 0 || yieldvalues.size() != oldyieldvalues.size()) {
+    QwError << "The tree vectors have " << yieldvalues.size() << " and "
+            << oldyieldvalues.size() << " entries" << QwLog::endl;
+    return EXIT_FAILURE;
+  }
+
+  //  The detector arrays must use the kernel, or the test compares the
+  //  operators with themselves
+  Int_t kernelsubsystems = 0;
+  std::mt19937 rng(20241017);
+  Int_t patterns = 0, failed = 0, flagged = 0;
+  for (std::size_t patternsize: {2, 4, 8}) {
+    std::vector<QwSubsystemArrayParity> events(patternsize, detectors);
+    for (Int_t n = 0; n < kPatterns; n++) {
+      for (std::size_t i = 0; i < patternsize; i++) {
+        source.ProcessNextEvent(detectors);
+        events[i] = detectors;
+      }
+
+      //  Random helicities, with as many positive as negative phases; the
+      //  phases are ordered as by QwHelicityPattern::CalculateAsymmetry
+      std::vector<Int_t> helicity(patternsize, 0);
+      std::fill(helicity.begin(), helicity.begin() + patternsize/2, 1);
+      std::shuffle(helicity.begin(), helicity.end(), rng);
+      std::vector<QwSubsystemArrayParity*> phases;
+      std::size_t nplus = 0;
+      for (std::size_t i = 0; i < patternsize; i++) {
+        if (helicity[i] == 1) {
+          phases.insert(phases.begin() + nplus, &events[i]);
+          nplus++;
+        } else {
+          phases.push_back(&events[i]);
+        }
+      }
+
+      //  Pattern sums
+      yield.CalculatePatternSums(phases, nplus, difference, positive, negative);
+
+      //  Operators, as in QwHelicityPattern::CalculateAsymmetry before the
+      //  pattern sums
+      Bool_t firstplus = kTRUE, firstminus = kTRUE;
+      for (std::size_t i = 0; i < patternsize; i++) {
+        if (helicity[i] == 1) {
+          if (firstplus) oldpositive = events[i];
+          else oldpositive += events[i];
+          firstplus = kFALSE;
+        } else {
+          if (firstminus) oldnegative = events[i];
+          else oldnegative += events[i];
+          firstminus = kFALSE;
+        }
+      }
+      oldyield.Sum(oldpositive, oldnegative);
+      oldyield.Scale(1.0/patternsize);
+      olddifference.Difference(oldpositive, oldnegative);
+      olddifference.Scale(1.0/patternsize);
+
+      Bool_t equal = CompareResults("yield", patterns, yield, yieldvalues, oldyield, oldyieldvalues);
+      equal &= CompareResults("difference", patterns, difference, differencevalues,
+                              olddifference, olddifferencevalues);
+      if (! equal) failed++;
+      if (oldyield.GetEventcutErrorFlag() != 0) flagged++;
+      patterns++;
+
+      //  Count the subsystems that use the kernel, on a scratch copy
+      if (n == 0 && patternsize == 4) {
+        QwSubsystemArrayParity scratchyield(detectors), scratchdifference(detectors);
+        std::vector<VQwSubsystem*> subsys_phases(patternsize);
+        for (std::size_t i = 0; i < scratchyield.size(); i++) {
+          for (std::size_t p = 0; p < patternsize; p++)
+            subsys_phases[p] = phases[p]->at(i).get();
+          VQwSubsystemParity* subsys =
+            dynamic_cast<VQwSubsystemParity*>(scratchyield.at(i).get());
+          if (subsys->CalculatePatternSums(subsys_phases, nplus,
+                                           scratchdifference.at(i).get()))
+            kernelsubsystems++;
+        }
+      }
+    }
+  }
+
+  QwMessage << patterns << " patterns compared (" << flagged
+            << " with error flags), " << failed << " differ; "
+            << kernelsubsystems << " subsystems use the kernel" << QwLog::endl;
+  if (kernelsubsystems == 0) {
+    QwError << "No subsystem uses the pattern kernel" << QwLog::endl;
+    return EXIT_FAILURE;
+  }
+  return (failed == 0)? EXIT_SUCCESS: EXIT_FAILURE;
+}
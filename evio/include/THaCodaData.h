@@ -75,8 +75,8 @@ public:
    virtual Int_t codaOpen(const char* file_name, const char* session, Int_t mode=1) = 0;
    virtual Int_t codaClose()=0;
    virtual Int_t codaRead()=0;
-   UInt_t*       getEvBuffer() { return evbuffer.get(); }
-   UInt_t        getBuffSize() const { return evbuffer.size(); }
+   virtual UInt_t* getEvBuffer() { return evbuffer.get(); }
+   virtual UInt_t  getBuffSize() const { return evbuffer.size(); }
    virtual Bool_t isOpen() const = 0;
    virtual Int_t getCodaVersion();
    void          setVerbosity(int level) { verbose = level; }
@@ -0,0 +1,72 @@
+#ifndef Podd_THaCodaMappedFile_h_
+#define Podd_THaCodaMappedFile_h_
+
+/////////////////////////////////////////////////////////////////////
+//
+//  THaCodaMappedFile
+//  Memory-mapped file of CODA data (read-only)
+//
+//  The file is mapped into memory and the EVIO block (or record)
+//  headers are parsed directly from the mapping.  getEvBuffer()
+//  returns a pointer into the mapping, so events are not copied
+//  and no read system call is made per event.  Only events that
+//  span a block boundary (EVIO versions 1-3) are assembled in the
+//  event buffer.
+//
+//  Supported are uncompressed EVIO files of versions 1-4 and 6 in
+//  the native byte order; codaOpen fails for other files, which
+//  can still be read with THaCodaFile.
+//
+/////////////////////////////////////////////////////////////////////
+
+#include "THaCodaData.h"
+#include <cstddef>
+
+class THaCodaMappedFile : public THaCodaData {
+
+public:
+
+  THaCodaMappedFile();
+  explicit THaCodaMappedFile(const char* filename);
+  THaCodaMappedFile(const THaCodaMappedFile &fn) = delete;
+  THaCodaMappedFile& operator=(const THaCodaMappedFile &fn) = delete;
+  virtual ~THaCodaMappedFile();
+  virtual Int_t codaOpen(const char* filename, Int_t mode=1);
+  virtual Int_t codaOpen(const char* filename, const char* rw, Int_t mode=1);
+  virtual Int_t codaClose();
+  virtual Int_t codaRead();
+  virtual UInt_t* getEvBuffer() { return fEvPtr; }
+  virtual UInt_t  getBuffSize() const { return fEvSize; }
+  virtual bool isOpen() const;
+  virtual Int_t getCodaVersion();
+  Int_t getEvioVersion() const { return fEvioVersion; }
+  // Position of the current event, for use with codaSeek
+  void  getEventPosition(ULong64_t& block, UInt_t& offset) const;
+  Int_t codaSeek(ULong64_t block, UInt_t offset);
+  ULong64_t getFileSize() const { return fMapWords*sizeof(UInt_t); }
+
+private:
+
+  Int_t  NextBlock();
+  Int_t  ReadSpanningEvent( UInt_t evsize );
+
+  UInt_t*     fMap;           // Start of the mapped file
+  size_t      fMapWords;      // Size of the mapping in words
+  Int_t       fEvioVersion;   // EVIO format version of the file
+  size_t      fBlockPos;      // Offset of current block/record header
+  size_t      fBlockEnd;      // Offset past the event data in this block
+  size_t      fEventPos;      // Offset of the next event
+  UInt_t      fEventsLeft;    // Events left in this block (versions 4, 6)
+  Bool_t      fLastBlock;     // Current block is flagged as the last one
+  Bool_t      fFirstBlock;    // No block has been read yet
+  size_t      fEvBlockPos;    // Block of current event
+  size_t      fEvPos;         // Offset of current event
+  UInt_t*     fEvPtr;         // Current event
+  UInt_t      fEvSize;        // Size of current event in words
+
+  ClassDef(THaCodaMappedFile,0)   //  Memory-mapped file of CODA data
+
+};
+
+
+#endif